@@ -30,6 +30,7 @@
 #define ID_DRAW_RECTANGLE               40205
 #define ID_DRAW_POLYLINE                40206
 #define ID_DRAW_BSPLINE                 40207
+#define ID_DRAW_NURBS                   40209
 
 #define ID_FILL_SCANLINE                40301
 #define ID_FILL_BOUNDARY                40302
@@ -12,60 +12,12 @@
  * (x,y), (-x,y), (x,-y), (-x,-y), (y,x), (-y,x), (y,-x), (-y,-x)
  * 因此只需计算1/8圆弧（从0°到45°），就可以通过对称性得到整个圆。
  * 这大大减少了计算量，提高了绘制效率。
- */
-
-#include "CircleDrawer.h"
-
-/**
- * @brief 设置指定位置的像素颜色
- * @param hdc Windows设备上下文句柄
- * @param x 像素x坐标
- * @param y 像素y坐标
- * @param color 像素颜色
  * 
- * 封装Windows GDI的SetPixel函数，用于在指定位置绘制单个像素点
+ * 算法主体（连同逐行说明）位于 RasterCore.h 的模板中，本文件的方法以GDI输出策略实例化。
  */
-void CircleDrawer::SetPixel(HDC hdc, int x, int y, COLORREF color) {
-    ::SetPixel(hdc, x, y, color);
-}
 
-/**
- * @brief 利用圆的八分对称性绘制八个对称点
- * @param hdc Windows设备上下文句柄
- * @param center 圆心坐标
- * @param x 相对于圆心的x偏移（第一象限45°以下的点）
- * @param y 相对于圆心的y偏移（第一象限45°以下的点）
- * @param color 像素颜色
- * 
- * 【八分对称性原理】
- * 对于圆心在原点的圆，如果(x,y)在圆上，则以下8个点都在圆上：
- * 
- *        (-x,y)  |  (x,y)
- *     (-y,x)     |     (y,x)
- *   -------------|-------------
- *     (-y,-x)    |     (y,-x)
- *        (-x,-y) |  (x,-y)
- * 
- * 这8个点分别对应圆的8个45°扇区，通过一次计算绘制8个点
- */
-void CircleDrawer::DrawCirclePoints(HDC hdc, Point2D center, int x, int y, COLORREF color) {
-    // 第一象限：0°-45°区域的点 (x, y)
-    SetPixel(hdc, center.x + x, center.y + y, color);
-    // 第二象限：135°-180°区域的点 (-x, y)
-    SetPixel(hdc, center.x - x, center.y + y, color);
-    // 第四象限：315°-360°区域的点 (x, -y)
-    SetPixel(hdc, center.x + x, center.y - y, color);
-    // 第三象限：180°-225°区域的点 (-x, -y)
-    SetPixel(hdc, center.x - x, center.y - y, color);
-    // 第一象限：45°-90°区域的点 (y, x) - x和y交换
-    SetPixel(hdc, center.x + y, center.y + x, color);
-    // 第二象限：90°-135°区域的点 (-y, x)
-    SetPixel(hdc, center.x - y, center.y + x, color);
-    // 第四象限：270°-315°区域的点 (y, -x)
-    SetPixel(hdc, center.x + y, center.y - x, color);
-    // 第三象限：225°-270°区域的点 (-y, -x)
-    SetPixel(hdc, center.x - y, center.y - x, color);
-}
+#include "CircleDrawer.h"
+#include "RasterCore.h"
 
 /**
  * @brief 中点圆绘制算法
@@ -96,30 +48,9 @@ void CircleDrawer::DrawCirclePoints(HDC hdc, Point2D center, int x, int y, COLOR
  * 为避免浮点运算，取 d₀ = 1 - r（近似处理）
  */
 void CircleDrawer::DrawMidpoint(HDC hdc, Point2D center, int radius, COLORREF color) {
-    int x = 0, y = radius;  // 从圆的最上方点(0, r)开始
-    
-    // 初始决策参数 d = 1 - r
-    // 这是中点(1, r-0.5)代入圆方程的近似值
-    int d = 1 - radius;
-
-    // 只需绘制1/8圆弧（从90°到45°），利用对称性绘制完整圆
-    // 当 x > y 时，已经超过45°，停止循环
-    while (x <= y) {
-        // 利用八分对称性绘制8个点
-        DrawCirclePoints(hdc, center, x, y, color);
-        
-        if (d < 0) {
-            // 中点在圆内，选择正右方的点E(x+1, y)
-            // 下一个中点的决策参数增量：d_new = d + 2x + 3
-            d += 2 * x + 3;
-        } else {
-            // 中点在圆外或圆上，选择右下方的点SE(x+1, y-1)
-            // 下一个中点的决策参数增量：d_new = d + 2(x-y) + 5
-            d += 2 * (x - y) + 5;
-            y--;  // y坐标减1
-        }
-        x++;  // x坐标始终增加1
-    }
+    // 具体实现见 RasterCore::CircleMidpoint，这里以GDI像素输出策略实例化
+    GdiPixelSink sink(hdc, color);
+    RasterCore::CircleMidpoint(sink, center.x, center.y, radius);
 }
 
 /**
@@ -151,27 +82,7 @@ void CircleDrawer::DrawMidpoint(HDC hdc, Point2D center, int radius, COLORREF co
  * - 计算效率高，适合硬件实现
  */
 void CircleDrawer::DrawBresenham(HDC hdc, Point2D center, int radius, COLORREF color) {
-    int x = 0, y = radius;  // 从圆的最上方点(0, r)开始
-    
-    // Bresenham算法的初始决策参数
-    // d = 3 - 2r 是该算法的特征初始值
-    int d = 3 - 2 * radius;
-
-    // 只需绘制1/8圆弧，利用对称性绘制完整圆
-    while (x <= y) {
-        // 利用八分对称性绘制8个点
-        DrawCirclePoints(hdc, center, x, y, color);
-        
-        if (d < 0) {
-            // 选择正右方的点E(x+1, y)
-            // 决策参数增量：4x + 6
-            d += 4 * x + 6;
-        } else {
-            // 选择右下方的点SE(x+1, y-1)
-            // 决策参数增量：4(x-y) + 10
-            d += 4 * (x - y) + 10;
-            y--;  // y坐标减1
-        }
-        x++;  // x坐标始终增加1
-    }
+    // 具体实现见 RasterCore::CircleBresenham，这里以GDI像素输出策略实例化
+    GdiPixelSink sink(hdc, color);
+    RasterCore::CircleBresenham(sink, center.x, center.y, radius);
 }
@@ -40,26 +40,4 @@ public:
      * 只使用整数运算，效率更高
      */
     static void DrawBresenham(HDC hdc, Point2D center, int radius, COLORREF color = RGB(0, 0, 0));
-
-private:
-    /**
-     * @brief 设置指定位置的像素颜色
-     * @param hdc Windows设备上下文句柄
-     * @param x 像素x坐标
-     * @param y 像素y坐标
-     * @param color 像素颜色
-     */
-    static void SetPixel(HDC hdc, int x, int y, COLORREF color);
-    
-    /**
-     * @brief 利用圆的八分对称性绘制八个对称点
-     * @param hdc Windows设备上下文句柄
-     * @param center 圆心坐标
-     * @param x 相对于圆心的x偏移
-     * @param y 相对于圆心的y偏移
-     * @param color 像素颜色
-     * 
-     * 根据圆的对称性，一次计算可以绘制八个对称的像素点
-     */
-    static void DrawCirclePoints(HDC hdc, Point2D center, int x, int y, COLORREF color);
 };
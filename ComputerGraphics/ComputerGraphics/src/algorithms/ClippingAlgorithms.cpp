@@ -27,6 +27,7 @@
  */
 
 #include "ClippingAlgorithms.h"
+#include "../diagnostics/Profiler.h"
 #include <cmath>
 #include <set>
 
@@ -45,7 +46,8 @@
  * bit 2: BOTTOM (点在下方)
  * bit 3: TOP (点在上方)
  */
-int ClippingAlgorithms::ComputeOutCode(Point2D point, int xmin, int ymin, int xmax, int ymax) {
+template <typename T>
+int ClippingAlgorithms::ComputeOutCode(Point2<T> point, T xmin, T ymin, T xmax, T ymax) {
     int code = INSIDE;  // 初始化为内部区域
     
     // 检查水平位置
@@ -79,7 +81,9 @@ int ClippingAlgorithms::ComputeOutCode(Point2D point, int xmin, int ymin, int xm
  * 3. 如果两点在窗口同一侧外，直接拒绝
  * 4. 否则计算与窗口边界的交点，更新端点并重复
  */
-bool ClippingAlgorithms::ClipLineCohenSutherland(Point2D& p1, Point2D& p2, int xmin, int ymin, int xmax, int ymax) {
+template <typename T>
+bool ClippingAlgorithms::ClipLineCohenSutherland(Point2<T>& p1, Point2<T>& p2, T xmin, T ymin, T xmax, T ymax) {
+    PROFILE_FUNCTION();
     int outcode1 = ComputeOutCode(p1, xmin, ymin, xmax, ymax);  // 起点编码
     int outcode2 = ComputeOutCode(p2, xmin, ymin, xmax, ymax);  // 终点编码
     bool accept = false;
@@ -98,24 +102,24 @@ bool ClippingAlgorithms::ClipLineCohenSutherland(Point2D& p1, Point2D& p2, int x
         else {
             // 选择窗口外的点进行裁剪
             int outcodeOut = outcode1 ? outcode1 : outcode2;
-            Point2D intersection;
+            Point2<T> intersection;
 
-            // 计算与窗口边界的交点
+            // 计算与窗口边界的交点（插值精度由坐标类型决定）
             if (outcodeOut & TOP) {
                 // 与上边界相交
-                intersection.x = p1.x + (p2.x - p1.x) * (ymin - p1.y) / (p2.y - p1.y);
+                intersection.x = ScalarTraits<T>::Lerp(p1.x, p2.x, ymin - p1.y, p2.y - p1.y);
                 intersection.y = ymin;
             } else if (outcodeOut & BOTTOM) {
                 // 与下边界相交
-                intersection.x = p1.x + (p2.x - p1.x) * (ymax - p1.y) / (p2.y - p1.y);
+                intersection.x = ScalarTraits<T>::Lerp(p1.x, p2.x, ymax - p1.y, p2.y - p1.y);
                 intersection.y = ymax;
             } else if (outcodeOut & RIGHT) {
                 // 与右边界相交
-                intersection.y = p1.y + (p2.y - p1.y) * (xmax - p1.x) / (p2.x - p1.x);
+                intersection.y = ScalarTraits<T>::Lerp(p1.y, p2.y, xmax - p1.x, p2.x - p1.x);
                 intersection.x = xmax;
             } else if (outcodeOut & LEFT) {
                 // 与左边界相交
-                intersection.y = p1.y + (p2.y - p1.y) * (xmin - p1.x) / (p2.x - p1.x);
+                intersection.y = ScalarTraits<T>::Lerp(p1.y, p2.y, xmin - p1.x, p2.x - p1.x);
                 intersection.x = xmin;
             }
 
@@ -242,6 +246,7 @@ void ClippingAlgorithms::ClipLineMidpointRecursive(Point2D p1, Point2D p2, int x
  */
 void ClippingAlgorithms::ClipLineMidpoint(Point2D p1, Point2D p2, int xmin, int ymin, int xmax, int ymax,
                                           std::vector<std::pair<Point2D, Point2D>>& result) {
+    PROFILE_FUNCTION();
     ClipLineMidpointRecursive(p1, p2, xmin, ymin, xmax, ymax, result, 0);
 }
 
@@ -261,7 +266,8 @@ void ClippingAlgorithms::ClipLineMidpoint(Point2D p1, Point2D p2, int xmin, int
  * - 下边界：y <= ymax
  * - 上边界：y >= ymin
  */
-bool ClippingAlgorithms::IsInsideEdge(Point2D point, ClipEdge edge, int xmin, int ymin, int xmax, int ymax) {
+template <typename T>
+bool ClippingAlgorithms::IsInsideEdge(Point2<T> point, ClipEdge edge, T xmin, T ymin, T xmax, T ymax) {
     switch (edge) {
         case CLIP_LEFT: return point.x >= xmin;
         case CLIP_RIGHT: return point.x <= xmax;
@@ -287,28 +293,29 @@ bool ClippingAlgorithms::IsInsideEdge(Point2D point, ClipEdge edge, int xmin, in
  * 对于水平边界（上、下）：y = 边界值，x = p1.x + t * (p2.x - p1.x)
  * 其中 t = (边界值 - p1坐标) / (p2坐标 - p1坐标)
  */
-Point2D ClippingAlgorithms::ComputeIntersection(Point2D p1, Point2D p2, ClipEdge edge, int xmin, int ymin, int xmax, int ymax) {
-    Point2D intersection;
+template <typename T>
+Point2<T> ClippingAlgorithms::ComputeIntersection(Point2<T> p1, Point2<T> p2, ClipEdge edge, T xmin, T ymin, T xmax, T ymax) {
+    Point2<T> intersection;
     switch (edge) {
         case CLIP_LEFT:
             // 与左边界 x = xmin 相交
             intersection.x = xmin;
-            intersection.y = (p2.x != p1.x) ? p1.y + (p2.y - p1.y) * (xmin - p1.x) / (p2.x - p1.x) : p1.y;
+            intersection.y = (p2.x != p1.x) ? ScalarTraits<T>::Lerp(p1.y, p2.y, xmin - p1.x, p2.x - p1.x) : p1.y;
             break;
         case CLIP_RIGHT:
             // 与右边界 x = xmax 相交
             intersection.x = xmax;
-            intersection.y = (p2.x != p1.x) ? p1.y + (p2.y - p1.y) * (xmax - p1.x) / (p2.x - p1.x) : p1.y;
+            intersection.y = (p2.x != p1.x) ? ScalarTraits<T>::Lerp(p1.y, p2.y, xmax - p1.x, p2.x - p1.x) : p1.y;
             break;
         case CLIP_BOTTOM:
             // 与下边界 y = ymax 相交
             intersection.y = ymax;
-            intersection.x = (p2.y != p1.y) ? p1.x + (p2.x - p1.x) * (ymax - p1.y) / (p2.y - p1.y) : p1.x;
+            intersection.x = (p2.y != p1.y) ? ScalarTraits<T>::Lerp(p1.x, p2.x, ymax - p1.y, p2.y - p1.y) : p1.x;
             break;
         case CLIP_TOP:
             // 与上边界 y = ymin 相交
             intersection.y = ymin;
-            intersection.x = (p2.y != p1.y) ? p1.x + (p2.x - p1.x) * (ymin - p1.y) / (p2.y - p1.y) : p1.x;
+            intersection.x = (p2.y != p1.y) ? ScalarTraits<T>::Lerp(p1.x, p2.x, ymin - p1.y, p2.y - p1.y) : p1.x;
             break;
     }
     return intersection;
@@ -332,15 +339,16 @@ Point2D ClippingAlgorithms::ComputeIntersection(Point2D p1, Point2D p2, ClipEdge
  * 
  * 这是Sutherland-Hodgman算法的核心，通过对四条边依次调用此函数完成裁剪。
  */
-std::vector<Point2D> ClippingAlgorithms::ClipPolygonAgainstEdge(const std::vector<Point2D>& polygon, ClipEdge edge,
-                                                                 int xmin, int ymin, int xmax, int ymax) {
-    std::vector<Point2D> outputList;
+template <typename T>
+std::vector<Point2<T>> ClippingAlgorithms::ClipPolygonAgainstEdge(const std::vector<Point2<T>>& polygon, ClipEdge edge,
+                                                                   T xmin, T ymin, T xmax, T ymax) {
+    std::vector<Point2<T>> outputList;
     if (polygon.empty()) return outputList;
 
     // 遍历多边形的每条边
     for (size_t i = 0; i < polygon.size(); i++) {
-        Point2D currentVertex = polygon[i];
-        Point2D previousVertex = polygon[(i + polygon.size() - 1) % polygon.size()];
+        Point2<T> currentVertex = polygon[i];
+        Point2<T> previousVertex = polygon[(i + polygon.size() - 1) % polygon.size()];
 
         // 判断当前顶点和前一顶点是否在边的内侧
         bool currentInside = IsInsideEdge(currentVertex, edge, xmin, ymin, xmax, ymax);
@@ -351,11 +359,11 @@ std::vector<Point2D> ClippingAlgorithms::ClipPolygonAgainstEdge(const std::vecto
             outputList.push_back(currentVertex);
         } else if (previousInside && !currentInside) {
             // 情况2：内→外，输出交点
-            Point2D intersection = ComputeIntersection(previousVertex, currentVertex, edge, xmin, ymin, xmax, ymax);
+            Point2<T> intersection = ComputeIntersection(previousVertex, currentVertex, edge, xmin, ymin, xmax, ymax);
             outputList.push_back(intersection);
         } else if (!previousInside && currentInside) {
             // 情况3：外→内，输出交点和当前顶点
-            Point2D intersection = ComputeIntersection(previousVertex, currentVertex, edge, xmin, ymin, xmax, ymax);
+            Point2<T> intersection = ComputeIntersection(previousVertex, currentVertex, edge, xmin, ymin, xmax, ymax);
             outputList.push_back(intersection);
             outputList.push_back(currentVertex);
         }
@@ -387,9 +395,11 @@ std::vector<Point2D> ClippingAlgorithms::ClipPolygonAgainstEdge(const std::vecto
  * - 对凹多边形可能产生错误结果
  * - 只能产生一个输出多边形
  */
-std::vector<Point2D> ClippingAlgorithms::ClipPolygonSutherlandHodgman(const std::vector<Point2D>& polygon,
-                                                                       int xmin, int ymin, int xmax, int ymax) {
-    std::vector<Point2D> clipped = polygon;
+template <typename T>
+std::vector<Point2<T>> ClippingAlgorithms::ClipPolygonSutherlandHodgman(const std::vector<Point2<T>>& polygon,
+                                                                         T xmin, T ymin, T xmax, T ymax) {
+    PROFILE_FUNCTION();
+    std::vector<Point2<T>> clipped = polygon;
     
     // 依次对四条边进行裁剪
     if (!clipped.empty()) clipped = ClipPolygonAgainstEdge(clipped, CLIP_LEFT, xmin, ymin, xmax, ymax);
@@ -400,6 +410,15 @@ std::vector<Point2D> ClippingAlgorithms::ClipPolygonSutherlandHodgman(const std:
     return clipped;
 }
 
+// ============================================================================
+// 显式实例化：16.16定点坐标（GraphicsEngine在亚像素精度下裁剪，最后取整一次）
+// ============================================================================
+
+template bool ClippingAlgorithms::ClipLineCohenSutherland<Fixed16>(Point2x&, Point2x&, Fixed16, Fixed16, Fixed16, Fixed16);
+
+template std::vector<Point2x> ClippingAlgorithms::ClipPolygonSutherlandHodgman<Fixed16>(
+    const std::vector<Point2x>&, Fixed16, Fixed16, Fixed16, Fixed16);
+
 
 // ============================================================================
 // Weiler-Atherton 多边形裁剪算法实现
@@ -945,6 +964,7 @@ void ClippingAlgorithms::CleanupVertexList(std::vector<WAVertex*>& vertexList) {
  */
 std::vector<std::vector<Point2D>> ClippingAlgorithms::ClipPolygonWeilerAtherton(
     const std::vector<Point2D>& polygon, int xmin, int ymin, int xmax, int ymax) {
+    PROFILE_FUNCTION();
     std::vector<std::vector<Point2D>> result;
     
     // 多边形至少需要3个顶点
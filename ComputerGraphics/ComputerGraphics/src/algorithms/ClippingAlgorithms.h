@@ -28,8 +28,10 @@ public:
      * @return 如果直线与窗口有交集返回true，否则返回false
      * 
      * 使用区域编码的方法快速判断和裁剪直线段
+     * 交点按坐标类型T的精度计算；当前以Fixed16实例化，端点被多次替换时不会累积取整误差
      */
-    static bool ClipLineCohenSutherland(Point2D& p1, Point2D& p2, int xmin, int ymin, int xmax, int ymax);
+    template <typename T>
+    static bool ClipLineCohenSutherland(Point2<T>& p1, Point2<T>& p2, T xmin, T ymin, T xmax, T ymax);
     
     /**
      * @brief 中点分割直线裁剪算法
@@ -56,9 +58,11 @@ public:
      * @return 裁剪后的多边形顶点序列
      * 
      * 逐边裁剪多边形，适用于凸多边形裁剪窗口
+     * 交点按坐标类型T的精度计算；当前以Fixed16实例化，四条边的交点不会逐边累积取整误差
      */
-    static std::vector<Point2D> ClipPolygonSutherlandHodgman(const std::vector<Point2D>& polygon,
-                                                              int xmin, int ymin, int xmax, int ymax);
+    template <typename T>
+    static std::vector<Point2<T>> ClipPolygonSutherlandHodgman(const std::vector<Point2<T>>& polygon,
+                                                                T xmin, T ymin, T xmax, T ymax);
     
     /**
      * @brief Weiler-Atherton多边形裁剪算法
@@ -166,7 +170,8 @@ private:
     };
     
     /// @brief 计算点的区域编码
-    static int ComputeOutCode(Point2D point, int xmin, int ymin, int xmax, int ymax);
+    template <typename T>
+    static int ComputeOutCode(Point2<T> point, T xmin, T ymin, T xmax, T ymax);
     
     /// @brief 判断点是否在窗口内部
     static bool IsInsideWindow(Point2D point, int xmin, int ymin, int xmax, int ymax);
@@ -179,12 +184,15 @@ private:
                                           std::vector<std::pair<Point2D, Point2D>>& result, int depth);
     
     /// @brief 判断点是否在指定边的内侧
-    static bool IsInsideEdge(Point2D point, ClipEdge edge, int xmin, int ymin, int xmax, int ymax);
+    template <typename T>
+    static bool IsInsideEdge(Point2<T> point, ClipEdge edge, T xmin, T ymin, T xmax, T ymax);
     
     /// @brief 计算直线与裁剪边的交点
-    static Point2D ComputeIntersection(Point2D p1, Point2D p2, ClipEdge edge, int xmin, int ymin, int xmax, int ymax);
+    template <typename T>
+    static Point2<T> ComputeIntersection(Point2<T> p1, Point2<T> p2, ClipEdge edge, T xmin, T ymin, T xmax, T ymax);
     
     /// @brief 用指定边裁剪多边形
-    static std::vector<Point2D> ClipPolygonAgainstEdge(const std::vector<Point2D>& polygon, ClipEdge edge,
-                                                        int xmin, int ymin, int xmax, int ymax);
+    template <typename T>
+    static std::vector<Point2<T>> ClipPolygonAgainstEdge(const std::vector<Point2<T>>& polygon, ClipEdge edge,
+                                                          T xmin, T ymin, T xmax, T ymax);
 };
@@ -0,0 +1,156 @@
+﻿/**
+ * @file Compositor.cpp
+ * @brief Gamma校正的alpha合成算法实现
+ * @author ln1.opensource@gmail.com
+ * 
+ * 本文件实现了32位像素的source-over合成：
+ * 1. sRGB与12位线性值之间的双向查找表（首次使用时建立）
+ * 2. 单色区间的线性空间混合（SSE2 / 标量两种路径）
+ */
+
+#include "Compositor.h"
+#include "Framebuffer.h"
+#include <cmath>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#include <emmintrin.h>
+#define COMPOSITOR_SSE2 1
+#endif
+
+// 线性值的位数与最大值
+static const int LINEAR_BITS = 12;
+static const int LINEAR_MAX = (1 << LINEAR_BITS) - 1;
+
+/**
+ * @brief 8位不透明度映射到 0..256 的混合权重
+ */
+static inline int AlphaToWeight(uint32_t alpha) {
+    return (int)(alpha + (alpha >> 7));
+}
+
+// ============================================================================
+// 查找表
+// ============================================================================
+
+/**
+ * @brief sRGB 8位到12位线性值的查找表
+ * 
+ * 【算法原理】
+ * sRGB传递函数：
+ *   c <= 0.04045 时 L = c / 12.92
+ *   否则          L = ((c + 0.055) / 1.055)^2.4
+ * 线性值用12位保存，暗部的相邻sRGB值仍能区分
+ */
+const uint16_t* Compositor::ToLinearTable() {
+    struct Table {
+        uint16_t v[256];
+        Table() {
+            for (int i = 0; i < 256; i++) {
+                double c = i / 255.0;
+                double l = c <= 0.04045 ? c / 12.92 : pow((c + 0.055) / 1.055, 2.4);
+                v[i] = (uint16_t)(l * LINEAR_MAX + 0.5);
+            }
+        }
+    };
+    static const Table table;
+    return table.v;
+}
+
+/**
+ * @brief 12位线性值到sRGB 8位的查找表
+ * 
+ * 【算法原理】
+ * sRGB逆传递函数：
+ *   L <= 0.0031308 时 c = 12.92 L
+ *   否则            c = 1.055 L^(1/2.4) - 0.055
+ */
+const uint8_t* Compositor::ToSrgbTable() {
+    struct Table {
+        uint8_t v[LINEAR_MAX + 1];
+        Table() {
+            for (int i = 0; i <= LINEAR_MAX; i++) {
+                double l = (double)i / LINEAR_MAX;
+                double c = l <= 0.0031308 ? l * 12.92 : 1.055 * pow(l, 1.0 / 2.4) - 0.055;
+                v[i] = (uint8_t)(c * 255.0 + 0.5);
+            }
+        }
+    };
+    static const Table table;
+    return table.v;
+}
+
+// ============================================================================
+// 区间合成
+// ============================================================================
+
+/**
+ * @brief 一个像素的alpha字节按 source-over 合成后，与颜色字节拼回32位像素
+ */
+static inline uint32_t PackPixel(const uint8_t* toSrgb, const int lin[3], uint32_t dp, uint32_t as) {
+    uint32_t ao = as + MulDiv255(dp >> 24, 255 - as);
+    return (uint32_t)toSrgb[lin[0]] | ((uint32_t)toSrgb[lin[1]] << 8) |
+           ((uint32_t)toSrgb[lin[2]] << 16) | (ao << 24);
+}
+
+/**
+ * @brief 以单一颜色和不透明度合成像素区间
+ * 
+ * 【算法原理】
+ * 权重 w = alpha 映射到 0..256（alpha=255 时 w=256），
+ * 每个颜色通道 out = (S*w + D*(256-w)) >> 8，S、D为12位线性值，
+ * 除法变为移位。S*w 对整个区间不变，开始时算好（预乘），
+ * 逐像素只需查表得到D，再做一次乘加
+ * 
+ * 【SSE2路径】
+ * 两个像素的8个通道（alpha通道占位为0）放入一个寄存器，
+ * _mm_mullo_epi16 / _mm_mulhi_epu16 得到 D*(256-w) 的低16位和高16位，
+ * 交错成32位后加上 S*w 再右移8位，一次得到两个像素的全部通道
+ */
+void Compositor::CompositeSpan(uint32_t* dst, int count, uint32_t src, uint32_t alpha) {
+    if (alpha == 0 || count <= 0) return;
+    if (alpha >= 255) {
+        uint32_t opaque = src | 0xFF000000u;
+        for (int i = 0; i < count; i++) dst[i] = opaque;
+        return;
+    }
+
+    const uint16_t* toLinear = ToLinearTable();
+    const uint8_t* toSrgb = ToSrgbTable();
+    int w = AlphaToWeight(alpha);
+    int inv = 256 - w;
+
+    // 预乘：源颜色的线性值乘以权重，整个区间只算一次
+    int sw[3];
+    for (int c = 0; c < 3; c++) sw[c] = toLinear[(src >> (c * 8)) & 0xFF] * w;
+
+    int i = 0;
+#ifdef COMPOSITOR_SSE2
+    const __m128i vinv = _mm_set1_epi16((short)inv);
+    const __m128i vsw = _mm_set_epi32(0, sw[2], sw[1], sw[0]);
+    for (; i + 2 <= count; i += 2) {
+        uint32_t d0 = dst[i], d1 = dst[i + 1];
+        __m128i vd = _mm_set_epi16(0, (short)toLinear[(d1 >> 16) & 0xFF],
+                                   (short)toLinear[(d1 >> 8) & 0xFF], (short)toLinear[d1 & 0xFF],
+                                   0, (short)toLinear[(d0 >> 16) & 0xFF],
+                                   (short)toLinear[(d0 >> 8) & 0xFF], (short)toLinear[d0 & 0xFF]);
+        __m128i lo16 = _mm_mullo_epi16(vd, vinv);
+        __m128i hi16 = _mm_mulhi_epu16(vd, vinv);
+        __m128i p0 = _mm_add_epi32(_mm_unpacklo_epi16(lo16, hi16), vsw);
+        __m128i p1 = _mm_add_epi32(_mm_unpackhi_epi16(lo16, hi16), vsw);
+        __m128i r = _mm_packs_epi32(_mm_srli_epi32(p0, 8), _mm_srli_epi32(p1, 8));
+        alignas(16) int16_t lin[8];
+        _mm_store_si128((__m128i*)lin, r);
+        int l0[3] = { lin[0], lin[1], lin[2] };
+        int l1[3] = { lin[4], lin[5], lin[6] };
+        dst[i] = PackPixel(toSrgb, l0, d0, alpha);
+        dst[i + 1] = PackPixel(toSrgb, l1, d1, alpha);
+    }
+#endif
+    for (; i < count; i++) {
+        uint32_t dp = dst[i];
+        int lin[3];
+        for (int c = 0; c < 3; c++)
+            lin[c] = (sw[c] + toLinear[(dp >> (c * 8)) & 0xFF] * inv) >> 8;
+        dst[i] = PackPixel(toSrgb, lin, dp, alpha);
+    }
+}
@@ -0,0 +1,46 @@
+﻿#pragma once
+#include <cstdint>
+
+/**
+ * @file Compositor.h
+ * @brief Gamma校正的alpha合成算法类定义
+ * @author ln1.opensource@gmail.com
+ */
+
+/**
+ * @class Compositor
+ * @brief 32位像素区间的source-over合成
+ * 
+ * 对32位像素（每通道8位，第3字节为alpha）做单色半透明叠加：
+ * - 颜色通道经256项查找表从sRGB的8位转换到12位线性值，在线性空间混合，
+ *   再经4096项查找表转换回8位，避免直接在sRGB值上混合造成的偏暗
+ * - 目标按预乘alpha处理：颜色 out = s*a + d*(1-a)，alpha ao = as + ad*(1-as)，
+ *   不需要逐像素除以ao；不透明的目标（如窗口帧缓冲）与非预乘结果相同
+ * - 前三个字节的含义不影响计算，因此RGBA8与BGRA8像素都可以直接使用，
+ *   只要源颜色与目标像素的字节顺序一致
+ * 
+ * 源颜色的线性值与权重的乘积在区间开始时算好，逐像素只剩查表和一次乘加。
+ * 在支持SSE2的平台上每次处理两个像素（8个16位通道）；
+ * 其他平台使用逐通道的标量代码，两种路径结果逐位一致。
+ */
+class Compositor {
+public:
+    /**
+     * @brief 以单一颜色和不透明度合成像素区间
+     * @param dst 目标像素（就地修改）
+     * @param count 像素个数
+     * @param src 源颜色（与dst字节顺序相同，alpha字节被忽略）
+     * @param alpha 不透明度（0-255）
+     */
+    static void CompositeSpan(uint32_t* dst, int count, uint32_t src, uint32_t alpha);
+
+    /**
+     * @brief sRGB 8位到12位线性值的查找表（256项）
+     */
+    static const uint16_t* ToLinearTable();
+
+    /**
+     * @brief 12位线性值到sRGB 8位的查找表（4096项）
+     */
+    static const uint8_t* ToSrgbTable();
+};
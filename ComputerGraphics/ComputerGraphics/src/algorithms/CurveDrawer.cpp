@@ -0,0 +1,150 @@
+﻿/**
+ * @file CurveDrawer.cpp
+ * @brief 曲线绘制算法实现
+ * @author ln1.opensource@gmail.com
+ * 
+ * 本文件实现了均匀三次B样条曲线的绘制：
+ * 1. 将每段曲线转换为幂基多项式
+ * 2. 使用前向差分法逐步求值，每个采样点只需三次向量加法
+ * 3. 自适应展平：由二阶导数上界解析计算每段所需的采样数
+ * 
+ * 展平得到的折线由ShapeRenderer逐段交给Bresenham算法连线。
+ */
+
+#include "CurveDrawer.h"
+#include <cmath>
+
+// 自适应展平时单段曲线的最大采样步数，防止容差过小时采样数失控
+static const int MAX_FLATTEN_STEPS = 256;
+
+// ============================================================================
+// 自适应展平
+// ============================================================================
+
+/**
+ * @brief 按平直度容差自适应展平均匀三次B样条曲线
+ * @param controlPoints 控制点序列
+ * @param tolerance 展平容差
+ * @param outPoints 输出的折线顶点
+ * 
+ * 【算法原理】
+ * 用n段等参数弦逼近二阶连续曲线时，弦与曲线的最大偏差满足
+ *   err <= (1/8) * max|P''(t)| * (1/n)²
+ * 令 err <= tolerance 即得每段所需的步数
+ *   n = ceil( sqrt( max|P''| / (8 * tolerance) ) )
+ * 对三次多项式 P''(t) = 6a*t + 2b 为线性函数，其最大模在端点取得：
+ *   max|P''| = max(|2b|, |6a + 2b|)
+ * 平直的段（二阶导数接近0）只需1步，弯曲越剧烈步数越多。
+ */
+void CurveDrawer::FlattenBSpline(const std::vector<Point2D>& controlPoints, double tolerance,
+                                 std::vector<Point2D>& outPoints) {
+    outPoints.clear();
+    size_t n = controlPoints.size();
+    if (n < 4) {
+        outPoints = controlPoints;
+        return;
+    }
+
+    for (size_t i = 0; i + 3 < n; i++) {
+        CubicCoeffs coeffs = BSplineCoeffs(controlPoints[i], controlPoints[i+1],
+                                           controlPoints[i+2], controlPoints[i+3]);
+        ForwardDifference(coeffs, StepsForTolerance(coeffs, tolerance), i == 0, outPoints);
+    }
+}
+
+// ============================================================================
+// 私有辅助方法
+// ============================================================================
+
+/**
+ * @brief 计算一段均匀三次B样条的幂基系数
+ * 
+ * 由均匀三次B样条基矩阵展开：
+ *   a = (-P0 + 3P1 - 3P2 + P3) / 6
+ *   b = ( 3P0 - 6P1 + 3P2)     / 6
+ *   c = (-3P0 + 3P2)           / 6
+ *   d = ( P0 + 4P1 + P2)       / 6
+ */
+CurveDrawer::CubicCoeffs CurveDrawer::BSplineCoeffs(Point2D p0, Point2D p1, Point2D p2, Point2D p3) {
+    CubicCoeffs c;
+    c.ax = (-p0.x + 3.0 * p1.x - 3.0 * p2.x + p3.x) / 6.0;
+    c.ay = (-p0.y + 3.0 * p1.y - 3.0 * p2.y + p3.y) / 6.0;
+    c.bx = (3.0 * p0.x - 6.0 * p1.x + 3.0 * p2.x) / 6.0;
+    c.by = (3.0 * p0.y - 6.0 * p1.y + 3.0 * p2.y) / 6.0;
+    c.cx = (-3.0 * p0.x + 3.0 * p2.x) / 6.0;
+    c.cy = (-3.0 * p0.y + 3.0 * p2.y) / 6.0;
+    c.dx = (p0.x + 4.0 * p1.x + p2.x) / 6.0;
+    c.dy = (p0.y + 4.0 * p1.y + p2.y) / 6.0;
+    return c;
+}
+
+/**
+ * @brief 由平直度容差计算一段曲线所需的采样步数
+ * @param coeffs 曲线的幂基系数
+ * @param tolerance 展平容差
+ * @return 采样步数，范围 [1, MAX_FLATTEN_STEPS]
+ */
+int CurveDrawer::StepsForTolerance(const CubicCoeffs& coeffs, double tolerance) {
+    if (tolerance <= 0.0) return MAX_FLATTEN_STEPS;
+
+    // P''(0) = 2b, P''(1) = 6a + 2b
+    double s0x = 2.0 * coeffs.bx, s0y = 2.0 * coeffs.by;
+    double s1x = 6.0 * coeffs.ax + s0x, s1y = 6.0 * coeffs.ay + s0y;
+    double m0 = s0x * s0x + s0y * s0y;
+    double m1 = s1x * s1x + s1y * s1y;
+    double maxSecond = sqrt(m0 > m1 ? m0 : m1);
+
+    int steps = (int)ceil(sqrt(maxSecond / (8.0 * tolerance)));
+    if (steps < 1) steps = 1;
+    if (steps > MAX_FLATTEN_STEPS) steps = MAX_FLATTEN_STEPS;
+    return steps;
+}
+
+/**
+ * @brief 对一段三次曲线做前向差分采样
+ * @param coeffs 曲线的幂基系数
+ * @param steps 采样步数
+ * @param includeStart 是否输出该段起点
+ * @param outPoints 采样点追加到此序列
+ * 
+ * 【算法原理】
+ * 以固定步长 h = 1/steps 求值时，三次多项式的三阶差分为常数：
+ *   Δ1 = a*h³ + b*h² + c*h
+ *   Δ2 = 6a*h³ + 2b*h²
+ *   Δ3 = 6a*h³
+ * 
+ * 【算法步骤】
+ * 1. 由步长计算初始差分 Δ1, Δ2, Δ3，当前点 P = d
+ * 2. 每一步：P += Δ1, Δ1 += Δ2, Δ2 += Δ3（仅三次加法）
+ * 3. 将P四舍五入为整数像素坐标输出，与上一点重合则跳过
+ */
+void CurveDrawer::ForwardDifference(const CubicCoeffs& coeffs, int steps, bool includeStart,
+                                    std::vector<Point2D>& outPoints) {
+    if (steps < 1) steps = 1;
+
+    // 初始差分
+    double h = 1.0 / steps;
+    double h2 = h * h;
+    double h3 = h2 * h;
+    double d1x = coeffs.ax * h3 + coeffs.bx * h2 + coeffs.cx * h;
+    double d1y = coeffs.ay * h3 + coeffs.by * h2 + coeffs.cy * h;
+    double d2x = 6.0 * coeffs.ax * h3 + 2.0 * coeffs.bx * h2;
+    double d2y = 6.0 * coeffs.ay * h3 + 2.0 * coeffs.by * h2;
+    double d3x = 6.0 * coeffs.ax * h3;
+    double d3y = 6.0 * coeffs.ay * h3;
+
+    // 当前点从 t=0 开始，P(0) = d
+    double x = coeffs.dx, y = coeffs.dy;
+    if (includeStart)
+        outPoints.push_back(Point2D((int)floor(x + 0.5), (int)floor(y + 0.5)));
+
+    for (int i = 0; i < steps; i++) {
+        x += d1x;  y += d1y;
+        d1x += d2x; d1y += d2y;
+        d2x += d3x; d2y += d3y;
+        Point2D pt((int)floor(x + 0.5), (int)floor(y + 0.5));
+        if (!outPoints.empty() && outPoints.back().x == pt.x && outPoints.back().y == pt.y)
+            continue;
+        outPoints.push_back(pt);
+    }
+}
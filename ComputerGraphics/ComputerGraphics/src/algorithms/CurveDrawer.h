@@ -0,0 +1,66 @@
+﻿#pragma once
+#include "../core/Point2D.h"
+#include <vector>
+
+/**
+ * @file CurveDrawer.h
+ * @brief 曲线绘制算法类定义
+ * @author ln1.opensource@gmail.com
+ */
+
+/**
+ * @class CurveDrawer
+ * @brief 曲线绘制算法实现类
+ * 
+ * 提供均匀三次B样条曲线的展平：
+ * - 使用前向差分法逐段生成采样点，采样点之间由ShapeRenderer交给Bresenham直线算法光栅化
+ * - 自适应展平：根据二阶导数上界为每段计算采样数，
+ *   平直部分少采样，弯曲部分多采样
+ * 所有方法都是静态方法，可以直接调用而无需实例化
+ */
+class CurveDrawer {
+public:
+    /**
+     * @brief 按平直度容差自适应展平均匀三次B样条曲线
+     * @param controlPoints 控制点序列
+     * @param tolerance 展平容差（折线与曲线的最大偏差，单位与坐标相同）
+     * @param outPoints 输出的折线顶点（会先被清空）
+     * 
+     * 每段曲线的采样数由该段二阶导数的上界解析求得，
+     * 保证折线与曲线的偏差不超过tolerance
+     */
+    static void FlattenBSpline(const std::vector<Point2D>& controlPoints, double tolerance,
+                               std::vector<Point2D>& outPoints);
+
+private:
+    /**
+     * @struct CubicCoeffs
+     * @brief 三次多项式曲线的幂基系数 P(t) = a*t³ + b*t² + c*t + d
+     */
+    struct CubicCoeffs {
+        double ax, ay, bx, by, cx, cy, dx, dy;
+    };
+
+    /**
+     * @brief 计算一段均匀三次B样条的幂基系数
+     */
+    static CubicCoeffs BSplineCoeffs(Point2D p0, Point2D p1, Point2D p2, Point2D p3);
+
+    /**
+     * @brief 由平直度容差计算一段曲线所需的采样步数
+     * @param coeffs 曲线的幂基系数
+     * @param tolerance 展平容差
+     * @return 采样步数（至少为1）
+     */
+    static int StepsForTolerance(const CubicCoeffs& coeffs, double tolerance);
+
+    /**
+     * @brief 对一段三次曲线做前向差分采样
+     * @param coeffs 曲线的幂基系数
+     * @param steps 采样步数
+     * @param includeStart 是否输出该段起点（首段为true，后续段起点与上一段终点重合）
+     * @param outPoints 采样点追加到此序列（取整后与上一点重合的采样会被跳过）
+     */
+    static void ForwardDifference(const CubicCoeffs& coeffs, int steps, bool includeStart,
+                                  std::vector<Point2D>& outPoints);
+};
@@ -13,8 +13,9 @@
  */
 
 #include "FillAlgorithms.h"
+#include "RasterCore.h"
+#include "../diagnostics/Profiler.h"
 #include <stack>
-#include <algorithm>
 
 /**
  * @brief 边界填充算法（扫描线种子填充优化版）
@@ -24,6 +25,7 @@
  * @param y 种子点y坐标
  * @param fillColor 填充颜色
  * @param boundaryColor 边界颜色
+ * @param filledSpans 可选，追加记录本次填充的所有水平区间
  * 
  * 【算法原理】
  * 边界填充算法是一种种子填充算法，从指定的种子点开始，
@@ -50,7 +52,10 @@
  * - 超出窗口范围停止
  * - 设置最大迭代次数防止死循环
  */
-void FillAlgorithms::BoundaryFill(HDC hdc, HWND hwnd, int x, int y, COLORREF fillColor, COLORREF boundaryColor) {
+void FillAlgorithms::BoundaryFill(HDC hdc, HWND hwnd, int x, int y, COLORREF fillColor, COLORREF boundaryColor,
+                                  std::vector<RasterSpan>* filledSpans) {
+    PROFILE_FUNCTION();
+    
     // 获取窗口客户区大小，用于边界检查
     RECT clientRect;
     GetClientRect(hwnd, &clientRect);
@@ -101,6 +106,10 @@ void FillAlgorithms::BoundaryFill(HDC hdc, HWND hwnd, int x, int y, COLORREF fil
         // 使用LineTo比逐像素SetPixel效率更高
         MoveToEx(hdc, left, seed.y, NULL);
         LineTo(hdc, right + 1, seed.y);
+        if (filledSpans) {
+            RasterSpan span = { seed.y, left, right };
+            filledSpans->push_back(span);
+        }
         
         // 检查上下两行，将新的种子点压栈
         // 这里简化处理：将区间内每个点都检查（可进一步优化为区间合并）
@@ -156,48 +165,13 @@ void FillAlgorithms::BoundaryFill(HDC hdc, HWND hwnd, int x, int y, COLORREF fil
  * - 本实现是简化版本，适用于简单多边形
  * - 对于复杂多边形（自相交），可能需要更复杂的处理
  */
-void FillAlgorithms::ScanlineFill(HDC hdc, const std::vector<Point2D>& polygon, COLORREF fillColor) {
-    // 多边形至少需要3个顶点
-    if (polygon.size() < 3) return;
-    
-    // 【步骤1】找到多边形的y坐标范围
-    int ymin = polygon[0].y, ymax = polygon[0].y;
-    for (const auto& p : polygon) {
-        if (p.y < ymin) ymin = p.y;  // 更新最小y
-        if (p.y > ymax) ymax = p.y;  // 更新最大y
-    }
-    
-    // 【步骤2】逐条扫描线处理
-    for (int y = ymin; y <= ymax; y++) {
-        // 存储当前扫描线与所有边的交点x坐标
-        std::vector<int> intersections;
-        
-        // 【步骤2a】计算扫描线与每条边的交点
-        for (size_t i = 0; i < polygon.size(); i++) {
-            // 获取当前边的两个端点
-            Point2D p1 = polygon[i];
-            Point2D p2 = polygon[(i + 1) % polygon.size()];  // 下一个顶点，形成闭合
-            
-            // 判断扫描线是否穿过该边
-            // 使用半开区间避免顶点重复计算：[ymin, ymax)
-            if ((p1.y <= y && p2.y > y) || (p2.y <= y && p1.y > y)) {
-                // 计算交点的x坐标（线性插值）
-                // x = x1 + (y - y1) / (y2 - y1) * (x2 - x1)
-                float x = p1.x + (float)(y - p1.y) / (p2.y - p1.y) * (p2.x - p1.x);
-                intersections.push_back((int)(x + 0.5));  // 四舍五入
-            }
-        }
-        
-        // 【步骤2b】将交点按x坐标排序
-        std::sort(intersections.begin(), intersections.end());
-        
-        // 【步骤2c】两两配对填充
-        // 根据奇偶规则：第0-1对、第2-3对...之间的区域需要填充
-        for (size_t i = 0; i + 1 < intersections.size(); i += 2) {
-            // 填充从intersections[i]到intersections[i+1]的水平线段
-            for (int x = intersections[i]; x <= intersections[i + 1]; x++) {
-                SetPixel(hdc, x, y, fillColor);
-            }
-        }
-    }
+template <typename T>
+void FillAlgorithms::ScanlineFill(HDC hdc, const std::vector<Point2<T>>& polygon, COLORREF fillColor) {
+    PROFILE_FUNCTION();
+    // 具体实现见 RasterCore::ScanlineFill，这里以GDI像素输出策略实例化
+    GdiPixelSink sink(hdc, fillColor);
+    RasterCore::ScanlineFill(sink, polygon);
 }
+
+// 显式实例化：整数坐标
+template void FillAlgorithms::ScanlineFill<int>(HDC, const std::vector<Point2i>&, COLORREF);
@@ -1,5 +1,6 @@
 ﻿#pragma once
 #include "../core/Point2D.h"
+#include "RasterCore.h"
 #include <windows.h>
 #include <vector>
 
@@ -25,22 +26,25 @@ public:
      * @param y 种子点y坐标
      * @param fillColor 填充颜色
      * @param boundaryColor 边界颜色
+     * @param filledSpans 可选，追加记录本次填充的所有水平区间（供图层保存和撤销使用）
      * 
      * 从指定种子点开始，向四个方向扩散填充，直到遇到边界颜色为止
      * 适用于填充封闭区域
      */
-    static void BoundaryFill(HDC hdc, HWND hwnd, int x, int y, COLORREF fillColor, COLORREF boundaryColor);
+    static void BoundaryFill(HDC hdc, HWND hwnd, int x, int y, COLORREF fillColor, COLORREF boundaryColor,
+                             std::vector<RasterSpan>* filledSpans = nullptr);
     
     /**
      * @brief 扫描线填充算法
      * @param hdc Windows设备上下文句柄
-     * @param polygon 多边形顶点序列
+     * @param polygon 多边形顶点序列（坐标类型T当前实例化为int）
      * @param fillColor 填充颜色
      * 
      * 使用扫描线算法填充多边形内部，通过构建边表和活性边表
      * 来确定每条扫描线与多边形的交点，然后填充交点间的区域
      */
-    static void ScanlineFill(HDC hdc, const std::vector<Point2D>& polygon, COLORREF fillColor);
+    template <typename T>
+    static void ScanlineFill(HDC hdc, const std::vector<Point2<T>>& polygon, COLORREF fillColor);
 
 private:
     /**
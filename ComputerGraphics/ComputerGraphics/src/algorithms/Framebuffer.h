@@ -0,0 +1,201 @@
+﻿#pragma once
+#include "Compositor.h"
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+/**
+ * @file Framebuffer.h
+ * @brief 按像素格式特化的内存帧缓冲
+ * @author ln1.opensource@gmail.com
+ * 
+ * 2D画布整帧重绘时先写入BGRA8帧缓冲（与32位DIB位图布局一致），再一次性显示；
+ * 软件三维渲染器写入RGBA8帧缓冲，不依赖GDI设备上下文。
+ * 像素格式作为模板参数在编译期确定，每种格式提供：
+ * - Storage：单个像素的存储类型（决定内存占用）
+ * - Pack：将8位RGBA分量打包为本格式像素
+ * - FromColor：将COLORREF布局（0x00BBGGRR）的颜色转换为本格式像素
+ * 
+ * 颜色以 uint32_t 传入，与Windows的 COLORREF/RGB() 取值相同，
+ * 本文件不包含 windows.h，软件三维渲染器可以在没有窗口的进程中使用。
+ * 
+ * 颜色只在建立输出策略时打包一次，光栅化过程中直接写入本格式像素，
+ * 不再逐像素转换。
+ */
+
+// ============================================================================
+// 像素格式
+// ============================================================================
+
+/**
+ * @brief 8位乘法后除以255（精确到四舍五入）
+ */
+inline uint32_t MulDiv255(uint32_t a, uint32_t b) {
+    uint32_t t = a * b + 128;
+    return (t + (t >> 8)) >> 8;
+}
+
+/**
+ * @struct PixelRGBA8
+ * @brief 32位像素，内存字节顺序 R,G,B,A
+ * 
+ * 低24位与COLORREF的布局（0x00BBGGRR）相同，转换只需补上alpha
+ */
+struct PixelRGBA8 {
+    typedef uint32_t Storage;
+    static const int BYTES_PER_PIXEL = 4;
+
+    static Storage Pack(uint32_t r, uint32_t g, uint32_t b, uint32_t a) {
+        return r | (g << 8) | (b << 16) | (a << 24);
+    }
+    static Storage FromColor(uint32_t color, uint32_t alpha = 255) {
+        return (color & 0x00FFFFFFu) | (alpha << 24);
+    }
+};
+
+/**
+ * @struct PixelBGRA8
+ * @brief 32位像素，内存字节顺序 B,G,R,A（与32位DIB位图一致）
+ */
+struct PixelBGRA8 {
+    typedef uint32_t Storage;
+    static const int BYTES_PER_PIXEL = 4;
+
+    static Storage Pack(uint32_t r, uint32_t g, uint32_t b, uint32_t a) {
+        return b | (g << 8) | (r << 16) | (a << 24);
+    }
+    static Storage FromColor(uint32_t color, uint32_t alpha = 255) {
+        return Pack(color & 0xFF, (color >> 8) & 0xFF, (color >> 16) & 0xFF, alpha);
+    }
+};
+
+// ============================================================================
+// 帧缓冲
+// ============================================================================
+
+/**
+ * @class Framebuffer
+ * @brief 以Format格式存储像素的内存帧缓冲
+ * 
+ * 像素按行连续存储，每行stride个像素；
+ * 所有写入操作对越界坐标做裁剪，不会越界访问
+ */
+template <class Format>
+class Framebuffer {
+public:
+    typedef typename Format::Storage Storage;
+
+    Framebuffer() : width(0), height(0) {}
+    Framebuffer(int width, int height) { Resize(width, height); }
+
+    /**
+     * @brief 重新分配尺寸，像素清零
+     */
+    void Resize(int w, int h) {
+        width = w > 0 ? w : 0;
+        height = h > 0 ? h : 0;
+        pixels.assign((size_t)width * height, Storage());
+    }
+
+    int Width() const { return width; }
+    int Height() const { return height; }
+    int Stride() const { return width; }
+    size_t SizeInBytes() const { return pixels.size() * sizeof(Storage); }
+
+    Storage* Row(int y) { return pixels.data() + (size_t)y * width; }
+    const Storage* Row(int y) const { return pixels.data() + (size_t)y * width; }
+    Storage* Data() { return pixels.data(); }
+    const Storage* Data() const { return pixels.data(); }
+
+    /**
+     * @brief 以单一像素值填满整个缓冲
+     */
+    void Clear(Storage value) {
+        std::fill(pixels.begin(), pixels.end(), value);
+    }
+
+    Storage GetPixel(int x, int y) const {
+        if ((unsigned)x >= (unsigned)width || (unsigned)y >= (unsigned)height) return Storage();
+        return Row(y)[x];
+    }
+
+    void SetPixel(int x, int y, Storage value) {
+        if ((unsigned)x < (unsigned)width && (unsigned)y < (unsigned)height)
+            Row(y)[x] = value;
+    }
+
+    /**
+     * @brief 以同一像素值填充水平区间 [x0, x1]（含两端）
+     */
+    void FillSpan(int y, int x0, int x1, Storage value) {
+        if (!ClipSpan(y, x0, x1)) return;
+        std::fill(Row(y) + x0, Row(y) + x1 + 1, value);
+    }
+
+private:
+    /**
+     * @brief 将区间裁剪到缓冲范围内，区间为空时返回false
+     */
+    bool ClipSpan(int y, int& x0, int& x1) const {
+        if ((unsigned)y >= (unsigned)height) return false;
+        if (x0 < 0) x0 = 0;
+        if (x1 >= width) x1 = width - 1;
+        return x0 <= x1;
+    }
+
+    std::vector<Storage> pixels;   ///< 像素数据
+    int width;                     ///< 宽度（像素）
+    int height;                    ///< 高度（像素）
+};
+
+typedef Framebuffer<PixelRGBA8> FramebufferRGBA8;
+typedef Framebuffer<PixelBGRA8> FramebufferBGRA8;
+
+// ============================================================================
+// 光栅化输出策略
+// ============================================================================
+
+/**
+ * @struct FormatSink
+ * @brief 以本格式像素写入Framebuffer的输出策略（供RasterCore模板使用）
+ * 
+ * 颜色在构造时打包一次，Plot/Span只做存储写入
+ */
+template <class Format>
+struct FormatSink {
+    Framebuffer<Format>& target;            ///< 目标帧缓冲
+    typename Format::Storage value;         ///< 已打包的像素值
+
+    FormatSink(Framebuffer<Format>& target, uint32_t color)
+        : target(target), value(Format::FromColor(color)) {}
+
+    void Plot(int x, int y) { target.SetPixel(x, y, value); }
+    void Span(int y, int x0, int x1) { target.FillSpan(y, x0, x1, value); }
+};
+
+/**
+ * @struct GammaBlendSink
+ * @brief 在线性空间半透明混合写入32位Framebuffer的输出策略
+ * 
+ * 只适用于RGBA8、BGRA8两种32位格式，合成由Compositor完成
+ */
+template <class Format>
+struct GammaBlendSink {
+    Framebuffer<Format>& target;            ///< 目标帧缓冲
+    uint32_t value;                         ///< 已打包的像素值
+    uint32_t alpha;                         ///< 不透明度（0-255）
+
+    GammaBlendSink(Framebuffer<Format>& target, uint32_t color, uint32_t alpha)
+        : target(target), value(Format::FromColor(color, 255)), alpha(alpha) {}
+
+    void Plot(int x, int y) {
+        if ((unsigned)x < (unsigned)target.Width() && (unsigned)y < (unsigned)target.Height())
+            Compositor::CompositeSpan(target.Row(y) + x, 1, value, alpha);
+    }
+    void Span(int y, int x0, int x1) {
+        if ((unsigned)y >= (unsigned)target.Height()) return;
+        if (x0 < 0) x0 = 0;
+        if (x1 >= target.Width()) x1 = target.Width() - 1;
+        if (x0 <= x1) Compositor::CompositeSpan(target.Row(y) + x0, x1 - x0 + 1, value, alpha);
+    }
+};
@@ -9,23 +9,12 @@
  * 
  * 这两种算法都是光栅化直线的基础算法，用于将数学上的连续直线
  * 转换为离散的像素点序列。
+ * 
+ * 算法主体（连同逐行说明）位于 RasterCore.h 的模板中，本文件的方法以GDI输出策略实例化。
  */
 
 #include "LineDrawer.h"
-#include <cmath>
-
-/**
- * @brief 设置指定位置的像素颜色
- * @param hdc Windows设备上下文句柄
- * @param x 像素x坐标
- * @param y 像素y坐标
- * @param color 像素颜色
- * 
- * 封装Windows GDI的SetPixel函数，用于在指定位置绘制单个像素点
- */
-void LineDrawer::SetPixel(HDC hdc, int x, int y, COLORREF color) {
-    ::SetPixel(hdc, x, y, color);
-}
+#include "RasterCore.h"
 
 /**
  * @brief DDA（数字微分分析器）直线绘制算法
@@ -52,36 +41,9 @@ void LineDrawer::SetPixel(HDC hdc, int x, int y, COLORREF color) {
  * 缺点：需要浮点运算和四舍五入，效率相对较低
  */
 void LineDrawer::DrawDDA(HDC hdc, Point2D p1, Point2D p2, COLORREF color) {
-    // 计算x和y方向的总增量
-    int dx = p2.x - p1.x;  // x方向增量
-    int dy = p2.y - p1.y;  // y方向增量
-    
-    // 确定步数：选择变化较大的方向作为主方向
-    // 这样可以保证直线的连续性，不会出现断点
-    int steps = abs(dx) > abs(dy) ? abs(dx) : abs(dy);
-
-    // 如果起点和终点重合，无需绘制
-    if (steps == 0) return;
-
-    // 计算每一步x和y的增量
-    // 主方向每步增加1（或-1），另一方向按比例增加
-    float xInc = (float)dx / steps;  // x方向每步增量
-    float yInc = (float)dy / steps;  // y方向每步增量
-    
-    // 使用浮点数保存当前位置，以保证精度
-    float x = (float)p1.x;
-    float y = (float)p1.y;
-
-    // 循环绘制每个像素点
-    for (int i = 0; i <= steps; i++) {
-        // 四舍五入到最近的整数像素位置并绘制
-        // 加0.5后取整实现四舍五入效果
-        SetPixel(hdc, (int)(x + 0.5), (int)(y + 0.5), color);
-        
-        // 更新当前位置
-        x += xInc;
-        y += yInc;
-    }
+    // 具体实现见 RasterCore::LineDDA，这里以GDI像素输出策略实例化
+    GdiPixelSink sink(hdc, color);
+    RasterCore::LineDDA(sink, p1.x, p1.y, p2.x, p2.y);
 }
 
 /**
@@ -117,48 +79,7 @@ void LineDrawer::DrawDDA(HDC hdc, Point2D p1, Point2D p2, COLORREF color) {
  * 缺点：算法理解相对复杂
  */
 void LineDrawer::DrawBresenham(HDC hdc, Point2D p1, Point2D p2, COLORREF color) {
-    // 计算x和y方向的绝对增量
-    int dx = abs(p2.x - p1.x);  // x方向距离（绝对值）
-    int dy = abs(p2.y - p1.y);  // y方向距离（绝对值）
-    
-    // 确定x和y的步进方向
-    // sx: x增加的方向，+1表示向右，-1表示向左
-    // sy: y增加的方向，+1表示向下，-1表示向上
-    int sx = p1.x < p2.x ? 1 : -1;
-    int sy = p1.y < p2.y ? 1 : -1;
-    
-    // 初始化误差值
-    // err = dx - dy 是Bresenham算法的核心
-    // 它综合考虑了x和y两个方向的偏差
-    int err = dx - dy;
-    
-    // 当前绘制位置
-    int x = p1.x, y = p1.y;
-
-    // 循环绘制直到到达终点
-    while (true) {
-        // 绘制当前像素
-        SetPixel(hdc, x, y, color);
-        
-        // 检查是否到达终点
-        if (x == p2.x && y == p2.y) break;
-
-        // 计算2倍误差值，用于判断步进方向
-        // 使用2*err避免浮点除法，这是算法高效的关键
-        int e2 = 2 * err;
-        
-        // 判断是否需要在x方向步进
-        // 当 e2 > -dy 时，说明偏差偏向x轴，需要x步进
-        if (e2 > -dy) { 
-            err -= dy;   // 更新误差值
-            x += sx;     // x方向步进
-        }
-        
-        // 判断是否需要在y方向步进
-        // 当 e2 < dx 时，说明偏差偏向y轴，需要y步进
-        if (e2 < dx) { 
-            err += dx;   // 更新误差值
-            y += sy;     // y方向步进
-        }
-    }
+    // 具体实现见 RasterCore::LineBresenham，这里以GDI像素输出策略实例化
+    GdiPixelSink sink(hdc, color);
+    RasterCore::LineBresenham(sink, p1.x, p1.y, p2.x, p2.y);
 }
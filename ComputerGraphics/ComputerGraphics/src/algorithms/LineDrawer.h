@@ -9,8 +9,15 @@
  * 【2D绘图算法】
  * - LineDrawer.*        - 直线绘制算法（DDA、Bresenham）
  * - CircleDrawer.*      - 圆形绘制算法（中点圆、Bresenham圆）
+ * - CurveDrawer.*       - 曲线绘制算法（均匀三次B样条，前向差分、自适应展平）
+ * - NurbsCurve.*        - NURBS曲线求值（批量de Boor算法）
  * - FillAlgorithms.*    - 区域填充算法（边界填充、扫描线填充）
  * - TransformAlgorithms.* - 几何变换算法（平移、旋转、缩放）
+ * - RasterCore.h        - 光栅化算法模板（像素输出策略 × 坐标类型）
+ * - Framebuffer.h       - 按像素格式特化的内存帧缓冲（RGBA8、BGRA8）
+ * - Compositor.*        - Gamma校正的alpha合成（区间、覆盖率遮罩，SSE2）
+ * - RunLengthCanvas.*   - 行程编码画布（稀疏图层，内存随绘制内容增长）
+ * - TiledCanvas.*       - 写时复制的分块画布（撤销快照共享未修改的块）
  * 
  * 【裁剪算法】
  * - ClippingAlgorithms.* - 裁剪算法集合
@@ -21,6 +28,11 @@
  * 
  * 【3D图形算法】
  * - MeshGenerator.*     - 3D网格生成器（立方体、球体、圆柱体、平面）
+ * - VertexPacker.*      - 紧凑顶点格式编码（16位位置、八面体法线、半精度纹理坐标、16位索引）
+ * - MeshOptimizer.*     - 网格重排（顶点缓存、遮挡、顶点读取顺序）与 ACMR/ATVR 统计
+ * - MeshWelder.*        - 按容差焊接重复顶点（保留法线和纹理接缝），输出映射表
+ * - ParametricSurface.* - 参数曲面（圆锥、圆环、胶囊、超二次曲面等）按行展开，共享正弦/余弦表
+ * - SoftwareRasterizer.* - 多线程CPU三角形光栅化器（分块分箱、8×8半平面测试、SSE2）
  * - ShaderManager.*     - OpenGL着色器管理（编译、链接、使用）
  * - TextureLoader.*     - 纹理加载器（支持常见图片格式）
  * 
@@ -71,14 +83,4 @@ public:
      * 效率更高，是最常用的直线绘制算法
      */
     static void DrawBresenham(HDC hdc, Point2D p1, Point2D p2, COLORREF color = RGB(0, 0, 0));
-
-private:
-    /**
-     * @brief 设置指定位置的像素颜色
-     * @param hdc Windows设备上下文句柄
-     * @param x 像素x坐标
-     * @param y 像素y坐标
-     * @param color 像素颜色
-     */
-    static void SetPixel(HDC hdc, int x, int y, COLORREF color);
 };
@@ -8,34 +8,146 @@
  * 2. 球体（Sphere）- 基于经纬度参数化
  * 3. 圆柱体（Cylinder）- 侧面 + 顶面 + 底面
  * 4. 平面（Plane）- 简单的四边形
+ * 以及细分二十面体球、立方体投影球和参数曲面（GenerateParametric，见 ParametricSurface）。
+ * 球体和圆柱体的方位角取自按分段数共享的 SinCosTable，内层循环不调用三角函数。
  * 
  * 【顶点数据格式】
  * 每个顶点包含8个float值，共32字节：
  * - 位置坐标 (x, y, z)：3个float，定义顶点在3D空间中的位置
  * - 法线向量 (nx, ny, nz)：3个float，用于光照计算
  * - 纹理坐标 (u, v)：2个float，用于纹理映射
+ * 上传到顶点缓冲对象时可以编码为更紧凑的格式（见 MeshBuffers::Create 和 VertexPacker）。
  * 
  * 【索引数据】
  * 使用索引数组定义三角形面片，每3个索引构成一个三角形。
  * 索引的顺序决定了面的朝向（逆时针为正面）。
+ * 各生成函数按行列顺序构造三角形，最后由 MeshWelder 合并重复顶点、删除零面积三角形，
+ * 再由 MeshOptimizer 重排三角形和顶点的顺序（提高顶点缓存命中率、减少遮挡开销），
+ * 因此生成后的顶点下标不再是行列顺序，顶点数也可能少于下面各函数说明中的数目。
  * 
- * 【OpenGL缓冲对象】
- * - VAO（顶点数组对象）：存储顶点属性配置
- * - VBO（顶点缓冲对象）：存储顶点数据
- * - EBO（元素缓冲对象）：存储索引数据
+ * 【不依赖OpenGL】
+ * 本文件只生成CPU端的 vertices 和 indices，不包含任何OpenGL或windows.h的头文件，
+ * 软件光栅化可以在没有窗口和GPU的进程中直接使用生成的网格。
+ * 上传到显存由 engine/MeshBuffers 完成。
  */
 
 #include "MeshGenerator.h"
-#include "../engine/OpenGLFunctions.h"
+#include "MeshOptimizer.h"
+#include "MeshWelder.h"
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
+namespace {
+
+void NormalizeVector(float v[3]) {
+    float length = sqrtf(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+    if (length > 0.0f) {
+        v[0] /= length;
+        v[1] /= length;
+        v[2] /= length;
+    }
+}
+
+float DistanceSquared(const float a[3], const float b[3]) {
+    float dx = a[0] - b[0], dy = a[1] - b[1], dz = a[2] - b[2];
+    return dx * dx + dy * dy + dz * dz;
+}
+
+/**
+ * @brief 把单位球面上的顶点和三角形写入网格，生成法线和经纬纹理坐标
+ * @param mesh 输出网格
+ * @param radius 球体半径
+ * @param positions 单位球面上的顶点（每顶点3个float）
+ * @param triangles 三角形索引
+ * 
+ * 纹理坐标与 GenerateSphere 相同：u = θ / 2π，v = φ / π。
+ * 经纬映射在两处不连续，需要按三角形复制顶点：
+ * - 跨越 u = 0/1 接缝的三角形（u 的跨度超过0.5），u < 0.5 一侧的顶点复制一份并令 u + 1
+ * - 极点上的 u 没有定义，每个三角形复制一份极点，u 取另外两个角点的平均值
+ * 复制的顶点以 (原下标, u) 为键去重。
+ */
+void EmitUnitSphere(Mesh3D& mesh, float radius, const std::vector<float>& positions,
+                    const std::vector<unsigned int>& triangles) {
+    mesh.vertices.clear();
+    mesh.indices.clear();
+    mesh.vertices.reserve(positions.size() / 3 * 8);
+    mesh.indices.reserve(triangles.size());
+    
+    std::unordered_map<uint64_t, unsigned int> emitted;
+    emitted.reserve(positions.size() / 3);
+    
+    for (size_t i = 0; i + 2 < triangles.size(); i += 3) {
+        float u[3];
+        bool pole[3];
+        for (int k = 0; k < 3; k++) {
+            const float* p = &positions[triangles[i + k] * 3];
+            pole[k] = p[0] * p[0] + p[2] * p[2] < 1e-10f;
+            u[k] = pole[k] ? 0.0f : atan2f(p[2], p[0]) / (2.0f * (float)M_PI);
+            if (u[k] < 0.0f) u[k] += 1.0f;
+        }
+        
+        // 接缝：按非极点角点的 u 跨度判断
+        float lo = 1.0f, hi = 0.0f;
+        for (int k = 0; k < 3; k++) {
+            if (pole[k]) continue;
+            lo = std::min(lo, u[k]);
+            hi = std::max(hi, u[k]);
+        }
+        if (hi - lo > 0.5f) {
+            for (int k = 0; k < 3; k++)
+                if (!pole[k] && u[k] < 0.5f) u[k] += 1.0f;
+        }
+        
+        // 极点：取另外两个角点的平均值
+        for (int k = 0; k < 3; k++) {
+            if (!pole[k]) continue;
+            float sum = 0.0f;
+            int count = 0;
+            for (int m = 0; m < 3; m++) {
+                if (pole[m]) continue;
+                sum += u[m];
+                count++;
+            }
+            u[k] = count ? sum / count : 0.5f;
+        }
+        
+        for (int k = 0; k < 3; k++) {
+            unsigned int source = triangles[i + k];
+            uint32_t uBits;
+            memcpy(&uBits, &u[k], sizeof(uBits));
+            uint64_t key = (uint64_t)source << 32 | uBits;
+            std::unordered_map<uint64_t, unsigned int>::iterator it = emitted.find(key);
+            if (it != emitted.end()) {
+                mesh.indices.push_back(it->second);
+                continue;
+            }
+            
+            const float* p = &positions[source * 3];
+            float v = acosf(std::max(-1.0f, std::min(1.0f, p[1]))) / (float)M_PI;
+            unsigned int index = (unsigned int)(mesh.vertices.size() / 8);
+            mesh.vertices.insert(mesh.vertices.end(), {
+                p[0] * radius, p[1] * radius, p[2] * radius,
+                p[0], p[1], p[2],
+                u[k], v
+            });
+            emitted[key] = index;
+            mesh.indices.push_back(index);
+        }
+    }
+}
+
+} // namespace
+
 /**
  * @brief 生成立方体网格
- * @param shape 要填充网格数据的Shape3D对象引用
+ * @param mesh 要填充网格数据的Mesh3D对象引用
  * @param size 立方体的边长
  * 
  * 【生成原理】
@@ -54,10 +166,9 @@
  * 【三角形划分】
  * 每个正方形面由2个三角形组成，共12个三角形。
  */
-void MeshGenerator::GenerateCube(Shape3D& shape, float size) {
-    shape.type = SHAPE3D_CUBE;
-    shape.vertices.clear();
-    shape.indices.clear();
+void MeshGenerator::GenerateCube(Mesh3D& mesh, float size) {
+    mesh.vertices.clear();
+    mesh.indices.clear();
     
     // 计算半边长，使立方体以原点为中心
     float halfSize = size / 2.0f;
@@ -67,7 +178,7 @@ void MeshGenerator::GenerateCube(Shape3D& shape, float size) {
     
     // ========== 前面 (z = +halfSize) ==========
     // 法线指向+Z方向，面向观察者
-    shape.vertices.insert(shape.vertices.end(), {
+    mesh.vertices.insert(mesh.vertices.end(), {
         // 左下角
         -halfSize, -halfSize,  halfSize,  0.0f,  0.0f,  1.0f,  0.0f, 0.0f,
         // 右下角
@@ -80,7 +191,7 @@ void MeshGenerator::GenerateCube(Shape3D& shape, float size) {
     
     // ========== 后面 (z = -halfSize) ==========
     // 法线指向-Z方向，背向观察者
-    shape.vertices.insert(shape.vertices.end(), {
+    mesh.vertices.insert(mesh.vertices.end(), {
          halfSize, -halfSize, -halfSize,  0.0f,  0.0f, -1.0f,  0.0f, 0.0f,
         -halfSize, -halfSize, -halfSize,  0.0f,  0.0f, -1.0f,  1.0f, 0.0f,
         -halfSize,  halfSize, -halfSize,  0.0f,  0.0f, -1.0f,  1.0f, 1.0f,
@@ -89,7 +200,7 @@ void MeshGenerator::GenerateCube(Shape3D& shape, float size) {
     
     // ========== 上面 (y = +halfSize) ==========
     // 法线指向+Y方向（向上）
-    shape.vertices.insert(shape.vertices.end(), {
+    mesh.vertices.insert(mesh.vertices.end(), {
         -halfSize,  halfSize,  halfSize,  0.0f,  1.0f,  0.0f,  0.0f, 0.0f,
          halfSize,  halfSize,  halfSize,  0.0f,  1.0f,  0.0f,  1.0f, 0.0f,
          halfSize,  halfSize, -halfSize,  0.0f,  1.0f,  0.0f,  1.0f, 1.0f,
@@ -98,7 +209,7 @@ void MeshGenerator::GenerateCube(Shape3D& shape, float size) {
     
     // ========== 下面 (y = -halfSize) ==========
     // 法线指向-Y方向（向下）
-    shape.vertices.insert(shape.vertices.end(), {
+    mesh.vertices.insert(mesh.vertices.end(), {
         -halfSize, -halfSize, -halfSize,  0.0f, -1.0f,  0.0f,  0.0f, 0.0f,
          halfSize, -halfSize, -halfSize,  0.0f, -1.0f,  0.0f,  1.0f, 0.0f,
          halfSize, -halfSize,  halfSize,  0.0f, -1.0f,  0.0f,  1.0f, 1.0f,
@@ -107,7 +218,7 @@ void MeshGenerator::GenerateCube(Shape3D& shape, float size) {
     
     // ========== 右面 (x = +halfSize) ==========
     // 法线指向+X方向（向右）
-    shape.vertices.insert(shape.vertices.end(), {
+    mesh.vertices.insert(mesh.vertices.end(), {
          halfSize, -halfSize,  halfSize,  1.0f,  0.0f,  0.0f,  0.0f, 0.0f,
          halfSize, -halfSize, -halfSize,  1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
          halfSize,  halfSize, -halfSize,  1.0f,  0.0f,  0.0f,  1.0f, 1.0f,
@@ -116,7 +227,7 @@ void MeshGenerator::GenerateCube(Shape3D& shape, float size) {
     
     // ========== 左面 (x = -halfSize) ==========
     // 法线指向-X方向（向左）
-    shape.vertices.insert(shape.vertices.end(), {
+    mesh.vertices.insert(mesh.vertices.end(), {
         -halfSize, -halfSize, -halfSize, -1.0f,  0.0f,  0.0f,  0.0f, 0.0f,
         -halfSize, -halfSize,  halfSize, -1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
         -halfSize,  halfSize,  halfSize, -1.0f,  0.0f,  0.0f,  1.0f, 1.0f,
@@ -128,19 +239,20 @@ void MeshGenerator::GenerateCube(Shape3D& shape, float size) {
     // 三角形1: 0-1-2，三角形2: 0-2-3
     for (unsigned int face = 0; face < 6; face++) {
         unsigned int base = face * 4;  // 每个面4个顶点
-        shape.indices.insert(shape.indices.end(), {
+        mesh.indices.insert(mesh.indices.end(), {
             base + 0, base + 1, base + 2,  // 第一个三角形
             base + 0, base + 2, base + 3   // 第二个三角形
         });
     }
     
-    // 创建OpenGL缓冲对象
-    CreateBuffers(shape);
+    // 焊接、重排
+    MeshWelder::Weld(mesh);
+    MeshOptimizer::Optimize(mesh);
 }
 
 /**
  * @brief 生成球体网格
- * @param shape 要填充网格数据的Shape3D对象引用
+ * @param mesh 要填充网格数据的Mesh3D对象引用
  * @param radius 球体半径
  * @param segments 水平分段数（经线数量，控制水平方向的精细度）
  * @param rings 垂直分段数（纬线数量，控制垂直方向的精细度）
@@ -165,29 +277,27 @@ void MeshGenerator::GenerateCube(Shape3D& shape, float size) {
  * - u = θ / 2π（水平方向）
  * - v = φ / π（垂直方向）
  */
-void MeshGenerator::GenerateSphere(Shape3D& shape, float radius, int segments, int rings) {
-    shape.type = SHAPE3D_SPHERE;
-    shape.vertices.clear();
-    shape.indices.clear();
+void MeshGenerator::GenerateSphere(Mesh3D& mesh, float radius, int segments, int rings) {
+    mesh.vertices.clear();
+    mesh.indices.clear();
+    
+    // θ = 2π×seg/segments 取自 segments 分段的表，φ = π×ring/rings 取自 2×rings 分段的表
+    const SinCosTable& thetaTable = SinCosTable::Get(segments);
+    const SinCosTable& phiTable = SinCosTable::Get(2 * rings);
+    mesh.vertices.reserve((size_t)(rings + 1) * (segments + 1) * 8);
     
     // ========== 生成顶点 ==========
     // 从北极（ring=0）到南极（ring=rings）逐圈生成
     for (int ring = 0; ring <= rings; ring++) {
-        // φ角：从0（北极）到π（南极）
-        float phi = (float)M_PI * ring / rings;
-        
-        // 计算当前纬度圈的y坐标和半径
-        float y = radius * cosf(phi);           // y = r × cos(φ)
-        float ringRadius = radius * sinf(phi);  // 当前圈的半径 = r × sin(φ)
+        // φ角：从0（北极）到π（南极），计算当前纬度圈的y坐标和半径
+        float y = radius * phiTable.Cos()[ring];           // y = r × cos(φ)
+        float ringRadius = radius * phiTable.Sin()[ring];  // 当前圈的半径 = r × sin(φ)
         
         // 沿当前纬度圈生成顶点
         for (int seg = 0; seg <= segments; seg++) {
-            // θ角：从0到2π绕Y轴一圈
-            float theta = 2.0f * (float)M_PI * seg / segments;
-            
-            // 计算顶点的x和z坐标
-            float x = ringRadius * cosf(theta);  // x = ringRadius × cos(θ)
-            float z = ringRadius * sinf(theta);  // z = ringRadius × sin(θ)
+            // θ角：从0到2π绕Y轴一圈，计算顶点的x和z坐标
+            float x = ringRadius * thetaTable.Cos()[seg];  // x = ringRadius × cos(θ)
+            float z = ringRadius * thetaTable.Sin()[seg];  // z = ringRadius × sin(θ)
             
             // 法线向量：单位球面上的点就是法线方向
             // 对于半径为r的球，法线 = 位置 / r
@@ -200,7 +310,7 @@ void MeshGenerator::GenerateSphere(Shape3D& shape, float radius, int segments, i
             float v = (float)ring / rings;     // 垂直方向 [0, 1]
             
             // 添加顶点数据
-            shape.vertices.insert(shape.vertices.end(), {
+            mesh.vertices.insert(mesh.vertices.end(), {
                 x, y, z, nx, ny, nz, u, v
             });
         }
@@ -217,19 +327,173 @@ void MeshGenerator::GenerateSphere(Shape3D& shape, float radius, int segments, i
             // 两个三角形组成一个四边形
             // 三角形1: current -> next -> current+1
             // 三角形2: current+1 -> next -> next+1
-            shape.indices.insert(shape.indices.end(), {
+            mesh.indices.insert(mesh.indices.end(), {
                 current, next, current + 1,
                 current + 1, next, next + 1
             });
         }
     }
     
-    CreateBuffers(shape);
+    MeshWelder::Weld(mesh);
+    MeshOptimizer::Optimize(mesh);
+}
+
+/**
+ * @brief 生成细分二十面体球（icosphere）网格
+ * @param mesh 要填充网格数据的Mesh3D对象引用
+ * @param radius 球体半径
+ * @param subdivisions 细分次数，三角形数为 20 × 4^subdivisions
+ * 
+ * 【生成原理】
+ * 从正二十面体出发，每次把每个三角形按三条边的中点分成4个，
+ * 新顶点投影回单位球面。正二十面体的20个面全等，细分后各三角形的大小相差不到一倍，
+ * 不像经纬球那样在两极堆积细长的三角形。
+ * 
+ * 【边中点缓存】
+ * 相邻两个三角形共享一条边，边中点只能生成一次（否则会出现裂缝和重复顶点）。
+ * 以边的两个端点下标 (小, 大) 为键查哈希表，每条边只生成一次中点，
+ * 每轮细分的时间与三角形数成正比，总时间为 O(最终三角形数)。
+ */
+void MeshGenerator::GenerateIcosphere(Mesh3D& mesh, float radius, int subdivisions) {
+    // ========== 正二十面体 ==========
+    // 12个顶点位于三个互相垂直的黄金矩形 (0, ±1, ±φ) 的角上
+    const float t = (1.0f + sqrtf(5.0f)) / 2.0f;
+    std::vector<float> positions = {
+        -1,  t,  0,   1,  t,  0,  -1, -t,  0,   1, -t,  0,
+         0, -1,  t,   0,  1,  t,   0, -1, -t,   0,  1, -t,
+         t,  0, -1,   t,  0,  1,  -t,  0, -1,  -t,  0,  1
+    };
+    for (size_t i = 0; i < positions.size(); i += 3) NormalizeVector(&positions[i]);
+    
+    std::vector<unsigned int> triangles = {
+        0, 11, 5,   0, 5, 1,    0, 1, 7,    0, 7, 10,   0, 10, 11,
+        1, 5, 9,    5, 11, 4,   11, 10, 2,  10, 7, 6,   7, 1, 8,
+        3, 9, 4,    3, 4, 2,    3, 2, 6,    3, 6, 8,    3, 8, 9,
+        4, 9, 5,    2, 4, 11,   6, 2, 10,   8, 6, 7,    9, 8, 1
+    };
+    
+    // ========== 逐轮细分 ==========
+    std::unordered_map<uint64_t, unsigned int> midpoints;
+    for (int level = 0; level < subdivisions; level++) {
+        std::vector<unsigned int> refined;
+        refined.reserve(triangles.size() * 4);
+        midpoints.clear();
+        midpoints.reserve(triangles.size() * 3 / 2);
+        
+        // 取边 (a, b) 的中点下标，不存在时生成并投影到球面
+        auto midpoint = [&](unsigned int a, unsigned int b) -> unsigned int {
+            uint64_t key = a < b ? ((uint64_t)a << 32 | b) : ((uint64_t)b << 32 | a);
+            std::unordered_map<uint64_t, unsigned int>::iterator it = midpoints.find(key);
+            if (it != midpoints.end()) return it->second;
+            unsigned int index = (unsigned int)(positions.size() / 3);
+            float m[3];
+            for (int k = 0; k < 3; k++) m[k] = 0.5f * (positions[a * 3 + k] + positions[b * 3 + k]);
+            NormalizeVector(m);
+            positions.insert(positions.end(), m, m + 3);
+            midpoints[key] = index;
+            return index;
+        };
+        
+        for (size_t i = 0; i < triangles.size(); i += 3) {
+            unsigned int a = triangles[i], b = triangles[i + 1], c = triangles[i + 2];
+            unsigned int ab = midpoint(a, b), bc = midpoint(b, c), ca = midpoint(c, a);
+            refined.insert(refined.end(), {
+                a, ab, ca,
+                b, bc, ab,
+                c, ca, bc,
+                ab, bc, ca
+            });
+        }
+        triangles.swap(refined);
+    }
+    
+    EmitUnitSphere(mesh, radius, positions, triangles);
+    MeshWelder::Weld(mesh);
+    MeshOptimizer::Optimize(mesh);
+}
+
+/**
+ * @brief 生成立方体投影球（cube sphere）网格
+ * @param mesh 要填充网格数据的Mesh3D对象引用
+ * @param radius 球体半径
+ * @param subdivisions 立方体每个面每条边的分段数，三角形数为 12 × subdivisions²
+ * 
+ * 【生成原理】
+ * 把立方体的6个面各划分为 subdivisions × subdivisions 的网格，再投影到球面上。
+ * 直接归一化均匀网格会使面中心的格子比角上的大约1.7倍；
+ * 这里用等角映射 s → tan(s × π/4)（s ∈ [-1, 1]），每个格子在球心张开的角度相同。
+ * 与二十面体球相比，分段数可以取任意整数，能更精确地贴合目标误差。
+ */
+void MeshGenerator::GenerateCubeSphere(Mesh3D& mesh, float radius, int subdivisions) {
+    if (subdivisions < 1) subdivisions = 1;
+    
+    // 每个面：法线方向n、网格的横向a和纵向b（a × b = n，网格按逆时针连接时朝外）
+    static const float faces[6][3][3] = {
+        { { 1, 0, 0 }, { 0, 0, -1 }, { 0, 1, 0 } },
+        { { -1, 0, 0 }, { 0, 0, 1 }, { 0, 1, 0 } },
+        { { 0, 1, 0 }, { 1, 0, 0 }, { 0, 0, -1 } },
+        { { 0, -1, 0 }, { 1, 0, 0 }, { 0, 0, 1 } },
+        { { 0, 0, 1 }, { 1, 0, 0 }, { 0, 1, 0 } },
+        { { 0, 0, -1 }, { -1, 0, 0 }, { 0, 1, 0 } }
+    };
+    
+    // 等角映射的网格坐标，6个面共用
+    const int n = subdivisions;
+    std::vector<float> grid(n + 1);
+    for (int i = 0; i <= n; i++) grid[i] = tanf((-1.0f + 2.0f * i / n) * (float)M_PI / 4.0f);
+    
+    std::vector<float> positions;
+    std::vector<unsigned int> triangles;
+    positions.reserve(6 * (n + 1) * (n + 1) * 3);
+    triangles.reserve(6 * n * n * 6);
+    
+    for (int f = 0; f < 6; f++) {
+        const float* normal = faces[f][0];
+        const float* across = faces[f][1];
+        const float* up = faces[f][2];
+        unsigned int base = (unsigned int)(positions.size() / 3);
+        
+        for (int j = 0; j <= n; j++) {
+            for (int i = 0; i <= n; i++) {
+                float p[3];
+                for (int k = 0; k < 3; k++) p[k] = normal[k] + grid[i] * across[k] + grid[j] * up[k];
+                NormalizeVector(p);
+                positions.insert(positions.end(), p, p + 3);
+            }
+        }
+        
+        for (int j = 0; j < n; j++) {
+            for (int i = 0; i < n; i++) {
+                unsigned int p00 = base + j * (n + 1) + i;
+                unsigned int p10 = p00 + 1;
+                unsigned int p01 = p00 + n + 1;
+                unsigned int p11 = p01 + 1;
+                // 沿较短的对角线切分：靠近立方体角的格子是菱形，沿长对角线切会产生钝角三角形
+                if (DistanceSquared(&positions[p00 * 3], &positions[p11 * 3]) <=
+                    DistanceSquared(&positions[p10 * 3], &positions[p01 * 3])) {
+                    triangles.insert(triangles.end(), {
+                        p00, p10, p11,
+                        p00, p11, p01
+                    });
+                } else {
+                    triangles.insert(triangles.end(), {
+                        p00, p10, p01,
+                        p10, p11, p01
+                    });
+                }
+            }
+        }
+    }
+    
+    // 相邻两个面的公共边上各有一份顶点，由焊接合并
+    EmitUnitSphere(mesh, radius, positions, triangles);
+    MeshWelder::Weld(mesh);
+    MeshOptimizer::Optimize(mesh);
 }
 
 /**
  * @brief 生成圆柱体网格
- * @param shape 要填充网格数据的Shape3D对象引用
+ * @param mesh 要填充网格数据的Mesh3D对象引用
  * @param radius 圆柱体底面半径
  * @param height 圆柱体高度
  * @param segments 圆周分段数（控制圆的精细度）
@@ -252,37 +516,38 @@ void MeshGenerator::GenerateSphere(Shape3D& shape, float radius, int segments, i
  * 使用扇形三角形，中心点连接边缘点。
  * 顶面法线向上 (0, 1, 0)，底面法线向下 (0, -1, 0)
  */
-void MeshGenerator::GenerateCylinder(Shape3D& shape, float radius, float height, int segments) {
-    shape.type = SHAPE3D_CYLINDER;
-    shape.vertices.clear();
-    shape.indices.clear();
+void MeshGenerator::GenerateCylinder(Mesh3D& mesh, float radius, float height, int segments) {
+    mesh.vertices.clear();
+    mesh.indices.clear();
     
     float halfHeight = height / 2.0f;
     
+    // θ = 2π×i/segments 的余弦/正弦取自共享的表，侧面和两个盖子共用
+    const SinCosTable& table = SinCosTable::Get(segments);
+    const float* cosTheta = table.Cos();
+    const float* sinTheta = table.Sin();
+    
     // ========== 侧面顶点 ==========
     // 每个分段生成上下两个顶点
     for (int i = 0; i <= segments; i++) {
-        // θ角：绕Y轴一圈
-        float theta = 2.0f * (float)M_PI * i / segments;
-        
         // 计算圆周上的x和z坐标
-        float x = radius * cosf(theta);
-        float z = radius * sinf(theta);
+        float x = radius * cosTheta[i];
+        float z = radius * sinTheta[i];
         
         // 侧面法线：水平向外，与位置方向相同（但归一化）
-        float nx = cosf(theta);
-        float nz = sinf(theta);
+        float nx = cosTheta[i];
+        float nz = sinTheta[i];
         
         // 纹理坐标：u沿圆周，v沿高度
         float u = (float)i / segments;
         
         // 底部顶点 (y = -halfHeight)
-        shape.vertices.insert(shape.vertices.end(), {
+        mesh.vertices.insert(mesh.vertices.end(), {
             x, -halfHeight, z, nx, 0.0f, nz, u, 0.0f
         });
         
         // 顶部顶点 (y = +halfHeight)
-        shape.vertices.insert(shape.vertices.end(), {
+        mesh.vertices.insert(mesh.vertices.end(), {
             x, halfHeight, z, nx, 0.0f, nz, u, 1.0f
         });
     }
@@ -292,7 +557,7 @@ void MeshGenerator::GenerateCylinder(Shape3D& shape, float radius, float height,
     for (int i = 0; i < segments; i++) {
         unsigned int base = i * 2;  // 每个分段2个顶点（上下）
         // 四边形分成2个三角形
-        shape.indices.insert(shape.indices.end(), {
+        mesh.indices.insert(mesh.indices.end(), {
             base, base + 2, base + 1,      // 三角形1
             base + 1, base + 2, base + 3   // 三角形2
         });
@@ -300,25 +565,24 @@ void MeshGenerator::GenerateCylinder(Shape3D& shape, float radius, float height,
     
     // ========== 顶面 ==========
     // 顶面中心点
-    unsigned int topCenterIndex = (unsigned int)shape.vertices.size() / 8;
-    shape.vertices.insert(shape.vertices.end(), {
+    unsigned int topCenterIndex = (unsigned int)mesh.vertices.size() / 8;
+    mesh.vertices.insert(mesh.vertices.end(), {
         0.0f, halfHeight, 0.0f,   // 位置：顶面中心
         0.0f, 1.0f, 0.0f,         // 法线：向上
         0.5f, 0.5f                // 纹理：中心
     });
     
     // 顶面边缘顶点（需要单独的顶点，因为法线不同）
-    unsigned int topEdgeStart = (unsigned int)shape.vertices.size() / 8;
+    unsigned int topEdgeStart = (unsigned int)mesh.vertices.size() / 8;
     for (int i = 0; i <= segments; i++) {
-        float theta = 2.0f * (float)M_PI * i / segments;
-        float x = radius * cosf(theta);
-        float z = radius * sinf(theta);
+        float x = radius * cosTheta[i];
+        float z = radius * sinTheta[i];
         
         // 纹理坐标：圆形映射到[0,1]×[0,1]
-        float u = 0.5f + 0.5f * cosf(theta);
-        float v = 0.5f + 0.5f * sinf(theta);
+        float u = 0.5f + 0.5f * cosTheta[i];
+        float v = 0.5f + 0.5f * sinTheta[i];
         
-        shape.vertices.insert(shape.vertices.end(), {
+        mesh.vertices.insert(mesh.vertices.end(), {
             x, halfHeight, z,     // 位置
             0.0f, 1.0f, 0.0f,     // 法线：向上
             u, v                  // 纹理
@@ -327,30 +591,29 @@ void MeshGenerator::GenerateCylinder(Shape3D& shape, float radius, float height,
     
     // 顶面索引：扇形三角形
     for (int i = 0; i < segments; i++) {
-        shape.indices.insert(shape.indices.end(), {
+        mesh.indices.insert(mesh.indices.end(), {
             topCenterIndex, topEdgeStart + i, topEdgeStart + i + 1
         });
     }
     
     // ========== 底面 ==========
     // 底面中心点
-    unsigned int bottomCenterIndex = (unsigned int)shape.vertices.size() / 8;
-    shape.vertices.insert(shape.vertices.end(), {
+    unsigned int bottomCenterIndex = (unsigned int)mesh.vertices.size() / 8;
+    mesh.vertices.insert(mesh.vertices.end(), {
         0.0f, -halfHeight, 0.0f,  // 位置：底面中心
         0.0f, -1.0f, 0.0f,        // 法线：向下
         0.5f, 0.5f                // 纹理：中心
     });
     
     // 底面边缘顶点
-    unsigned int bottomEdgeStart = (unsigned int)shape.vertices.size() / 8;
+    unsigned int bottomEdgeStart = (unsigned int)mesh.vertices.size() / 8;
     for (int i = 0; i <= segments; i++) {
-        float theta = 2.0f * (float)M_PI * i / segments;
-        float x = radius * cosf(theta);
-        float z = radius * sinf(theta);
-        float u = 0.5f + 0.5f * cosf(theta);
-        float v = 0.5f + 0.5f * sinf(theta);
+        float x = radius * cosTheta[i];
+        float z = radius * sinTheta[i];
+        float u = 0.5f + 0.5f * cosTheta[i];
+        float v = 0.5f + 0.5f * sinTheta[i];
         
-        shape.vertices.insert(shape.vertices.end(), {
+        mesh.vertices.insert(mesh.vertices.end(), {
             x, -halfHeight, z,    // 位置
             0.0f, -1.0f, 0.0f,    // 法线：向下
             u, v                  // 纹理
@@ -359,17 +622,29 @@ void MeshGenerator::GenerateCylinder(Shape3D& shape, float radius, float height,
     
     // 底面索引：扇形三角形（注意缠绕顺序相反，使法线朝下）
     for (int i = 0; i < segments; i++) {
-        shape.indices.insert(shape.indices.end(), {
+        mesh.indices.insert(mesh.indices.end(), {
             bottomCenterIndex, bottomEdgeStart + i + 1, bottomEdgeStart + i
         });
     }
     
-    CreateBuffers(shape);
+    MeshWelder::Weld(mesh);
+    MeshOptimizer::Optimize(mesh);
+}
+
+/**
+ * @brief 生成参数曲面网格
+ * 
+ * SurfaceTessellator 生成的网格没有重复顶点（接缝两侧纹理坐标不同）和退化三角形，
+ * 焊接不会改变任何东西，因此只做重排。
+ */
+void MeshGenerator::GenerateParametric(Mesh3D& mesh, const ParametricSurface& surface) {
+    SurfaceTessellator::Tessellate(mesh, surface);
+    MeshOptimizer::Optimize(mesh);
 }
 
 /**
  * @brief 生成平面网格
- * @param shape 要填充网格数据的Shape3D对象引用
+ * @param mesh 要填充网格数据的Mesh3D对象引用
  * @param width 平面宽度（X方向）
  * @param height 平面高度（Z方向）
  * 
@@ -389,17 +664,16 @@ void MeshGenerator::GenerateCylinder(Shape3D& shape, float radius, float height,
  * - 墙壁
  * - 任何需要平面的场景
  */
-void MeshGenerator::GeneratePlane(Shape3D& shape, float width, float height) {
-    shape.type = SHAPE3D_PLANE;
-    shape.vertices.clear();
-    shape.indices.clear();
+void MeshGenerator::GeneratePlane(Mesh3D& mesh, float width, float height) {
+    mesh.vertices.clear();
+    mesh.indices.clear();
     
     float halfWidth = width / 2.0f;
     float halfHeight = height / 2.0f;
     
     // 顶点格式: x, y, z, nx, ny, nz, u, v
     // 平面位于XZ平面（y=0），法线指向Y轴正方向
-    shape.vertices = {
+    mesh.vertices = {
         // 顶点0：左下角
         -halfWidth, 0.0f, -halfHeight,  0.0f, 1.0f, 0.0f,  0.0f, 0.0f,
         // 顶点1：右下角
@@ -412,101 +686,119 @@ void MeshGenerator::GeneratePlane(Shape3D& shape, float width, float height) {
     
     // 索引：2个三角形组成矩形
     // 三角形1: 0-1-2，三角形2: 0-2-3
-    shape.indices = {
+    mesh.indices = {
         0, 1, 2,
         0, 2, 3
     };
     
-    CreateBuffers(shape);
+    MeshWelder::Weld(mesh);
+    MeshOptimizer::Optimize(mesh);
 }
 
 /**
- * @brief 创建OpenGL缓冲对象
- * @param shape 包含顶点和索引数据的Shape3D对象引用
- * 
- * 【OpenGL缓冲对象说明】
- * 
- * VAO（Vertex Array Object，顶点数组对象）：
- * - 存储顶点属性的配置状态
- * - 记录VBO和EBO的绑定关系
- * - 记录顶点属性指针的设置
- * - 渲染时只需绑定VAO即可恢复所有配置
- * 
- * VBO（Vertex Buffer Object，顶点缓冲对象）：
- * - 存储顶点数据（位置、法线、纹理坐标等）
- * - 数据存储在GPU显存中，提高渲染效率
+ * @brief 根据顶点计算网格的包围盒和包围球
+ * @param mesh 已填充顶点数据的Mesh3D对象引用
  * 
- * EBO（Element Buffer Object，元素缓冲对象）：
- * - 存储索引数据
- * - 允许顶点复用，减少数据量
- * 
- * 【顶点属性布局】
- * 每个顶点32字节（8个float）：
- * - location 0：位置 (x, y, z) - 偏移0，3个float
- * - location 1：法线 (nx, ny, nz) - 偏移12字节，3个float
- * - location 2：纹理坐标 (u, v) - 偏移24字节，2个float
+ * 两遍扫描：第一遍求包围盒，其中心作为球心，第二遍求到球心的最大距离。
+ * 比最小包围球略大，但对剔除来说足够紧，且与顶点顺序无关。
  */
-void MeshGenerator::CreateBuffers(Shape3D& shape) {
-    // 检查OpenGL函数是否可用（动态加载的函数指针）
-    if (!glGenVertexArrays || !glBindVertexArray || !glGenBuffers || 
-        !glBindBuffer || !glBufferData || !glVertexAttribPointer || 
-        !glEnableVertexAttribArray) {
+void MeshGenerator::ComputeBounds(Mesh3D& mesh) {
+    const size_t stride = 8;
+    size_t vertexCount = mesh.vertices.size() / stride;
+    if (vertexCount == 0) {
+        for (int c = 0; c < 3; c++) mesh.boundMin[c] = mesh.boundMax[c] = mesh.boundCenter[c] = 0.0f;
+        mesh.boundRadius = 0.0f;
         return;
     }
-    
-    // ========== 清理旧的缓冲对象 ==========
-    // 如果之前已经创建过缓冲对象，需要先删除
-    if (shape.VAO != 0 && glDeleteVertexArrays) {
-        glDeleteVertexArrays(1, &shape.VAO);
-        shape.VAO = 0;
+
+    float lo[3], hi[3];
+    for (int c = 0; c < 3; c++) lo[c] = hi[c] = mesh.vertices[c];
+    for (size_t v = 1; v < vertexCount; v++) {
+        const float* p = &mesh.vertices[v * stride];
+        for (int c = 0; c < 3; c++) {
+            if (p[c] < lo[c]) lo[c] = p[c];
+            if (p[c] > hi[c]) hi[c] = p[c];
+        }
     }
-    if (shape.VBO != 0 && glDeleteBuffers) {
-        glDeleteBuffers(1, &shape.VBO);
-        shape.VBO = 0;
+    for (int c = 0; c < 3; c++) {
+        mesh.boundMin[c] = lo[c];
+        mesh.boundMax[c] = hi[c];
+        mesh.boundCenter[c] = 0.5f * (lo[c] + hi[c]);
     }
-    if (shape.EBO != 0 && glDeleteBuffers) {
-        glDeleteBuffers(1, &shape.EBO);
-        shape.EBO = 0;
+
+    float maxDistSq = 0.0f;
+    for (size_t v = 0; v < vertexCount; v++) {
+        const float* p = &mesh.vertices[v * stride];
+        float dx = p[0] - mesh.boundCenter[0];
+        float dy = p[1] - mesh.boundCenter[1];
+        float dz = p[2] - mesh.boundCenter[2];
+        float distSq = dx * dx + dy * dy + dz * dz;
+        if (distSq > maxDistSq) maxDistSq = distSq;
     }
-    
-    // ========== 创建VAO ==========
-    // VAO记录后续的VBO绑定和顶点属性配置
-    glGenVertexArrays(1, &shape.VAO);
-    glBindVertexArray(shape.VAO);
-    
-    // ========== 创建VBO并上传顶点数据 ==========
-    glGenBuffers(1, &shape.VBO);
-    glBindBuffer(GL_ARRAY_BUFFER, shape.VBO);
-    // GL_STATIC_DRAW：数据不会或很少改变，适合静态网格
-    glBufferData(GL_ARRAY_BUFFER, shape.vertices.size() * sizeof(float), 
-                 shape.vertices.data(), GL_STATIC_DRAW);
-    
-    // ========== 创建EBO并上传索引数据 ==========
-    glGenBuffers(1, &shape.EBO);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, shape.EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, shape.indices.size() * sizeof(unsigned int), 
-                 shape.indices.data(), GL_STATIC_DRAW);
-    
-    // ========== 设置顶点属性指针 ==========
-    // 顶点格式: [x, y, z, nx, ny, nz, u, v]
-    // 步长（stride）= 8 * sizeof(float) = 32字节
-    
-    // 位置属性 (location = 0)
-    // 3个float，从偏移0开始
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    
-    // 法线属性 (location = 1)
-    // 3个float，从偏移12字节（3*sizeof(float)）开始
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    
-    // 纹理坐标属性 (location = 2)
-    // 2个float，从偏移24字节（6*sizeof(float)）开始
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
-    glEnableVertexAttribArray(2);
-    
-    // ========== 解绑VAO ==========
-    // 解绑后，后续的VBO/EBO操作不会影响这个VAO
-    glBindVertexArray(0);
+    mesh.boundRadius = sqrtf(maxDistSq);
+}
+
+/**
+ * @brief 二十面体球的几何误差
+ * 
+ * 边长为 θ（弧度）的球面正三角形，平面三角形的中心离球面最远，
+ * 距离为 1 - cos(θ/√3) ≈ θ²/6。每细分一次边长减半，误差降为1/4。
+ * 系数0.293为实测的最大误差 × 4^subdivisions（0～6次细分中的最大值；
+ * 投影到球面时原二十面体各面中心附近的三角形被拉得最大）。
+ */
+float MeshGenerator::IcosphereError(int subdivisions) {
+    if (subdivisions < 0) subdivisions = 0;
+    return 0.293f / (float)(1 << (2 * subdivisions));
+}
+
+/**
+ * @brief 立方体投影球的几何误差
+ * 
+ * 等角映射下每个格子张开约 (π/2)/N 的角度，切成两个直角三角形后外接圆的角半径约为
+ * (π/2)/N × √2/2，误差 1 - cos(·) ≈ 0.617/N²（实测值，与估算一致）。
+ */
+float MeshGenerator::CubeSphereError(int subdivisions) {
+    if (subdivisions < 1) subdivisions = 1;
+    return 0.62f / ((float)subdivisions * (float)subdivisions);
+}
+
+/**
+ * @brief 满足屏幕误差的最小二十面体球细分次数
+ * 
+ * 屏幕误差 = 投影半径 × 相对误差，从0次开始逐级增加直到满足要求。
+ * 细分次数每加1三角形数乘4，目标误差落在两级之间时三角形数可能多出近4倍，
+ * 需要更细的控制时使用立方体投影球。
+ */
+int MeshGenerator::IcosphereSubdivisions(float pixelRadius, float maxErrorPixels) {
+    int subdivisions = 0;
+    while (subdivisions < MAX_ICOSPHERE_SUBDIVISIONS && pixelRadius * IcosphereError(subdivisions) > maxErrorPixels)
+        subdivisions++;
+    return subdivisions;
+}
+
+/**
+ * @brief 满足屏幕误差的最小立方体投影球分段数
+ * 
+ * 由 R × 0.62 / N² ≤ e 直接解出 N = ceil(sqrt(0.62 R / e))。
+ */
+int MeshGenerator::CubeSphereSubdivisions(float pixelRadius, float maxErrorPixels) {
+    if (maxErrorPixels <= 0.0f) return MAX_CUBE_SPHERE_SUBDIVISIONS;
+    float n = ceilf(sqrtf(CubeSphereError(1) * pixelRadius / maxErrorPixels));
+    if (n < 1.0f) return 1;
+    if (n > (float)MAX_CUBE_SPHERE_SUBDIVISIONS) return MAX_CUBE_SPHERE_SUBDIVISIONS;
+    return (int)n;
+}
+
+/**
+ * @brief 细节层次对应的圆周分段数
+ * @param level 细节层次
+ * @return 8 × 2^level
+ * 
+ * 相邻层次的分段数相差一倍，屏幕上的边长也随之减半，
+ * 选择层次时只需按投影半径翻倍的阈值逐级切换（见 LevelOfDetail）。
+ */
+int MeshGenerator::LodSegments(int level) {
+    if (level < 0) level = 0;
+    if (level >= LOD_LEVEL_COUNT) level = LOD_LEVEL_COUNT - 1;
+    return 8 << level;
 }
@@ -1,5 +1,6 @@
 ﻿#pragma once
-#include "../core/Shape3D.h"
+#include "../core/Mesh3D.h"
+#include "ParametricSurface.h"
 #include <vector>
 
 /**
@@ -13,14 +14,17 @@
  * @brief 三维网格生成算法类
  * 
  * 提供各种基本三维图形的网格生成功能，包括球体、柱体、平面和立方体。
- * 生成的网格数据包含顶点坐标、法线向量和纹理坐标，适用于OpenGL渲染。
+ * 生成的网格数据包含顶点坐标、法线向量和纹理坐标，每顶点8个float。
  * 参照2D算法类（LineDrawer, CircleDrawer）的设计模式。
+ * 
+ * 只生成CPU端的 vertices 和 indices（已经过 MeshWelder 焊接和 MeshOptimizer 重排），
+ * 不依赖OpenGL；上传到显存及顶点缓冲对象中的编码见 MeshBuffers。
  */
 class MeshGenerator {
 public:
     /**
      * @brief 生成立方体网格
-     * @param shape 要填充网格数据的Shape3D对象引用
+     * @param mesh 要填充网格数据的Mesh3D对象引用
      * @param size 立方体的边长
      * 
      * 生成一个以原点为中心的立方体网格，边长为size。
@@ -30,46 +34,120 @@ public:
      * - 法线向量(nx,ny,nz): 3个float  
      * - 纹理坐标(u,v): 2个float
      */
-    static void GenerateCube(Shape3D& shape, float size);
+    static void GenerateCube(Mesh3D& mesh, float size);
     
     /**
      * @brief 生成球体网格
-     * @param shape 要填充网格数据的Shape3D对象引用
+     * @param mesh 要填充网格数据的Mesh3D对象引用
      * @param radius 球体半径
      * @param segments 水平分段数（经线数量）
      * @param rings 垂直分段数（纬线数量）
      */
-    static void GenerateSphere(Shape3D& shape, float radius, 
+    static void GenerateSphere(Mesh3D& mesh, float radius, 
                                int segments, int rings);
     
+    /**
+     * @brief 生成细分二十面体球网格（三角形分布均匀）
+     * @param mesh 要填充网格数据的Mesh3D对象引用
+     * @param radius 球体半径
+     * @param subdivisions 细分次数，三角形数为 20 × 4^subdivisions
+     */
+    static void GenerateIcosphere(Mesh3D& mesh, float radius, int subdivisions);
+    
+    /**
+     * @brief 生成立方体投影球网格（等角映射，三角形分布均匀）
+     * @param mesh 要填充网格数据的Mesh3D对象引用
+     * @param radius 球体半径
+     * @param subdivisions 每个面每条边的分段数，三角形数为 12 × subdivisions²
+     */
+    static void GenerateCubeSphere(Mesh3D& mesh, float radius, int subdivisions);
+    
     /**
      * @brief 生成柱体网格
-     * @param shape 要填充网格数据的Shape3D对象引用
+     * @param mesh 要填充网格数据的Mesh3D对象引用
      * @param radius 柱体底面半径
      * @param height 柱体高度
      * @param segments 圆周分段数
      */
-    static void GenerateCylinder(Shape3D& shape, float radius, 
+    static void GenerateCylinder(Mesh3D& mesh, float radius, 
                                  float height, int segments);
     
     /**
      * @brief 生成平面网格
-     * @param shape 要填充网格数据的Shape3D对象引用
+     * @param mesh 要填充网格数据的Mesh3D对象引用
      * @param width 平面宽度
      * @param height 平面高度
      */
-    static void GeneratePlane(Shape3D& shape, float width, float height);
+    static void GeneratePlane(Mesh3D& mesh, float width, float height);
     
-private:
     /**
-     * @brief 创建OpenGL缓冲对象
-     * @param shape 包含顶点和索引数据的Shape3D对象引用
+     * @brief 生成参数曲面网格（球体、圆柱、圆锥、圆环、胶囊、超二次曲面）
+     * @param mesh 要填充网格数据的Mesh3D对象引用
+     * @param surface 曲面参数（用 ParametricSurface 的静态工厂函数构造）
      * 
-     * 根据shape中的vertices和indices数据创建VAO、VBO和EBO，
-     * 并设置顶点属性指针。顶点数据格式：
-     * - location 0: 位置坐标 (3 floats)
-     * - location 1: 法线向量 (3 floats)  
-     * - location 2: 纹理坐标 (2 floats)
+     * 顶点由 SurfaceTessellator 按行展开（共享 SinCosTable，不逐顶点调用三角函数），
+     * 不产生重复顶点和退化三角形，因此跳过焊接，直接重排。
+     * 不需要重排时（例如批量生成后自行处理）直接调用 SurfaceTessellator::Tessellate。
+     */
+    static void GenerateParametric(Mesh3D& mesh, const ParametricSurface& surface);
+    
+    /**
+     * @brief 根据顶点计算网格的包围盒和包围球
+     * @param mesh 已填充顶点数据的Mesh3D对象引用
+     * 
+     * 包围盒取顶点坐标的最小/最大值；球心取包围盒的中心，半径取球心到最远顶点的距离。
+     * 对基本体而言球心即原点，球面紧贴最远的顶点。
+     */
+    static void ComputeBounds(Mesh3D& mesh);
+    
+    // === 均匀剖分球的误差与细分数 ===
+    static const int MAX_ICOSPHERE_SUBDIVISIONS = 7;      ///< 二十面体球的最大细分次数（327680个三角形）
+    static const int MAX_CUBE_SPHERE_SUBDIVISIONS = 160;  ///< 立方体投影球每条边的最大分段数（307200个三角形）
+    
+    /**
+     * @brief 二十面体球的几何误差
+     * @param subdivisions 细分次数
+     * @return 三角形偏离球面的最大距离，以球半径为单位
+     */
+    static float IcosphereError(int subdivisions);
+    
+    /**
+     * @brief 立方体投影球的几何误差
+     * @param subdivisions 每条边的分段数
+     * @return 三角形偏离球面的最大距离，以球半径为单位
+     */
+    static float CubeSphereError(int subdivisions);
+    
+    /**
+     * @brief 满足屏幕误差的最小二十面体球细分次数
+     * @param pixelRadius 球在屏幕上的投影半径（像素）
+     * @param maxErrorPixels 允许的最大屏幕误差（像素）
+     * @return 细分次数，不超过 MAX_ICOSPHERE_SUBDIVISIONS
+     */
+    static int IcosphereSubdivisions(float pixelRadius, float maxErrorPixels);
+    
+    /**
+     * @brief 满足屏幕误差的最小立方体投影球分段数
+     * @param pixelRadius 球在屏幕上的投影半径（像素）
+     * @param maxErrorPixels 允许的最大屏幕误差（像素）
+     * @return 每条边的分段数，范围 [1, MAX_CUBE_SPHERE_SUBDIVISIONS]
+     */
+    static int CubeSphereSubdivisions(float pixelRadius, float maxErrorPixels);
+    
+    // === 细节层次（LOD） ===
+    static const int LOD_LEVEL_COUNT = 5;  ///< 球体和圆柱体预设的细分层次数
+    
+    /**
+     * @brief 细节层次对应的圆周分段数
+     * @param level 细节层次，范围 [0, LOD_LEVEL_COUNT)，越大越精细（越界时截断）
+     * @return 8 × 2^level，即8、16、32、64、128（球体经线数、圆柱体圆周分段数）
+     */
+    static int LodSegments(int level);
+    
+    /**
+     * @brief 细节层次对应的球体纬线数
+     * @param level 细节层次
+     * @return 与经线数相同，默认层次1即原有的 16×16 球体
      */
-    static void CreateBuffers(Shape3D& shape);
+    static int LodRings(int level) { return LodSegments(level); }
 };
\ No newline at end of file
@@ -0,0 +1,392 @@
+﻿/**
+ * @file MeshOptimizer.cpp
+ * @brief 三维网格的三角形和顶点重排实现
+ * @author ln1.opensource@gmail.com
+ * 
+ * 【顶点缓存】
+ * GPU把最近变换过的若干个顶点的结果保存在缓存中（后变换缓存），
+ * 索引命中缓存时不再执行顶点着色器。生成器按行输出的三角形在一行末尾才回头，
+ * 上一行的顶点早已被挤出缓存，球体的 ACMR 约为1；重排后接近0.6～0.7。
+ * 
+ * 【Forsyth 算法】（Tom Forsyth, "Linear-Speed Vertex Cache Optimisation", 2006）
+ * 每个顶点按它在模拟LRU缓存中的位置和剩余未输出的三角形数打分：
+ * - 缓存位置分：刚用过的3个顶点固定0.75（避免立刻重复同一条边），
+ *   其余随位置按 (1 - (pos-3)/(size-3))^1.5 衰减，不在缓存中为0
+ * - 度数分：2 × 剩余三角形数^-0.5，剩余三角形少的顶点优先处理完，避免留下孤立三角形
+ * 三角形的得分为三个顶点得分之和。每一步输出得分最高的三角形，
+ * 只重新计算缓存中顶点相邻的三角形，因此每步的工作量与缓存大小成正比，总时间线性。
+ * 
+ * 【遮挡排序】（Sander, Nehab, Barczak, "Fast Triangle Reordering for Vertex Locality
+ * and Reduced Overdraw", 2007）
+ * 顶点缓存优化后的序列在缓存"冷启动"处（三个顶点都未命中）天然可以切开；
+ * 再在簇内局部 ACMR 不超过阈值的位置继续细分。各簇按
+ * dot(簇中心 - 网格中心, 簇平均法线) 从大到小排序：朝外且靠外的簇先画，
+ * 它们写入的深度挡住后画的簇，被遮挡的像素在深度测试时提前剔除。
+ */
+
+#include "MeshOptimizer.h"
+#include "../diagnostics/Log.h"
+#include "../diagnostics/Profiler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const size_t VERTEX_FLOATS = 8;                       // 每顶点的float数
+const unsigned int CACHE_SIZE = MeshOptimizer::OPTIMIZE_CACHE_SIZE;
+const unsigned int MAX_VALENCE = 32;                  // 度数分查表的上限（更大的度数按上限计分）
+const unsigned int INVALID_INDEX = ~0u;
+
+/**
+ * @brief Forsyth 算法的顶点打分表
+ */
+struct ForsythScoreTable {
+    float cache[CACHE_SIZE];
+    float valence[MAX_VALENCE + 1];
+
+    ForsythScoreTable() {
+        for (unsigned int pos = 0; pos < CACHE_SIZE; pos++) {
+            if (pos < 3) cache[pos] = 0.75f;
+            else cache[pos] = powf(1.0f - (float)(pos - 3) / (float)(CACHE_SIZE - 3), 1.5f);
+        }
+        valence[0] = 0.0f;
+        for (unsigned int v = 1; v <= MAX_VALENCE; v++)
+            valence[v] = 2.0f / sqrtf((float)v);
+    }
+
+    float Score(int cachePos, unsigned int liveTriangles) const {
+        if (liveTriangles == 0) return -1.0f;  // 不再被任何三角形引用
+        float score = cachePos >= 0 ? cache[cachePos] : 0.0f;
+        return score + valence[liveTriangles < MAX_VALENCE ? liveTriangles : MAX_VALENCE];
+    }
+};
+
+/**
+ * @brief 先进先出顶点缓存模拟（时间戳法，每次访问 O(1)）
+ * 
+ * 顶点在第 t 次未命中时进入缓存，之后再发生 cacheSize 次未命中后被挤出，
+ * 因此"当前时间 - 进入时间 <= cacheSize"即表示仍在缓存中。
+ */
+class FifoCache {
+public:
+    FifoCache(size_t vertexCount, unsigned int cacheSize)
+        : stamps(vertexCount, 0), size(cacheSize), time(cacheSize + 1) {}
+
+    /** @brief 访问一个顶点，返回是否未命中 */
+    bool Miss(unsigned int v) {
+        if (time - stamps[v] <= size) return false;
+        stamps[v] = time++;
+        return true;
+    }
+
+    /** @brief 清空缓存 */
+    void Reset() { time += size + 1; }
+
+private:
+    std::vector<unsigned int> stamps;
+    unsigned int size;
+    unsigned int time;
+};
+
+/**
+ * @brief 三角形面积向量（法线方向，长度为面积的2倍）和重心
+ */
+void TriangleGeometry(const std::vector<float>& vertices, const unsigned int* tri, float normal[3], float centroid[3]) {
+    const float* a = &vertices[tri[0] * VERTEX_FLOATS];
+    const float* b = &vertices[tri[1] * VERTEX_FLOATS];
+    const float* c = &vertices[tri[2] * VERTEX_FLOATS];
+    float e1[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+    float e2[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+    normal[0] = e1[1] * e2[2] - e1[2] * e2[1];
+    normal[1] = e1[2] * e2[0] - e1[0] * e2[2];
+    normal[2] = e1[0] * e2[1] - e1[1] * e2[0];
+    for (int k = 0; k < 3; k++) centroid[k] = (a[k] + b[k] + c[k]) / 3.0f;
+}
+
+} // namespace
+
+/**
+ * @brief 依次执行三步优化
+ * 
+ * 顶点缓存优化的结果比输入差时（例如只有一两个三角形的平面）保留原顺序，
+ * 因此 ACMR 只会变好，最多因遮挡排序变差 threshold 规定的幅度。
+ */
+MeshOptimizeReport MeshOptimizer::Optimize(Mesh3D& mesh) {
+    PROFILE_FUNCTION();
+    MeshOptimizeReport report;
+    size_t vertexCount = mesh.vertices.size() / VERTEX_FLOATS;
+    report.before = AnalyzeVertexCache(mesh.indices, vertexCount);
+    report.clusterCount = 0;
+    if (mesh.indices.size() < 3) {
+        report.after = report.before;
+        return report;
+    }
+
+    std::vector<unsigned int> original = mesh.indices;
+    OptimizeVertexCache(mesh.indices, vertexCount);
+    if (AnalyzeVertexCache(mesh.indices, vertexCount).acmr > report.before.acmr)
+        mesh.indices.swap(original);
+
+    report.clusterCount = OptimizeOverdraw(mesh.indices, mesh.vertices);
+    vertexCount = OptimizeVertexFetch(mesh.vertices, mesh.indices);
+    report.after = AnalyzeVertexCache(mesh.indices, vertexCount);
+
+    LOG_DEBUG("网格优化: %zu 个三角形, ACMR %.3f -> %.3f, ATVR %.3f -> %.3f, %zu 个簇",
+              report.after.triangleCount, report.before.acmr, report.after.acmr,
+              report.before.atvr, report.after.atvr, report.clusterCount);
+    return report;
+}
+
+VertexCacheStats MeshOptimizer::AnalyzeVertexCache(const std::vector<unsigned int>& indices, size_t vertexCount,
+                                                    unsigned int cacheSize) {
+    VertexCacheStats stats;
+    stats.triangleCount = indices.size() / 3;
+    stats.vertexCount = 0;
+    stats.transformedCount = 0;
+
+    FifoCache cache(vertexCount, cacheSize);
+    std::vector<bool> referenced(vertexCount, false);
+    for (size_t i = 0; i < stats.triangleCount * 3; i++) {
+        unsigned int v = indices[i];
+        if (!referenced[v]) {
+            referenced[v] = true;
+            stats.vertexCount++;
+        }
+        if (cache.Miss(v)) stats.transformedCount++;
+    }
+
+    stats.acmr = stats.triangleCount ? (float)stats.transformedCount / stats.triangleCount : 0.0f;
+    stats.atvr = stats.vertexCount ? (float)stats.transformedCount / stats.vertexCount : 0.0f;
+    return stats;
+}
+
+/**
+ * @brief Forsyth 顶点缓存优化
+ * 
+ * 每个顶点的相邻三角形存放在一张连续表中（按顶点分段），
+ * 段内前 liveCount[v] 项是尚未输出的三角形，输出三角形时与段内最后一个存活项交换。
+ * 候选三角形只来自缓存中顶点的相邻三角形；缓存中没有候选时（网格的一个连通块画完），
+ * 从输入顺序中取下一个未输出的三角形，游标只前进不后退。
+ */
+void MeshOptimizer::OptimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount) {
+    static const ForsythScoreTable table;
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) return;
+
+    // ========== 顶点到三角形的邻接表 ==========
+    std::vector<unsigned int> liveCount(vertexCount, 0);
+    for (size_t i = 0; i < triangleCount * 3; i++) liveCount[indices[i]]++;
+
+    std::vector<unsigned int> adjacencyOffset(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; v++) adjacencyOffset[v + 1] = adjacencyOffset[v] + liveCount[v];
+
+    std::vector<unsigned int> adjacency(triangleCount * 3);
+    std::vector<unsigned int> fill(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+    for (size_t t = 0; t < triangleCount; t++)
+        for (int k = 0; k < 3; k++) adjacency[fill[indices[t * 3 + k]]++] = (unsigned int)t;
+
+    // ========== 初始得分 ==========
+    std::vector<int> cachePos(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (size_t v = 0; v < vertexCount; v++) vertexScore[v] = table.Score(-1, liveCount[v]);
+
+    std::vector<bool> emitted(triangleCount, false);
+    unsigned int best = 0;
+    float bestScore = -1.0f;
+    for (size_t t = 0; t < triangleCount; t++) {
+        const unsigned int* tri = &indices[t * 3];
+        float score = vertexScore[tri[0]] + vertexScore[tri[1]] + vertexScore[tri[2]];
+        if (score > bestScore) {
+            bestScore = score;
+            best = (unsigned int)t;
+        }
+    }
+
+    std::vector<unsigned int> result(triangleCount * 3);
+    unsigned int cache[CACHE_SIZE + 3], newCache[CACHE_SIZE + 3];
+    unsigned int cacheCount = 0;
+    size_t cursor = 0;
+
+    for (size_t out = 0; out < triangleCount; out++) {
+        if (best == INVALID_INDEX) {
+            while (emitted[cursor]) cursor++;
+            best = (unsigned int)cursor;
+        }
+
+        // ========== 输出三角形并从邻接表中移除 ==========
+        const unsigned int* tri = &indices[best * 3];
+        emitted[best] = true;
+        for (int k = 0; k < 3; k++) {
+            unsigned int v = tri[k];
+            result[out * 3 + k] = v;
+            unsigned int* live = &adjacency[adjacencyOffset[v]];
+            for (unsigned int j = 0; j < liveCount[v]; j++) {
+                if (live[j] == best) {
+                    live[j] = live[liveCount[v] - 1];
+                    liveCount[v]--;
+                    break;
+                }
+            }
+        }
+
+        // ========== 更新LRU缓存：三角形的顶点移到最前 ==========
+        unsigned int newCount = 0;
+        for (int k = 0; k < 3; k++) {
+            unsigned int v = tri[k];
+            if (std::find(newCache, newCache + newCount, v) == newCache + newCount) newCache[newCount++] = v;
+        }
+        for (unsigned int i = 0; i < cacheCount; i++) {
+            unsigned int v = cache[i];
+            if (v != tri[0] && v != tri[1] && v != tri[2]) newCache[newCount++] = v;
+        }
+
+        // ========== 重新打分：被挤出的顶点分数下降，缓存中的顶点分数按新位置计算 ==========
+        for (unsigned int i = 0; i < newCount; i++) {
+            unsigned int v = newCache[i];
+            cachePos[v] = i < CACHE_SIZE ? (int)i : -1;
+            vertexScore[v] = table.Score(cachePos[v], liveCount[v]);
+        }
+        cacheCount = newCount < CACHE_SIZE ? newCount : CACHE_SIZE;
+        std::copy(newCache, newCache + cacheCount, cache);
+
+        best = INVALID_INDEX;
+        bestScore = -1.0f;
+        for (unsigned int i = 0; i < cacheCount; i++) {
+            unsigned int v = cache[i];
+            const unsigned int* live = &adjacency[adjacencyOffset[v]];
+            for (unsigned int j = 0; j < liveCount[v]; j++) {
+                unsigned int t = live[j];
+                const unsigned int* adj = &indices[t * 3];
+                float score = vertexScore[adj[0]] + vertexScore[adj[1]] + vertexScore[adj[2]];
+                if (score > bestScore) {
+                    bestScore = score;
+                    best = t;
+                }
+            }
+        }
+    }
+
+    indices.swap(result);
+}
+
+/**
+ * @brief 遮挡优化
+ * 
+ * 1. 模拟整条序列的顶点缓存，三个顶点都未命中的三角形处是硬边界
+ * 2. 每个硬簇内重新从空缓存开始模拟，局部 ACMR 降到硬簇 ACMR × threshold 以下时切开
+ *    （切开后的小簇各自从空缓存开始也不会比原来差太多）
+ * 3. 按面积加权求各簇的中心和平均法线，按 dot(簇中心 - 网格中心, 簇法线) 从大到小排序
+ */
+size_t MeshOptimizer::OptimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<float>& vertices,
+                                       float threshold) {
+    const size_t triangleCount = indices.size() / 3;
+    const size_t vertexCount = vertices.size() / VERTEX_FLOATS;
+    if (triangleCount == 0) return 0;
+
+    // ========== 硬边界 ==========
+    std::vector<unsigned char> misses(triangleCount);
+    FifoCache cache(vertexCount, ANALYZE_CACHE_SIZE);
+    for (size_t t = 0; t < triangleCount; t++) {
+        const unsigned int* tri = &indices[t * 3];
+        misses[t] = (unsigned char)(cache.Miss(tri[0]) + cache.Miss(tri[1]) + cache.Miss(tri[2]));
+    }
+
+    // ========== 软边界：clusterStart 为各簇的起始三角形 ==========
+    std::vector<size_t> clusterStart;
+    for (size_t start = 0; start < triangleCount;) {
+        size_t end = start + 1;
+        unsigned int hardMisses = misses[start];
+        while (end < triangleCount && misses[end] != 3) hardMisses += misses[end++];
+        float limit = (float)hardMisses / (end - start) * threshold;
+
+        cache.Reset();
+        size_t subStart = start;
+        unsigned int subMisses = 0;
+        clusterStart.push_back(start);
+        for (size_t t = start; t < end; t++) {
+            const unsigned int* tri = &indices[t * 3];
+            subMisses += cache.Miss(tri[0]) + cache.Miss(tri[1]) + cache.Miss(tri[2]);
+            if (t + 1 < end && (float)subMisses / (t + 1 - subStart) <= limit) {
+                clusterStart.push_back(t + 1);
+                subStart = t + 1;
+                subMisses = 0;
+                cache.Reset();
+            }
+        }
+        start = end;
+    }
+    const size_t clusterCount = clusterStart.size();
+    clusterStart.push_back(triangleCount);
+    if (clusterCount == 1) return 1;
+
+    // ========== 各簇与整个网格的中心、法线 ==========
+    std::vector<float> clusterData(clusterCount * 7, 0.0f);  // 中心×面积(3) 法线×面积(3) 面积(1)
+    float meshCenter[3] = { 0.0f, 0.0f, 0.0f };
+    float meshArea = 0.0f;
+    for (size_t c = 0; c < clusterCount; c++) {
+        float* data = &clusterData[c * 7];
+        for (size_t t = clusterStart[c]; t < clusterStart[c + 1]; t++) {
+            float normal[3], centroid[3];
+            TriangleGeometry(vertices, &indices[t * 3], normal, centroid);
+            float area = 0.5f * sqrtf(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+            for (int k = 0; k < 3; k++) {
+                data[k] += centroid[k] * area;
+                data[3 + k] += normal[k];
+            }
+            data[6] += area;
+        }
+        for (int k = 0; k < 3; k++) meshCenter[k] += data[k];
+        meshArea += data[6];
+    }
+    if (meshArea <= 0.0f) return clusterCount;
+    for (int k = 0; k < 3; k++) meshCenter[k] /= meshArea;
+
+    std::vector<std::pair<float, size_t>> order(clusterCount);
+    for (size_t c = 0; c < clusterCount; c++) {
+        const float* data = &clusterData[c * 7];
+        float key = 0.0f;
+        float normalLength = sqrtf(data[3] * data[3] + data[4] * data[4] + data[5] * data[5]);
+        if (data[6] > 0.0f && normalLength > 0.0f) {
+            for (int k = 0; k < 3; k++) key += (data[k] / data[6] - meshCenter[k]) * data[3 + k];
+            key /= normalLength;
+        }
+        order[c] = std::make_pair(-key, c);  // 升序排序，键取负得到从大到小
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [](const std::pair<float, size_t>& a, const std::pair<float, size_t>& b) { return a.first < b.first; });
+
+    // ========== 按新顺序拼接各簇 ==========
+    std::vector<unsigned int> result;
+    result.reserve(triangleCount * 3);
+    for (size_t i = 0; i < clusterCount; i++) {
+        size_t c = order[i].second;
+        result.insert(result.end(), indices.begin() + clusterStart[c] * 3, indices.begin() + clusterStart[c + 1] * 3);
+    }
+    indices.swap(result);
+    return clusterCount;
+}
+
+/**
+ * @brief 顶点读取优化
+ * 
+ * 顶点按索引序列中首次出现的顺序编号，顶点着色器读取顶点缓冲时基本是顺序访问，
+ * 缓存行和预取都能充分利用。未被任何三角形引用的顶点不会出现在结果中。
+ */
+size_t MeshOptimizer::OptimizeVertexFetch(std::vector<float>& vertices, std::vector<unsigned int>& indices) {
+    const size_t vertexCount = vertices.size() / VERTEX_FLOATS;
+    std::vector<unsigned int> remap(vertexCount, INVALID_INDEX);
+    std::vector<float> result;
+    result.reserve(vertices.size());
+
+    unsigned int next = 0;
+    for (size_t i = 0; i < indices.size(); i++) {
+        unsigned int& v = indices[i];
+        if (remap[v] == INVALID_INDEX) {
+            remap[v] = next++;
+            result.insert(result.end(), vertices.begin() + v * VERTEX_FLOATS, vertices.begin() + (v + 1) * VERTEX_FLOATS);
+        }
+        v = remap[v];
+    }
+    vertices.swap(result);
+    return next;
+}
@@ -0,0 +1,98 @@
+﻿#pragma once
+#include "../core/Mesh3D.h"
+#include <cstddef>
+#include <vector>
+
+/**
+ * @file MeshOptimizer.h
+ * @brief 三维网格的三角形和顶点重排
+ * @author ln1.opensource@gmail.com
+ */
+
+/**
+ * @struct VertexCacheStats
+ * @brief 按先进先出顶点缓存模拟一遍索引序列得到的统计
+ * 
+ * - ACMR（平均缓存未命中率）= 变换的顶点数 / 三角形数，下限约0.5，最坏3
+ * - ATVR（平均变换顶点比）= 变换的顶点数 / 被引用的顶点数，下限1
+ */
+struct VertexCacheStats {
+    size_t triangleCount;      ///< 三角形数
+    size_t vertexCount;        ///< 被索引引用的不同顶点数
+    size_t transformedCount;   ///< 缓存未命中（需要执行顶点着色器）的次数
+    float acmr;                ///< 平均缓存未命中率
+    float atvr;                ///< 平均变换顶点比
+};
+
+/**
+ * @struct MeshOptimizeReport
+ * @brief MeshOptimizer::Optimize 前后的统计
+ */
+struct MeshOptimizeReport {
+    VertexCacheStats before;   ///< 优化前
+    VertexCacheStats after;    ///< 优化后
+    size_t clusterCount;       ///< 按遮挡排序的三角形簇数
+};
+
+/**
+ * @class MeshOptimizer
+ * @brief 为GPU顶点缓存、遮挡和顶点读取重排网格
+ * 
+ * 三个步骤依次进行，只改变三角形和顶点的顺序（以及三角形内部不影响朝向的轮换），
+ * 不改变网格的外观：
+ * 1. OptimizeVertexCache：Forsyth 线性速度顶点缓存优化，让相邻三角形共享刚变换过的顶点
+ * 2. OptimizeOverdraw：把上一步的序列切成簇，外侧、朝外的簇先画，减少被遮挡像素的着色
+ * 3. OptimizeVertexFetch：顶点按首次被引用的顺序重排，使顶点读取顺序访问内存
+ * 
+ * 时间与三角形数成线性关系（簇排序为 C log C，簇数 C 远小于三角形数）。
+ * 生成器产生的网格在上传前自动优化；其他来源的网格在调用
+ * MeshBuffers::Create 之前调用 Optimize。
+ */
+class MeshOptimizer {
+public:
+    static const unsigned int ANALYZE_CACHE_SIZE = 16;   ///< 统计时模拟的先进先出缓存大小
+    static const unsigned int OPTIMIZE_CACHE_SIZE = 32;  ///< Forsyth 算法打分用的LRU缓存大小
+
+    /**
+     * @brief 依次执行顶点缓存、遮挡和顶点读取优化
+     * @param mesh 已填充 vertices 和 indices 的网格（每顶点8个float）
+     * @return 优化前后的统计
+     * 
+     * 只修改CPU端数组，已创建的缓冲对象需要重新调用 MeshBuffers::Create 上传。
+     */
+    static MeshOptimizeReport Optimize(Mesh3D& mesh);
+
+    /**
+     * @brief 模拟先进先出顶点缓存，统计 ACMR 和 ATVR
+     * @param indices 三角形索引
+     * @param vertexCount 顶点数
+     * @param cacheSize 缓存大小
+     */
+    static VertexCacheStats AnalyzeVertexCache(const std::vector<unsigned int>& indices, size_t vertexCount,
+                                               unsigned int cacheSize = ANALYZE_CACHE_SIZE);
+
+    /**
+     * @brief Forsyth 顶点缓存优化：重排三角形顺序
+     * @param indices 三角形索引（原地重排）
+     * @param vertexCount 顶点数
+     */
+    static void OptimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount);
+
+    /**
+     * @brief 遮挡优化：把三角形序列切成簇，按簇朝外的程度排序
+     * @param indices 已做过顶点缓存优化的三角形索引（原地重排）
+     * @param vertices 顶点数据，每顶点8个float
+     * @param threshold 允许的 ACMR 增幅（1.05 表示最多比输入差5%）
+     * @return 簇数
+     */
+    static size_t OptimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<float>& vertices,
+                                   float threshold = 1.05f);
+
+    /**
+     * @brief 顶点读取优化：顶点按首次被引用的顺序重排并改写索引
+     * @param vertices 顶点数据，每顶点8个float（原地重排，未被引用的顶点被删除）
+     * @param indices 三角形索引（原地改写）
+     * @return 重排后的顶点数
+     */
+    static size_t OptimizeVertexFetch(std::vector<float>& vertices, std::vector<unsigned int>& indices);
+};
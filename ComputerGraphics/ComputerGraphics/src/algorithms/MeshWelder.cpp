@@ -0,0 +1,205 @@
+﻿/**
+ * @file MeshWelder.cpp
+ * @brief 三维网格的顶点焊接实现
+ * @author ln1.opensource@gmail.com
+ * 
+ * 【空间哈希】
+ * 位置按容差 ε 划分为边长 ε 的立方体单元，单元坐标 floor(p / ε) 散列为64位键。
+ * 与 p 的各分量差值都不超过 ε 的点只可能落在 p 所在单元或其相邻的26个单元中，
+ * 因此每个顶点只需检查27个单元里已登记的代表顶点。
+ * 不同单元散列到同一个键时只会多比较几个顶点，不影响结果。
+ * 单元坐标限制在 ±2^60 以内，极大的坐标（或NaN）不会在转换为整数时溢出，
+ * 只是落入同一个边界单元。
+ * 
+ * 位置容差为0时只合并位置完全相同的顶点，单元坐标直接取各分量的位模式
+ * （+0与-0视为相同），只需检查本单元。
+ */
+
+#include "MeshWelder.h"
+#include "../diagnostics/Log.h"
+#include "../diagnostics/Profiler.h"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+
+const size_t VERTEX_FLOATS = 8;   // 每顶点的float数
+const unsigned int NO_VERTEX = ~0u;
+
+const double CELL_LIMIT = 1152921504606846976.0;   // 2^60，单元坐标的上下限
+
+uint64_t CellKey(long long x, long long y, long long z) {
+    return (uint64_t)x * 0x9E3779B97F4A7C15ull ^ (uint64_t)y * 0xC2B2AE3D27D4EB4Full ^ (uint64_t)z * 0x165667B19E3779F9ull;
+}
+
+/**
+ * @brief 坐标所在单元的整数坐标，限制在 [-CELL_LIMIT, CELL_LIMIT] 内（NaN取下限）
+ */
+long long CellIndex(float value, float cellSize) {
+    double cell = floor((double)value / cellSize);
+    if (!(cell >= -CELL_LIMIT)) cell = -CELL_LIMIT;
+    if (cell > CELL_LIMIT) cell = CELL_LIMIT;
+    return (long long)cell;
+}
+
+/**
+ * @brief 坐标的位模式，+0与-0取相同的值
+ */
+long long ExactCell(float value) {
+    if (value == 0.0f) return 0;
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return (long long)bits;
+}
+
+/**
+ * @brief 两个顶点是否在容差内相同
+ * @param cosNormal 法线夹角余弦的下限（忽略法线时小于-1）
+ */
+bool SameVertex(const float* a, const float* b, const WeldTolerance& tolerance, float cosNormal) {
+    for (int k = 0; k < 3; k++)
+        if (fabsf(a[k] - b[k]) > tolerance.position) return false;
+
+    if (tolerance.texCoord >= 0.0f) {
+        if (fabsf(a[6] - b[6]) > tolerance.texCoord || fabsf(a[7] - b[7]) > tolerance.texCoord) return false;
+    }
+
+    if (tolerance.normalAngle >= 0.0f) {
+        float dot = a[3] * b[3] + a[4] * b[4] + a[5] * b[5];
+        float lengths = sqrtf((a[3] * a[3] + a[4] * a[4] + a[5] * a[5]) * (b[3] * b[3] + b[4] * b[4] + b[5] * b[5]));
+        if (lengths > 0.0f) return dot >= cosNormal * lengths;
+        return a[3] == b[3] && a[4] == b[4] && a[5] == b[5];
+    }
+    return true;
+}
+
+bool SamePosition(const float* a, const float* b, float tolerance) {
+    return fabsf(a[0] - b[0]) <= tolerance && fabsf(a[1] - b[1]) <= tolerance && fabsf(a[2] - b[2]) <= tolerance;
+}
+
+} // namespace
+
+/**
+ * @brief 焊接网格
+ * 
+ * 先合并顶点，再删除因此（或本来就）面积为零的三角形；
+ * 删除三角形后不再被引用的顶点留给 MeshOptimizer::OptimizeVertexFetch 清理。
+ */
+WeldReport MeshWelder::Weld(Mesh3D& mesh, const WeldTolerance& tolerance, std::vector<unsigned int>* remap) {
+    PROFILE_FUNCTION();
+    WeldReport report;
+    report.verticesBefore = mesh.vertices.size() / VERTEX_FLOATS;
+    report.trianglesBefore = mesh.indices.size() / 3;
+
+    std::vector<unsigned int> table;
+    size_t uniqueCount = BuildRemap(mesh.vertices, tolerance, table);
+    ApplyRemap(mesh.vertices, mesh.indices, table, uniqueCount);
+    RemoveDegenerateTriangles(mesh.vertices, mesh.indices, tolerance.position > 0.0f ? tolerance.position : 0.0f);
+
+    report.verticesAfter = uniqueCount;
+    report.trianglesAfter = mesh.indices.size() / 3;
+    if (remap) remap->swap(table);
+
+    LOG_DEBUG("顶点焊接: 顶点 %zu -> %zu, 三角形 %zu -> %zu",
+              report.verticesBefore, report.verticesAfter, report.trianglesBefore, report.trianglesAfter);
+    return report;
+}
+
+size_t MeshWelder::BuildRemap(const std::vector<float>& vertices, const WeldTolerance& tolerance,
+                              std::vector<unsigned int>& remap) {
+    const size_t vertexCount = vertices.size() / VERTEX_FLOATS;
+    remap.assign(vertexCount, NO_VERTEX);
+
+    // 位置容差为0时按位模式分组，只需检查本单元
+    const bool exact = !(tolerance.position > 0.0f);
+    const float cellSize = exact ? 1.0f : tolerance.position;
+    const int neighbourCells = exact ? 1 : 27;
+    const float cosNormal = tolerance.normalAngle >= 0.0f ? cosf(tolerance.normalAngle * (float)M_PI / 180.0f) : -2.0f;
+    WeldTolerance limits = tolerance;
+    if (limits.position < 0.0f) limits.position = 0.0f;
+
+    // 每个单元的代表顶点链表：cellHead 为链表头，nextInCell 为同一单元的下一个代表顶点
+    std::unordered_map<uint64_t, unsigned int> cellHead;
+    cellHead.reserve(vertexCount);
+    std::vector<unsigned int> nextInCell(vertexCount, NO_VERTEX);
+
+    unsigned int uniqueCount = 0;
+    for (size_t v = 0; v < vertexCount; v++) {
+        const float* p = &vertices[v * VERTEX_FLOATS];
+        long long cell[3];
+        for (int k = 0; k < 3; k++) cell[k] = exact ? ExactCell(p[k]) : CellIndex(p[k], cellSize);
+
+        // 重复顶点绝大多数与代表落在同一单元，先查本单元
+        unsigned int match = NO_VERTEX;
+        for (int n = 0; n < neighbourCells && match == NO_VERTEX; n++) {
+            int offset = (n + 13) % 27;  // 13 对应偏移 (0, 0, 0)
+            std::unordered_map<uint64_t, unsigned int>::const_iterator it =
+                cellHead.find(CellKey(cell[0] + offset / 9 - 1, cell[1] + offset / 3 % 3 - 1, cell[2] + offset % 3 - 1));
+            if (it == cellHead.end()) continue;
+            for (unsigned int r = it->second; r != NO_VERTEX; r = nextInCell[r]) {
+                if (SameVertex(p, &vertices[r * VERTEX_FLOATS], limits, cosNormal)) {
+                    match = r;
+                    break;
+                }
+            }
+        }
+
+        if (match != NO_VERTEX) {
+            remap[v] = remap[match];
+        } else {
+            remap[v] = uniqueCount++;
+            unsigned int& head = cellHead.insert(std::make_pair(CellKey(cell[0], cell[1], cell[2]), NO_VERTEX)).first->second;
+            nextInCell[v] = head;
+            head = (unsigned int)v;
+        }
+    }
+    return uniqueCount;
+}
+
+/**
+ * @brief 按映射表重排顶点和索引
+ * 
+ * 新下标按代表顶点首次出现的顺序递增，顺序扫描时遇到下一个新下标的就是它的代表顶点。
+ */
+void MeshWelder::ApplyRemap(std::vector<float>& vertices, std::vector<unsigned int>& indices,
+                            const std::vector<unsigned int>& remap, size_t uniqueCount) {
+    std::vector<float> result;
+    result.reserve(uniqueCount * VERTEX_FLOATS);
+    unsigned int next = 0;
+    for (size_t v = 0; v < remap.size(); v++) {
+        if (remap[v] == next) {
+            result.insert(result.end(), vertices.begin() + v * VERTEX_FLOATS, vertices.begin() + (v + 1) * VERTEX_FLOATS);
+            next++;
+        }
+    }
+    vertices.swap(result);
+
+    for (size_t i = 0; i < indices.size(); i++) indices[i] = remap[indices[i]];
+}
+
+size_t MeshWelder::RemoveDegenerateTriangles(const std::vector<float>& vertices, std::vector<unsigned int>& indices,
+                                             float positionTolerance) {
+    const size_t triangleCount = indices.size() / 3;
+    size_t kept = 0;
+    for (size_t t = 0; t < triangleCount; t++) {
+        unsigned int i0 = indices[t * 3], i1 = indices[t * 3 + 1], i2 = indices[t * 3 + 2];
+        const float* a = &vertices[i0 * VERTEX_FLOATS];
+        const float* b = &vertices[i1 * VERTEX_FLOATS];
+        const float* c = &vertices[i2 * VERTEX_FLOATS];
+        if (SamePosition(a, b, positionTolerance) || SamePosition(b, c, positionTolerance) ||
+            SamePosition(c, a, positionTolerance))
+            continue;
+        indices[kept * 3] = i0;
+        indices[kept * 3 + 1] = i1;
+        indices[kept * 3 + 2] = i2;
+        kept++;
+    }
+    indices.resize(kept * 3);
+    return triangleCount - kept;
+}
@@ -0,0 +1,100 @@
+﻿#pragma once
+#include "../core/Mesh3D.h"
+#include <cstddef>
+#include <vector>
+
+/**
+ * @file MeshWelder.h
+ * @brief 三维网格的顶点焊接（合并重复顶点）
+ * @author ln1.opensource@gmail.com
+ */
+
+/**
+ * @struct WeldTolerance
+ * @brief 两个顶点被视为同一个顶点的容差
+ * 
+ * 三个属性都在容差内才合并，因此法线不同的硬边和纹理坐标不同的接缝都会保留。
+ * 位置容差为0时要求位置完全相同；法线或纹理坐标的容差取负值表示忽略该属性
+ * （例如不贴纹理的网格可以忽略纹理坐标，把接缝两侧的顶点也合并起来）。
+ */
+struct WeldTolerance {
+    float position;      ///< 位置各分量的最大差值（模型空间单位）
+    float normalAngle;   ///< 法线的最大夹角（度）
+    float texCoord;      ///< 纹理坐标各分量的最大差值
+
+    WeldTolerance() : position(1e-5f), normalAngle(1.0f), texCoord(1e-5f) {}
+    WeldTolerance(float positionTolerance, float normalAngleDegrees, float texCoordTolerance)
+        : position(positionTolerance), normalAngle(normalAngleDegrees), texCoord(texCoordTolerance) {}
+};
+
+/**
+ * @struct WeldReport
+ * @brief MeshWelder::Weld 前后的顶点数和三角形数
+ */
+struct WeldReport {
+    size_t verticesBefore;    ///< 焊接前的顶点数
+    size_t verticesAfter;     ///< 焊接后的顶点数
+    size_t trianglesBefore;   ///< 焊接前的三角形数
+    size_t trianglesAfter;    ///< 删除退化三角形后的三角形数
+};
+
+/**
+ * @class MeshWelder
+ * @brief 基于空间哈希的顶点焊接
+ * 
+ * 位置按容差划分网格单元，每个顶点只与所在单元及相邻26个单元中已登记的顶点比较，
+ * 期望时间与顶点数成线性关系。焊接不改变任何三角形的外观：
+ * 合并的顶点在容差内相同，删除的三角形面积为零（有两个角点位置重合）。
+ * 
+ * 生成器产生的网格在重排（MeshOptimizer）之前自动焊接；
+ * 其他来源的网格依次调用 Weld、MeshOptimizer::Optimize 和 MeshBuffers::Create。
+ */
+class MeshWelder {
+public:
+    /**
+     * @brief 焊接网格的重复顶点并删除退化三角形
+     * @param mesh 已填充 vertices 和 indices 的网格（每顶点8个float）
+     * @param tolerance 合并容差
+     * @param remap 可选，输出旧顶点下标到新顶点下标的映射表
+     * @return 焊接前后的统计
+     * 
+     * 只修改CPU端数组，已创建的缓冲对象需要重新上传。
+     */
+    static WeldReport Weld(Mesh3D& mesh, const WeldTolerance& tolerance = WeldTolerance(),
+                           std::vector<unsigned int>* remap = nullptr);
+
+    /**
+     * @brief 计算顶点的合并映射表
+     * @param vertices 顶点数据，每顶点8个float
+     * @param tolerance 合并容差
+     * @param remap 输出，remap[i] 为顶点 i 合并后的新下标；新下标按代表顶点首次出现的顺序编号
+     * @return 合并后的顶点数
+     * 
+     * 每个新顶点以第一个落入它的旧顶点为代表，后续顶点与代表比较（不做传递合并），
+     * 因此合并后的顶点与其代表的差值不超过容差。
+     */
+    static size_t BuildRemap(const std::vector<float>& vertices, const WeldTolerance& tolerance,
+                             std::vector<unsigned int>& remap);
+
+    /**
+     * @brief 按映射表重排顶点和索引
+     * @param vertices 顶点数据（原地替换为 uniqueCount 个代表顶点）
+     * @param indices 三角形索引（原地改写）
+     * @param remap BuildRemap 得到的映射表
+     * @param uniqueCount 合并后的顶点数
+     */
+    static void ApplyRemap(std::vector<float>& vertices, std::vector<unsigned int>& indices,
+                           const std::vector<unsigned int>& remap, size_t uniqueCount);
+
+    /**
+     * @brief 删除有两个角点位置重合（差值不超过容差）的三角形
+     * @param vertices 顶点数据，每顶点8个float
+     * @param indices 三角形索引（原地删除）
+     * @param positionTolerance 位置容差
+     * @return 删除的三角形数
+     * 
+     * 例如经纬球两极的一圈三角形中有一半的两个角点都落在极点上，面积为零。
+     */
+    static size_t RemoveDegenerateTriangles(const std::vector<float>& vertices, std::vector<unsigned int>& indices,
+                                            float positionTolerance);
+};
@@ -0,0 +1,397 @@
+﻿/**
+ * @file NurbsCurve.cpp
+ * @brief NURBS曲线求值算法实现
+ * @author ln1.opensource@gmail.com
+ * 
+ * 本文件实现了NURBS曲线的求值和展平：
+ * 1. 节点区间查找（二分查找）
+ * 2. 齐次坐标下的de Boor递推，四个参数一组用SSE2同时求值
+ * 3. 按节点区间逐段采样，每段只建立一次区间缓存
+ */
+
+#include "NurbsCurve.h"
+#include <cmath>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#include <emmintrin.h>
+#define NURBS_CURVE_SSE2 1
+#endif
+
+// 展平时单个节点区间的最大采样步数
+static const int MAX_FLATTEN_STEPS = 256;
+
+// ============================================================================
+// 节点向量与参数检查
+// ============================================================================
+
+/**
+ * @brief 生成端点插值（clamped）的均匀节点向量
+ * @param controlCount 控制点个数
+ * @param degree 曲线次数
+ * @param knots 输出的节点向量
+ * 
+ * 首尾各有 degree+1 个重复节点，中间节点均匀分布在(0,1)内，
+ * 使曲线经过首末控制点
+ */
+void NurbsCurve::MakeClampedKnots(int controlCount, int degree, std::vector<double>& knots) {
+    knots.clear();
+    if (controlCount < degree + 1 || degree < 1) return;
+
+    int knotCount = controlCount + degree + 1;
+    int interior = controlCount - degree;   // 非空节点区间个数
+    knots.reserve(knotCount);
+    for (int i = 0; i < knotCount; i++) {
+        if (i <= degree)
+            knots.push_back(0.0);
+        else if (i >= controlCount)
+            knots.push_back(1.0);
+        else
+            knots.push_back((double)(i - degree) / interior);
+    }
+}
+
+/**
+ * @brief 检查NURBS曲线参数是否合法
+ * 
+ * 合法条件：
+ * - 1 <= degree <= MAX_DEGREE，且控制点个数不少于 degree+1
+ * - 权重为空或与控制点个数相同且全部为正
+ * - 节点向量为空或长度为 n+p+1 且单调不减，有效参数区间非空
+ */
+bool NurbsCurve::IsValid(const std::vector<Point2D>& controlPoints, const std::vector<double>& weights,
+                         const std::vector<double>& knots, int degree) {
+    int n = (int)controlPoints.size();
+    if (degree < 1 || degree > MAX_DEGREE || n < degree + 1) return false;
+
+    if (!weights.empty()) {
+        if ((int)weights.size() != n) return false;
+        for (double w : weights)
+            if (!(w > 0.0)) return false;
+    }
+
+    if (!knots.empty()) {
+        if ((int)knots.size() != n + degree + 1) return false;
+        for (size_t i = 1; i < knots.size(); i++)
+            if (knots[i] < knots[i-1]) return false;
+        if (!(knots[degree] < knots[n])) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 查找参数所在的节点区间
+ * 
+ * 在有效区间 [knots[p], knots[n]] 内二分查找，
+ * 参数等于终点时归入最后一个非空区间，保证曲线终点可以求值
+ */
+int NurbsCurve::FindKnotSpan(const std::vector<double>& knots, int degree, int controlCount, double t) {
+    int n = controlCount;
+    if (t >= knots[n]) {
+        int k = n - 1;
+        while (k > degree && knots[k] >= knots[n]) k--;
+        return k;
+    }
+    if (t <= knots[degree]) {
+        int k = degree;
+        while (k < n - 1 && knots[k + 1] <= knots[degree]) k++;
+        return k;
+    }
+
+    int low = degree, high = n;
+    int mid = (low + high) / 2;
+    while (t < knots[mid] || t >= knots[mid + 1]) {
+        if (t < knots[mid]) high = mid;
+        else low = mid;
+        mid = (low + high) / 2;
+    }
+    return mid;
+}
+
+// ============================================================================
+// 求值
+// ============================================================================
+
+/**
+ * @brief 在指定参数处求值（单点）
+ * 
+ * 建立区间缓存后按单个参数调用批量求值（走双精度逐点路径），供偶尔的单点查询使用；
+ * 密集采样请使用Flatten，以便区间缓存在整段内复用。
+ * 先用 IsValid 检查参数，节点向量、权重长度不符时不会越界访问。
+ */
+void NurbsCurve::Evaluate(const std::vector<Point2D>& controlPoints, const std::vector<double>& weights,
+                          const std::vector<double>& knots, int degree, double t,
+                          double& outX, double& outY) {
+    if (!IsValid(controlPoints, weights, knots, degree)) {
+        outX = controlPoints.empty() ? 0.0 : controlPoints[0].x;
+        outY = controlPoints.empty() ? 0.0 : controlPoints[0].y;
+        return;
+    }
+
+    int n = (int)controlPoints.size();
+    std::vector<double> clampedKnots;
+    if (knots.empty()) MakeClampedKnots(n, degree, clampedKnots);
+    const std::vector<double>& U = knots.empty() ? clampedKnots : knots;
+
+    SpanCache cache;
+    BuildSpanCache(U, degree, FindKnotSpan(U, degree, n, t), cache);
+    EvaluateBatch(controlPoints, weights, cache, &t, 1, &outX, &outY);
+}
+
+/**
+ * @brief 按容差展平NURBS曲线为折线
+ * 
+ * 【算法步骤】
+ * 1. 检查参数，节点向量为空时生成clamped均匀节点
+ * 2. 遍历每个非空节点区间 [a, b) = [knots[k], knots[k+1])：
+ *    a. 建立该区间的求值缓存（区间下标与节点差倒数）
+ *    b. 由二阶导数上界求出初始采样步数
+ *    c. 连同每条弦的参数中点一起按LANES个一组批量求值，
+ *       有中点偏离弦超过容差时步数加倍重新采样
+ * 3. 采样点四舍五入为像素坐标，与上一点重合则跳过
+ * 
+ * 【步数估计】
+ * 参数步长为h的弦与二阶连续曲线的最大偏差不超过 (1/8)·M·h²，M为区间内 |C''(t)| 的上界，
+ * 因此步数取 n = ceil( (b - a) · sqrt( M / (8 · tolerance) ) )。
+ * 非有理曲线的M由 SecondDerivativeBound 精确给出（含 p(p-1) 因子和节点差缩放）；
+ * 有理曲线再乘以局部权重的最大/最小比值作为估计，不足之处由中点检查补足。
+ */
+void NurbsCurve::Flatten(const std::vector<Point2D>& controlPoints, const std::vector<double>& weights,
+                         const std::vector<double>& knots, int degree, double tolerance,
+                         std::vector<Point2D>& outPoints) {
+    outPoints.clear();
+    if (!IsValid(controlPoints, weights, knots, degree)) {
+        outPoints = controlPoints;
+        return;
+    }
+
+    int n = (int)controlPoints.size();
+    std::vector<double> clampedKnots;
+    const std::vector<double>* kv = &knots;
+    if (knots.empty()) {
+        MakeClampedKnots(n, degree, clampedKnots);
+        kv = &clampedKnots;
+    }
+    const std::vector<double>& U = *kv;
+
+    SpanCache cache;
+    std::vector<double> xs, ys;
+    bool first = true;
+
+    for (int k = degree; k < n; k++) {
+        double a = U[k], b = U[k + 1];
+        if (!(a < b)) continue;   // 跳过重节点形成的空区间
+
+        BuildSpanCache(U, degree, k, cache);
+
+        int steps = MAX_FLATTEN_STEPS;
+        if (tolerance > 0.0) {
+            double maxSecond = SecondDerivativeBound(controlPoints, U, degree, k);
+            if (!weights.empty()) {
+                double wMin = weights[k - degree], wMax = wMin;
+                for (int i = k - degree + 1; i <= k; i++) {
+                    if (weights[i] < wMin) wMin = weights[i];
+                    if (weights[i] > wMax) wMax = weights[i];
+                }
+                maxSecond *= wMax / wMin;
+            }
+            double estimate = ceil((b - a) * sqrt(maxSecond / (8.0 * tolerance)));
+            steps = estimate < 1.0 ? 1 : (estimate > MAX_FLATTEN_STEPS ? MAX_FLATTEN_STEPS : (int)estimate);
+        }
+
+        // 采样点（偶数下标）和弦的参数中点（奇数下标）一起求值，
+        // 有中点偏离弦超过容差时步数加倍，直到满足容差或达到上限
+        for (;;) {
+            SampleSpan(controlPoints, weights, cache, a, b, 2 * steps, xs, ys);
+            if (tolerance <= 0.0 || steps >= MAX_FLATTEN_STEPS) break;
+            bool within = true;
+            for (int s = 0; s < steps && within; s++) {
+                double x0 = xs[2 * s], y0 = ys[2 * s];
+                double ex = xs[2 * s + 2] - x0, ey = ys[2 * s + 2] - y0;
+                double mx = xs[2 * s + 1] - x0, my = ys[2 * s + 1] - y0;
+                double len2 = ex * ex + ey * ey;
+                double u = len2 > 0.0 ? (mx * ex + my * ey) / len2 : 0.0;
+                if (u < 0.0) u = 0.0;
+                if (u > 1.0) u = 1.0;
+                double dx = mx - u * ex, dy = my - u * ey;
+                within = dx * dx + dy * dy <= tolerance * tolerance;
+            }
+            if (within) break;
+            steps = steps * 2 > MAX_FLATTEN_STEPS ? MAX_FLATTEN_STEPS : steps * 2;
+        }
+
+        // 输出采样点（首段包含起点）
+        for (int s = first ? 0 : 1; s <= steps; s++) {
+            Point2D pt((int)floor(xs[2 * s] + 0.5), (int)floor(ys[2 * s] + 0.5));
+            if (!outPoints.empty() && outPoints.back() == pt) continue;
+            outPoints.push_back(pt);
+        }
+        first = false;
+    }
+}
+
+// ============================================================================
+// 私有辅助方法
+// ============================================================================
+
+/**
+ * @brief 非有理曲线在节点区间k内二阶导数模的上界
+ * 
+ * p次B样条的一阶导数是 p-1 次B样条，控制点 Q1(i) = p·(P(i+1) - P(i)) / (u(i+p+1) - u(i+1))；
+ * 二阶导数是 p-2 次B样条，控制点 Q2(i) = (p-1)·(Q1(i+1) - Q1(i)) / (u(i+p+1) - u(i+2))。
+ * 区间k只受 Q2(k-p)..Q2(k-2) 影响，基函数非负且和为1，二阶导数的模不超过它们的最大模。
+ * 节点差为0的项对应的基函数恒为0，按0处理。
+ */
+double NurbsCurve::SecondDerivativeBound(const std::vector<Point2D>& controlPoints, const std::vector<double>& knots,
+                                         int degree, int span) {
+    const int p = degree;
+    double maxSecond = 0.0;
+    for (int i = span - p; i <= span - 2; i++) {
+        double d0 = knots[i + p + 1] - knots[i + 1];
+        double d1 = knots[i + p + 2] - knots[i + 2];
+        double d2 = knots[i + p + 1] - knots[i + 2];
+        if (d2 <= 0.0) continue;
+        double q0x = d0 > 0.0 ? (controlPoints[i + 1].x - controlPoints[i].x) / d0 : 0.0;
+        double q0y = d0 > 0.0 ? (controlPoints[i + 1].y - controlPoints[i].y) / d0 : 0.0;
+        double q1x = d1 > 0.0 ? (controlPoints[i + 2].x - controlPoints[i + 1].x) / d1 : 0.0;
+        double q1y = d1 > 0.0 ? (controlPoints[i + 2].y - controlPoints[i + 1].y) / d1 : 0.0;
+        double sx = p * (p - 1) * (q1x - q0x) / d2;
+        double sy = p * (p - 1) * (q1y - q0y) / d2;
+        double m = sqrt(sx * sx + sy * sy);
+        if (m > maxSecond) maxSecond = m;
+    }
+    return maxSecond;
+}
+
+/**
+ * @brief 在节点区间 [a, b] 内等参数采样 count+1 个点
+ * 
+ * 参数按LANES个一组交给 EvaluateBatch，凑不满一组的尾部按实际个数传入；
+ * 最后一个参数取b本身，避免舍入落到下一个区间
+ */
+void NurbsCurve::SampleSpan(const std::vector<Point2D>& controlPoints, const std::vector<double>& weights,
+                            const SpanCache& cache, double a, double b, int count,
+                            std::vector<double>& xs, std::vector<double>& ys) {
+    xs.resize(count + 1);
+    ys.resize(count + 1);
+    double params[LANES];
+    int s = 0;
+    while (s <= count) {
+        int start = s, lanes = 0;
+        while (lanes < LANES && s <= count) {
+            params[lanes++] = (s == count) ? b : a + (b - a) * s / count;
+            s++;
+        }
+        EvaluateBatch(controlPoints, weights, cache, params, lanes, &xs[start], &ys[start]);
+    }
+}
+
+/**
+ * @brief 为指定节点区间建立求值缓存
+ * 
+ * de Boor递推第r层第j项的插值系数为
+ *   alpha = (t - knots[k-p+j]) / (knots[k+1+j-r] - knots[k-p+j])
+ * 分母只与区间有关，这里一次性求出倒数；重节点导致分母为0时记为0
+ */
+void NurbsCurve::BuildSpanCache(const std::vector<double>& knots, int degree, int span, SpanCache& cache) {
+    cache.span = span;
+    cache.degree = degree;
+    for (int j = 0; j <= degree; j++)
+        cache.leftKnot[j] = knots[span - degree + j];
+    for (int r = 1; r <= degree; r++) {
+        for (int j = r; j <= degree; j++) {
+            double denom = knots[span + 1 + j - r] - knots[span - degree + j];
+            cache.invDenom[r][j] = denom != 0.0 ? 1.0 / denom : 0.0;
+        }
+    }
+}
+
+/**
+ * @brief 在同一节点区间内批量求值
+ * 
+ * 【算法原理】
+ * NURBS曲线 C(t) = Σ N(i,p)(t)·w(i)·P(i) / Σ N(i,p)(t)·w(i)
+ * 将控制点提升为齐次坐标 (w·x, w·y, w) 后，即可用普通B样条的de Boor算法求值，
+ * 最后除以齐次分量得到平面坐标。
+ * 
+ * 【算法步骤】
+ * 1. 取该区间影响的 p+1 个控制点，转换为齐次坐标，复制到每个通道
+ * 2. 对 r = 1..p，j = p..r：
+ *    d[j] = (1 - alpha) * d[j-1] + alpha * d[j]
+ *    alpha 由各通道的参数值和缓存的节点差倒数求出
+ * 3. 结果为 d[p] 的齐次坐标除以权重分量
+ * 
+ * 【SSE2路径】
+ * 参数凑满LANES个时，四个参数放在一个 __m128 的四个通道里，每步递推是四通道同时的乘加。
+ * 单精度下先减去区间第一个控制点作为局部原点，坐标量级只与曲线尺寸有关，
+ * 误差远小于展平容差；不足LANES个的尾部和无SSE2的平台逐点按双精度求值。
+ */
+void NurbsCurve::EvaluateBatch(const std::vector<Point2D>& controlPoints, const std::vector<double>& weights,
+                               const SpanCache& cache, const double* t, int count,
+                               double* outX, double* outY) {
+    const int p = cache.degree;
+    const int base = cache.span - p;
+
+#ifdef NURBS_CURVE_SSE2
+    if (count == LANES) {
+        const double ox = controlPoints[base].x, oy = controlPoints[base].y;
+        __m128 tv = _mm_set_ps((float)t[3], (float)t[2], (float)t[1], (float)t[0]);
+        __m128 dx[MAX_DEGREE + 1], dy[MAX_DEGREE + 1], dw[MAX_DEGREE + 1];
+
+        // 步骤1：齐次控制点（相对局部原点），广播到四个通道
+        for (int j = 0; j <= p; j++) {
+            double w = weights.empty() ? 1.0 : weights[base + j];
+            dx[j] = _mm_set1_ps((float)((controlPoints[base + j].x - ox) * w));
+            dy[j] = _mm_set1_ps((float)((controlPoints[base + j].y - oy) * w));
+            dw[j] = _mm_set1_ps((float)w);
+        }
+
+        // 步骤2：de Boor递推，d[j] = d[j-1] + alpha * (d[j] - d[j-1])
+        for (int r = 1; r <= p; r++) {
+            for (int j = p; j >= r; j--) {
+                __m128 alpha = _mm_mul_ps(_mm_sub_ps(tv, _mm_set1_ps((float)cache.leftKnot[j])),
+                                          _mm_set1_ps((float)cache.invDenom[r][j]));
+                dx[j] = _mm_add_ps(dx[j-1], _mm_mul_ps(alpha, _mm_sub_ps(dx[j], dx[j-1])));
+                dy[j] = _mm_add_ps(dy[j-1], _mm_mul_ps(alpha, _mm_sub_ps(dy[j], dy[j-1])));
+                dw[j] = _mm_add_ps(dw[j-1], _mm_mul_ps(alpha, _mm_sub_ps(dw[j], dw[j-1])));
+            }
+        }
+
+        // 步骤3：透视除法，加回局部原点
+        float xs[LANES], ys[LANES];
+        _mm_storeu_ps(xs, _mm_div_ps(dx[p], dw[p]));
+        _mm_storeu_ps(ys, _mm_div_ps(dy[p], dw[p]));
+        for (int l = 0; l < LANES; l++) {
+            outX[l] = ox + xs[l];
+            outY[l] = oy + ys[l];
+        }
+        return;
+    }
+#endif
+
+    for (int l = 0; l < count; l++) {
+        double dx[MAX_DEGREE + 1], dy[MAX_DEGREE + 1], dw[MAX_DEGREE + 1];
+
+        // 步骤1：齐次控制点
+        for (int j = 0; j <= p; j++) {
+            double w = weights.empty() ? 1.0 : weights[base + j];
+            dx[j] = controlPoints[base + j].x * w;
+            dy[j] = controlPoints[base + j].y * w;
+            dw[j] = w;
+        }
+
+        // 步骤2：de Boor递推
+        for (int r = 1; r <= p; r++) {
+            for (int j = p; j >= r; j--) {
+                double alpha = (t[l] - cache.leftKnot[j]) * cache.invDenom[r][j];
+                double beta = 1.0 - alpha;
+                dx[j] = beta * dx[j-1] + alpha * dx[j];
+                dy[j] = beta * dy[j-1] + alpha * dy[j];
+                dw[j] = beta * dw[j-1] + alpha * dw[j];
+            }
+        }
+
+        // 步骤3：透视除法
+        outX[l] = dx[p] / dw[p];
+        outY[l] = dy[p] / dw[p];
+    }
+}
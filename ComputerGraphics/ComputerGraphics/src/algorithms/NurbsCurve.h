@@ -0,0 +1,136 @@
+﻿#pragma once
+#include "../core/Point2D.h"
+#include <vector>
+
+/**
+ * @file NurbsCurve.h
+ * @brief NURBS曲线求值算法类定义
+ * @author ln1.opensource@gmail.com
+ */
+
+/**
+ * @class NurbsCurve
+ * @brief NURBS（非均匀有理B样条）曲线求值实现类
+ * 
+ * 使用de Boor算法在齐次坐标下求值，支持非均匀节点向量和控制点权重。
+ * 采样按节点区间逐段进行：
+ * - 每段的节点区间下标和de Boor递推所需的节点差倒数只计算一次
+ * - 同一段内的参数值按LANES个一组，用SSE2单精度四通道同时递推；
+ *   不足一组的尾部和无SSE2的平台逐点按双精度求值
+ * 所有方法都是静态方法，可以直接调用而无需实例化
+ */
+class NurbsCurve {
+public:
+    static const int LANES = 4;        ///< 批量求值的通道数（一次同时求值的参数个数）
+    static const int MAX_DEGREE = 7;   ///< 支持的最高次数
+
+    /**
+     * @brief 生成端点插值（clamped）的均匀节点向量
+     * @param controlCount 控制点个数
+     * @param degree 曲线次数
+     * @param knots 输出的节点向量，长度为 controlCount + degree + 1
+     */
+    static void MakeClampedKnots(int controlCount, int degree, std::vector<double>& knots);
+
+    /**
+     * @brief 检查NURBS曲线参数是否合法
+     * @param controlPoints 控制点序列
+     * @param weights 控制点权重（为空表示全部为1）
+     * @param knots 节点向量（为空表示使用clamped均匀节点）
+     * @param degree 曲线次数
+     * @return 参数合法返回true
+     */
+    static bool IsValid(const std::vector<Point2D>& controlPoints, const std::vector<double>& weights,
+                        const std::vector<double>& knots, int degree);
+
+    /**
+     * @brief 查找参数所在的节点区间
+     * @param knots 节点向量
+     * @param degree 曲线次数
+     * @param controlCount 控制点个数
+     * @param t 参数值
+     * @return 满足 knots[k] <= t < knots[k+1] 的下标k（t为终点时返回最后一个非空区间）
+     */
+    static int FindKnotSpan(const std::vector<double>& knots, int degree, int controlCount, double t);
+
+    /**
+     * @brief 在指定参数处求值（单点）
+     * @param controlPoints 控制点序列
+     * @param weights 控制点权重（为空表示全部为1）
+     * @param knots 节点向量（为空表示使用clamped均匀节点）
+     * @param degree 曲线次数
+     * @param t 参数值
+     * @param outX 输出x坐标
+     * @param outY 输出y坐标
+     * 
+     * 参数不合法（见 IsValid）时输出第一个控制点，没有控制点时输出原点
+     */
+    static void Evaluate(const std::vector<Point2D>& controlPoints, const std::vector<double>& weights,
+                         const std::vector<double>& knots, int degree, double t,
+                         double& outX, double& outY);
+
+    /**
+     * @brief 按容差展平NURBS曲线为折线
+     * @param controlPoints 控制点序列
+     * @param weights 控制点权重（为空表示全部为1）
+     * @param knots 节点向量（为空表示使用clamped均匀节点）
+     * @param degree 曲线次数
+     * @param tolerance 展平容差（折线与曲线的最大偏差，单位与坐标相同，不含输出时的取整）
+     * @param outPoints 输出的折线顶点（会先被清空）
+     * 
+     * 参数不合法时输出控制点本身（即绘制控制多边形）
+     */
+    static void Flatten(const std::vector<Point2D>& controlPoints, const std::vector<double>& weights,
+                        const std::vector<double>& knots, int degree, double tolerance,
+                        std::vector<Point2D>& outPoints);
+
+private:
+    /**
+     * @struct SpanCache
+     * @brief 单个节点区间的de Boor求值缓存
+     * 
+     * 同一节点区间内，de Boor递推中的节点差 knots[i+p-r+1] - knots[i] 与参数无关，
+     * 预先求出其倒数，求值时只剩乘加运算
+     */
+    struct SpanCache {
+        int span;                                          ///< 节点区间下标k
+        int degree;                                        ///< 曲线次数p
+        double leftKnot[MAX_DEGREE + 1];                   ///< knots[k-p+j]，j=0..p
+        double invDenom[MAX_DEGREE + 1][MAX_DEGREE + 1];   ///< [r][j] 节点差的倒数
+    };
+
+    /**
+     * @brief 非有理曲线在节点区间k内二阶导数模的上界
+     * 
+     * 二阶导数是 p-2 次B样条，其控制点含 p(p-1) 因子和节点差的缩放，
+     * 由凸包性质，区间内的二阶导数不超过这些控制点的最大模
+     */
+    static double SecondDerivativeBound(const std::vector<Point2D>& controlPoints, const std::vector<double>& knots,
+                                        int degree, int span);
+
+    /**
+     * @brief 在节点区间 [a, b] 内等参数采样 count+1 个点（批量求值）
+     */
+    static void SampleSpan(const std::vector<Point2D>& controlPoints, const std::vector<double>& weights,
+                           const SpanCache& cache, double a, double b, int count,
+                           std::vector<double>& xs, std::vector<double>& ys);
+
+    /**
+     * @brief 为指定节点区间建立求值缓存
+     */
+    static void BuildSpanCache(const std::vector<double>& knots, int degree, int span, SpanCache& cache);
+
+    /**
+     * @brief 在同一节点区间内批量求值
+     * @param controlPoints 控制点序列
+     * @param weights 控制点权重（为空表示全部为1）
+     * @param cache 节点区间缓存
+     * @param t 参数值数组（长度为count，均位于该节点区间内）
+     * @param count 参数个数（1..LANES，等于LANES时走SSE2路径）
+     * @param outX 输出x坐标数组
+     * @param outY 输出y坐标数组
+     */
+    static void EvaluateBatch(const std::vector<Point2D>& controlPoints, const std::vector<double>& weights,
+                              const SpanCache& cache, const double* t, int count,
+                              double* outX, double* outY);
+};
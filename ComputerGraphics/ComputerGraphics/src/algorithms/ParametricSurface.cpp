@@ -0,0 +1,421 @@
+﻿/**
+ * @file ParametricSurface.cpp
+ * @brief 参数曲面的网格生成实现
+ * @author ln1.opensource@gmail.com
+ * 
+ * 【轮廓行】
+ * 旋转体由一串轮廓行描述：行半径 r、行高度 y、法线的径向/轴向分量 (nr, ny) 和纹理坐标。
+ * 行内第j个顶点为 (r·X[j], y, r·Z[j])，法线为 (nr·NX[j], ny, nr·NZ[j])，
+ * 旋转体的 X、Z、NX、NZ 都是 SinCosTable 的 cos/sin 表。
+ * 轮廓自上而下（球体从北极到南极，圆柱从顶面中心经侧面到底面中心），
+ * 相邻两行之间按固定的顺序连成三角形，从外侧看为逆时针；
+ * 盖子与侧面之间法线不连续，盖子的行不与相邻的侧面行相连，边缘顶点各自独立。
+ * 
+ * 【超二次曲面】
+ * x = a·C(η)^ε1·C(θ)^ε2，y = b·S(η)^ε1，z = a·C(η)^ε1·S(θ)^ε2（C^ε、S^ε 为带符号幂），
+ * 法线 ∝ (C(η)^(2-ε1)·C(θ)^(2-ε2)/a, S(η)^(2-ε1)/b, C(η)^(2-ε1)·S(θ)^(2-ε2)/a)。
+ * 两者都能分解为 "行因子 × 列因子"，列因子每次生成算一遍，行内只做乘法，法线逐顶点归一化。
+ * 
+ * 【行的SIMD展开】
+ * 每次取4列，用SSE算出 x、y、z、nx 和 ny、nz、u、v 共8个4元向量，
+ * 两次4×4转置后正好是4个顶点的交错布局 [x y z nx | ny nz u v]，直接写入顶点数组。
+ */
+
+#include "ParametricSurface.h"
+#include <cmath>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#include <emmintrin.h>
+#define PARAMETRIC_SURFACE_SSE2 1
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+
+const size_t VERTEX_FLOATS = 8;   // 每顶点的float数
+const int MIN_SEGMENTS = 3;
+
+/**
+ * @struct TableCache
+ * @brief 进程内所有 SinCosTable 的缓存
+ */
+struct TableCache {
+    std::mutex mutex;
+    std::map<int, std::unique_ptr<SinCosTable>> tables;
+};
+
+TableCache& Cache() {
+    static TableCache cache;
+    return cache;
+}
+
+/**
+ * @struct ProfileRow
+ * @brief 轮廓上的一行（一圈纬线）
+ */
+struct ProfileRow {
+    float radius;        ///< 行半径
+    float y;             ///< 行高度
+    float normalRadius;  ///< 法线的径向分量（乘以列因子）
+    float normalY;       ///< 法线的轴向分量
+    float v;             ///< 侧面的纵向纹理坐标
+    float capTexRadius;  ///< 不小于0时为盖子，纹理坐标取 (0.5 + t·cosθ, 0.5 + t·sinθ)；小于0时 u = j/segments
+    bool joinPrevious;   ///< 是否与上一行连成三角形
+};
+
+/**
+ * @struct RowColumns
+ * @brief 行内各列共用的因子，每个数组有 segments+1 项
+ */
+struct RowColumns {
+    const float* x;      ///< 位置的X因子
+    const float* z;      ///< 位置的Z因子
+    const float* nx;     ///< 法线的X因子
+    const float* nz;     ///< 法线的Z因子
+    const float* u;      ///< 侧面的横向纹理坐标
+    bool normalize;      ///< 法线是否需要逐顶点归一化（超二次曲面）
+};
+
+void AddRow(std::vector<ProfileRow>& rows, float radius, float y, float normalRadius, float normalY,
+            float v, bool joinPrevious) {
+    ProfileRow row = { radius, y, normalRadius, normalY, v, -1.0f, joinPrevious };
+    rows.push_back(row);
+}
+
+void AddCapRow(std::vector<ProfileRow>& rows, float radius, float y, float normalY,
+               float capTexRadius, bool joinPrevious) {
+    ProfileRow row = { radius, y, 0.0f, normalY, 0.0f, capTexRadius, joinPrevious };
+    rows.push_back(row);
+}
+
+/**
+ * @brief 带符号幂 sign(x)·|x|^e，x为0时返回0
+ */
+float SignedPow(float x, float e) {
+    if (x == 0.0f) return 0.0f;
+    return x < 0.0f ? -powf(-x, e) : powf(x, e);
+}
+
+/**
+ * @brief 圆柱、圆锥的盖子：中心行和边缘行
+ * @param top true为顶面（中心→边缘），false为底面（边缘→中心），两种顺序都使三角形朝外
+ */
+void AddCap(std::vector<ProfileRow>& rows, float radius, float y, bool top) {
+    float normalY = top ? 1.0f : -1.0f;
+    if (top) {
+        AddCapRow(rows, 0.0f, y, normalY, 0.0f, false);
+        AddCapRow(rows, radius, y, normalY, 0.5f, true);
+    } else {
+        AddCapRow(rows, radius, y, normalY, 0.5f, false);
+        AddCapRow(rows, 0.0f, y, normalY, 0.0f, true);
+    }
+}
+
+/**
+ * @brief 按曲面类型生成轮廓行
+ */
+void BuildProfile(const ParametricSurface& s, int rings, std::vector<ProfileRow>& rows) {
+    float halfHeight = 0.5f * s.height;
+    switch (s.shape) {
+        case PARAMETRIC_SPHERE: {
+            // φ = πi/rings 取自 2×rings 分段的表
+            const SinCosTable& table = SinCosTable::Get(2 * rings);
+            for (int i = 0; i <= rings; i++) {
+                float sinPhi = table.Sin()[i], cosPhi = table.Cos()[i];
+                AddRow(rows, s.radius * sinPhi, s.radius * cosPhi, sinPhi, cosPhi, (float)i / rings, i > 0);
+            }
+            break;
+        }
+        case PARAMETRIC_CYLINDER:
+            AddCap(rows, s.radius, halfHeight, true);
+            for (int i = 0; i <= rings; i++)
+                AddRow(rows, s.radius, halfHeight - s.height * i / rings, 1.0f, 0.0f, (float)i / rings, i > 0);
+            AddCap(rows, s.radius, -halfHeight, false);
+            break;
+        case PARAMETRIC_CONE: {
+            // 侧面法线处处与母线垂直：(h, r) / √(h² + r²)
+            float slant = sqrtf(s.height * s.height + s.radius * s.radius);
+            float normalRadius = slant > 0.0f ? s.height / slant : 1.0f;
+            float normalY = slant > 0.0f ? s.radius / slant : 0.0f;
+            for (int i = 0; i <= rings; i++) {
+                float t = (float)i / rings;
+                AddRow(rows, s.radius * t, halfHeight - s.height * t, normalRadius, normalY, t, i > 0);
+            }
+            AddCap(rows, s.radius, -halfHeight, false);
+            break;
+        }
+        case PARAMETRIC_TORUS: {
+            // 管截面角 φ = -2πi/rings：从外侧赤道向下绕一圈，与球体的行方向一致
+            const SinCosTable& table = SinCosTable::Get(rings);
+            for (int i = 0; i <= rings; i++) {
+                float cosPhi = table.Cos()[i], sinPhi = -table.Sin()[i];
+                AddRow(rows, s.radius + s.minorRadius * cosPhi, s.minorRadius * sinPhi, cosPhi, sinPhi,
+                       (float)i / rings, i > 0);
+            }
+            break;
+        }
+        case PARAMETRIC_CAPSULE: {
+            // 半球的角度步长为 (π/2)/rings，取自 4×rings 分段的表；纵向纹理坐标按弧长分配
+            const SinCosTable& table = SinCosTable::Get(4 * rings);
+            float arc = 0.5f * (float)M_PI * s.radius;
+            float total = 2.0f * arc + s.height;
+            float vScale = total > 0.0f ? 1.0f / total : 0.0f;
+            for (int i = 0; i <= rings; i++) {
+                float sinPhi = table.Sin()[i], cosPhi = table.Cos()[i];
+                AddRow(rows, s.radius * sinPhi, halfHeight + s.radius * cosPhi, sinPhi, cosPhi,
+                       arc * i / rings * vScale, i > 0);
+            }
+            // 中间圆柱段高度为0时下半球的第一行与上半球的最后一行重合，直接跳过
+            for (int i = s.height > 0.0f ? 0 : 1; i <= rings; i++) {
+                float sinA = table.Sin()[i], cosA = table.Cos()[i];
+                AddRow(rows, s.radius * cosA, -halfHeight - s.radius * sinA, cosA, -sinA,
+                       (arc + s.height + arc * i / rings) * vScale, true);
+            }
+            break;
+        }
+        case PARAMETRIC_SUPERQUADRIC: {
+            // 纬度 η = π/2 - πi/rings：cos η = sin(πi/rings)，sin η = cos(πi/rings)
+            const SinCosTable& table = SinCosTable::Get(2 * rings);
+            float e1 = s.exponents[0];
+            float a = s.radius, b = halfHeight;
+            for (int i = 0; i <= rings; i++) {
+                float cosEta = table.Sin()[i], sinEta = table.Cos()[i];
+                AddRow(rows, a * SignedPow(cosEta, e1), b * SignedPow(sinEta, e1),
+                       SignedPow(cosEta, 2.0f - e1) / a, SignedPow(sinEta, 2.0f - e1) / b,
+                       (float)i / rings, i > 0);
+            }
+            break;
+        }
+    }
+}
+
+/**
+ * @brief 写出一行的 count 个顶点（交错布局，每顶点8个float）
+ */
+void EmitRow(float* out, const ProfileRow& row, const RowColumns& col, int count) {
+    bool cap = row.capTexRadius >= 0.0f;
+    int j = 0;
+#ifdef PARAMETRIC_SURFACE_SSE2
+    const __m128 radius = _mm_set1_ps(row.radius);
+    const __m128 normalRadius = _mm_set1_ps(row.normalRadius);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 capTex = _mm_set1_ps(row.capTexRadius);
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (; j + 4 <= count; j += 4) {
+        __m128 cx = _mm_loadu_ps(col.x + j), cz = _mm_loadu_ps(col.z + j);
+        __m128 x = _mm_mul_ps(radius, cx);
+        __m128 y = _mm_set1_ps(row.y);
+        __m128 z = _mm_mul_ps(radius, cz);
+        __m128 nx = _mm_mul_ps(normalRadius, _mm_loadu_ps(col.nx + j));
+        __m128 ny = _mm_set1_ps(row.normalY);
+        __m128 nz = _mm_mul_ps(normalRadius, _mm_loadu_ps(col.nz + j));
+        if (col.normalize) {
+            __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, nx), _mm_mul_ps(ny, ny)),
+                                                   _mm_mul_ps(nz, nz)));
+            __m128 inverse = _mm_div_ps(one, length);
+            nx = _mm_mul_ps(nx, inverse);
+            ny = _mm_mul_ps(ny, inverse);
+            nz = _mm_mul_ps(nz, inverse);
+        }
+        __m128 u, v;
+        if (cap) {
+            u = _mm_add_ps(half, _mm_mul_ps(capTex, cx));
+            v = _mm_add_ps(half, _mm_mul_ps(capTex, cz));
+        } else {
+            u = _mm_loadu_ps(col.u + j);
+            v = _mm_set1_ps(row.v);
+        }
+        _MM_TRANSPOSE4_PS(x, y, z, nx);
+        _MM_TRANSPOSE4_PS(ny, nz, u, v);
+        float* dst = out + (size_t)j * VERTEX_FLOATS;
+        _mm_storeu_ps(dst, x);      _mm_storeu_ps(dst + 4, ny);
+        _mm_storeu_ps(dst + 8, y);  _mm_storeu_ps(dst + 12, nz);
+        _mm_storeu_ps(dst + 16, z); _mm_storeu_ps(dst + 20, u);
+        _mm_storeu_ps(dst + 24, nx); _mm_storeu_ps(dst + 28, v);
+    }
+#endif
+    for (; j < count; j++) {
+        float nx = row.normalRadius * col.nx[j], ny = row.normalY, nz = row.normalRadius * col.nz[j];
+        if (col.normalize) {
+            float inverse = 1.0f / sqrtf(nx * nx + ny * ny + nz * nz);
+            nx *= inverse; ny *= inverse; nz *= inverse;
+        }
+        float* dst = out + (size_t)j * VERTEX_FLOATS;
+        dst[0] = row.radius * col.x[j];
+        dst[1] = row.y;
+        dst[2] = row.radius * col.z[j];
+        dst[3] = nx; dst[4] = ny; dst[5] = nz;
+        dst[6] = cap ? 0.5f + row.capTexRadius * col.x[j] : col.u[j];
+        dst[7] = cap ? 0.5f + row.capTexRadius * col.z[j] : row.v;
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// SinCosTable
+// ============================================================================
+
+/**
+ * @brief 计算 segments+1 项的余弦/正弦
+ * 
+ * 用双精度计算后舍入为float；落在坐标轴上的角度（4k 是 segments 的倍数）取精确的0和±1，
+ * 极点的行半径因此严格为0，首尾两项也完全相同。
+ */
+SinCosTable::SinCosTable(int segmentCount)
+    : segments(segmentCount), cosines(segmentCount + 1), sines(segmentCount + 1) {
+    static const float AXIS_COS[4] = { 1.0f, 0.0f, -1.0f, 0.0f };
+    static const float AXIS_SIN[4] = { 0.0f, 1.0f, 0.0f, -1.0f };
+    for (int k = 0; k <= segments; k++) {
+        if ((4 * k) % segments == 0) {
+            int quadrant = (4 * k / segments) % 4;
+            cosines[k] = AXIS_COS[quadrant];
+            sines[k] = AXIS_SIN[quadrant];
+        } else {
+            double angle = 2.0 * M_PI * k / segments;
+            cosines[k] = (float)cos(angle);
+            sines[k] = (float)sin(angle);
+        }
+    }
+}
+
+const SinCosTable& SinCosTable::Get(int segments) {
+    if (segments < 1) segments = 1;
+    TableCache& cache = Cache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    std::unique_ptr<SinCosTable>& table = cache.tables[segments];
+    if (!table) table.reset(new SinCosTable(segments));
+    return *table;
+}
+
+// ============================================================================
+// ParametricSurface
+// ============================================================================
+
+namespace {
+
+ParametricSurface MakeSurface(ParametricShape shape, float radius, float height, int segments, int rings) {
+    ParametricSurface s;
+    s.shape = shape;
+    s.radius = radius;
+    s.height = height;
+    s.minorRadius = 0.0f;
+    s.exponents[0] = s.exponents[1] = 1.0f;
+    s.segments = segments;
+    s.rings = rings;
+    return s;
+}
+
+} // namespace
+
+ParametricSurface ParametricSurface::Sphere(float radius, int segments, int rings) {
+    return MakeSurface(PARAMETRIC_SPHERE, radius, 2.0f * radius, segments, rings);
+}
+
+ParametricSurface ParametricSurface::Cylinder(float radius, float height, int segments, int rings) {
+    return MakeSurface(PARAMETRIC_CYLINDER, radius, height, segments, rings);
+}
+
+ParametricSurface ParametricSurface::Cone(float radius, float height, int segments, int rings) {
+    return MakeSurface(PARAMETRIC_CONE, radius, height, segments, rings);
+}
+
+ParametricSurface ParametricSurface::Torus(float radius, float minorRadius, int segments, int rings) {
+    ParametricSurface s = MakeSurface(PARAMETRIC_TORUS, radius, 2.0f * minorRadius, segments, rings);
+    s.minorRadius = minorRadius;
+    return s;
+}
+
+ParametricSurface ParametricSurface::Capsule(float radius, float height, int segments, int rings) {
+    return MakeSurface(PARAMETRIC_CAPSULE, radius, height, segments, rings);
+}
+
+ParametricSurface ParametricSurface::Superquadric(float radius, float height, float latitudeExponent,
+                                                  float longitudeExponent, int segments, int rings) {
+    ParametricSurface s = MakeSurface(PARAMETRIC_SUPERQUADRIC, radius, height, segments, rings);
+    s.exponents[0] = latitudeExponent;
+    s.exponents[1] = longitudeExponent;
+    return s;
+}
+
+// ============================================================================
+// SurfaceTessellator
+// ============================================================================
+
+/**
+ * @brief 生成参数曲面的顶点和索引
+ * 
+ * 1. 按类型生成轮廓行（行数与纵向分段数成正比，行因子只算一次）
+ * 2. 准备列因子：旋转体直接引用缓存的 cos/sin 表，超二次曲面算一遍带符号幂
+ * 3. 逐行展开顶点（EmitRow），顶点数组一次分配到位
+ * 4. 相连的两行之间每个四边形分成2个三角形，半径为0的一侧只生成1个
+ */
+void SurfaceTessellator::Tessellate(Mesh3D& mesh, const ParametricSurface& surface) {
+    int segments = surface.segments < MIN_SEGMENTS ? MIN_SEGMENTS : surface.segments;
+    int minRings = (surface.shape == PARAMETRIC_TORUS) ? 3
+                 : (surface.shape == PARAMETRIC_SPHERE || surface.shape == PARAMETRIC_SUPERQUADRIC) ? 2 : 1;
+    int rings = surface.rings < minRings ? minRings : surface.rings;
+
+    std::vector<ProfileRow> rows;
+    rows.reserve(rings * 2 + 6);
+    BuildProfile(surface, rings, rows);
+
+    // ========== 列因子 ==========
+    int columns = segments + 1;
+    const SinCosTable& table = SinCosTable::Get(segments);
+    std::vector<float> texU(columns);
+    for (int j = 0; j < columns; j++) texU[j] = (float)j / segments;
+
+    RowColumns col = { table.Cos(), table.Sin(), table.Cos(), table.Sin(), texU.data(), false };
+    std::vector<float> superColumns;
+    if (surface.shape == PARAMETRIC_SUPERQUADRIC) {
+        float e2 = surface.exponents[1];
+        superColumns.resize((size_t)columns * 4);
+        float* px = &superColumns[0];
+        float* pz = px + columns;
+        float* pnx = pz + columns;
+        float* pnz = pnx + columns;
+        for (int j = 0; j < columns; j++) {
+            px[j] = SignedPow(table.Cos()[j], e2);
+            pz[j] = SignedPow(table.Sin()[j], e2);
+            pnx[j] = SignedPow(table.Cos()[j], 2.0f - e2);
+            pnz[j] = SignedPow(table.Sin()[j], 2.0f - e2);
+        }
+        col.x = px; col.z = pz; col.nx = pnx; col.nz = pnz;
+        col.normalize = true;
+    }
+
+    // ========== 顶点 ==========
+    mesh.vertices.resize(rows.size() * columns * VERTEX_FLOATS);
+    for (size_t r = 0; r < rows.size(); r++)
+        EmitRow(&mesh.vertices[r * columns * VERTEX_FLOATS], rows[r], col, columns);
+
+    // ========== 索引 ==========
+    // 上一行的 a、c 与本行的 b、d 组成四边形，三角形 (a, c, b) 和 (c, d, b) 从外侧看为逆时针
+    size_t triangleCount = 0;
+    for (size_t r = 1; r < rows.size(); r++) {
+        if (!rows[r].joinPrevious) continue;
+        triangleCount += (rows[r - 1].radius != 0.0f ? segments : 0) + (rows[r].radius != 0.0f ? segments : 0);
+    }
+    mesh.indices.resize(triangleCount * 3);
+    unsigned int* out = mesh.indices.data();
+    for (size_t r = 1; r < rows.size(); r++) {
+        if (!rows[r].joinPrevious) continue;
+        bool upperPoint = rows[r - 1].radius == 0.0f;
+        bool lowerPoint = rows[r].radius == 0.0f;
+        unsigned int upper = (unsigned int)((r - 1) * columns);
+        unsigned int lower = (unsigned int)(r * columns);
+        for (int j = 0; j < segments; j++) {
+            unsigned int a = upper + j, c = a + 1;
+            unsigned int b = lower + j, d = b + 1;
+            if (!upperPoint) { out[0] = a; out[1] = c; out[2] = b; out += 3; }
+            if (!lowerPoint) { out[0] = c; out[1] = d; out[2] = b; out += 3; }
+        }
+    }
+}
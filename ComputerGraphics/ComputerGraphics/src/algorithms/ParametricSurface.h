@@ -0,0 +1,97 @@
+﻿#pragma once
+#include "../core/Mesh3D.h"
+#include <vector>
+
+/**
+ * @file ParametricSurface.h
+ * @brief 参数曲面（旋转体与超二次曲面）的网格生成
+ * @author ln1.opensource@gmail.com
+ */
+
+/**
+ * @class SinCosTable
+ * @brief 按分段数缓存的正弦/余弦表
+ * 
+ * 第k项为角度 2πk/segments 的余弦和正弦，共 segments+1 项（首尾相同，便于生成接缝处的重复顶点）。
+ * 同一分段数的表在进程内只计算一次，之后所有生成函数共享；
+ * 表一旦建立就不再释放，返回的引用始终有效。可以在多个线程中同时调用 Get。
+ */
+class SinCosTable {
+public:
+    /**
+     * @brief 取得分段数对应的表（不存在时计算）
+     * @param segments 分段数，至少为1
+     */
+    static const SinCosTable& Get(int segments);
+
+    int Segments() const { return segments; }
+    const float* Cos() const { return cosines.data(); }   ///< cos(2πk/segments)，k ∈ [0, segments]
+    const float* Sin() const { return sines.data(); }     ///< sin(2πk/segments)，k ∈ [0, segments]
+
+private:
+    explicit SinCosTable(int segments);
+
+    int segments;
+    std::vector<float> cosines;
+    std::vector<float> sines;
+};
+
+/**
+ * @enum ParametricShape
+ * @brief 参数曲面的类型，均以Y轴为中心轴、以原点为中心
+ */
+enum ParametricShape {
+    PARAMETRIC_SPHERE,        ///< 球体
+    PARAMETRIC_CYLINDER,      ///< 圆柱体（带顶面和底面）
+    PARAMETRIC_CONE,          ///< 圆锥体（顶点朝上，带底面）
+    PARAMETRIC_TORUS,         ///< 圆环（在XZ平面内）
+    PARAMETRIC_CAPSULE,       ///< 胶囊体（圆柱两端接半球）
+    PARAMETRIC_SUPERQUADRIC   ///< 超二次椭球
+};
+
+/**
+ * @struct ParametricSurface
+ * @brief 参数曲面的形状参数和细分数
+ * 
+ * 各参数的含义随类型而定，未用到的参数忽略；请用静态工厂函数构造。
+ */
+struct ParametricSurface {
+    ParametricShape shape;  ///< 曲面类型
+    float radius;           ///< 半径；圆环为中心圆半径；超二次曲面为X/Z方向的半轴
+    float height;           ///< 圆柱、圆锥的高度，胶囊中间圆柱段的高度；超二次曲面为Y方向的全长
+    float minorRadius;      ///< 圆环的管半径
+    float exponents[2];     ///< 超二次曲面的纬向、经向形状指数（1为椭球，趋近0为方盒，2为八面体）
+    int segments;           ///< 圆周分段数
+    int rings;              ///< 纵向分段数（胶囊为每个半球的分段数，圆环为管截面的分段数）
+
+    static ParametricSurface Sphere(float radius, int segments, int rings);
+    static ParametricSurface Cylinder(float radius, float height, int segments, int rings = 1);
+    static ParametricSurface Cone(float radius, float height, int segments, int rings = 1);
+    static ParametricSurface Torus(float radius, float minorRadius, int segments, int rings);
+    static ParametricSurface Capsule(float radius, float height, int segments, int rings);
+    static ParametricSurface Superquadric(float radius, float height, float latitudeExponent,
+                                          float longitudeExponent, int segments, int rings);
+};
+
+/**
+ * @class SurfaceTessellator
+ * @brief 按行展开参数曲面的网格生成器
+ * 
+ * 所有曲面都写成 "行 × 列" 的形式：每一行是一圈纬线，行内各顶点只差一个方位角θ，
+ * 位置为 (行半径 × X(θ), 行高度, 行半径 × Z(θ))。旋转体的 X(θ)、Z(θ) 就是缓存的
+ * cos/sin 表，超二次曲面则是它们的带符号幂，每次生成只算一遍。
+ * 因此生成时不调用任何三角函数（超二次曲面的幂函数除外），每行的顶点用SSE一次算4个。
+ * 
+ * 只填充CPU端的 vertices 和 indices（每顶点8个float），三角形从外侧看为逆时针；
+ * 半径为0的行（极点、锥顶、盖子中心）不生成退化三角形，因此不需要焊接。
+ * 需要重排的网格请用 MeshGenerator::GenerateParametric，上传显存见 MeshBuffers::Create。
+ */
+class SurfaceTessellator {
+public:
+    /**
+     * @brief 生成参数曲面的顶点和索引
+     * @param mesh 输出网格（原有的 vertices 和 indices 被替换）
+     * @param surface 曲面参数，分段数过小时自动提升到最小值
+     */
+    static void Tessellate(Mesh3D& mesh, const ParametricSurface& surface);
+};
@@ -0,0 +1,340 @@
+﻿#pragma once
+#include "../core/Point2D.h"
+#include <windows.h>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+/**
+ * @file RasterCore.h
+ * @brief 基于策略模板的光栅化核心
+ * @author ln1.opensource@gmail.com
+ * 
+ * 直线、圆和扫描线填充算法的模板实现，按两个维度在编译期参数化：
+ * - 像素输出策略（Sink）：决定像素写到哪里（GDI设备，或 Framebuffer.h 中按像素格式写入的 FormatSink）
+ * - 坐标类型（Coord）：决定输入坐标的表示（int、float、double等），由ScalarTraits（Point2.h）换算到像素
+ * 
+ * 每种组合都会实例化出独立的函数，像素写入是对策略对象的内联成员调用，
+ * 不再经过逐像素的函数指针或跨编译单元调用。
+ * LineDrawer、CircleDrawer、FillAlgorithms的静态方法是这些模板的GDI包装。
+ */
+
+// ============================================================================
+// 像素输出策略
+// ============================================================================
+// 每个策略提供两个内联成员：
+//   void Plot(int x, int y)             写入单个像素
+//   void Span(int y, int x0, int x1)    写入水平区间 [x0, x1]（含两端）
+
+/**
+ * @struct GdiPixelSink
+ * @brief 写入Windows GDI设备上下文（与原有绘制行为一致）
+ */
+struct GdiPixelSink {
+    HDC hdc;          ///< 设备上下文句柄
+    COLORREF color;   ///< 像素颜色
+
+    GdiPixelSink(HDC hdc, COLORREF color) : hdc(hdc), color(color) {}
+
+    void Plot(int x, int y) { ::SetPixel(hdc, x, y, color); }
+    void Span(int y, int x0, int x1) {
+        for (int x = x0; x <= x1; x++) ::SetPixel(hdc, x, y, color);
+    }
+};
+
+/**
+ * @struct RasterSpan
+ * @brief 水平像素区间 [x0, x1]（含两端）
+ */
+struct RasterSpan {
+    int y;    ///< 所在行
+    int x0;   ///< 起始列
+    int x1;   ///< 结束列
+};
+
+// ============================================================================
+// 光栅化算法模板
+// ============================================================================
+
+/**
+ * @class RasterCore
+ * @brief 光栅化算法的模板实现
+ * 
+ * 算法步骤与LineDrawer、CircleDrawer、FillAlgorithms中的说明相同，
+ * 所有方法都是静态模板方法
+ */
+class RasterCore {
+public:
+    /**
+     * @brief DDA直线算法
+     * @param sink 像素输出策略
+     * @param x0 起点x
+     * @param y0 起点y
+     * @param x1 终点x
+     * @param y1 终点y
+     */
+    template <class Sink, typename Coord>
+    static void LineDDA(Sink& sink, Coord x0, Coord y0, Coord x1, Coord y1) {
+        // 计算x和y方向的总增量
+        double dx = ScalarTraits<Coord>::ToDouble(x1) - ScalarTraits<Coord>::ToDouble(x0);
+        double dy = ScalarTraits<Coord>::ToDouble(y1) - ScalarTraits<Coord>::ToDouble(y0);
+
+        // 确定步数：选择变化较大的方向作为主方向
+        // 这样可以保证直线的连续性，不会出现断点
+        double adx = fabs(dx), ady = fabs(dy);
+        int steps = (int)ceil(adx > ady ? adx : ady);
+
+        // 如果起点和终点重合，无需绘制
+        if (steps == 0) return;
+
+        // 计算每一步x和y的增量
+        // 主方向每步增加1（或-1），另一方向按比例增加
+        float xInc = (float)(dx / steps);  // x方向每步增量
+        float yInc = (float)(dy / steps);  // y方向每步增量
+
+        // 使用浮点数保存当前位置，以保证精度
+        float x = (float)ScalarTraits<Coord>::ToDouble(x0);
+        float y = (float)ScalarTraits<Coord>::ToDouble(y0);
+
+        // 循环绘制每个像素点
+        for (int i = 0; i <= steps; i++) {
+            // 四舍五入到最近的整数像素位置并绘制
+            // 加0.5后取整实现四舍五入效果
+            sink.Plot((int)(x + 0.5), (int)(y + 0.5));
+
+            // 更新当前位置
+            x += xInc;
+            y += yInc;
+        }
+    }
+
+    /**
+     * @brief Bresenham直线算法
+     * @param sink 像素输出策略
+     * @param x0 起点x
+     * @param y0 起点y
+     * @param x1 终点x
+     * @param y1 终点y
+     * 
+     * 端点先换算为像素坐标，之后只使用整数运算
+     */
+    template <class Sink, typename Coord>
+    static void LineBresenham(Sink& sink, Coord x0, Coord y0, Coord x1, Coord y1) {
+        // 当前绘制位置与终点
+        int x = ScalarTraits<Coord>::ToPixel(x0), y = ScalarTraits<Coord>::ToPixel(y0);
+        int xe = ScalarTraits<Coord>::ToPixel(x1), ye = ScalarTraits<Coord>::ToPixel(y1);
+
+        // 计算x和y方向的绝对增量
+        int dx = abs(xe - x);  // x方向距离（绝对值）
+        int dy = abs(ye - y);  // y方向距离（绝对值）
+
+        // 确定x和y的步进方向
+        // sx: x增加的方向，+1表示向右，-1表示向左
+        // sy: y增加的方向，+1表示向下，-1表示向上
+        int sx = x < xe ? 1 : -1;
+        int sy = y < ye ? 1 : -1;
+
+        // 初始化误差值
+        // err = dx - dy 是Bresenham算法的核心
+        // 它综合考虑了x和y两个方向的偏差
+        int err = dx - dy;
+
+        // 循环绘制直到到达终点
+        while (true) {
+            // 绘制当前像素
+            sink.Plot(x, y);
+
+            // 检查是否到达终点
+            if (x == xe && y == ye) break;
+
+            // 计算2倍误差值，用于判断步进方向
+            // 使用2*err避免浮点除法，这是算法高效的关键
+            int e2 = 2 * err;
+
+            // 判断是否需要在x方向步进
+            // 当 e2 > -dy 时，说明偏差偏向x轴，需要x步进
+            if (e2 > -dy) {
+                err -= dy;   // 更新误差值
+                x += sx;     // x方向步进
+            }
+
+            // 判断是否需要在y方向步进
+            // 当 e2 < dx 时，说明偏差偏向y轴，需要y步进
+            if (e2 < dx) {
+                err += dx;   // 更新误差值
+                y += sy;     // y方向步进
+            }
+        }
+    }
+
+    /**
+     * @brief 中点圆算法
+     * @param sink 像素输出策略
+     * @param cx 圆心x
+     * @param cy 圆心y
+     * @param radius 半径（像素）
+     */
+    template <class Sink, typename Coord>
+    static void CircleMidpoint(Sink& sink, Coord cx, Coord cy, int radius) {
+        int px = ScalarTraits<Coord>::ToPixel(cx), py = ScalarTraits<Coord>::ToPixel(cy);
+        int x = 0, y = radius;  // 从圆的最上方点(0, r)开始
+
+        // 初始决策参数 d = 1 - r
+        // 这是中点(1, r-0.5)代入圆方程的近似值
+        int d = 1 - radius;
+
+        // 只需绘制1/8圆弧（从90°到45°），利用对称性绘制完整圆
+        // 当 x > y 时，已经超过45°，停止循环
+        while (x <= y) {
+            // 利用八分对称性绘制8个点
+            PlotCirclePoints(sink, px, py, x, y);
+
+            if (d < 0) {
+                // 中点在圆内，选择正右方的点E(x+1, y)
+                // 下一个中点的决策参数增量：d_new = d + 2x + 3
+                d += 2 * x + 3;
+            } else {
+                // 中点在圆外或圆上，选择右下方的点SE(x+1, y-1)
+                // 下一个中点的决策参数增量：d_new = d + 2(x-y) + 5
+                d += 2 * (x - y) + 5;
+                y--;  // y坐标减1
+            }
+            x++;  // x坐标始终增加1
+        }
+    }
+
+    /**
+     * @brief Bresenham圆算法
+     * @param sink 像素输出策略
+     * @param cx 圆心x
+     * @param cy 圆心y
+     * @param radius 半径（像素）
+     */
+    template <class Sink, typename Coord>
+    static void CircleBresenham(Sink& sink, Coord cx, Coord cy, int radius) {
+        int px = ScalarTraits<Coord>::ToPixel(cx), py = ScalarTraits<Coord>::ToPixel(cy);
+        int x = 0, y = radius;  // 从圆的最上方点(0, r)开始
+
+        // Bresenham算法的初始决策参数
+        // d = 3 - 2r 是该算法的特征初始值
+        int d = 3 - 2 * radius;
+
+        // 只需绘制1/8圆弧，利用对称性绘制完整圆
+        while (x <= y) {
+            // 利用八分对称性绘制8个点
+            PlotCirclePoints(sink, px, py, x, y);
+
+            if (d < 0) {
+                // 选择正右方的点E(x+1, y)
+                // 决策参数增量：4x + 6
+                d += 4 * x + 6;
+            } else {
+                // 选择右下方的点SE(x+1, y-1)
+                // 决策参数增量：4(x-y) + 10
+                d += 4 * (x - y) + 10;
+                y--;  // y坐标减1
+            }
+            x++;  // x坐标始终增加1
+        }
+    }
+
+    /**
+     * @brief 扫描线多边形填充（奇偶规则）
+     * @param sink 像素输出策略
+     * @param polygon 多边形顶点序列（顶点类型需提供x、y成员）
+     * 
+     * 扫描线取整数行，交点按顶点坐标的实际精度计算后四舍五入，
+     * 因此非整数坐标的多边形不需要先取整
+     */
+    template <class Sink, class PointT>
+    static void ScanlineFill(Sink& sink, const std::vector<PointT>& polygon) {
+        typedef typename std::decay<decltype(polygon[0].x)>::type Coord;
+        // 多边形至少需要3个顶点
+        if (polygon.size() < 3) return;
+
+        // 【步骤1】找到多边形的y坐标范围
+        double yminF = ScalarTraits<Coord>::ToDouble(polygon[0].y), ymaxF = yminF;
+        for (const auto& p : polygon) {
+            double py = ScalarTraits<Coord>::ToDouble(p.y);
+            if (py < yminF) yminF = py;
+            if (py > ymaxF) ymaxF = py;
+        }
+        int ymin = (int)ceil(yminF), ymax = (int)floor(ymaxF);
+
+        // 存储当前扫描线与所有边的交点x坐标
+        std::vector<int> intersections;
+        size_t n = polygon.size();
+
+        // 【步骤2】逐条扫描线处理
+        for (int y = ymin; y <= ymax; y++) {
+            intersections.clear();
+
+            // 【步骤2a】计算扫描线与每条边的交点
+            for (size_t i = 0; i < n; i++) {
+                // 获取当前边的两个端点
+                const PointT& p1 = polygon[i];
+                const PointT& p2 = polygon[(i + 1) % n];  // 下一个顶点，形成闭合
+                double x1 = ScalarTraits<Coord>::ToDouble(p1.x), y1 = ScalarTraits<Coord>::ToDouble(p1.y);
+                double x2 = ScalarTraits<Coord>::ToDouble(p2.x), y2 = ScalarTraits<Coord>::ToDouble(p2.y);
+                // 判断扫描线是否穿过该边
+                // 使用半开区间避免顶点重复计算：[ymin, ymax)
+                if ((y1 <= y && y2 > y) || (y2 <= y && y1 > y)) {
+                    // 计算交点的x坐标（线性插值）
+                    // x = x1 + (y - y1) / (y2 - y1) * (x2 - x1)
+                    // 单精度插值，与整数坐标下的原有结果逐像素一致
+                    float x = (float)x1 + (float)(y - y1) / (float)(y2 - y1) * (float)(x2 - x1);
+                    intersections.push_back((int)(x + 0.5));  // 四舍五入
+                }
+            }
+
+            // 【步骤2b】将交点按x坐标排序
+            std::sort(intersections.begin(), intersections.end());
+
+            // 【步骤2c】两两配对填充
+            // 根据奇偶规则：第0-1对、第2-3对...之间的区域需要填充
+            for (size_t i = 0; i + 1 < intersections.size(); i += 2)
+                sink.Span(y, intersections[i], intersections[i + 1]);
+        }
+    }
+
+private:
+    /**
+     * @brief 利用圆的八分对称性输出八个对称点
+     * @param sink 像素输出策略
+     * @param cx 圆心x
+     * @param cy 圆心y
+     * @param x 相对于圆心的x偏移（第一象限45°以下的点）
+     * @param y 相对于圆心的y偏移（第一象限45°以下的点）
+     * 
+     * 【八分对称性原理】
+     * 对于圆心在原点的圆，如果(x,y)在圆上，则以下8个点都在圆上：
+     * 
+     *        (-x,y)  |  (x,y)
+     *     (-y,x)     |     (y,x)
+     *   -------------|-------------
+     *     (-y,-x)    |     (y,-x)
+     *        (-x,-y) |  (x,-y)
+     * 
+     * 这8个点分别对应圆的8个45°扇区，通过一次计算输出8个点
+     */
+    template <class Sink>
+    static void PlotCirclePoints(Sink& sink, int cx, int cy, int x, int y) {
+        // 第一象限：0°-45°区域的点 (x, y)
+        sink.Plot(cx + x, cy + y);
+        // 第二象限：135°-180°区域的点 (-x, y)
+        sink.Plot(cx - x, cy + y);
+        // 第四象限：315°-360°区域的点 (x, -y)
+        sink.Plot(cx + x, cy - y);
+        // 第三象限：180°-225°区域的点 (-x, -y)
+        sink.Plot(cx - x, cy - y);
+        // 第一象限：45°-90°区域的点 (y, x) - x和y交换
+        sink.Plot(cx + y, cy + x);
+        // 第二象限：90°-135°区域的点 (-y, x)
+        sink.Plot(cx - y, cy + x);
+        // 第四象限：270°-315°区域的点 (y, -x)
+        sink.Plot(cx + y, cy - x);
+        // 第三象限：225°-270°区域的点 (-y, -x)
+        sink.Plot(cx - y, cy - x);
+    }
+};
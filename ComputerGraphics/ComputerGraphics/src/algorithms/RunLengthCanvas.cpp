@@ -0,0 +1,144 @@
+﻿/**
+ * @file RunLengthCanvas.cpp
+ * @brief 行程编码（RLE）画布实现
+ * @author ln1.opensource@gmail.com
+ * 
+ * 本文件实现了行程列表的维护：
+ * 1. 区间写入时拆分被部分覆盖的行程、合并相邻同色行程
+ * 2. 像素读取（按行二分查找）
+ * 3. 尺寸调整与内存统计
+ */
+
+#include "RunLengthCanvas.h"
+#include <algorithm>
+
+// ============================================================================
+// 构造与尺寸
+// ============================================================================
+
+RunLengthCanvas::RunLengthCanvas() : width(0), height(0) {}
+
+RunLengthCanvas::RunLengthCanvas(int width, int height) : width(0), height(0) {
+    Resize(width, height);
+}
+
+/**
+ * @brief 改变画布尺寸
+ * 
+ * 新增的行为空（透明），宽度缩小时截断越界的行程
+ */
+void RunLengthCanvas::Resize(int w, int h) {
+    width = w > 0 ? w : 0;
+    height = h > 0 ? h : 0;
+    rows.resize(height);
+    for (auto& row : rows) {
+        while (!row.empty() && row.back().x0 >= width) row.pop_back();
+        if (!row.empty() && row.back().x1 >= width) row.back().x1 = width - 1;
+    }
+}
+
+void RunLengthCanvas::Clear() {
+    for (auto& row : rows) row.clear();
+}
+
+// ============================================================================
+// 区间写入
+// ============================================================================
+
+void RunLengthCanvas::FillSpan(int y, int x0, int x1, COLORREF color) {
+    ReplaceSpan(y, x0, x1, true, color);
+}
+
+void RunLengthCanvas::EraseSpan(int y, int x0, int x1) {
+    ReplaceSpan(y, x0, x1, false, 0);
+}
+
+/**
+ * @brief 用新行程替换区间内的原有内容
+ * 
+ * 【算法步骤】
+ * 1. 将区间裁剪到画布范围内
+ * 2. 二分查找第一个与 [x0-1, x1+1] 相交的行程（包括紧邻的行程）
+ * 3. 依次处理所有相交行程：
+ *    - 与新颜色相同：并入新行程（扩展新行程的端点）
+ *    - 颜色不同：只保留落在区间左侧和右侧的部分
+ * 4. 用"左侧残余 + 新行程 + 右侧残余"替换这些行程
+ * 
+ * 每次写入只移动该行中被替换位置之后的元素，行内行程始终有序且不重叠
+ */
+void RunLengthCanvas::ReplaceSpan(int y, int x0, int x1, bool paint, COLORREF color) {
+    if ((unsigned)y >= (unsigned)height) return;
+    if (x0 < 0) x0 = 0;
+    if (x1 >= width) x1 = width - 1;
+    if (x0 > x1) return;
+
+    std::vector<ColorRun>& row = rows[y];
+    auto first = std::lower_bound(row.begin(), row.end(), x0 - 1,
+        [](const ColorRun& r, int x) { return r.x1 < x; });
+
+    ColorRun added = { x0, x1, color };
+    ColorRun pieces[3];
+    int pieceCount = 0;
+    bool hasLeft = false, hasRight = false;
+    ColorRun left = {}, right = {};
+
+    auto last = first;
+    for (; last != row.end() && last->x0 <= x1 + 1; ++last) {
+        const ColorRun& r = *last;
+        if (paint && r.color == color) {
+            if (r.x0 < added.x0) added.x0 = r.x0;
+            if (r.x1 > added.x1) added.x1 = r.x1;
+            continue;
+        }
+        if (r.x0 < x0) {
+            left = r;
+            left.x1 = std::min(r.x1, x0 - 1);
+            hasLeft = true;
+        }
+        if (r.x1 > x1) {
+            right = r;
+            right.x0 = std::max(r.x0, x1 + 1);
+            hasRight = true;
+        }
+    }
+
+    if (hasLeft) pieces[pieceCount++] = left;
+    if (paint) pieces[pieceCount++] = added;
+    if (hasRight) pieces[pieceCount++] = right;
+
+    // 原位覆盖能复用的元素，多出或不足的部分再插入或删除
+    size_t replaced = (size_t)(last - first);
+    size_t pos = (size_t)(first - row.begin());
+    size_t common = std::min(replaced, (size_t)pieceCount);
+    for (size_t i = 0; i < common; i++) row[pos + i] = pieces[i];
+    if (replaced > common)
+        row.erase(row.begin() + pos + common, row.begin() + pos + replaced);
+    else if ((size_t)pieceCount > common)
+        row.insert(row.begin() + pos + common, pieces + common, pieces + pieceCount);
+}
+
+// ============================================================================
+// 查询
+// ============================================================================
+
+bool RunLengthCanvas::GetPixel(int x, int y, COLORREF& color) const {
+    if ((unsigned)x >= (unsigned)width || (unsigned)y >= (unsigned)height) return false;
+    const std::vector<ColorRun>& row = rows[y];
+    auto it = std::lower_bound(row.begin(), row.end(), x,
+        [](const ColorRun& r, int v) { return r.x1 < v; });
+    if (it == row.end() || it->x0 > x) return false;
+    color = it->color;
+    return true;
+}
+
+size_t RunLengthCanvas::RunCount() const {
+    size_t n = 0;
+    for (const auto& row : rows) n += row.size();
+    return n;
+}
+
+size_t RunLengthCanvas::MemoryBytes() const {
+    size_t bytes = sizeof(*this) + rows.capacity() * sizeof(std::vector<ColorRun>);
+    for (const auto& row : rows) bytes += row.capacity() * sizeof(ColorRun);
+    return bytes;
+}
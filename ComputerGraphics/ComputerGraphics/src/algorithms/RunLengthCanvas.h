@@ -0,0 +1,152 @@
+﻿#pragma once
+#include "Framebuffer.h"
+#include <windows.h>
+#include <vector>
+#include <cstdint>
+
+/**
+ * @file RunLengthCanvas.h
+ * @brief 行程编码（RLE）画布类定义
+ * @author ln1.opensource@gmail.com
+ */
+
+/**
+ * @struct ColorRun
+ * @brief 同一行上颜色相同的连续像素 [x0, x1]（含两端）
+ */
+struct ColorRun {
+    int x0;           ///< 起始列
+    int x1;           ///< 结束列
+    COLORREF color;   ///< 颜色
+};
+
+/**
+ * @class RunLengthCanvas
+ * @brief 以行程列表保存像素的稀疏画布
+ * 
+ * 每行保存一个按x递增、互不重叠的ColorRun列表，
+ * 未被任何行程覆盖的像素视为透明。
+ * 相邻且颜色相同的行程会被合并，因此大面积填充每行只占一个行程，
+ * 细线条每行只占少量行程，内存随绘制内容增长而不是随画布面积增长。
+ * 
+ * 适合作为持久化的填充图层、缓存的背景等大部分为空白的图层：
+ * - 通过RunLengthSink可直接作为RasterCore模板的输出目标
+ * - 通过DecodeTo按行程整段写入Framebuffer，或用ForEachRun整段绘制到GDI
+ */
+class RunLengthCanvas {
+public:
+    RunLengthCanvas();
+    RunLengthCanvas(int width, int height);
+
+    /**
+     * @brief 改变画布尺寸，保留范围内的已有内容
+     */
+    void Resize(int width, int height);
+
+    /**
+     * @brief 清除所有行程（全部变为透明）
+     */
+    void Clear();
+
+    int Width() const { return width; }
+    int Height() const { return height; }
+
+    /**
+     * @brief 以指定颜色填充水平区间 [x0, x1]（含两端），覆盖原有内容
+     */
+    void FillSpan(int y, int x0, int x1, COLORREF color);
+
+    /**
+     * @brief 将水平区间 [x0, x1]（含两端）恢复为透明
+     */
+    void EraseSpan(int y, int x0, int x1);
+
+    /**
+     * @brief 设置单个像素
+     */
+    void SetPixel(int x, int y, COLORREF color) { FillSpan(y, x, x, color); }
+
+    /**
+     * @brief 读取单个像素
+     * @param color 输出像素颜色
+     * @return 像素不透明时返回true
+     */
+    bool GetPixel(int x, int y, COLORREF& color) const;
+
+    /**
+     * @brief 获取一行的行程列表
+     */
+    const std::vector<ColorRun>& Row(int y) const { return rows[y]; }
+
+    /**
+     * @brief 用runs交换第y行的行程列表（y越界时不做任何事）
+     * 
+     * runs必须按x递增、互不重叠且位于画布宽度内，
+     * 撤销历史用它按行换回被修改的行，不复制整个画布
+     */
+    void SwapRow(int y, std::vector<ColorRun>& runs) {
+        if ((unsigned)y < (unsigned)height) rows[y].swap(runs);
+    }
+
+    /**
+     * @brief 所有行的行程总数
+     */
+    size_t RunCount() const;
+
+    /**
+     * @brief 行程数据占用的内存字节数（近似值）
+     */
+    size_t MemoryBytes() const;
+
+    /**
+     * @brief 按行序遍历所有行程
+     * @param fn 回调，参数为 (int y, const ColorRun& run)
+     */
+    template <class Fn>
+    void ForEachRun(Fn fn) const {
+        for (int y = 0; y < height; y++)
+            for (const ColorRun& r : rows[y]) fn(y, r);
+    }
+
+    /**
+     * @brief 将所有行程写入帧缓冲，透明像素保持不变
+     * @param target 目标帧缓冲（尺寸不必相同，超出部分被裁剪）
+     * 
+     * 每个行程只做一次颜色打包和一次区间填充
+     */
+    template <class Format>
+    void DecodeTo(Framebuffer<Format>& target) const {
+        int h = height < target.Height() ? height : target.Height();
+        for (int y = 0; y < h; y++) {
+            for (const ColorRun& r : rows[y])
+                target.FillSpan(y, r.x0, r.x1, Format::FromColor(r.color));
+        }
+    }
+
+private:
+    /**
+     * @brief 用新行程替换区间 [x0, x1] 内的原有内容
+     * @param paint 为false时只清除，不插入新行程
+     */
+    void ReplaceSpan(int y, int x0, int x1, bool paint, COLORREF color);
+
+    std::vector<std::vector<ColorRun>> rows;   ///< 每行的行程列表
+    int width;                                 ///< 宽度（像素）
+    int height;                                ///< 高度（像素）
+};
+
+/**
+ * @struct RunLengthSink
+ * @brief 写入RunLengthCanvas的输出策略（供RasterCore模板使用）
+ * 
+ * 扫描线填充输出的整段区间直接成为行程，不经过逐像素写入
+ */
+struct RunLengthSink {
+    RunLengthCanvas& canvas;   ///< 目标画布
+    COLORREF color;            ///< 像素颜色
+
+    RunLengthSink(RunLengthCanvas& canvas, COLORREF color) : canvas(canvas), color(color) {}
+
+    void Plot(int x, int y) { canvas.FillSpan(y, x, x, color); }
+    void Span(int y, int x0, int x1) { canvas.FillSpan(y, x0, x1, color); }
+};
@@ -76,6 +76,7 @@ typedef void (APIENTRY *PFNGLLINKPROGRAMPROC)(GLuint program);
 typedef void (APIENTRY *PFNGLGETPROGRAMIVPROC)(GLuint program, GLenum pname, GLint *params);
 typedef void (APIENTRY *PFNGLGETPROGRAMINFOLOGPROC)(GLuint program, GLsizei bufSize, GLsizei *length, GLchar *infoLog);
 typedef void (APIENTRY *PFNGLDELETESHADERPROC)(GLuint shader);
+typedef void (APIENTRY *PFNGLBINDATTRIBLOCATIONPROC)(GLuint program, GLuint index, const GLchar *name);
 
 // ============================================================
 // 全局函数指针
@@ -93,6 +94,7 @@ static PFNGLLINKPROGRAMPROC glLinkProgram = nullptr;         // 链接程序
 static PFNGLGETPROGRAMIVPROC glGetProgramiv = nullptr;       // 获取程序参数
 static PFNGLGETPROGRAMINFOLOGPROC glGetProgramInfoLog = nullptr; // 获取程序日志
 static PFNGLDELETESHADERPROC glDeleteShader = nullptr;       // 删除着色器对象
+static PFNGLBINDATTRIBLOCATIONPROC glBindAttribLocation = nullptr; // 绑定顶点属性位置
 
 /**
  * @brief 加载OpenGL着色器相关函数
@@ -120,12 +122,13 @@ static bool LoadShaderFunctions() {
     glGetProgramiv = (PFNGLGETPROGRAMIVPROC)wglGetProcAddress("glGetProgramiv");
     glGetProgramInfoLog = (PFNGLGETPROGRAMINFOLOGPROC)wglGetProcAddress("glGetProgramInfoLog");
     glDeleteShader = (PFNGLDELETESHADERPROC)wglGetProcAddress("glDeleteShader");
+    glBindAttribLocation = (PFNGLBINDATTRIBLOCATIONPROC)wglGetProcAddress("glBindAttribLocation");
     
     // 检查所有函数是否都成功加载
     loaded = (glCreateShader && glShaderSource && glCompileShader && 
               glGetShaderiv && glGetShaderInfoLog && glCreateProgram && 
               glAttachShader && glLinkProgram && glGetProgramiv && 
-              glGetProgramInfoLog && glDeleteShader);
+              glGetProgramInfoLog && glDeleteShader && glBindAttribLocation);
     
     return loaded;
 }
@@ -134,6 +137,8 @@ static bool LoadShaderFunctions() {
  * @brief 创建着色器程序
  * @param vertexSource 顶点着色器源代码（GLSL）
  * @param fragmentSource 片段着色器源代码（GLSL）
+ * @param attributeNames 顶点属性名数组，可为nullptr
+ * @param attributeCount 顶点属性名个数
  * @return 着色器程序ID，失败返回0
  * 
  * 【创建流程】
@@ -141,10 +146,13 @@ static bool LoadShaderFunctions() {
  * 2. 编译顶点着色器
  * 3. 编译片段着色器
  * 4. 创建程序对象
- * 5. 附加着色器并链接
+ * 5. 附加着色器，绑定顶点属性位置（如果给出）并链接
  * 6. 清理着色器对象
+ * 
+ * 绑定属性位置后，调用者可以直接按下标设置顶点属性指针，无需链接后再查询位置。
  */
-unsigned int ShaderManager::CreateShaderProgram(const char* vertexSource, const char* fragmentSource) {
+unsigned int ShaderManager::CreateShaderProgram(const char* vertexSource, const char* fragmentSource,
+                                                const char* const* attributeNames, int attributeCount) {
     // 首先加载OpenGL函数
     if (!LoadShaderFunctions()) {
         MessageBoxA(NULL, "Failed to load OpenGL shader functions", "Shader Error", MB_OK | MB_ICONERROR);
@@ -171,6 +179,11 @@ unsigned int ShaderManager::CreateShaderProgram(const char* vertexSource, const
     glAttachShader(shaderProgram, vertexShader);
     glAttachShader(shaderProgram, fragmentShader);
     
+    // 绑定顶点属性位置（必须在链接之前）
+    for (int i = 0; i < attributeCount && attributeNames; i++) {
+        glBindAttribLocation(shaderProgram, (GLuint)i, attributeNames[i]);
+    }
+    
     // 链接程序：将所有着色器组合成一个完整的渲染管线
     glLinkProgram(shaderProgram);
     
@@ -278,8 +291,8 @@ const char* ShaderManager::GetDefaultVertexShader() {
         #version 120
         
         // ========== 顶点属性输入 ==========
-        attribute vec3 aPos;       // 顶点位置（模型空间）
-        attribute vec3 aNormal;    // 顶点法线（模型空间）
+        attribute vec3 aPos;       // 顶点位置（模型空间，紧凑格式下为量化整数）
+        attribute vec3 aNormal;    // 顶点法线（模型空间，紧凑格式下为八面体编码的两个整数）
         attribute vec2 aTexCoord;  // 纹理坐标
         
         // ========== 传递给片段着色器的变量 ==========
@@ -292,15 +305,28 @@ const char* ShaderManager::GetDefaultVertexShader() {
         uniform mat4 view;         // 视图矩阵：世界空间 → 视图空间
         uniform mat4 projection;   // 投影矩阵：视图空间 → 裁剪空间
         
+        // ========== 顶点解码（见 VertexPacker） ==========
+        uniform vec3 positionScale;   // 位置 = aPos × positionScale + positionOffset
+        uniform vec3 positionOffset;
+        uniform bool octNormals;      // 法线是否为八面体编码
+        
+        vec3 DecodeNormal(vec3 n) {
+            if (!octNormals) return n;
+            vec2 e = n.xy / 32767.0;
+            vec3 v = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+            if (v.z < 0.0) v.xy = (1.0 - abs(e.yx)) * vec2(e.x >= 0.0 ? 1.0 : -1.0, e.y >= 0.0 ? 1.0 : -1.0);
+            return normalize(v);
+        }
+        
         void main() {
             // 将顶点位置变换到世界空间
             // FragPos用于片段着色器中的光照计算
-            FragPos = vec3(model * vec4(aPos, 1.0));
+            FragPos = vec3(model * vec4(aPos * positionScale + positionOffset, 1.0));
             
             // 将法线变换到世界空间
             // 注意：对于非均匀缩放，应该使用模型矩阵的逆转置矩阵
             // 这里简化处理，使用mat3(model)，适用于均匀缩放
-            Normal = mat3(model) * aNormal;
+            Normal = mat3(model) * DecodeNormal(aNormal);
             
             // 直接传递纹理坐标（不需要变换）
             TexCoord = aTexCoord;
@@ -429,3 +455,108 @@ const char* ShaderManager::GetDefaultFragmentShader() {
         }
     )";
 }
+
+/**
+ * @brief 获取实例化渲染的顶点着色器源代码
+ * @return GLSL顶点着色器代码
+ * 
+ * 【逐实例属性】
+ * 模型矩阵（4列）、法线矩阵（3列）和材质参数作为顶点属性输入，
+ * 设置了实例步进（divisor = 1）后每个实例读取一组，一次绘制调用画出整批实例。
+ * 
+ * 【顶点解码】
+ * 网格可能以紧凑格式存放（见 VertexPacker）：位置按 positionScale / positionOffset 还原，
+ * octNormals 为真时法线按八面体编码解码；float格式的网格传入缩放1、偏移0。
+ * 
+ * 【光照】
+ * 在顶点着色器中按固定管线的公式计算单光源的逐顶点光照，
+ * 光源参数直接读取固定管线状态（gl_LightSource[0]、gl_LightModel），
+ * 视图矩阵取自 gl_ModelViewMatrix，因此与固定管线逐个绘制的画面一致：
+ * - 颜色 = Ka × (全局环境光 + 光源环境光) + Kd × 光源漫反射 × max(N·L, 0)
+ *         + Ks × 光源镜面反射 × max(N·H, 0)^n（仅当 N·L > 0）
+ * - H 为半角向量（局部观察者），正反两面分别计算（双面光照）
+ */
+const char* ShaderManager::GetInstancedVertexShader() {
+    return R"(
+        #version 120
+        
+        // ========== 逐顶点属性 ==========
+        attribute vec3 aPos;          // 顶点位置（模型空间，紧凑格式下为量化整数）
+        attribute vec3 aNormal;       // 顶点法线（模型空间，紧凑格式下为八面体编码的两个整数）
+        attribute vec2 aTexCoord;     // 纹理坐标
+        
+        // ========== 逐实例属性 ==========
+        attribute vec4 iModel0;       // 模型矩阵第0列
+        attribute vec4 iModel1;       // 模型矩阵第1列
+        attribute vec4 iModel2;       // 模型矩阵第2列
+        attribute vec4 iModel3;       // 模型矩阵第3列
+        attribute vec3 iNormal0;      // 法线矩阵第0列
+        attribute vec3 iNormal1;      // 法线矩阵第1列
+        attribute vec3 iNormal2;      // 法线矩阵第2列
+        attribute vec4 iAmbient;      // 环境光反射系数
+        attribute vec4 iDiffuse;      // 漫反射系数
+        attribute vec4 iSpecular;     // 镜面反射系数（rgb）和光泽度（a）
+        
+        // ========== 顶点解码（每个批次按网格的格式设置，见 VertexPacker） ==========
+        uniform vec3 positionScale;   // 位置 = aPos × positionScale + positionOffset
+        uniform vec3 positionOffset;
+        uniform bool octNormals;      // 法线是否为八面体编码
+        
+        vec3 DecodeNormal(vec3 n) {
+            if (!octNormals) return n;
+            vec2 e = n.xy / 32767.0;
+            vec3 v = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+            if (v.z < 0.0) v.xy = (1.0 - abs(e.yx)) * vec2(e.x >= 0.0 ? 1.0 : -1.0, e.y >= 0.0 ? 1.0 : -1.0);
+            return v;
+        }
+        
+        vec4 Shade(vec3 P, vec3 N) {
+            vec3 L = normalize(gl_LightSource[0].position.xyz - P * gl_LightSource[0].position.w);
+            float NdotL = max(dot(N, L), 0.0);
+            vec3 color = iAmbient.rgb * (gl_LightModel.ambient.rgb + gl_LightSource[0].ambient.rgb)
+                       + iDiffuse.rgb * gl_LightSource[0].diffuse.rgb * NdotL;
+            if (NdotL > 0.0) {
+                vec3 H = normalize(L + normalize(-P));
+                color += iSpecular.rgb * gl_LightSource[0].specular.rgb * pow(max(dot(N, H), 0.0), iSpecular.a);
+            }
+            return vec4(color, iDiffuse.a);
+        }
+        
+        void main() {
+            mat4 model = mat4(iModel0, iModel1, iModel2, iModel3);
+            mat3 normalMatrix = mat3(iNormal0, iNormal1, iNormal2);
+            
+            // 模型空间 → 世界空间 → 眼睛空间（gl_ModelViewMatrix 此时只含视图变换）
+            vec4 eyePos = gl_ModelViewMatrix * (model * vec4(aPos * positionScale + positionOffset, 1.0));
+            vec3 eyeNormal = normalize(gl_NormalMatrix * (normalMatrix * DecodeNormal(aNormal)));
+            
+            gl_FrontColor = Shade(eyePos.xyz, eyeNormal);
+            gl_BackColor = Shade(eyePos.xyz, -eyeNormal);
+            gl_TexCoord[0] = vec4(aTexCoord, 0.0, 1.0);
+            gl_Position = gl_ProjectionMatrix * eyePos;
+        }
+    )";
+}
+
+/**
+ * @brief 获取实例化渲染的片段着色器源代码
+ * @return GLSL片段着色器代码
+ * 
+ * 光照颜色已在顶点着色器中算好，这里只做插值颜色与纹理的相乘（同 GL_MODULATE）。
+ */
+const char* ShaderManager::GetInstancedFragmentShader() {
+    return R"(
+        #version 120
+        
+        uniform int useTexture;             // 是否使用纹理
+        uniform sampler2D textureSampler;   // 纹理采样器
+        
+        void main() {
+            vec4 color = gl_Color;
+            if (useTexture != 0) {
+                color *= texture2D(textureSampler, gl_TexCoord[0].st);
+            }
+            gl_FragColor = color;
+        }
+    )";
+}
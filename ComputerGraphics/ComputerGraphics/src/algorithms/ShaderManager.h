@@ -5,14 +5,21 @@
 class ShaderManager {
 public:
     // 创建着色器程序
+    // attributeNames 非空时，第i个名字的顶点属性在链接前绑定到位置i
     static unsigned int CreateShaderProgram(
         const char* vertexSource, 
-        const char* fragmentSource);
+        const char* fragmentSource,
+        const char* const* attributeNames = nullptr,
+        int attributeCount = 0);
     
     // 获取默认着色器
     static const char* GetDefaultVertexShader();
     static const char* GetDefaultFragmentShader();
     
+    // 获取实例化渲染着色器（逐实例矩阵和材质，按固定管线公式做逐顶点光照）
+    static const char* GetInstancedVertexShader();
+    static const char* GetInstancedFragmentShader();
+    
 private:
     static unsigned int CompileShader(const char* source, unsigned int type);
     static bool CheckCompileErrors(unsigned int shader, const std::string& type);
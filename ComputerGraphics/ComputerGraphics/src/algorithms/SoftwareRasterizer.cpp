@@ -0,0 +1,570 @@
+﻿/**
+ * @file SoftwareRasterizer.cpp
+ * @brief 多线程CPU三角形光栅化器实现
+ * @author ln1.opensource@gmail.com
+ * 
+ * 本文件实现了一个分块并行的半平面（边函数）光栅化器：
+ * 1. 顶点阶段 - 按OpenGL固定管线的公式做变换与逐顶点光照
+ * 2. 裁剪阶段 - 视锥体外剔除 + 近裁剪面切割
+ * 3. 建立阶段 - 计算边函数、深度平面，按包围盒分箱到 64×64 的屏幕块
+ * 4. 光栅阶段 - 多线程按屏幕块并行，块内以 8×8 小块为单位做整块接受/拒绝
+ * 
+ * 【边函数】
+ * 对有向边 a→b，E(p) = (a.y-b.y)·p.x + (b.x-a.x)·p.y + (a.x·b.y - a.y·b.x)
+ * E(p) 是三角形 a,b,p 有向面积的2倍：p 在边的内侧时为正。
+ * 三条边的 E 同时也是未归一化的重心坐标，可直接用于插值深度和颜色。
+ * 
+ * 【为什么小块四角的测试是精确的】
+ * 采样点的 E 按 fl(fl(A·x) + fl(fl(B·y) + C)) 计算，浮点舍入对每个坐标单调，
+ * 所以小块内所有采样点的最大、最小 E 一定出现在四个角点上，
+ * 用角点做整块接受/拒绝与逐像素测试的结果完全一致。
+ */
+
+#include "SoftwareRasterizer.h"
+#include "../diagnostics/Profiler.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#include <emmintrin.h>
+#define RASTERIZER_SSE2 1
+#endif
+
+// std::min按引用接收参数，类内初始化的静态常量需要一个定义
+const int SoftwareRasterizer::TILE_SIZE;
+const int SoftwareRasterizer::BLOCK_SIZE;
+
+namespace {
+
+/**
+ * @brief 列主序矩阵乘以齐次坐标 (x, y, z, w)
+ */
+inline void TransformPoint(const Matrix4& m, float x, float y, float z, float w, float out[4]) {
+    for (int r = 0; r < 4; r++)
+        out[r] = m.m[r] * x + m.m[4 + r] * y + m.m[8 + r] * z + m.m[12 + r] * w;
+}
+
+inline void Normalize3(float v[3]) {
+    float len = sqrtf(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+    if (len > 1e-12f) { v[0] /= len; v[1] /= len; v[2] /= len; }
+}
+
+inline float Clamp01(float v) {
+    return v < 0.0f ? 0.0f : (v > 1.0f ? 1.0f : v);
+}
+
+inline uint32_t PackRGBA(float r, float g, float b) {
+    return PixelRGBA8::Pack((uint32_t)(Clamp01(r) * 255.0f + 0.5f), (uint32_t)(Clamp01(g) * 255.0f + 0.5f),
+                            (uint32_t)(Clamp01(b) * 255.0f + 0.5f), 255);
+}
+
+/**
+ * @brief 判断采样点是否被某条边覆盖（左上填充规则）
+ */
+inline bool EdgeCovers(float e, bool topLeft) {
+    return e > 0.0f || (e == 0.0f && topLeft);
+}
+
+// 视锥体外码：每一位表示在对应裁剪平面之外
+enum { OUT_LEFT = 1, OUT_RIGHT = 2, OUT_BOTTOM = 4, OUT_TOP = 8, OUT_NEAR = 16, OUT_FAR = 32 };
+
+template <typename V>
+inline int OutCode(const V& v) {
+    int code = 0;
+    if (v.x < -v.w) code |= OUT_LEFT;
+    if (v.x > v.w) code |= OUT_RIGHT;
+    if (v.y < -v.w) code |= OUT_BOTTOM;
+    if (v.y > v.w) code |= OUT_TOP;
+    if (v.z < -v.w) code |= OUT_NEAR;
+    if (v.z > v.w) code |= OUT_FAR;
+    return code;
+}
+
+} // namespace
+
+SoftwareRasterizer::SoftwareRasterizer()
+    : width(0), height(0), stride(0), tilesX(0), tilesY(0), threadCount(0), clearColor(0xFF000000u),
+      color(nullptr), generation(0), busyWorkers(0), stopping(false), nextTile(0) {
+    RasterLight defaults = {};
+    SetLight(defaults);
+}
+
+SoftwareRasterizer::~SoftwareRasterizer() {
+    StopWorkers();
+}
+
+void SoftwareRasterizer::Resize(int w, int h) {
+    width = w > 0 ? w : 0;
+    height = h > 0 ? h : 0;
+    stride = (width + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE;
+    tilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+    tilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+    depth.assign((size_t)stride * height, 1.0f);
+    bins.assign((size_t)tilesX * tilesY, std::vector<uint32_t>());
+}
+
+void SoftwareRasterizer::SetThreadCount(int count) {
+    threadCount = count > 0 ? count : 0;
+}
+
+void SoftwareRasterizer::SetClearColor(float r, float g, float b) {
+    clearColor = PackRGBA(r, g, b);
+}
+
+void SoftwareRasterizer::SetCamera(const Matrix4& viewMatrix, const Matrix4& projectionMatrix) {
+    view = viewMatrix;
+    projection = projectionMatrix;
+    SetLight(light);  // 光源位置随视图矩阵重新变换到眼睛空间
+}
+
+/**
+ * @brief 设置光源
+ * 
+ * 与固定管线在设置视图矩阵之后调用 glLightfv(GL_POSITION) 相同，
+ * 光源位置在这里一次性变换到眼睛空间，逐顶点光照都在眼睛空间中计算。
+ */
+void SoftwareRasterizer::SetLight(const RasterLight& newLight) {
+    light = newLight;
+    float eye[4];
+    TransformPoint(view, light.position[0], light.position[1], light.position[2], 1.0f, eye);
+    lightEye[0] = eye[0]; lightEye[1] = eye[1]; lightEye[2] = eye[2];
+}
+
+void SoftwareRasterizer::BeginFrame(FramebufferRGBA8& target) {
+    if (target.Width() != width || target.Height() != height)
+        Resize(target.Width(), target.Height());
+    color = &target;
+    color->Clear(clearColor);
+    std::fill(depth.begin(), depth.end(), 1.0f);
+    for (size_t i = 0; i < bins.size(); i++) bins[i].clear();
+    triangles.clear();
+}
+
+/**
+ * @brief 提交一个网格
+ * 
+ * 每个顶点只变换和光照一次（按顶点而非按三角形），
+ * 然后逐三角形做裁剪、建立和分箱。
+ * 法线矩阵取模型视图矩阵左上3×3的伴随矩阵（逆转置差一个行列式倍数，
+ * 归一化后相同），非均匀缩放下法线仍然正确，相当于开启了 GL_NORMALIZE。
+ */
+void SoftwareRasterizer::DrawMesh(const std::vector<float>& vertices, const std::vector<unsigned int>& indices,
+                                  const Matrix4& model, const RasterMaterial& material) {
+    if (width == 0 || height == 0) return;
+    const size_t vertexCount = vertices.size() / 8;
+    Matrix4 modelView = view * model;
+
+    // 伴随矩阵的各行 = 原矩阵两行的叉积；行列式为负（镜像）时翻转方向
+    const float* m = modelView.m;
+    float row[3][3] = {
+        { m[0], m[4], m[8] },
+        { m[1], m[5], m[9] },
+        { m[2], m[6], m[10] }
+    };
+    float normalMatrix[9];
+    for (int r = 0; r < 3; r++) {
+        const float* a = row[(r + 1) % 3];
+        const float* b = row[(r + 2) % 3];
+        normalMatrix[r * 3 + 0] = a[1] * b[2] - a[2] * b[1];
+        normalMatrix[r * 3 + 1] = a[2] * b[0] - a[0] * b[2];
+        normalMatrix[r * 3 + 2] = a[0] * b[1] - a[1] * b[0];
+    }
+    float det = row[0][0] * normalMatrix[0] + row[0][1] * normalMatrix[1] + row[0][2] * normalMatrix[2];
+    if (det < 0.0f)
+        for (int i = 0; i < 9; i++) normalMatrix[i] = -normalMatrix[i];
+
+    shaded.resize(vertexCount);
+    for (size_t i = 0; i < vertexCount; i++)
+        ShadeVertex(&vertices[i * 8], modelView, normalMatrix, material, shaded[i]);
+
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        unsigned int i0 = indices[i], i1 = indices[i + 1], i2 = indices[i + 2];
+        if (i0 >= vertexCount || i1 >= vertexCount || i2 >= vertexCount) continue;
+        ClipAndSetup(shaded[i0], shaded[i1], shaded[i2]);
+    }
+}
+
+/**
+ * @brief 变换并光照一个顶点
+ * 
+ * 光照公式与固定管线相同（单个点光源，无衰减，局部观察者）：
+ * color = 全局环境光·Ma + La·Ma + max(N·L,0)·Ld·Md + [N·L>0] · max(N·H,0)^s · Ls·Ms
+ * 双面光照：背面用 -N 再算一次，三角形建立时按朝向选用。
+ */
+void SoftwareRasterizer::ShadeVertex(const float* v, const Matrix4& modelView, const float normalMatrix[9],
+                                     const RasterMaterial& material, ClipVertex& out) const {
+    float eye[4];
+    TransformPoint(modelView, v[0], v[1], v[2], 1.0f, eye);
+    float clip[4];
+    TransformPoint(projection, eye[0], eye[1], eye[2], eye[3], clip);
+    out.x = clip[0]; out.y = clip[1]; out.z = clip[2]; out.w = clip[3];
+
+    float n[3];
+    for (int r = 0; r < 3; r++)
+        n[r] = normalMatrix[r * 3 + 0] * v[3] + normalMatrix[r * 3 + 1] * v[4] + normalMatrix[r * 3 + 2] * v[5];
+    Normalize3(n);
+
+    float toLight[3] = { lightEye[0] - eye[0], lightEye[1] - eye[1], lightEye[2] - eye[2] };
+    Normalize3(toLight);
+    float toEye[3] = { -eye[0], -eye[1], -eye[2] };
+    Normalize3(toEye);
+    float half[3] = { toLight[0] + toEye[0], toLight[1] + toEye[1], toLight[2] + toEye[2] };
+    Normalize3(half);
+
+    float nDotL = n[0] * toLight[0] + n[1] * toLight[1] + n[2] * toLight[2];
+    float nDotH = n[0] * half[0] + n[1] * half[1] + n[2] * half[2];
+
+    for (int side = 0; side < 2; side++) {
+        float* result = side == 0 ? out.front : out.back;
+        float diff = side == 0 ? nDotL : -nDotL;
+        float spec = side == 0 ? nDotH : -nDotH;
+        float specFactor = 0.0f;
+        if (diff > 0.0f && spec > 0.0f) specFactor = powf(spec, material.shininess);
+        if (diff < 0.0f) diff = 0.0f;
+        for (int c = 0; c < 3; c++) {
+            float value = (light.globalAmbient[c] + light.ambient[c]) * material.ambient[c]
+                        + diff * light.diffuse[c] * material.diffuse[c]
+                        + specFactor * light.specular[c] * material.specular[c];
+            result[c] = Clamp01(value);
+        }
+    }
+}
+
+/**
+ * @brief 裁剪一个三角形并交给建立阶段
+ * 
+ * 三个顶点都在同一裁剪平面外 → 整体剔除；
+ * 有顶点在近裁剪面之后 → Sutherland-Hodgman 切割后按扇形重新三角化；
+ * 其余平面不切割，屏幕外部分由包围盒裁剪处理。
+ */
+void SoftwareRasterizer::ClipAndSetup(const ClipVertex& a, const ClipVertex& b, const ClipVertex& c) {
+    int codeA = OutCode(a), codeB = OutCode(b), codeC = OutCode(c);
+    if (codeA & codeB & codeC) return;
+    if (((codeA | codeB | codeC) & OUT_NEAR) == 0) {
+        SetupTriangle(a, b, c);
+        return;
+    }
+
+    // 按 z + w >= 0 切割；交点总是从内侧顶点插值到外侧顶点，
+    // 使共享这条边的两个三角形得到完全相同的交点，避免出现裂缝
+    const ClipVertex* in[3] = { &a, &b, &c };
+    ClipVertex out[4];
+    int count = 0;
+    for (int i = 0; i < 3; i++) {
+        const ClipVertex& p = *in[i];
+        const ClipVertex& q = *in[(i + 1) % 3];
+        float dp = p.z + p.w, dq = q.z + q.w;
+        if (dp >= 0.0f) out[count++] = p;
+        if ((dp >= 0.0f) != (dq >= 0.0f)) {
+            const ClipVertex& inside = dp >= 0.0f ? p : q;
+            const ClipVertex& outside = dp >= 0.0f ? q : p;
+            float di = inside.z + inside.w, doo = outside.z + outside.w;
+            float t = di / (di - doo);
+            ClipVertex& v = out[count++];
+            v.x = inside.x + (outside.x - inside.x) * t;
+            v.y = inside.y + (outside.y - inside.y) * t;
+            v.z = inside.z + (outside.z - inside.z) * t;
+            v.w = inside.w + (outside.w - inside.w) * t;
+            for (int k = 0; k < 3; k++) {
+                v.front[k] = inside.front[k] + (outside.front[k] - inside.front[k]) * t;
+                v.back[k] = inside.back[k] + (outside.back[k] - inside.back[k]) * t;
+            }
+        }
+    }
+    for (int i = 1; i + 1 < count; i++)
+        SetupTriangle(out[0], out[i], out[i + 1]);
+}
+
+/**
+ * @brief 三角形建立：投影到屏幕，计算边函数和深度平面，分箱
+ * 
+ * 屏幕坐标y轴向下。固定管线的正面为窗口坐标（y轴向上）中的逆时针，
+ * 对应这里有向面积为负；为了让三角形内部统一满足 E > 0，
+ * 面积为负时交换两个顶点，颜色则按原始朝向选用正面或背面光照。
+ */
+void SoftwareRasterizer::SetupTriangle(const ClipVertex& a, const ClipVertex& b, const ClipVertex& c) {
+    const ClipVertex* v[3] = { &a, &b, &c };
+    float sx[3], sy[3], sz[3], invW[3];
+    for (int i = 0; i < 3; i++) {
+        invW[i] = 1.0f / v[i]->w;
+        sx[i] = (v[i]->x * invW[i] * 0.5f + 0.5f) * (float)width;
+        sy[i] = (0.5f - v[i]->y * invW[i] * 0.5f) * (float)height;
+        sz[i] = v[i]->z * invW[i] * 0.5f + 0.5f;
+    }
+
+    float area2 = (sx[1] - sx[0]) * (sy[2] - sy[0]) - (sx[2] - sx[0]) * (sy[1] - sy[0]);
+    if (!(area2 != 0.0f)) return;  // 退化三角形（含NaN）
+    bool frontFacing = area2 < 0.0f;
+    int order[3] = { 0, 1, 2 };
+    if (area2 < 0.0f) {
+        order[1] = 2; order[2] = 1;
+        area2 = -area2;
+    }
+
+    Triangle tri;
+    float minXf = sx[0], maxXf = sx[0], minYf = sy[0], maxYf = sy[0];
+    for (int i = 0; i < 3; i++) {
+        int p = order[(i + 1) % 3], q = order[(i + 2) % 3];  // 边 i 是顶点 i 的对边
+        tri.edgeA[i] = sy[p] - sy[q];
+        tri.edgeB[i] = sx[q] - sx[p];
+        tri.edgeC[i] = sx[p] * sy[q] - sy[p] * sx[q];
+        tri.topLeft[i] = tri.edgeA[i] > 0.0f || (tri.edgeA[i] == 0.0f && tri.edgeB[i] > 0.0f);
+
+        int k = order[i];
+        tri.invW[i] = invW[k];
+        const float* shade = frontFacing ? v[k]->front : v[k]->back;
+        tri.color[i][0] = shade[0]; tri.color[i][1] = shade[1]; tri.color[i][2] = shade[2];
+
+        minXf = std::min(minXf, sx[i]); maxXf = std::max(maxXf, sx[i]);
+        minYf = std::min(minYf, sy[i]); maxYf = std::max(maxYf, sy[i]);
+    }
+    tri.z0 = sz[order[0]];
+    tri.dz1 = (sz[order[1]] - sz[order[0]]) / area2;
+    tri.dz2 = (sz[order[2]] - sz[order[0]]) / area2;
+
+    // 采样点在像素中心，像素 x 被采样当且仅当 minX <= x + 0.5 <= maxX
+    float limitX = (float)(width - 1), limitY = (float)(height - 1);
+    tri.minX = (int)std::max(0.0f, std::min(limitX, floorf(minXf - 0.5f)));
+    tri.maxX = (int)std::max(0.0f, std::min(limitX, ceilf(maxXf - 0.5f)));
+    tri.minY = (int)std::max(0.0f, std::min(limitY, floorf(minYf - 0.5f)));
+    tri.maxY = (int)std::max(0.0f, std::min(limitY, ceilf(maxYf - 0.5f)));
+    if (maxXf < 0.0f || minXf > (float)width || maxYf < 0.0f || minYf > (float)height) return;
+
+    uint32_t index = (uint32_t)triangles.size();
+    triangles.push_back(tri);
+    for (int ty = tri.minY / TILE_SIZE; ty <= tri.maxY / TILE_SIZE; ty++)
+        for (int tx = tri.minX / TILE_SIZE; tx <= tri.maxX / TILE_SIZE; tx++)
+            bins[(size_t)ty * tilesX + tx].push_back(index);
+}
+
+/**
+ * @brief 并行光栅化所有屏幕块
+ * 
+ * 各线程用原子计数器领取屏幕块，先做完的线程继续领取，负载自动均衡。
+ * 屏幕块之间没有共享的像素，光栅化过程中线程间不需要任何锁；
+ * 只有唤醒工作线程和等待它们完成时才用到互斥量。
+ */
+void SoftwareRasterizer::EndFrame() {
+    PROFILE_FUNCTION();
+    const int tileCount = tilesX * tilesY;
+    if (tileCount == 0 || triangles.empty()) return;
+
+    int threads = threadCount > 0 ? threadCount : (int)std::thread::hardware_concurrency();
+    if (threads < 1) threads = 1;
+    EnsureWorkers(threads - 1);
+
+    nextTile = 0;
+    if (!workers.empty()) {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        busyWorkers = (int)workers.size();
+        generation++;
+    }
+    frameReady.notify_all();
+
+    RasterizeTiles();  // 调用线程也参与光栅化
+
+    if (!workers.empty()) {
+        std::unique_lock<std::mutex> lock(poolMutex);
+        frameDone.wait(lock, [this]() { return busyWorkers == 0; });
+    }
+}
+
+/**
+ * @brief 领取并光栅化屏幕块，直到全部领完
+ */
+void SoftwareRasterizer::RasterizeTiles() {
+    PROFILE_ZONE("RasterizeTiles");  // 每个线程一个计时区，记录在各自的缓冲区中
+    const int tileCount = tilesX * tilesY;
+    for (int tile = nextTile++; tile < tileCount; tile = nextTile++)
+        RasterizeTile(tile);
+}
+
+/**
+ * @brief 使常驻工作线程数为count，数量不变时什么也不做
+ */
+void SoftwareRasterizer::EnsureWorkers(int count) {
+    if ((int)workers.size() == count) return;
+    StopWorkers();
+    stopping = false;
+    for (int i = 0; i < count; i++)
+        workers.push_back(std::thread(&SoftwareRasterizer::WorkerLoop, this, generation));
+}
+
+void SoftwareRasterizer::StopWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        stopping = true;
+    }
+    frameReady.notify_all();
+    for (size_t i = 0; i < workers.size(); i++) workers[i].join();
+    workers.clear();
+}
+
+/**
+ * @brief 工作线程主循环
+ * @param startGeneration 创建线程时的帧序号，之后每次序号变化处理一帧
+ */
+void SoftwareRasterizer::WorkerLoop(unsigned startGeneration) {
+    unsigned seen = startGeneration;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(poolMutex);
+            frameReady.wait(lock, [this, seen]() { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+        RasterizeTiles();
+        std::lock_guard<std::mutex> lock(poolMutex);
+        if (--busyWorkers == 0) frameDone.notify_one();
+    }
+}
+
+/**
+ * @brief 光栅化一个屏幕块内的全部三角形
+ * 
+ * 对每个三角形，把其包围盒与屏幕块的交集按 8×8 小块遍历，
+ * 用小块四角的边函数值决定整块拒绝、整块接受还是逐像素测试。
+ */
+void SoftwareRasterizer::RasterizeTile(int tileIndex) {
+    const std::vector<uint32_t>& bin = bins[tileIndex];
+    if (bin.empty()) return;
+    const int tileX0 = (tileIndex % tilesX) * TILE_SIZE;
+    const int tileY0 = (tileIndex / tilesX) * TILE_SIZE;
+    const int tileX1 = std::min(tileX0 + TILE_SIZE, width) - 1;
+    const int tileY1 = std::min(tileY0 + TILE_SIZE, height) - 1;
+
+    for (size_t t = 0; t < bin.size(); t++) {
+        const Triangle& tri = triangles[bin[t]];
+        int minX = std::max(tri.minX, tileX0), maxX = std::min(tri.maxX, tileX1);
+        int minY = std::max(tri.minY, tileY0), maxY = std::min(tri.maxY, tileY1);
+        if (minX > maxX || minY > maxY) continue;
+
+        for (int by = minY & ~(BLOCK_SIZE - 1); by <= maxY; by += BLOCK_SIZE) {
+            for (int bx = minX & ~(BLOCK_SIZE - 1); bx <= maxX; bx += BLOCK_SIZE) {
+                float xs0 = bx + 0.5f, xs1 = bx + BLOCK_SIZE - 0.5f;
+                float ys0 = by + 0.5f, ys1 = by + BLOCK_SIZE - 0.5f;
+                bool rejected = false, covered = true;
+                for (int e = 0; e < 3; e++) {
+                    float A = tri.edgeA[e], B = tri.edgeB[e], C = tri.edgeC[e];
+                    float hiX = A >= 0.0f ? xs1 : xs0, loX = A >= 0.0f ? xs0 : xs1;
+                    float hiY = B >= 0.0f ? ys1 : ys0, loY = B >= 0.0f ? ys0 : ys1;
+                    float eMax = A * hiX + (B * hiY + C);
+                    float eMin = A * loX + (B * loY + C);
+                    if (!EdgeCovers(eMax, tri.topLeft[e])) { rejected = true; break; }
+                    if (!EdgeCovers(eMin, tri.topLeft[e])) covered = false;
+                }
+                if (rejected) continue;
+                // 小块超出屏幕（右、下边缘）时不能整块写入
+                if (bx + BLOCK_SIZE > width || by + BLOCK_SIZE > height) covered = false;
+                RasterizeBlock(tri, bx, by, minX, minY, maxX, maxY, covered);
+            }
+        }
+    }
+}
+
+/**
+ * @brief 计算一个可见像素的颜色（透视校正插值）
+ * 
+ * 屏幕空间的重心坐标 E_i 除以 w_i 后重新归一化，得到透视正确的权重。
+ */
+uint32_t SoftwareRasterizer::ShadePixel(const Triangle& tri, float e0, float e1, float e2) const {
+    float l0 = e0 * tri.invW[0], l1 = e1 * tri.invW[1], l2 = e2 * tri.invW[2];
+    float sum = l0 + l1 + l2;
+    if (sum <= 0.0f) sum = 1.0f;
+    float inv = 1.0f / sum;
+    float rgb[3];
+    for (int c = 0; c < 3; c++)
+        rgb[c] = (l0 * tri.color[0][c] + l1 * tri.color[1][c] + l2 * tri.color[2][c]) * inv;
+    return PackRGBA(rgb[0], rgb[1], rgb[2]);
+}
+
+/**
+ * @brief 光栅化一个 8×8 小块
+ * @param minX, minY, maxX, maxY 三角形包围盒与屏幕块的交集，小块内只遍历落在其中的行和4像素组
+ * @param fullyCovered 小块内所有采样点都在三角形内，跳过边测试
+ * 
+ * 每次处理一行中的4个像素：求三条边函数 → 覆盖掩码 → 深度 → 深度测试，
+ * 通过的像素再逐个求颜色。SSE2与标量路径的运算顺序相同，结果逐位一致。
+ */
+void SoftwareRasterizer::RasterizeBlock(const Triangle& tri, int x0, int y0,
+                                        int minX, int minY, int maxX, int maxY, bool fullyCovered) {
+    // 小三角形往往只占小块的一角，只遍历与包围盒相交的行和4像素组
+    const int rowBegin = std::max(minY - y0, 0), rowEnd = std::min(maxY - y0 + 1, BLOCK_SIZE);
+    const int colBegin = std::max(minX - x0, 0), colEnd = std::min(maxX - x0 + 1, BLOCK_SIZE);
+    const int validX = width - x0;  // 本行有效像素数（右边缘小块可能不足8个）
+
+#ifdef RASTERIZER_SSE2
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 lane = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+    __m128 A[3], topLeft[3];
+    for (int e = 0; e < 3; e++) {
+        A[e] = _mm_set1_ps(tri.edgeA[e]);
+        topLeft[e] = _mm_castsi128_ps(_mm_set1_epi32(tri.topLeft[e] ? -1 : 0));
+    }
+    const __m128 z0 = _mm_set1_ps(tri.z0), dz1 = _mm_set1_ps(tri.dz1), dz2 = _mm_set1_ps(tri.dz2);
+
+    for (int r = rowBegin; r < rowEnd; r++) {
+        const int y = y0 + r;
+        const float py = y + 0.5f;
+        __m128 rowTerm[3];
+        for (int e = 0; e < 3; e++) rowTerm[e] = _mm_set1_ps(tri.edgeB[e] * py + tri.edgeC[e]);
+        float* depthRow = &depth[(size_t)y * stride + x0];
+        uint32_t* colorRow = color->Row(y) + x0;
+
+        for (int g = colBegin & ~3; g < colEnd; g += 4) {
+            __m128 px = _mm_add_ps(_mm_set1_ps((float)(x0 + g)), lane);
+            __m128 e[3];
+            __m128 mask = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (int k = 0; k < 3; k++) {
+                e[k] = _mm_add_ps(_mm_mul_ps(A[k], px), rowTerm[k]);
+                if (!fullyCovered) {
+                    __m128 inside = _mm_or_ps(_mm_cmpgt_ps(e[k], zero),
+                                              _mm_and_ps(_mm_cmpeq_ps(e[k], zero), topLeft[k]));
+                    mask = _mm_and_ps(mask, inside);
+                }
+            }
+            int bits = _mm_movemask_ps(mask);
+            if (g + 4 > validX) bits &= (1 << (validX > g ? validX - g : 0)) - 1;
+            if (!bits) continue;
+
+            __m128 z = _mm_add_ps(_mm_add_ps(z0, _mm_mul_ps(e[1], dz1)), _mm_mul_ps(e[2], dz2));
+            __m128 oldZ = _mm_loadu_ps(depthRow + g);
+            bits &= _mm_movemask_ps(_mm_cmplt_ps(z, oldZ));
+            if (!bits) continue;
+
+            __m128 pass = _mm_castsi128_ps(_mm_set_epi32((bits & 8) ? -1 : 0, (bits & 4) ? -1 : 0,
+                                                         (bits & 2) ? -1 : 0, (bits & 1) ? -1 : 0));
+            _mm_storeu_ps(depthRow + g, _mm_or_ps(_mm_and_ps(pass, z), _mm_andnot_ps(pass, oldZ)));
+
+            float ev[3][4];
+            for (int k = 0; k < 3; k++) _mm_storeu_ps(ev[k], e[k]);
+            for (int i = 0; i < 4; i++)
+                if (bits & (1 << i)) colorRow[g + i] = ShadePixel(tri, ev[0][i], ev[1][i], ev[2][i]);
+        }
+    }
+#else
+    for (int r = rowBegin; r < rowEnd; r++) {
+        const int y = y0 + r;
+        const float py = y + 0.5f;
+        float rowTerm[3];
+        for (int e = 0; e < 3; e++) rowTerm[e] = tri.edgeB[e] * py + tri.edgeC[e];
+        float* depthRow = &depth[(size_t)y * stride + x0];
+        uint32_t* colorRow = color->Row(y) + x0;
+
+        for (int i = colBegin; i < colEnd && i < validX; i++) {
+            float px = (float)(x0 + i) + 0.5f;
+            float e[3];
+            bool inside = true;
+            for (int k = 0; k < 3; k++) {
+                e[k] = tri.edgeA[k] * px + rowTerm[k];
+                if (!fullyCovered && !EdgeCovers(e[k], tri.topLeft[k])) inside = false;
+            }
+            if (!inside) continue;
+            float z = (tri.z0 + e[1] * tri.dz1) + e[2] * tri.dz2;
+            if (!(z < depthRow[i])) continue;
+            depthRow[i] = z;
+            colorRow[i] = ShadePixel(tri, e[0], e[1], e[2]);
+        }
+    }
+#endif
+}
@@ -0,0 +1,201 @@
+﻿#pragma once
+#include "../math/Matrix4.h"
+#include "Framebuffer.h"
+#include <vector>
+#include <cstdint>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+/**
+ * @file SoftwareRasterizer.h
+ * @brief 多线程CPU三角形光栅化器定义
+ * @author ln1.opensource@gmail.com
+ * 
+ * 本模块不依赖 windows.h 和 OpenGL，可在没有GPU的机器上离屏渲染3D场景。
+ */
+
+/**
+ * @struct RasterMaterial
+ * @brief 光栅化器使用的Phong材质（与 glMaterialfv 的参数一一对应）
+ */
+struct RasterMaterial {
+    float ambient[3];   ///< 环境光反射系数
+    float diffuse[3];   ///< 漫反射系数
+    float specular[3];  ///< 镜面反射系数
+    float shininess;    ///< 镜面反射指数
+};
+
+/**
+ * @struct RasterLight
+ * @brief 光栅化器使用的点光源（与 glLightfv 的参数一一对应）
+ */
+struct RasterLight {
+    float position[3];       ///< 光源位置（世界坐标）
+    float ambient[3];        ///< 光源环境光分量
+    float diffuse[3];        ///< 光源漫反射分量
+    float specular[3];       ///< 光源镜面反射分量
+    float globalAmbient[3];  ///< 全局环境光（GL_LIGHT_MODEL_AMBIENT）
+};
+
+/**
+ * @class SoftwareRasterizer
+ * @brief 分块、多线程的CPU三角形光栅化器
+ * 
+ * 渲染流程与OpenGL固定管线一致：
+ * 1. 顶点阶段：MVP变换，按固定管线公式逐顶点计算光照（局部观察者、双面光照）
+ * 2. 裁剪：视锥体外的三角形整体剔除，跨越近裁剪面的三角形按近裁剪面切割
+ * 3. 三角形建立：计算三条边的半平面方程 E(x,y)=A·x+B·y+C，按包围盒分箱到屏幕块
+ * 4. 光栅化：各线程从原子计数器领取屏幕块，块内按 8×8 小块遍历：
+ *    - 三条边在小块四角都为负的一侧 → 整块跳过
+ *    - 三条边在四角都为正 → 整块覆盖，省去逐像素的边测试
+ *    - 其余情况逐像素测试，每次处理4个像素（SSE2，不可用时退化为等价的标量代码）
+ * 5. 深度测试（GL_LESS）通过后，以透视校正插值得到的颜色写入调用者的 FramebufferRGBA8
+ * 
+ * 每个屏幕块只由一个线程处理，块内三角形按提交顺序光栅化，
+ * 因此结果与线程数无关，多次渲染逐像素相同。
+ * 工作线程由光栅化器持有并在帧之间复用，空闲时阻塞在条件变量上，析构时退出。
+ * 
+ * 覆盖规则采用左上填充规则，相邻三角形的公共边上每个像素恰好被填充一次。
+ */
+class SoftwareRasterizer {
+public:
+    static const int TILE_SIZE = 64;   ///< 分箱的屏幕块边长（像素）
+    static const int BLOCK_SIZE = 8;   ///< 块内遍历的小块边长（像素）
+
+    SoftwareRasterizer();
+    ~SoftwareRasterizer();
+
+    SoftwareRasterizer(const SoftwareRasterizer&) = delete;
+    SoftwareRasterizer& operator=(const SoftwareRasterizer&) = delete;
+
+    /**
+     * @brief 设置光栅化线程数
+     * @param count 线程数，0表示使用硬件并发数
+     */
+    void SetThreadCount(int count);
+
+    /**
+     * @brief 设置清屏颜色（各分量取值0~1）
+     */
+    void SetClearColor(float r, float g, float b);
+
+    /**
+     * @brief 设置视图矩阵和投影矩阵（列主序，与 glLoadMatrixf 相同）
+     */
+    void SetCamera(const Matrix4& view, const Matrix4& projection);
+
+    /**
+     * @brief 设置光源，光源位置在下一次 SetCamera 之后仍按世界坐标解释
+     */
+    void SetLight(const RasterLight& light);
+
+    /**
+     * @brief 开始新的一帧：清空分箱，以清屏颜色填满目标帧缓冲并清除深度缓冲
+     * @param target 本帧的颜色目标，输出尺寸取其宽高；须保持有效直到 EndFrame 返回
+     * 
+     * 尺寸与上一帧不同时重新分配深度缓冲和分箱。
+     */
+    void BeginFrame(FramebufferRGBA8& target);
+
+    /**
+     * @brief 提交一个网格
+     * @param vertices 顶点数据，每顶点8个float（位置、法线、纹理坐标），与 MeshGenerator 的格式相同
+     * @param indices 三角形索引，每3个一组
+     * @param model 模型矩阵
+     * @param material 材质
+     * 
+     * 顶点变换、光照和三角形建立在调用线程完成，光栅化推迟到 EndFrame。
+     */
+    void DrawMesh(const std::vector<float>& vertices, const std::vector<unsigned int>& indices,
+                  const Matrix4& model, const RasterMaterial& material);
+
+    /**
+     * @brief 并行光栅化本帧提交的全部三角形，返回后目标帧缓冲即为完整的一帧
+     */
+    void EndFrame();
+
+    int Width() const { return width; }
+    int Height() const { return height; }
+
+    /**
+     * @brief 深度缓冲的行宽（像素），补齐到 BLOCK_SIZE 的整数倍，每行只有前 Width() 个像素有效
+     */
+    int Stride() const { return stride; }
+
+    /**
+     * @brief 深度缓冲，取值0~1，每行 Stride() 个
+     */
+    const std::vector<float>& Depth() const { return depth; }
+
+    /**
+     * @brief 本帧建立的三角形数（裁剪、剔除之后）
+     */
+    size_t TriangleCount() const { return triangles.size(); }
+
+private:
+    /**
+     * @brief 裁剪空间中的顶点，附带正面、背面两种光照结果
+     */
+    struct ClipVertex {
+        float x, y, z, w;
+        float front[3];
+        float back[3];
+    };
+
+    /**
+     * @brief 建立完毕的屏幕空间三角形
+     * 
+     * 边 i 的方程为 E_i = edgeA[i]·x + edgeB[i]·y + edgeC[i]，三角形内部 E_i > 0；
+     * E_i 恰为顶点 i 对应的未归一化重心坐标。
+     */
+    struct Triangle {
+        float edgeA[3], edgeB[3], edgeC[3];
+        bool topLeft[3];             ///< 该边是否为上边或左边（E=0时算作覆盖）
+        float z0, dz1, dz2;          ///< 深度 z = z0 + E1·dz1 + E2·dz2
+        float invW[3];               ///< 各顶点的 1/w
+        float color[3][3];           ///< 各顶点（已选定朝向）的颜色
+        int minX, minY, maxX, maxY;  ///< 像素包围盒（已裁到屏幕内）
+    };
+
+    void ShadeVertex(const float* v, const Matrix4& modelView, const float normalMatrix[9],
+                     const RasterMaterial& material, ClipVertex& out) const;
+    void ClipAndSetup(const ClipVertex& a, const ClipVertex& b, const ClipVertex& c);
+    void SetupTriangle(const ClipVertex& a, const ClipVertex& b, const ClipVertex& c);
+    void RasterizeTile(int tileIndex);
+    void RasterizeTiles();
+    void EnsureWorkers(int count);
+    void StopWorkers();
+    void Resize(int width, int height);
+    void WorkerLoop(unsigned startGeneration);
+    void RasterizeBlock(const Triangle& tri, int x0, int y0,
+                        int minX, int minY, int maxX, int maxY, bool fullyCovered);
+    uint32_t ShadePixel(const Triangle& tri, float e0, float e1, float e2) const;
+
+    int width, height;
+    int stride;                                 ///< 深度缓冲行宽，补齐到 BLOCK_SIZE 的整数倍（4像素一组读写不越界）
+    int tilesX, tilesY;
+    int threadCount;
+    uint32_t clearColor;
+
+    Matrix4 view, projection;
+    RasterLight light;
+    float lightEye[3];                          ///< 光源在眼睛空间中的位置
+
+    FramebufferRGBA8* color;                    ///< 本帧的颜色目标（BeginFrame 设置）
+    std::vector<float> depth;
+    std::vector<Triangle> triangles;
+    std::vector<std::vector<uint32_t>> bins;    ///< 每个屏幕块覆盖到的三角形序号
+    std::vector<ClipVertex> shaded;             ///< DrawMesh 的逐顶点结果（复用以免反复分配）
+
+    // === 工作线程池 ===
+    std::vector<std::thread> workers;           ///< 常驻工作线程（调用线程之外的部分）
+    std::mutex poolMutex;                       ///< 保护下面三个状态
+    std::condition_variable frameReady;         ///< 新一帧开始或线程池停止时通知工作线程
+    std::condition_variable frameDone;          ///< 最后一个工作线程完成本帧时通知调用线程
+    unsigned generation;                        ///< 帧序号，工作线程据此判断有无新任务
+    int busyWorkers;                            ///< 本帧尚未完成的工作线程数
+    bool stopping;                              ///< 线程池正在停止
+    std::atomic<int> nextTile;                  ///< 下一个待领取的屏幕块
+};
@@ -12,6 +12,7 @@
 
 #include "TextureLoader.h"
 #include "../engine/OpenGLFunctions.h"
+#include "../diagnostics/Log.h"
 #include <windows.h>
 #include <gl/GL.h>
 #include <algorithm>
@@ -247,11 +248,8 @@ unsigned int TextureLoader::LoadTexture(const std::string& filepath) {
     // 解绑纹理
     glBindTexture(GL_TEXTURE_2D, 0);
     
-    // 输出调试信息
-    char debugMsg[512];
-    sprintf_s(debugMsg, "纹理加载成功: %s\n尺寸: %dx%d, 通道数: %d, ID: %u",
-              filepath.c_str(), width, height, channels, textureID);
-    OutputDebugStringA(debugMsg);
+    LOG_INFO("纹理加载成功: %s 尺寸: %dx%d, 通道数: %d, ID: %u",
+             filepath.c_str(), width, height, channels, textureID);
     
     return textureID;
 }
@@ -268,9 +266,6 @@ void TextureLoader::DeleteTexture(unsigned int textureID) {
         GLuint id = textureID;
         glDeleteTextures(1, &id);
         
-        // 输出调试信息
-        char debugMsg[128];
-        sprintf_s(debugMsg, "纹理已删除: ID %u", textureID);
-        OutputDebugStringA(debugMsg);
+        LOG_INFO("纹理已删除: ID %u", textureID);
     }
 }
@@ -0,0 +1,139 @@
+﻿/**
+ * @file TiledCanvas.cpp
+ * @brief 写时复制的分块画布实现
+ * @author ln1.opensource@gmail.com
+ * 
+ * 本文件实现了分块画布的像素读写：
+ * 1. 块指针表的建立与尺寸调整
+ * 2. 写入前的写时复制（引用计数大于1时复制块）
+ * 3. 多个快照共享块时的内存统计
+ */
+
+#include "TiledCanvas.h"
+#include <algorithm>
+
+// std::fill按引用接收填充值，类内初始化的静态常量需要一个定义
+const COLORREF TiledCanvas::TRANSPARENT_PIXEL;
+
+// ============================================================================
+// 构造与尺寸
+// ============================================================================
+
+TiledCanvas::TiledCanvas() : width(0), height(0), tilesX(0), tilesY(0) {}
+
+TiledCanvas::TiledCanvas(int width, int height) : width(0), height(0), tilesX(0), tilesY(0) {
+    Resize(width, height);
+}
+
+/**
+ * @brief 改变画布尺寸
+ * 
+ * 保留新旧范围重叠部分的块指针（不复制像素），其余块为空
+ */
+void TiledCanvas::Resize(int w, int h) {
+    w = w > 0 ? w : 0;
+    h = h > 0 ? h : 0;
+    int newTilesX = (w + TILE_SIZE - 1) / TILE_SIZE;
+    int newTilesY = (h + TILE_SIZE - 1) / TILE_SIZE;
+
+    std::vector<std::shared_ptr<Tile>> newTiles((size_t)newTilesX * newTilesY);
+    int copyX = std::min(tilesX, newTilesX), copyY = std::min(tilesY, newTilesY);
+    for (int ty = 0; ty < copyY; ty++)
+        for (int tx = 0; tx < copyX; tx++)
+            newTiles[ty * newTilesX + tx] = tiles[ty * tilesX + tx];
+
+    tiles.swap(newTiles);
+    width = w;
+    height = h;
+    tilesX = newTilesX;
+    tilesY = newTilesY;
+}
+
+void TiledCanvas::Clear() {
+    for (auto& t : tiles) t.reset();
+}
+
+// ============================================================================
+// 像素读写
+// ============================================================================
+
+COLORREF TiledCanvas::GetPixel(int x, int y) const {
+    if ((unsigned)x >= (unsigned)width || (unsigned)y >= (unsigned)height) return TRANSPARENT_PIXEL;
+    const Tile* tile = tiles[(y / TILE_SIZE) * tilesX + x / TILE_SIZE].get();
+    if (!tile) return TRANSPARENT_PIXEL;
+    return tile->pixels[(y % TILE_SIZE) * TILE_SIZE + x % TILE_SIZE];
+}
+
+void TiledCanvas::SetPixel(int x, int y, COLORREF color) {
+    FillSpan(y, x, x, color);
+}
+
+void TiledCanvas::FillSpan(int y, int x0, int x1, COLORREF color) {
+    if ((unsigned)y >= (unsigned)height) return;
+    if (x0 < 0) x0 = 0;
+    if (x1 >= width) x1 = width - 1;
+    if (x0 > x1) return;
+
+    int ty = y / TILE_SIZE, rowInTile = y % TILE_SIZE;
+    for (int tx = x0 / TILE_SIZE; tx <= x1 / TILE_SIZE; tx++) {
+        int tileX0 = tx * TILE_SIZE;
+        int a = std::max(x0, tileX0) - tileX0;
+        int b = std::min(x1, tileX0 + TILE_SIZE - 1) - tileX0;
+        COLORREF* row = MutableTile(tx, ty)->pixels + rowInTile * TILE_SIZE;
+        std::fill(row + a, row + b + 1, color);
+    }
+}
+
+/**
+ * @brief 获取可写的块
+ * 
+ * 【算法步骤】
+ * 1. 块不存在：新建一块并全部置为透明
+ * 2. 块被其他快照共享（引用计数大于1）：复制一份再替换本画布的指针，
+ *    其他快照仍指向原块，内容不受影响
+ * 3. 块只属于本画布：直接返回
+ */
+TiledCanvas::Tile* TiledCanvas::MutableTile(int tx, int ty) {
+    std::shared_ptr<Tile>& slot = tiles[ty * tilesX + tx];
+    if (!slot) {
+        slot = std::make_shared<Tile>();
+        std::fill(slot->pixels, slot->pixels + TILE_SIZE * TILE_SIZE, TRANSPARENT_PIXEL);
+    } else if (slot.use_count() > 1) {
+        slot = std::make_shared<Tile>(*slot);
+    }
+    return slot.get();
+}
+
+// ============================================================================
+// 内存统计
+// ============================================================================
+
+size_t TiledCanvas::TileCount() const {
+    size_t n = 0;
+    for (const auto& t : tiles) if (t) n++;
+    return n;
+}
+
+/**
+ * @brief 计入一个画布：块指针表总是计入，块只在第一次被引用时计入
+ */
+void TiledCanvas::MemoryCounter::Add(const TiledCanvas& canvas) {
+    bytes += canvas.tiles.capacity() * sizeof(std::shared_ptr<Tile>);
+    for (const auto& t : canvas.tiles)
+        if (t && refs[t.get()]++ == 0) bytes += sizeof(Tile);
+}
+
+/**
+ * @brief 移出一个画布：块在最后一个引用移出时扣除
+ */
+void TiledCanvas::MemoryCounter::Remove(const TiledCanvas& canvas) {
+    bytes -= canvas.tiles.capacity() * sizeof(std::shared_ptr<Tile>);
+    for (const auto& t : canvas.tiles) {
+        if (!t) continue;
+        auto it = refs.find(t.get());
+        if (it != refs.end() && --it->second == 0) {
+            refs.erase(it);
+            bytes -= sizeof(Tile);
+        }
+    }
+}
@@ -0,0 +1,139 @@
+﻿#pragma once
+#include <windows.h>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+/**
+ * @file TiledCanvas.h
+ * @brief 写时复制的分块画布类定义
+ * @author ln1.opensource@gmail.com
+ */
+
+/**
+ * @class TiledCanvas
+ * @brief 由固定大小像素块组成、块之间写时复制的画布
+ * 
+ * 画布按 TILE_SIZE×TILE_SIZE 分块，每块用引用计数指针保存：
+ * - 从未写入的块为空指针，不占像素内存，读出为透明
+ * - 复制画布（快照）只复制块指针，所有块在各个快照之间共享
+ * - 写入像素时，若目标块被多个快照共享，先复制该块再写入
+ * 
+ * 因此保存一个撤销快照的开销只是一张块指针表，
+ * 真正占用的像素内存只有操作实际修改过的那些块。
+ */
+class TiledCanvas {
+public:
+    static const int TILE_SIZE = 64;                      ///< 块边长（像素）
+    static const COLORREF TRANSPARENT_PIXEL = 0xFFFFFFFF; ///< 透明像素值（与CLR_INVALID相同）
+
+    TiledCanvas();
+    TiledCanvas(int width, int height);
+
+    /**
+     * @brief 改变画布尺寸，保留范围内的已有块
+     */
+    void Resize(int width, int height);
+
+    /**
+     * @brief 释放所有块（全部变为透明）
+     */
+    void Clear();
+
+    int Width() const { return width; }
+    int Height() const { return height; }
+
+    /**
+     * @brief 读取像素，未写入的位置返回TRANSPARENT_PIXEL
+     */
+    COLORREF GetPixel(int x, int y) const;
+
+    /**
+     * @brief 写入单个像素
+     */
+    void SetPixel(int x, int y, COLORREF color);
+
+    /**
+     * @brief 以同一颜色填充水平区间 [x0, x1]（含两端）
+     * 
+     * 区间跨越的每个块只做一次写时复制检查
+     */
+    void FillSpan(int y, int x0, int x1, COLORREF color);
+
+    /**
+     * @brief 已分配的块个数
+     */
+    size_t TileCount() const;
+
+    /**
+     * @class MemoryCounter
+     * @brief 一组画布（如撤销历史）实际占用的像素内存字节数
+     * 
+     * 每个块记录引用它的画布个数，被多个画布共享的块只计算一次。
+     * 画布加入和移出时增量更新总数，代价与该画布的块数成正比；
+     * 画布在加入之后、移出之前不能修改
+     */
+    class MemoryCounter {
+    public:
+        MemoryCounter() : bytes(0) {}
+
+        void Add(const TiledCanvas& canvas);
+        void Remove(const TiledCanvas& canvas);
+        void Clear() { refs.clear(); bytes = 0; }
+        size_t Bytes() const { return bytes; }
+
+    private:
+        std::unordered_map<const void*, unsigned> refs;   ///< 块 -> 引用它的画布个数
+        size_t bytes;                                      ///< 当前总字节数
+    };
+
+    /**
+     * @brief 按行序遍历所有非透明的同色区间
+     * @param fn 回调，参数为 (int y, int x0, int x1, COLORREF color)
+     * 
+     * 区间不跨越块边界，未分配的块直接跳过
+     */
+    template <class Fn>
+    void ForEachRun(Fn fn) const {
+        for (int ty = 0; ty < tilesY; ty++) {
+            for (int tx = 0; tx < tilesX; tx++) {
+                const Tile* tile = tiles[ty * tilesX + tx].get();
+                if (!tile) continue;
+                int x0 = tx * TILE_SIZE, y0 = ty * TILE_SIZE;
+                int w = (width - x0 < TILE_SIZE) ? width - x0 : TILE_SIZE;
+                int h = (height - y0 < TILE_SIZE) ? height - y0 : TILE_SIZE;
+                for (int j = 0; j < h; j++) {
+                    const COLORREF* row = tile->pixels + j * TILE_SIZE;
+                    int i = 0;
+                    while (i < w) {
+                        COLORREF c = row[i];
+                        int start = i;
+                        while (i + 1 < w && row[i + 1] == c) i++;
+                        if (c != TRANSPARENT_PIXEL) fn(y0 + j, x0 + start, x0 + i, c);
+                        i++;
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    /**
+     * @struct Tile
+     * @brief 一个像素块
+     */
+    struct Tile {
+        COLORREF pixels[TILE_SIZE * TILE_SIZE];   ///< 按行存储的像素
+    };
+
+    /**
+     * @brief 获取可写的块：空块新建为透明，共享块先复制
+     */
+    Tile* MutableTile(int tx, int ty);
+
+    std::vector<std::shared_ptr<Tile>> tiles;   ///< 块指针表（按行存储）
+    int width;                                  ///< 宽度（像素）
+    int height;                                 ///< 高度（像素）
+    int tilesX;                                 ///< 水平方向块数
+    int tilesY;                                 ///< 垂直方向块数
+};
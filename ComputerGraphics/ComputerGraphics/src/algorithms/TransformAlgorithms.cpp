@@ -77,10 +77,8 @@ Point2D TransformAlgorithms::CalculateShapeCenter(const Shape& shape) {
  */
 void TransformAlgorithms::ApplyTranslation(Shape& shape, int dx, int dy) {
     // 对图形的每个顶点应用平移
-    for (auto& p : shape.points) {
-        p.x += dx;  // x坐标加上水平偏移
-        p.y += dy;  // y坐标加上垂直偏移
-    }
+    TranslatePoints(shape.points, dx, dy);
+    shape.revision++;
 }
 
 /**
@@ -111,21 +109,14 @@ void TransformAlgorithms::ApplyTranslation(Shape& shape, int dx, int dy) {
  * 本实现使用等比例缩放（sx = sy = scale）
  */
 void TransformAlgorithms::ApplyScaling(Shape& shape, double scale, Point2D center) {
-    // 对图形的每个顶点应用缩放
-    for (auto& p : shape.points) {
-        // 计算顶点相对于缩放中心的偏移
-        int dx = p.x - center.x;
-        int dy = p.y - center.y;
-        
-        // 应用缩放并加回中心点坐标
-        p.x = center.x + (int)(dx * scale);
-        p.y = center.y + (int)(dy * scale);
-    }
+    // 对图形的每个顶点应用缩放（结果四舍五入到整数像素）
+    ScalePoints(shape.points, scale, center);
     
     // 特殊处理：如果是圆形，还需要缩放半径
     if (shape.type == SHAPE_CIRCLE) {
-        shape.radius = (int)(shape.radius * scale);
+        shape.radius = ScalarTraits<int>::FromDouble(shape.radius * scale);
     }
+    shape.revision++;
 }
 
 /**
@@ -164,20 +155,74 @@ void TransformAlgorithms::ApplyScaling(Shape& shape, double scale, Point2D cente
  * - 逆时针为正方向（数学坐标系），屏幕坐标系y轴向下，视觉效果为顺时针
  */
 void TransformAlgorithms::ApplyRotation(Shape& shape, double angle, Point2D center) {
+    // 对图形的每个顶点应用旋转（结果四舍五入到整数像素）
+    RotatePoints(shape.points, angle, center);
+    shape.revision++;
+}
+
+// ============================================================================
+// 通用坐标类型的顶点变换
+// ============================================================================
+
+/**
+ * @brief 平移顶点序列
+ * @param points 顶点序列
+ * @param dx x方向的平移距离
+ * @param dy y方向的平移距离
+ */
+template <typename T>
+void TransformAlgorithms::TranslatePoints(std::vector<Point2<T>>& points, T dx, T dy) {
+    for (auto& p : points) {
+        p.x = p.x + dx;
+        p.y = p.y + dy;
+    }
+}
+
+/**
+ * @brief 以指定点为中心等比例缩放顶点序列
+ * @param points 顶点序列
+ * @param scale 缩放因子
+ * @param center 缩放中心点
+ * 
+ * 公式同 ApplyScaling：x' = cx + (x - cx) × s, y' = cy + (y - cy) × s
+ * 偏移量在双精度下缩放后再换算回坐标类型，整数坐标四舍五入而不是截断，
+ * 避免多次变换后图形整体向原点方向漂移
+ */
+template <typename T>
+void TransformAlgorithms::ScalePoints(std::vector<Point2<T>>& points, double scale, Point2<T> center) {
+    for (auto& p : points) {
+        double dx = ScalarTraits<T>::ToDouble(p.x - center.x);
+        double dy = ScalarTraits<T>::ToDouble(p.y - center.y);
+        p.x = center.x + ScalarTraits<T>::FromDouble(dx * scale);
+        p.y = center.y + ScalarTraits<T>::FromDouble(dy * scale);
+    }
+}
+
+/**
+ * @brief 以指定点为中心旋转顶点序列
+ * @param points 顶点序列
+ * @param angle 旋转角度（弧度）
+ * @param center 旋转中心点
+ * 
+ * 公式同 ApplyRotation：
+ * x' = cx + dx×cosθ - dy×sinθ
+ * y' = cy + dx×sinθ + dy×cosθ
+ */
+template <typename T>
+void TransformAlgorithms::RotatePoints(std::vector<Point2<T>>& points, double angle, Point2<T> center) {
     // 预计算三角函数值，避免在循环中重复计算
-    double cosA = cos(angle);  // 余弦值
-    double sinA = sin(angle);  // 正弦值
+    double cosA = cos(angle);
+    double sinA = sin(angle);
     
-    // 对图形的每个顶点应用旋转
-    for (auto& p : shape.points) {
-        // 计算顶点相对于旋转中心的偏移
-        int dx = p.x - center.x;
-        int dy = p.y - center.y;
-        
-        // 应用旋转公式并加回中心点坐标
-        // x' = cx + dx×cosθ - dy×sinθ
-        // y' = cy + dx×sinθ + dy×cosθ
-        p.x = center.x + (int)(dx * cosA - dy * sinA);
-        p.y = center.y + (int)(dx * sinA + dy * cosA);
+    for (auto& p : points) {
+        double dx = ScalarTraits<T>::ToDouble(p.x - center.x);
+        double dy = ScalarTraits<T>::ToDouble(p.y - center.y);
+        p.x = center.x + ScalarTraits<T>::FromDouble(dx * cosA - dy * sinA);
+        p.y = center.y + ScalarTraits<T>::FromDouble(dx * sinA + dy * cosA);
     }
 }
+
+// 显式实例化：整数坐标（图形顶点）
+template void TransformAlgorithms::TranslatePoints<int>(std::vector<Point2i>&, int, int);
+template void TransformAlgorithms::ScalePoints<int>(std::vector<Point2i>&, double, Point2i);
+template void TransformAlgorithms::RotatePoints<int>(std::vector<Point2i>&, double, Point2i);
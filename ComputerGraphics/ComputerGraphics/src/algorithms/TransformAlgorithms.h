@@ -1,6 +1,7 @@
 ﻿#pragma once
 #include "../core/Point2D.h"
 #include "../core/Shape.h"
+#include <vector>
 
 /**
  * @file TransformAlgorithms.h
@@ -55,4 +56,36 @@ public:
      * 以指定点为中心对图形进行旋转变换
      */
     static void ApplyRotation(Shape& shape, double angle, Point2D center);
+
+    // === 通用坐标类型的顶点变换（T当前实例化为int）===
+    /**
+     * @brief 平移顶点序列
+     * @param points 顶点序列（引用，会被修改）
+     * @param dx x方向的平移距离
+     * @param dy y方向的平移距离
+     */
+    template <typename T>
+    static void TranslatePoints(std::vector<Point2<T>>& points, T dx, T dy);
+
+    /**
+     * @brief 以指定点为中心等比例缩放顶点序列
+     * @param points 顶点序列（引用，会被修改）
+     * @param scale 缩放因子
+     * @param center 缩放中心点
+     * 
+     * 计算在双精度下进行，结果按坐标类型换算（整数四舍五入，定点/浮点保留小数）
+     */
+    template <typename T>
+    static void ScalePoints(std::vector<Point2<T>>& points, double scale, Point2<T> center);
+
+    /**
+     * @brief 以指定点为中心旋转顶点序列
+     * @param points 顶点序列（引用，会被修改）
+     * @param angle 旋转角度（弧度，逆时针为正）
+     * @param center 旋转中心点
+     * 
+     * 计算在双精度下进行，结果按坐标类型换算（整数四舍五入，定点/浮点保留小数）
+     */
+    template <typename T>
+    static void RotatePoints(std::vector<Point2<T>>& points, double angle, Point2<T> center);
 };
@@ -0,0 +1,216 @@
+﻿/**
+ * @file VertexPacker.cpp
+ * @brief 顶点和索引的紧凑编码实现
+ * @author ln1.opensource@gmail.com
+ * 
+ * 【八面体映射】
+ * 单位向量 n 先除以 |x|+|y|+|z| 投影到八面体 |x|+|y|+|z| = 1 上，
+ * 上半部分 (z ≥ 0) 直接取 (x, y)；下半部分的四个三角形沿对角线翻折到正方形的四个角：
+ *   (x, y) → ((1 - |y|) × sign(x), (1 - |x|) × sign(y))
+ * 解码时先令 z = 1 - |x| - |y|，z < 0 时做相同的翻折，再归一化。
+ * 
+ * 【位置量化】
+ * 每个轴独立量化到 [-32767, 32767]：offset 为包围盒中心，scale 为半边长 / 32767。
+ */
+
+#include "VertexPacker.h"
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+const float SNORM16_MAX = 32767.0f;
+
+int16_t QuantizeSnorm16(float value) {
+    if (value > 1.0f) value = 1.0f;
+    if (value < -1.0f) value = -1.0f;
+    return (int16_t)lrintf(value * SNORM16_MAX);
+}
+
+float SignNotZero(float value) {
+    return value >= 0.0f ? 1.0f : -1.0f;
+}
+
+} // namespace
+
+VertexLayout VertexPacker::Layout(unsigned int format) {
+    VertexLayout layout;
+    unsigned int positionBytes = (format & VERTEX_POSITION_SNORM16) ? 4 * sizeof(int16_t) : 3 * sizeof(float);
+    unsigned int normalBytes = (format & VERTEX_NORMAL_OCT16) ? 2 * sizeof(int16_t) : 3 * sizeof(float);
+    unsigned int texCoordBytes = (format & VERTEX_TEXCOORD_HALF) ? 2 * sizeof(uint16_t) : 2 * sizeof(float);
+    layout.normalOffset = positionBytes;
+    layout.texCoordOffset = positionBytes + normalBytes;
+    layout.stride = positionBytes + normalBytes + texCoordBytes;
+    return layout;
+}
+
+/**
+ * @brief 编码顶点
+ * 
+ * 第一遍求位置的包围盒（仅量化位置时需要），第二遍逐顶点写入各属性。
+ * 位置补齐为4个分量，使每个属性都从4字节对齐的偏移开始。
+ */
+void VertexPacker::PackVertices(const std::vector<float>& vertices, unsigned int format,
+                                std::vector<unsigned char>& packed,
+                                float positionScale[3], float positionOffset[3]) {
+    const size_t stride = 8;
+    const size_t vertexCount = vertices.size() / stride;
+    const VertexLayout layout = Layout(format);
+    packed.assign(vertexCount * layout.stride, 0);
+
+    for (int c = 0; c < 3; c++) {
+        positionScale[c] = 1.0f;
+        positionOffset[c] = 0.0f;
+    }
+    if ((format & VERTEX_POSITION_SNORM16) && vertexCount > 0) {
+        float lo[3], hi[3];
+        for (int c = 0; c < 3; c++) lo[c] = hi[c] = vertices[c];
+        for (size_t v = 1; v < vertexCount; v++) {
+            const float* p = &vertices[v * stride];
+            for (int c = 0; c < 3; c++) {
+                if (p[c] < lo[c]) lo[c] = p[c];
+                if (p[c] > hi[c]) hi[c] = p[c];
+            }
+        }
+        for (int c = 0; c < 3; c++) {
+            float halfExtent = 0.5f * (hi[c] - lo[c]);
+            positionOffset[c] = 0.5f * (lo[c] + hi[c]);
+            positionScale[c] = halfExtent > 0.0f ? halfExtent / SNORM16_MAX : 1.0f;  // 扁平的轴全部编码为0
+        }
+    }
+
+    for (size_t v = 0; v < vertexCount; v++) {
+        const float* src = &vertices[v * stride];
+        unsigned char* dst = &packed[v * layout.stride];
+
+        if (format & VERTEX_POSITION_SNORM16) {
+            int16_t q[4] = { 0, 0, 0, 0 };
+            for (int c = 0; c < 3; c++)
+                q[c] = QuantizeSnorm16((src[c] - positionOffset[c]) / (positionScale[c] * SNORM16_MAX));
+            memcpy(dst, q, sizeof(q));
+        } else {
+            memcpy(dst, src, 3 * sizeof(float));
+        }
+
+        if (format & VERTEX_NORMAL_OCT16) {
+            int16_t q[2];
+            OctEncode(src + 3, q);
+            memcpy(dst + layout.normalOffset, q, sizeof(q));
+        } else {
+            memcpy(dst + layout.normalOffset, src + 3, 3 * sizeof(float));
+        }
+
+        if (format & VERTEX_TEXCOORD_HALF) {
+            uint16_t h[2] = { FloatToHalf(src[6]), FloatToHalf(src[7]) };
+            memcpy(dst + layout.texCoordOffset, h, sizeof(h));
+        } else {
+            memcpy(dst + layout.texCoordOffset, src + 6, 2 * sizeof(float));
+        }
+    }
+}
+
+unsigned int VertexPacker::PackIndices(const std::vector<unsigned int>& indices, size_t vertexCount,
+                                       std::vector<unsigned char>& packed) {
+    if (vertexCount < 65536) {
+        packed.resize(indices.size() * sizeof(uint16_t));
+        uint16_t* dst = reinterpret_cast<uint16_t*>(packed.data());
+        for (size_t i = 0; i < indices.size(); i++) dst[i] = (uint16_t)indices[i];
+        return sizeof(uint16_t);
+    }
+    packed.resize(indices.size() * sizeof(unsigned int));
+    if (!indices.empty()) memcpy(packed.data(), indices.data(), packed.size());
+    return sizeof(unsigned int);
+}
+
+/**
+ * @brief float转半精度浮点
+ * 
+ * 规格化范围内把指数偏移从127改为15，尾数截去低13位并就近舍入到偶数
+ * （舍入进位可能进入指数位，结果仍然正确）；小于 2^-14 时输出非规格化数。
+ */
+uint16_t VertexPacker::FloatToHalf(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    const uint16_t sign = (uint16_t)((bits >> 16) & 0x8000);
+    const uint32_t magnitude = bits & 0x7FFFFFFF;
+
+    if (magnitude >= 0x7F800000)  // 无穷大或NaN（NaN保留为静默NaN）
+        return (uint16_t)(sign | 0x7C00 | (magnitude > 0x7F800000 ? 0x0200 : 0));
+    if (magnitude >= 0x477FF000)  // ≥ 65520，舍入后超出半精度范围
+        return (uint16_t)(sign | 0x7C00);
+    if (magnitude >= 0x38800000) {  // ≥ 2^-14，规格化数
+        uint32_t rounded = magnitude - 0x38000000 + 0x0FFF + ((magnitude >> 13) & 1);
+        return (uint16_t)(sign | (rounded >> 13));
+    }
+    if (magnitude < 0x33000000)  // ≤ 2^-25 的部分舍入为0
+        return sign;
+
+    // 非规格化数：值 = m × 2^-24
+    const int exponent = (int)(magnitude >> 23);
+    const uint32_t mantissa = (magnitude & 0x007FFFFF) | 0x00800000;
+    const int shift = 126 - exponent;
+    uint32_t m = mantissa >> shift;
+    const uint32_t remainder = mantissa & ((1u << shift) - 1);
+    const uint32_t halfway = 1u << (shift - 1);
+    if (remainder > halfway || (remainder == halfway && (m & 1))) m++;
+    return (uint16_t)(sign | m);
+}
+
+float VertexPacker::HalfToFloat(uint16_t half) {
+    const uint32_t sign = (uint32_t)(half & 0x8000) << 16;
+    const uint32_t exponent = (half >> 10) & 0x1F;
+    uint32_t mantissa = half & 0x03FF;
+    uint32_t bits;
+    if (exponent == 0x1F) {
+        bits = sign | 0x7F800000 | (mantissa << 13);
+    } else if (exponent != 0) {
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    } else if (mantissa == 0) {
+        bits = sign;
+    } else {
+        // 非规格化数：左移尾数直到最高位成为隐含的1
+        int e = 113;
+        while (!(mantissa & 0x0400)) {
+            mantissa <<= 1;
+            e--;
+        }
+        bits = sign | ((uint32_t)e << 23) | ((mantissa & 0x03FF) << 13);
+    }
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+void VertexPacker::OctEncode(const float normal[3], int16_t encoded[2]) {
+    float l1 = fabsf(normal[0]) + fabsf(normal[1]) + fabsf(normal[2]);
+    if (l1 <= 0.0f) {
+        encoded[0] = encoded[1] = 0;  // 零向量：编码为 +Z
+        return;
+    }
+    float x = normal[0] / l1;
+    float y = normal[1] / l1;
+    if (normal[2] < 0.0f) {
+        float fx = (1.0f - fabsf(y)) * SignNotZero(x);
+        float fy = (1.0f - fabsf(x)) * SignNotZero(y);
+        x = fx;
+        y = fy;
+    }
+    encoded[0] = QuantizeSnorm16(x);
+    encoded[1] = QuantizeSnorm16(y);
+}
+
+void VertexPacker::OctDecode(const int16_t encoded[2], float normal[3]) {
+    float x = encoded[0] / SNORM16_MAX;
+    float y = encoded[1] / SNORM16_MAX;
+    float z = 1.0f - fabsf(x) - fabsf(y);
+    if (z < 0.0f) {
+        float fx = (1.0f - fabsf(y)) * SignNotZero(x);
+        float fy = (1.0f - fabsf(x)) * SignNotZero(y);
+        x = fx;
+        y = fy;
+    }
+    float length = sqrtf(x * x + y * y + z * z);
+    normal[0] = x / length;
+    normal[1] = y / length;
+    normal[2] = z / length;
+}
@@ -0,0 +1,92 @@
+﻿#pragma once
+#include "../core/Mesh3D.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @file VertexPacker.h
+ * @brief 顶点和索引的紧凑编码
+ * @author ln1.opensource@gmail.com
+ */
+
+/**
+ * @struct VertexLayout
+ * @brief 一种顶点格式在缓冲区中的布局（字节）
+ */
+struct VertexLayout {
+    unsigned int stride;          ///< 每个顶点的字节数
+    unsigned int normalOffset;    ///< 法线相对顶点起点的偏移
+    unsigned int texCoordOffset;  ///< 纹理坐标相对顶点起点的偏移
+};
+
+/**
+ * @class VertexPacker
+ * @brief 把float顶点数据编码为 VertexFormatFlags 描述的紧凑格式
+ * 
+ * 各属性的编码：
+ * - 位置：每个轴以包围盒中心为偏移、半边长/32767为缩放，量化为16位整数，
+ *   误差不超过该轴边长的 1/65534；解码 p = q × scale + offset
+ * - 法线：八面体映射把单位球面展开到 [-1,1]² 正方形，两个分量各量化为16位整数，
+ *   角度误差不超过0.05°；解码见 OctDecode
+ * - 纹理坐标：IEEE 754 半精度浮点（就近舍入到偶数），[0,1] 内的误差小于 2^-12
+ * 
+ * 所有整数分量都按非归一化整数上传（着色器中得到整数值本身），
+ * 缩放全部放在 scale 中，因此结果不依赖驱动对归一化整数的换算方式。
+ */
+class VertexPacker {
+public:
+    /**
+     * @brief 顶点格式的布局
+     * @param format VertexFormatFlags 的组合
+     */
+    static VertexLayout Layout(unsigned int format);
+
+    /**
+     * @brief 编码顶点
+     * @param vertices float顶点数据，每顶点8个float [x, y, z, nx, ny, nz, u, v]
+     * @param format VertexFormatFlags 的组合
+     * @param packed 输出的编码数据（Layout(format).stride × 顶点数 字节）
+     * @param positionScale 输出位置的反量化缩放（未量化位置时为1）
+     * @param positionOffset 输出位置的反量化偏移（未量化位置时为0）
+     */
+    static void PackVertices(const std::vector<float>& vertices, unsigned int format,
+                             std::vector<unsigned char>& packed,
+                             float positionScale[3], float positionOffset[3]);
+
+    /**
+     * @brief 编码索引：顶点数小于65536时使用16位，否则使用32位
+     * @param indices 索引
+     * @param vertexCount 顶点数
+     * @param packed 输出的编码数据
+     * @return 每个索引的字节数（2或4）
+     * 
+     * 16位索引的上限取65535个顶点，保留0xFFFF不用（可作为图元重启索引）。
+     */
+    static unsigned int PackIndices(const std::vector<unsigned int>& indices, size_t vertexCount,
+                                    std::vector<unsigned char>& packed);
+
+    /**
+     * @brief float转半精度浮点（就近舍入到偶数，溢出为无穷大）
+     */
+    static uint16_t FloatToHalf(float value);
+
+    /**
+     * @brief 半精度浮点转float
+     */
+    static float HalfToFloat(uint16_t half);
+
+    /**
+     * @brief 单位向量的八面体编码
+     * @param normal 法线（不要求严格单位长度，不能为零向量）
+     * @param encoded 输出的两个16位分量，范围 [-32767, 32767]
+     */
+    static void OctEncode(const float normal[3], int16_t encoded[2]);
+
+    /**
+     * @brief 八面体编码的解码（与着色器中的解码相同）
+     * @param encoded 两个16位分量
+     * @param normal 输出的单位向量
+     */
+    static void OctDecode(const int16_t encoded[2], float normal[3]);
+};
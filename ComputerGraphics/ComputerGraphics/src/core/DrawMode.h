@@ -31,6 +31,7 @@ enum DrawMode {
     MODE_POLYLINE,                    ///< 折线绘制模式
     MODE_POLYGON,                     ///< 多边形绘制模式
     MODE_BSPLINE,                     ///< B样条曲线绘制模式
+    MODE_NURBS,                       ///< NURBS曲线绘制模式（三次，端点插值）
     
     // === 2D 填充算法 ===
     MODE_FILL_SCANLINE,               ///< 扫描线填充算法
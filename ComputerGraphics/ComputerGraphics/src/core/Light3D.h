@@ -0,0 +1,33 @@
+﻿#pragma once
+
+/**
+ * @file Light3D.h
+ * @brief 三维场景光源参数定义
+ * @author ln1.opensource@gmail.com
+ */
+
+/**
+ * @struct Light
+ * @brief 光源参数结构
+ * 
+ * 定义了3D场景中光源的位置、颜色和强度参数
+ * 支持Phong光照模型的环境光、漫反射和镜面反射
+ */
+struct Light {
+    float positionX;           ///< 光源X坐标
+    float positionY;           ///< 光源Y坐标
+    float positionZ;           ///< 光源Z坐标
+    float color[3];            ///< 光源颜色（RGB）
+    float ambientIntensity;    ///< 环境光强度
+    float diffuseIntensity;    ///< 漫反射光强度
+    float specularIntensity;   ///< 镜面反射光强度
+    
+    /**
+     * @brief 默认构造函数
+     * 初始化光源位置和光照参数
+     */
+    Light() : positionX(5.0f), positionY(5.0f), positionZ(5.0f),
+              ambientIntensity(0.2f), diffuseIntensity(0.8f), specularIntensity(1.0f) {
+        color[0] = color[1] = color[2] = 1.0f;  // 白光
+    }
+};
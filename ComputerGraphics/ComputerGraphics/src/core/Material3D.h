@@ -0,0 +1,76 @@
+﻿#pragma once
+#include <cstddef>
+#include <vector>
+
+/**
+ * @file Material3D.h
+ * @brief 三维材质与材质表定义
+ * @author ln1.opensource@gmail.com
+ */
+
+/**
+ * @struct Material3D
+ * @brief Phong光照模型的材质参数
+ */
+struct Material3D {
+    float ambient[3];   ///< 环境光反射系数（RGB）
+    float diffuse[3];   ///< 漫反射系数（RGB）
+    float specular[3];  ///< 镜面反射系数（RGB）
+    float shininess;    ///< 镜面反射指数（控制高光大小）
+
+    /**
+     * @brief 默认构造函数：低环境光、高漫反射、全镜面反射
+     */
+    Material3D() : shininess(32.0f) {
+        ambient[0] = ambient[1] = ambient[2] = 0.2f;
+        diffuse[0] = diffuse[1] = diffuse[2] = 0.8f;
+        specular[0] = specular[1] = specular[2] = 1.0f;
+    }
+
+    Material3D(float ar, float ag, float ab, float dr, float dg, float db,
+               float sr, float sg, float sb, float shininess) : shininess(shininess) {
+        ambient[0] = ar; ambient[1] = ag; ambient[2] = ab;
+        diffuse[0] = dr; diffuse[1] = dg; diffuse[2] = db;
+        specular[0] = sr; specular[1] = sg; specular[2] = sb;
+    }
+
+    bool operator==(const Material3D& o) const {
+        for (int c = 0; c < 3; c++) {
+            if (ambient[c] != o.ambient[c] || diffuse[c] != o.diffuse[c] ||
+                specular[c] != o.specular[c]) return false;
+        }
+        return shininess == o.shininess;
+    }
+    bool operator!=(const Material3D& o) const { return !(*this == o); }
+};
+
+/**
+ * @class MaterialTable
+ * @brief 按值去重的材质表，图形通过下标引用材质
+ * 
+ * 同样参数的材质只保存一份，图形实例只需一个整数下标。
+ * 材质只增不删（清空场景时整表清空），因此已发出的下标始终有效；
+ * 场景中实际使用的不同材质通常只有几种，线性查找足够快。
+ */
+class MaterialTable {
+public:
+    /**
+     * @brief 查找或加入材质
+     * @param material 材质参数
+     * @return 材质在表中的下标
+     */
+    unsigned Intern(const Material3D& material) {
+        for (size_t i = 0; i < items.size(); i++) {
+            if (items[i] == material) return (unsigned)i;
+        }
+        items.push_back(material);
+        return (unsigned)(items.size() - 1);
+    }
+
+    const Material3D& operator[](unsigned index) const { return items[index]; }
+    size_t size() const { return items.size(); }
+    void Clear() { items.clear(); }
+
+private:
+    std::vector<Material3D> items;  ///< 材质数组（下标即材质编号）
+};
@@ -0,0 +1,77 @@
+﻿#pragma once
+#include <vector>
+#include <memory>
+
+/**
+ * @file Mesh3D.h
+ * @brief 三维网格数据结构定义
+ * @author ln1.opensource@gmail.com
+ */
+
+/**
+ * @enum VertexFormatFlags
+ * @brief 顶点缓冲对象（GPU端）中各属性的编码方式，可按位组合
+ * 
+ * 未设置的属性保持32位float。CPU端的 Mesh3D::vertices 始终是float格式，
+ * 编码只发生在上传到显存时（见 VertexPacker、MeshBuffers::Create）。
+ */
+enum VertexFormatFlags : unsigned int {
+    VERTEX_FORMAT_FLOAT = 0,              ///< 全部float：位置12 + 法线12 + 纹理坐标8 = 32字节
+    VERTEX_POSITION_SNORM16 = 1u << 0,    ///< 位置：3×16位整数（补齐到8字节），按网格的缩放/偏移反量化
+    VERTEX_NORMAL_OCT16 = 1u << 1,        ///< 法线：八面体映射后 2×16位整数（4字节）
+    VERTEX_TEXCOORD_HALF = 1u << 2,       ///< 纹理坐标：2×半精度浮点（4字节）
+    VERTEX_FORMAT_COMPACT = VERTEX_POSITION_SNORM16 | VERTEX_NORMAL_OCT16 | VERTEX_TEXCOORD_HALF  ///< 16字节
+};
+
+/**
+ * @struct Mesh3D
+ * @brief 三维网格：顶点/索引数组及其OpenGL缓冲对象
+ * 
+ * 网格与图形实例分离：同一种基本体（类型和参数都相同）的所有图形
+ * 共享同一份网格，图形只持有指向网格的句柄。
+ * 
+ * 顶点数据格式：每顶点8个float [x, y, z, nx, ny, nz, u, v]
+ * 顶点缓冲对象中的格式由 vertexFormat 决定，可以比CPU端更紧凑；
+ * 顶点数小于65536时索引缓冲对象使用16位索引（indexSize 为2）。
+ * 包围盒和包围球在模型空间中给出，由 MeshGenerator::ComputeBounds 根据顶点计算，
+ * 分别用于拾取（SceneBvh）和视锥剔除（FrustumCuller）。
+ */
+struct Mesh3D {
+    std::vector<float> vertices;         ///< 顶点数据数组
+    std::vector<unsigned int> indices;   ///< 索引数据数组（每3个构成一个三角形）
+    unsigned int VAO, VBO, EBO;          ///< OpenGL缓冲对象（顶点数组对象、顶点缓冲对象、元素缓冲对象）
+    float boundMin[3], boundMax[3];      ///< 轴对齐包围盒（模型空间）
+    float boundCenter[3];                ///< 包围球球心（模型空间，即包围盒中心）
+    float boundRadius;                   ///< 包围球半径（模型空间）
+    
+    // === 顶点缓冲对象的格式（由 MeshBuffers::Create 设置） ===
+    unsigned int vertexFormat;           ///< VertexFormatFlags 的组合
+    unsigned int vertexStride;           ///< 每个顶点的字节数
+    unsigned int indexSize;              ///< 每个索引的字节数（2或4）
+    float positionScale[3];              ///< 位置反量化：模型坐标 = 编码值 × positionScale + positionOffset
+    float positionOffset[3];             ///< （float格式时为1和0）
+
+    Mesh3D() : VAO(0), VBO(0), EBO(0), boundRadius(0.0f),
+               vertexFormat(VERTEX_FORMAT_FLOAT), vertexStride(8 * sizeof(float)), indexSize(sizeof(unsigned int)) {
+        for (int c = 0; c < 3; c++) {
+            boundMin[c] = boundMax[c] = boundCenter[c] = 0.0f;
+            positionScale[c] = 1.0f;
+            positionOffset[c] = 0.0f;
+        }
+    }
+
+    // 网格持有OpenGL缓冲对象，复制会导致重复释放，只允许移动
+    Mesh3D(Mesh3D&&) noexcept = default;
+    Mesh3D& operator=(Mesh3D&&) noexcept = default;
+    Mesh3D(const Mesh3D&) = delete;
+    Mesh3D& operator=(const Mesh3D&) = delete;
+};
+
+/**
+ * @typedef MeshHandle
+ * @brief 共享网格的引用计数句柄
+ * 
+ * 网格在最后一个句柄释放时销毁（连同OpenGL缓冲对象），
+ * 网格内容创建后只读，多个图形可以安全地共享同一份。
+ */
+typedef std::shared_ptr<const Mesh3D> MeshHandle;
@@ -0,0 +1,159 @@
+﻿#pragma once
+#include <cmath>
+
+/**
+ * @file Point2.h
+ * @brief 通用二维点模板及坐标标量类型定义
+ * @author ln1.opensource@gmail.com
+ */
+
+/**
+ * @struct Fixed16
+ * @brief 16.16定点数
+ * 
+ * 用32位整数表示实数：高16位为整数部分，低16位为小数部分，
+ * 精度为 1/65536，可表示范围约为 ±32768。
+ * 乘除法使用64位中间结果，避免溢出。
+ * 用于需要亚像素精度、又希望只使用整数运算的几何流水线。
+ */
+struct Fixed16 {
+    int raw;   ///< 原始定点表示（实际值 = raw / 65536）
+
+    static const int FRAC_BITS = 16;           ///< 小数位数
+    static const int ONE = 1 << FRAC_BITS;     ///< 1.0 的定点表示
+
+    /**
+     * @brief 默认构造函数，值为0
+     */
+    Fixed16() : raw(0) {}
+
+    /**
+     * @brief 由整数构造（允许隐式转换，便于与整数边界混合运算）
+     */
+    Fixed16(int v) : raw(v * ONE) {}
+
+    /**
+     * @brief 由原始定点表示构造
+     */
+    static Fixed16 FromRaw(int r) { Fixed16 f; f.raw = r; return f; }
+
+    /**
+     * @brief 由浮点数构造（四舍五入到最近的定点值）
+     */
+    static Fixed16 FromDouble(double v) { return FromRaw((int)floor(v * ONE + 0.5)); }
+
+    /**
+     * @brief 转换为浮点数
+     */
+    double ToDouble() const { return (double)raw / ONE; }
+
+    /**
+     * @brief 四舍五入到最近的整数
+     */
+    int Round() const { return (raw + (ONE >> 1)) >> FRAC_BITS; }
+
+    Fixed16 operator+(Fixed16 o) const { return FromRaw(raw + o.raw); }
+    Fixed16 operator-(Fixed16 o) const { return FromRaw(raw - o.raw); }
+    Fixed16 operator-() const { return FromRaw(-raw); }
+    Fixed16 operator*(Fixed16 o) const { return FromRaw((int)(((long long)raw * o.raw) >> FRAC_BITS)); }
+    Fixed16 operator/(Fixed16 o) const { return FromRaw((int)(((long long)raw << FRAC_BITS) / o.raw)); }
+    Fixed16& operator+=(Fixed16 o) { raw += o.raw; return *this; }
+    Fixed16& operator-=(Fixed16 o) { raw -= o.raw; return *this; }
+
+    bool operator==(Fixed16 o) const { return raw == o.raw; }
+    bool operator!=(Fixed16 o) const { return raw != o.raw; }
+    bool operator<(Fixed16 o) const { return raw < o.raw; }
+    bool operator>(Fixed16 o) const { return raw > o.raw; }
+    bool operator<=(Fixed16 o) const { return raw <= o.raw; }
+    bool operator>=(Fixed16 o) const { return raw >= o.raw; }
+};
+
+/**
+ * @struct ScalarTraits
+ * @brief 坐标标量类型的运算规则
+ * 
+ * 几何算法模板（裁剪、变换）和光栅化模板（RasterCore）都通过该特征类
+ * 完成与浮点数、像素坐标的换算和线性插值，各标量类型可按自身特点特化：
+ * - int：坐标即像素，插值保持原有的整数运算，换算时四舍五入
+ * - float/double：直接运算，取像素时四舍五入
+ * - Fixed16：插值使用64位中间结果，避免乘积溢出和精度损失
+ */
+template <typename T>
+struct ScalarTraits {
+    static T FromDouble(double v) { return (T)v; }
+    static double ToDouble(T v) { return (double)v; }
+    static int ToPixel(T v) { return (int)floor(v + (T)0.5); }
+
+    /**
+     * @brief 按比例插值：a + (b - a) * num / den
+     */
+    static T Lerp(T a, T b, T num, T den) { return a + (b - a) * num / den; }
+};
+
+/**
+ * @brief 整数特化：换算时四舍五入，不再截断
+ */
+template <>
+struct ScalarTraits<int> {
+    static int FromDouble(double v) { return (int)floor(v + 0.5); }
+    static double ToDouble(int v) { return (double)v; }
+    static int ToPixel(int v) { return v; }
+    static int Lerp(int a, int b, int num, int den) { return a + (b - a) * num / den; }
+};
+
+/**
+ * @brief 16.16定点特化
+ */
+template <>
+struct ScalarTraits<Fixed16> {
+    static Fixed16 FromDouble(double v) { return Fixed16::FromDouble(v); }
+    static double ToDouble(Fixed16 v) { return v.ToDouble(); }
+    static int ToPixel(Fixed16 v) { return v.Round(); }
+    static Fixed16 Lerp(Fixed16 a, Fixed16 b, Fixed16 num, Fixed16 den) {
+        // (b - a) * num / den 中的定点比例因子相互抵消，直接用原始值做64位运算
+        return a + Fixed16::FromRaw((int)((long long)(b - a).raw * num.raw / den.raw));
+    }
+};
+
+/**
+ * @struct Point2
+ * @brief 通用二维点模板
+ * @tparam T 坐标标量类型（int、Fixed16等）
+ * 
+ * 裁剪、填充、变换算法以该模板为参数，
+ * 同一套算法可在整数像素和定点亚像素坐标下运行，
+ * 多步运算（如逐边裁剪）在亚像素坐标下进行，只在最后取整一次
+ */
+template <typename T>
+struct Point2 {
+    T x, y;  ///< x坐标和y坐标
+
+    /**
+     * @brief 构造函数
+     * @param x x坐标值，默认为0
+     * @param y y坐标值，默认为0
+     */
+    Point2(T x = T(), T y = T()) : x(x), y(y) {}
+
+    /**
+     * @brief 判断两点坐标是否相同
+     */
+    bool operator==(const Point2& other) const { return x == other.x && y == other.y; }
+
+    /**
+     * @brief 判断两点坐标是否不同
+     */
+    bool operator!=(const Point2& other) const { return !(*this == other); }
+
+    /**
+     * @brief 转换为另一种坐标类型的点（经ScalarTraits换算，转为int时四舍五入）
+     */
+    template <typename U>
+    Point2<U> As() const {
+        return Point2<U>(ScalarTraits<U>::FromDouble(ScalarTraits<T>::ToDouble(x)),
+                         ScalarTraits<U>::FromDouble(ScalarTraits<T>::ToDouble(y)));
+    }
+};
+
+typedef Point2<int> Point2i;       ///< 32位整数坐标点（像素坐标）
+typedef Point2<Fixed16> Point2x;   ///< 16.16定点坐标点（亚像素坐标）
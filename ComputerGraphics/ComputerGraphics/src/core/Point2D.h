@@ -5,10 +5,14 @@
  * 本目录包含项目的基础数据类型定义，是整个图形系统的数据基础。
  * 
  * 目录内容：
- * - Point2D.h   - 二维点结构，用于2D图形绘制
+ * - Point2.h    - 通用二维点模板（整数、16.16定点坐标）
+ * - Point2D.h   - 二维整数点类型，用于2D图形绘制
  * - Point3D.h   - 三维点结构，用于3D图形绘制
  * - Shape.h     - 二维图形结构，包含类型、顶点、颜色等属性
- * - Shape3D.h   - 三维图形结构，包含变换、材质、纹理等属性
+ * - ShapeList.h - 结构共享的图形列表，供撤销历史廉价保存快照
+ * - Shape3D.h   - 三维图形实例（只可移动），包含变换、材质下标、纹理和网格句柄
+ * - Mesh3D.h    - 三维网格数据（顶点、索引、缓冲对象）与共享网格句柄
+ * - Material3D.h - 三维材质参数与按值去重的材质表
  * - DrawMode.h  - 绘图模式枚举，定义各种绘图操作类型
  * 
  * 使用说明：
@@ -17,6 +21,7 @@
  */
 
 #pragma once
+#include "Point2.h"
 
 /**
  * @file Point2D.h
@@ -25,19 +30,10 @@
  */
 
 /**
- * @struct Point2D
- * @brief 二维点结构体
+ * @typedef Point2D
+ * @brief 二维整数点类型
  * 
- * 用于表示二维坐标系中的一个点，包含x和y坐标
- * 主要用于2D图形绘制和几何计算
+ * 用于表示二维坐标系中的一个点，坐标为整数以适配像素坐标系统
+ * 主要用于2D图形绘制和几何计算；需要亚像素精度时使用 Point2x
  */
-struct Point2D {
-    int x, y;  ///< x坐标和y坐标，使用整数类型以适配像素坐标系统
-    
-    /**
-     * @brief 构造函数
-     * @param x x坐标值，默认为0
-     * @param y y坐标值，默认为0
-     */
-    Point2D(int x = 0, int y = 0) : x(x), y(y) {}
-};
+typedef Point2<int> Point2D;
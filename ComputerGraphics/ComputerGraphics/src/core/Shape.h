@@ -21,7 +21,24 @@ enum ShapeType {
     SHAPE_RECTANGLE, ///< 矩形
     SHAPE_POLYLINE,  ///< 折线（多段线）
     SHAPE_POLYGON,   ///< 多边形
-    SHAPE_BSPLINE    ///< B样条曲线
+    SHAPE_BSPLINE,   ///< B样条曲线
+    SHAPE_NURBS      ///< NURBS曲线（非均匀节点、带权重）
+};
+
+/**
+ * @struct CurveCache
+ * @brief 曲线展平结果缓存
+ * 
+ * 保存曲线类图形展平后的折线，以及生成该折线时图形的修改计数和视图缩放比例。
+ * 渲染和选择时若两者均未变化，直接复用折线，不重新展平；判断只比较两个数，与控制点数量无关。
+ */
+struct CurveCache {
+    std::vector<Point2D> polyline;        ///< 展平后的折线顶点
+    unsigned revision;                    ///< 生成折线时图形的修改计数
+    double viewScale;                     ///< 生成折线时的视图缩放比例
+    bool valid;                           ///< 缓存是否有效
+
+    CurveCache() : revision(0), viewScale(1.0), valid(false) {}
 };
 
 /**
@@ -36,11 +53,15 @@ struct Shape {
     std::vector<Point2D> points;   ///< 构成图形的关键点集合
     COLORREF color;                ///< 图形颜色（Windows颜色格式）
     int radius;                    ///< 圆形半径（仅对圆形有效）
-    bool selected;                 ///< 是否被选中状态标志
+    int degree;                    ///< 曲线次数（仅对NURBS曲线有效）
+    std::vector<double> knots;     ///< 节点向量（仅对NURBS曲线有效，为空表示clamped均匀节点）
+    std::vector<double> weights;   ///< 控制点权重（仅对NURBS曲线有效，为空表示全部为1）
+    unsigned revision;             ///< 修改计数，修改points/knots/weights后须递增，使曲线缓存失效
+    mutable CurveCache curveCache; ///< 曲线展平缓存（仅对曲线类图形有效）
 
     /**
      * @brief 默认构造函数
-     * 初始化为黑色直线，未选中状态
+     * 初始化为黑色直线
      */
-    Shape() : type(SHAPE_LINE), color(RGB(0, 0, 0)), radius(0), selected(false) {}
+    Shape() : type(SHAPE_LINE), color(RGB(0, 0, 0)), radius(0), degree(3), revision(0) {}
 };
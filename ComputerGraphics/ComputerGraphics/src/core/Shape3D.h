@@ -1,6 +1,6 @@
 ﻿#pragma once
 #include "Point3D.h"
-#include <vector>
+#include "Mesh3D.h"
 
 /**
  * @file Shape3D.h
@@ -23,10 +23,14 @@ enum Shape3DType {
 
 /**
  * @struct Shape3D
- * @brief 三维图形结构体
+ * @brief 三维图形实例记录
  * 
- * 包含了绘制和管理三维图形所需的所有信息，包括几何变换、
- * 材质属性、纹理信息和OpenGL渲染数据
+ * 只保存实例自身的数据：几何变换、材质下标、纹理和状态标志，
+ * 以及指向共享网格的句柄。网格由 MeshRegistry 持有，
+ * 材质参数保存在 MaterialTable 中，图形只记录其下标。
+ * 
+ * 图形只能移动不能复制：移动只转移网格句柄，不触碰引用计数，
+ * 也避免意外复制出一份与场景脱节的实例。
  */
 struct Shape3D {
     Shape3DType type;  ///< 三维图形类型
@@ -36,38 +40,31 @@ struct Shape3D {
     float rotationX, rotationY, rotationZ;  ///< 绕X、Y、Z轴的旋转角度（弧度）
     float scaleX, scaleY, scaleZ;           ///< X、Y、Z方向的缩放因子
     
-    // 材质参数（Phong光照模型）
-    float ambient[3];   ///< 环境光反射系数（RGB）
-    float diffuse[3];   ///< 漫反射系数（RGB）
-    float specular[3];  ///< 镜面反射系数（RGB）
-    float shininess;    ///< 镜面反射指数（控制高光大小）
+    unsigned int materialIndex;  ///< 材质在 MaterialTable 中的下标
     
     // 纹理相关
     unsigned int textureID;  ///< OpenGL纹理ID
     bool hasTexture;         ///< 是否应用纹理标志
     
-    // 网格数据（用于OpenGL渲染）
-    std::vector<float> vertices;         ///< 顶点数据数组
-    std::vector<unsigned int> indices;   ///< 索引数据数组
-    unsigned int VAO, VBO, EBO;          ///< OpenGL缓冲对象（顶点数组对象、顶点缓冲对象、元素缓冲对象）
-    
-    bool selected;  ///< 是否被选中状态标志
+    // 网格数据（同类型同参数的图形共享一份，见 MeshRegistry）
+    MeshHandle mesh;  ///< 共享网格句柄
+    int lodLevel;     ///< 网格的细节层次（仅球体和圆柱体有意义，见 LevelOfDetail）
     
     /**
      * @brief 默认构造函数
      * 
      * 初始化为球体，位于原点，无旋转，单位缩放
-     * 设置默认材质属性和OpenGL缓冲对象
+     * 使用0号材质，网格句柄为空，细节层次为1（16分段）
      */
     Shape3D() : type(SHAPE3D_SPHERE), 
                 positionX(0), positionY(0), positionZ(0),
                 rotationX(0), rotationY(0), rotationZ(0),
                 scaleX(1), scaleY(1), scaleZ(1),
-                shininess(32.0f), textureID(0), hasTexture(false),
-                VAO(0), VBO(0), EBO(0), selected(false) {
-        // 设置默认材质属性
-        ambient[0] = ambient[1] = ambient[2] = 0.2f;   // 低环境光
-        diffuse[0] = diffuse[1] = diffuse[2] = 0.8f;   // 高漫反射
-        specular[0] = specular[1] = specular[2] = 1.0f; // 全镜面反射
-    }
+                materialIndex(0), textureID(0), hasTexture(false),
+                lodLevel(1) {}
+
+    Shape3D(Shape3D&&) noexcept = default;
+    Shape3D& operator=(Shape3D&&) noexcept = default;
+    Shape3D(const Shape3D&) = delete;
+    Shape3D& operator=(const Shape3D&) = delete;
 };
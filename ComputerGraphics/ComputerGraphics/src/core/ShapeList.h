@@ -0,0 +1,66 @@
+﻿#pragma once
+#include "Shape.h"
+#include <vector>
+#include <memory>
+
+/**
+ * @file ShapeList.h
+ * @brief 结构共享的图形列表定义
+ * @author ln1.opensource@gmail.com
+ */
+
+/**
+ * @class ShapeList
+ * @brief 以引用计数指针保存图形、可廉价复制的图形列表
+ * 
+ * 列表中每个图形由一个指向只读Shape的共享指针持有：
+ * - 复制列表只复制指针数组，图形本身在各个副本之间共享
+ * - 图形本身不可修改，修改图形时换入新图形的指针，原图形仍由其他副本持有
+ * - 批量操作（如裁剪）生成新列表时，未改变的图形直接沿用原指针
+ * 
+ * 撤销历史保存的列表副本因此只额外占用指针数组和真正被修改过的图形。
+ * 只读访问接口与 std::vector<Shape> 保持一致，遍历得到 const Shape&。
+ */
+class ShapeList {
+public:
+    typedef std::shared_ptr<const Shape> Handle;   ///< 共享的只读图形
+
+    /**
+     * @class const_iterator
+     * @brief 只读迭代器，解引用得到 const Shape&
+     */
+    class const_iterator {
+    public:
+        explicit const_iterator(std::vector<Handle>::const_iterator it) : it(it) {}
+        const Shape& operator*() const { return **it; }
+        const Shape* operator->() const { return it->get(); }
+        const_iterator& operator++() { ++it; return *this; }
+        bool operator==(const const_iterator& o) const { return it == o.it; }
+        bool operator!=(const const_iterator& o) const { return it != o.it; }
+    private:
+        std::vector<Handle>::const_iterator it;
+    };
+
+    size_t size() const { return items.size(); }
+    bool empty() const { return items.empty(); }
+    void clear() { items.clear(); }
+    void reserve(size_t n) { items.reserve(n); }
+
+    const_iterator begin() const { return const_iterator(items.begin()); }
+    const_iterator end() const { return const_iterator(items.end()); }
+
+    const Shape& operator[](size_t i) const { return *items[i]; }
+
+    void push_back(const Shape& shape) { items.push_back(std::make_shared<Shape>(shape)); }
+    void push_back(Shape&& shape) { items.push_back(std::make_shared<Shape>(std::move(shape))); }
+
+    // === 按指针操作（不复制图形） ===
+    const Handle& GetHandle(size_t i) const { return items[i]; }
+    void SetHandle(size_t i, const Handle& h) { items[i] = h; }
+    void PushHandle(const Handle& h) { items.push_back(h); }
+    void InsertHandle(size_t i, const Handle& h) { items.insert(items.begin() + i, h); }
+    void Erase(size_t i) { items.erase(items.begin() + i); }
+
+private:
+    std::vector<Handle> items;   ///< 图形指针数组
+};
@@ -0,0 +1,322 @@
+﻿/**
+ * @file Log.cpp
+ * @brief 分级日志实现
+ * @author ln1.opensource@gmail.com
+ * 
+ * 【环形缓冲区】
+ * 有界多生产者单消费者队列：每个槽带一个序号，槽 i 初始序号为 i。
+ * - 写入：读取写位置 pos，若槽序号等于 pos 则用CAS占有该位置，写完记录后把序号置为 pos + 1；
+ *   序号小于 pos 说明消费者还没取走上一轮的记录，即缓冲区已满，记录被丢弃。
+ * - 读取：槽序号等于 读位置 + 1 时记录已写完，取出后把序号置为 读位置 + 容量，交还给下一轮写入。
+ * 写入端没有锁，也不会因为读取端慢而阻塞。
+ * 
+ * 【唤醒】
+ * 后台线程取空缓冲区后在条件变量上等待，没有日志时不会被周期性唤醒。
+ * 线程先置 sleeping 标志再检查缓冲区，写入端先发布记录再检查 sleeping，
+ * 两边之间各有一道全序栅栏，因此至少有一方能看到对方：
+ * 要么线程看到新记录不睡，要么写入端看到标志并加锁通知。
+ * 只有线程真正在等待时写入端才会进入互斥量。
+ * 
+ * 【输出】
+ * Windows 下写到调试器输出窗口（OutputDebugStringA），其他平台写到标准错误。
+ */
+
+#include "Log.h"
+#include "ThreadId.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+namespace {
+
+/**
+ * @struct LogSlot
+ * @brief 环形缓冲区的一个槽
+ */
+struct LogSlot {
+    std::atomic<size_t> sequence;  ///< 槽序号（见文件头说明）
+    LogRecord record;              ///< 日志记录
+};
+
+/**
+ * @struct LogRing
+ * @brief 环形缓冲区及消费端状态
+ */
+struct LogRing {
+    LogSlot slots[Log::CAPACITY];
+    std::atomic<size_t> tail;      ///< 下一个写位置（生产者共享）
+    std::atomic<size_t> dropped;   ///< 因缓冲区满被丢弃的记录数
+    size_t head;                   ///< 下一个读位置（仅消费者访问）
+    size_t reportedDropped;        ///< 已经报告过的丢弃数（仅消费者访问）
+    int64_t startTime;             ///< 时间戳零点
+
+    LogRing() : tail(0), dropped(0), head(0), reportedDropped(0) {
+        for (size_t i = 0; i < Log::CAPACITY; i++) slots[i].sequence.store(i, std::memory_order_relaxed);
+        startTime = std::chrono::steady_clock::now().time_since_epoch().count();
+    }
+};
+
+static_assert((Log::CAPACITY & (Log::CAPACITY - 1)) == 0, "日志缓冲区容量必须是2的幂");
+
+LogRing& Ring() {
+    static LogRing ring;
+    return ring;
+}
+
+std::atomic<bool> g_running(false);
+std::atomic<bool> g_sleeping(false);   ///< 后台线程正在（或即将）等待条件变量
+std::thread g_worker;
+std::mutex g_wakeMutex;
+std::condition_variable g_wake;
+
+/**
+ * @brief 读位置上的记录是否已写完（仅消费者调用）
+ */
+bool HasPending() {
+    LogRing& ring = Ring();
+    const LogSlot& slot = ring.slots[ring.head & (Log::CAPACITY - 1)];
+    return slot.sequence.load(std::memory_order_acquire) == ring.head + 1;
+}
+
+const char* LevelName(int level) {
+    static const char* const NAMES[] = { "TRACE", "DEBUG", "INFO", "WARN", "ERROR" };
+    return (level >= 0 && level < LOG_LEVEL_OFF) ? NAMES[level] : "?";
+}
+
+/**
+ * @brief 输出一行已格式化的日志
+ */
+void WriteLine(const char* line) {
+#ifdef _WIN32
+    OutputDebugStringA(line);
+#else
+    fputs(line, stderr);
+#endif
+}
+
+/**
+ * @brief 追加 snprintf 的输出，维护已写长度（截断时停在缓冲区末尾）
+ */
+void Advance(size_t& out, size_t size, int written) {
+    if (written <= 0) return;
+    out += (size_t)written;
+    if (out > size - 1) out = size - 1;
+}
+
+} // namespace
+
+std::atomic<int> Log::runtimeLevel(LOG_LEVEL_TRACE);
+
+/**
+ * @brief 启动后台输出线程
+ * 
+ * 编译期级别关闭了全部日志时不会有任何记录，不启动线程。
+ */
+void Log::Start() {
+    if (LOG_COMPILE_LEVEL >= LOG_LEVEL_OFF) return;
+    if (g_running.exchange(true)) return;
+    Ring();  // 在启动线程之前完成初始化
+    g_worker = std::thread([]() {
+        while (g_running.load(std::memory_order_relaxed)) {
+            if (Flush() > 0) continue;
+            std::unique_lock<std::mutex> lock(g_wakeMutex);
+            g_sleeping.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            g_wake.wait(lock, []() { return !g_running.load(std::memory_order_relaxed) || HasPending(); });
+            g_sleeping.store(false, std::memory_order_relaxed);
+        }
+    });
+}
+
+void Log::Stop() {
+    if (!g_running.exchange(false)) return;
+    {
+        std::lock_guard<std::mutex> lock(g_wakeMutex);
+    }
+    g_wake.notify_one();
+    if (g_worker.joinable()) g_worker.join();
+    Flush();
+}
+
+size_t Log::DroppedCount() {
+    return Ring().dropped.load(std::memory_order_relaxed);
+}
+
+void Log::PackString(LogRecord& record, const char* s) {
+    if (!s) s = "(null)";
+    LogRecord::Arg a;
+    size_t room = LogRecord::TEXT_SIZE - record.textUsed;
+    if (room == 0) {
+        // 空间用完：指向上一个字符串结尾的0，输出为空串
+        a.u = LogRecord::TEXT_SIZE - 1;
+    } else {
+        size_t length = strlen(s);
+        if (length > room - 1) length = room - 1;
+        memcpy(record.text + record.textUsed, s, length);
+        record.text[record.textUsed + length] = '\0';
+        a.u = record.textUsed;
+        record.textUsed = (unsigned char)(record.textUsed + length + 1);
+    }
+    PackValue(record, LogRecord::ARG_STRING, a);
+}
+
+void Log::Submit(LogRecord& record) {
+    LogRing& ring = Ring();
+    record.timestamp = std::chrono::steady_clock::now().time_since_epoch().count();
+    record.threadId = CurrentThreadId();
+
+    size_t pos = ring.tail.load(std::memory_order_relaxed);
+    LogSlot* slot;
+    for (;;) {
+        slot = &ring.slots[pos & (CAPACITY - 1)];
+        size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        ptrdiff_t diff = (ptrdiff_t)sequence - (ptrdiff_t)pos;
+        if (diff == 0) {
+            if (ring.tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            ring.dropped.fetch_add(1, std::memory_order_relaxed);  // 缓冲区满
+            return;
+        } else {
+            pos = ring.tail.load(std::memory_order_relaxed);       // 被其他线程抢先
+        }
+    }
+    slot->record = record;
+    slot->sequence.store(pos + 1, std::memory_order_release);
+
+    // 后台线程在等待时才加锁唤醒（见文件头的说明）
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (g_sleeping.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(g_wakeMutex);
+        g_wake.notify_one();
+    }
+}
+
+size_t Log::Format(const LogRecord& record, char* buffer, size_t size) {
+    if (size == 0) return 0;
+    size_t out = 0;
+    int argIndex = 0;
+    const char* f = record.format ? record.format : "";
+
+    while (*f && out + 1 < size) {
+        if (*f != '%') {
+            buffer[out++] = *f++;
+            continue;
+        }
+        if (f[1] == '%') {
+            buffer[out++] = '%';
+            f += 2;
+            continue;
+        }
+
+        // 解析转换说明：%[标志][宽度][.精度][长度]类型，长度修饰符丢弃后按参数类型重新补上
+        char spec[32];
+        int s = 0;
+        spec[s++] = *f++;
+        while (*f && strchr("-+ #0", *f) && s < 8) spec[s++] = *f++;
+        while (*f >= '0' && *f <= '9' && s < 16) spec[s++] = *f++;
+        if (*f == '.') {
+            spec[s++] = *f++;
+            while (*f >= '0' && *f <= '9' && s < 24) spec[s++] = *f++;
+        }
+        while (*f && strchr("hlLzjtqI", *f)) {
+            if (*f++ == 'I') while (*f >= '0' && *f <= '9') f++;  // MSVC 的 I64、I32
+        }
+        char conversion = *f;
+        if (!conversion) break;
+        f++;
+
+        if (argIndex >= record.argCount) {
+            Advance(out, size, snprintf(buffer + out, size - out, "<?>"));
+            continue;
+        }
+        LogRecord::ArgType type = record.argTypes[argIndex];
+        LogRecord::Arg arg = record.args[argIndex];
+        argIndex++;
+
+        long long asSigned = type == LogRecord::ARG_DOUBLE ? (long long)arg.d : arg.i;
+        double asDouble = type == LogRecord::ARG_DOUBLE ? arg.d
+                        : type == LogRecord::ARG_UINT ? (double)arg.u : (double)arg.i;
+        int written = 0;
+        switch (conversion) {
+            case 'd': case 'i':
+                spec[s++] = 'l'; spec[s++] = 'l'; spec[s++] = conversion; spec[s] = '\0';
+                written = snprintf(buffer + out, size - out, spec, asSigned);
+                break;
+            case 'u': case 'x': case 'X': case 'o':
+                spec[s++] = 'l'; spec[s++] = 'l'; spec[s++] = conversion; spec[s] = '\0';
+                written = snprintf(buffer + out, size - out, spec, (unsigned long long)asSigned);
+                break;
+            case 'c':
+                spec[s++] = 'c'; spec[s] = '\0';
+                written = snprintf(buffer + out, size - out, spec, (int)asSigned);
+                break;
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+                spec[s++] = conversion; spec[s] = '\0';
+                written = snprintf(buffer + out, size - out, spec, asDouble);
+                break;
+            case 's':
+                spec[s++] = 's'; spec[s] = '\0';
+                written = snprintf(buffer + out, size - out, spec,
+                                   type == LogRecord::ARG_STRING ? record.text + arg.u : "<?>");
+                break;
+            case 'p':
+                spec[s++] = 'p'; spec[s] = '\0';
+                written = snprintf(buffer + out, size - out, spec, arg.p);
+                break;
+            default:
+                written = snprintf(buffer + out, size - out, "<?>");
+                break;
+        }
+        Advance(out, size, written);
+    }
+    buffer[out] = '\0';
+    return out;
+}
+
+/**
+ * @brief 取出并输出缓冲区中的全部记录
+ * 
+ * 每条记录输出为一行：[级别 秒数 线程] 消息。
+ * 若上次输出之后有记录被丢弃，先输出一行丢弃数。
+ */
+size_t Log::Flush() {
+    LogRing& ring = Ring();
+    char line[1024];
+    size_t count = 0;
+
+    for (;;) {
+        LogSlot& slot = ring.slots[ring.head & (CAPACITY - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != ring.head + 1) break;
+
+        size_t dropped = ring.dropped.load(std::memory_order_relaxed);
+        if (dropped != ring.reportedDropped) {
+            snprintf(line, sizeof(line), "[WARN] 日志缓冲区已满，丢弃了 %llu 条记录\n",
+                     (unsigned long long)(dropped - ring.reportedDropped));
+            WriteLine(line);
+            ring.reportedDropped = dropped;
+        }
+
+        const LogRecord& record = slot.record;
+        double seconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::duration(record.timestamp - ring.startTime)).count();
+        size_t length = 0;
+        Advance(length, sizeof(line), snprintf(line, sizeof(line), "[%s %.3f #%u] ",
+                                               LevelName(record.level), seconds, record.threadId));
+        length += Format(record, line + length, sizeof(line) - length - 1);
+        line[length++] = '\n';
+        line[length] = '\0';
+        WriteLine(line);
+
+        slot.sequence.store(ring.head + CAPACITY, std::memory_order_release);
+        ring.head++;
+        count++;
+    }
+    return count;
+}
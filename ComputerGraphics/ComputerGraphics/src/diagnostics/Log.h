@@ -0,0 +1,238 @@
+﻿/**
+ * @dir diagnostics
+ * @brief 诊断工具目录
+ * 
+ * 本目录包含不参与图形计算、只用于观察程序运行状态的工具。
+ * 
+ * 目录内容：
+ * - Log.*      - 编译期按级别裁剪的日志，二进制记录写入无锁环形缓冲区，由后台线程格式化输出
+ * - Profiler.* - 作用域计时区，记录写入线程局部缓冲区，导出为 Chrome trace-event JSON
+ * 
+ * 使用说明：
+ * 各模块通过 LOG_TRACE / LOG_DEBUG / LOG_INFO / LOG_WARN / LOG_ERROR 宏记录日志，
+ * 不直接调用 sprintf_s + OutputDebugStringA；
+ * 需要计时的函数或代码段使用 PROFILE_FUNCTION / PROFILE_ZONE 宏。
+ */
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file Log.h
+ * @brief 分级日志定义
+ * @author ln1.opensource@gmail.com
+ */
+
+/**
+ * @enum LogLevel
+ * @brief 日志级别，数值越大越重要
+ */
+enum LogLevel {
+    LOG_LEVEL_TRACE = 0,  ///< 每帧、每次鼠标移动等高频事件
+    LOG_LEVEL_DEBUG = 1,  ///< 单次用户操作的细节
+    LOG_LEVEL_INFO = 2,   ///< 资源创建、释放等状态变化
+    LOG_LEVEL_WARN = 3,   ///< 可以继续运行的异常情况（例如功能退化）
+    LOG_LEVEL_ERROR = 4,  ///< 操作失败
+    LOG_LEVEL_OFF = 5     ///< 关闭全部日志
+};
+
+/**
+ * 编译期日志级别：低于该级别的日志宏展开为空语句，参数也不会求值。
+ * Debug 构建默认保留 DEBUG 及以上，Release 构建只保留 WARN 及以上，
+ * 可以在工程的预处理器定义中覆盖（例如 LOG_COMPILE_LEVEL=0 打开 TRACE）。
+ */
+#ifndef LOG_COMPILE_LEVEL
+#ifdef _DEBUG
+#define LOG_COMPILE_LEVEL 1
+#else
+#define LOG_COMPILE_LEVEL 3
+#endif
+#endif
+
+#define LOG_WRITE(level, ...) \
+    do { if (Log::IsEnabled(level)) Log::Write(level, __VA_ARGS__); } while (0)
+
+#if LOG_COMPILE_LEVEL <= 0
+#define LOG_TRACE(...) LOG_WRITE(LOG_LEVEL_TRACE, __VA_ARGS__)
+#else
+#define LOG_TRACE(...) ((void)0)
+#endif
+
+#if LOG_COMPILE_LEVEL <= 1
+#define LOG_DEBUG(...) LOG_WRITE(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) ((void)0)
+#endif
+
+#if LOG_COMPILE_LEVEL <= 2
+#define LOG_INFO(...) LOG_WRITE(LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...) ((void)0)
+#endif
+
+#if LOG_COMPILE_LEVEL <= 3
+#define LOG_WARN(...) LOG_WRITE(LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define LOG_WARN(...) ((void)0)
+#endif
+
+#if LOG_COMPILE_LEVEL <= 4
+#define LOG_ERROR(...) LOG_WRITE(LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) ((void)0)
+#endif
+
+/**
+ * @struct LogRecord
+ * @brief 一条日志的二进制记录（定长，不含格式化后的文本）
+ * 
+ * 格式串只保存指针，必须是字符串字面量；参数按类型存放在8字节槽中，
+ * 字符串参数复制到记录内的 text 区（超长时截断），因此调用返回后原字符串可以释放。
+ */
+struct LogRecord {
+    static const int MAX_ARGS = 10;    ///< 参数个数上限
+    static const int TEXT_SIZE = 80;   ///< 字符串参数的总容量（含结尾的0）
+
+    /**
+     * @enum ArgType
+     * @brief 参数槽中保存的值的类型
+     */
+    enum ArgType : unsigned char {
+        ARG_INT,       ///< 有符号整数（long long）
+        ARG_UINT,      ///< 无符号整数（unsigned long long）
+        ARG_DOUBLE,    ///< 浮点数
+        ARG_STRING,    ///< 字符串，槽中保存在 text 区的偏移
+        ARG_POINTER    ///< 指针
+    };
+
+    union Arg {
+        long long i;
+        unsigned long long u;
+        double d;
+        const void* p;
+    };
+
+    int64_t timestamp;           ///< 写入时刻（std::chrono::steady_clock 计数）
+    const char* format;          ///< printf 风格格式串（字符串字面量）
+    uint32_t threadId;           ///< 写入线程
+    unsigned char level;         ///< LogLevel
+    unsigned char argCount;      ///< 参数个数
+    unsigned char textUsed;      ///< text 区已用字节数
+    ArgType argTypes[MAX_ARGS];  ///< 各参数的类型
+    Arg args[MAX_ARGS];          ///< 参数值
+    char text[TEXT_SIZE];        ///< 字符串参数的副本
+};
+
+/**
+ * @class Log
+ * @brief 分级日志：写入端只打包二进制记录，格式化和输出在后台线程完成
+ * 
+ * 写入一条日志只需把格式串指针和参数复制进定长记录，再放入无锁的有界环形缓冲区
+ * （多生产者、单消费者），不做任何字符串格式化，也不进入系统调用。
+ * Start 启动的后台线程取出记录，格式化后交给 OutputDebugStringA（非Windows平台写到标准错误）；
+ * 缓冲区为空时线程阻塞在条件变量上，有新记录时才被唤醒。
+ * 
+ * 缓冲区满时新记录被丢弃而不是阻塞写入线程，丢弃的条数随下一条输出一起报告。
+ * 没有调用 Start 时记录只会积压直到缓冲区满，不影响程序运行。
+ */
+class Log {
+public:
+    static const size_t CAPACITY = 2048;  ///< 环形缓冲区容量（记录数，2的幂）
+
+    /**
+     * @brief 启动后台输出线程（重复调用无效；编译期关闭全部日志时不启动）
+     */
+    static void Start();
+
+    /**
+     * @brief 输出缓冲区中剩余的记录并停止后台线程
+     */
+    static void Stop();
+
+    /**
+     * @brief 设置运行期日志级别（只能在编译期级别之上进一步过滤）
+     */
+    static void SetLevel(LogLevel level) { runtimeLevel.store(level, std::memory_order_relaxed); }
+
+    static bool IsEnabled(LogLevel level) { return level >= runtimeLevel.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 打包并提交一条日志（通常通过 LOG_* 宏调用）
+     * @param level 日志级别
+     * @param format printf 风格格式串，必须是字符串字面量
+     * @param args 参数（整数、浮点数、字符串或指针），最多 LogRecord::MAX_ARGS 个
+     */
+    template <typename... Args>
+    static void Write(LogLevel level, const char* format, const Args&... args) {
+        static_assert(sizeof...(Args) <= LogRecord::MAX_ARGS, "日志参数过多");
+        LogRecord record;
+        record.format = format;
+        record.level = (unsigned char)level;
+        record.argCount = 0;
+        record.textUsed = 0;
+        int expand[] = { 0, (Pack(record, args), 0)... };
+        (void)expand;
+        Submit(record);
+    }
+
+    /**
+     * @brief 把一条记录格式化为文本
+     * @param record 日志记录
+     * @param buffer 输出缓冲区
+     * @param size 缓冲区大小（输出总以0结尾，超长时截断）
+     * @return 写入的字符数（不含结尾的0）
+     * 
+     * 每个转换说明单独交给 snprintf，整数统一按 long long 输出，
+     * 参数类型与转换说明不一致时按转换说明转换（例如 %d 对应浮点参数时取整）。
+     */
+    static size_t Format(const LogRecord& record, char* buffer, size_t size);
+
+    /**
+     * @brief 自启动以来因缓冲区满被丢弃的记录数
+     */
+    static size_t DroppedCount();
+
+    /**
+     * @brief 取出并输出缓冲区中的全部记录
+     * @return 输出的记录数
+     * 
+     * 缓冲区只有一个消费者：后台线程运行期间由它调用，未启动或 Stop 之后才可以手动调用。
+     */
+    static size_t Flush();
+
+private:
+    static void Submit(LogRecord& record);
+
+    static void PackValue(LogRecord& record, LogRecord::ArgType type, LogRecord::Arg value) {
+        record.argTypes[record.argCount] = type;
+        record.args[record.argCount] = value;
+        record.argCount++;
+    }
+    static void PackSigned(LogRecord& record, long long v) { LogRecord::Arg a; a.i = v; PackValue(record, LogRecord::ARG_INT, a); }
+    static void PackUnsigned(LogRecord& record, unsigned long long v) { LogRecord::Arg a; a.u = v; PackValue(record, LogRecord::ARG_UINT, a); }
+    static void PackString(LogRecord& record, const char* s);
+
+    static void Pack(LogRecord& record, bool v) { PackSigned(record, v ? 1 : 0); }
+    static void Pack(LogRecord& record, char v) { PackSigned(record, v); }
+    static void Pack(LogRecord& record, signed char v) { PackSigned(record, v); }
+    static void Pack(LogRecord& record, short v) { PackSigned(record, v); }
+    static void Pack(LogRecord& record, int v) { PackSigned(record, v); }
+    static void Pack(LogRecord& record, long v) { PackSigned(record, v); }
+    static void Pack(LogRecord& record, long long v) { PackSigned(record, v); }
+    static void Pack(LogRecord& record, unsigned char v) { PackUnsigned(record, v); }
+    static void Pack(LogRecord& record, unsigned short v) { PackUnsigned(record, v); }
+    static void Pack(LogRecord& record, unsigned int v) { PackUnsigned(record, v); }
+    static void Pack(LogRecord& record, unsigned long v) { PackUnsigned(record, v); }
+    static void Pack(LogRecord& record, unsigned long long v) { PackUnsigned(record, v); }
+    static void Pack(LogRecord& record, float v) { LogRecord::Arg a; a.d = v; PackValue(record, LogRecord::ARG_DOUBLE, a); }
+    static void Pack(LogRecord& record, double v) { LogRecord::Arg a; a.d = v; PackValue(record, LogRecord::ARG_DOUBLE, a); }
+    static void Pack(LogRecord& record, const char* v) { PackString(record, v); }
+    static void Pack(LogRecord& record, char* v) { PackString(record, v); }
+    template <size_t N>
+    static void Pack(LogRecord& record, const char (&v)[N]) { PackString(record, v); }
+    static void Pack(LogRecord& record, const void* v) { LogRecord::Arg a; a.p = v; PackValue(record, LogRecord::ARG_POINTER, a); }
+
+    static std::atomic<int> runtimeLevel;  ///< 运行期日志级别
+};
@@ -0,0 +1,194 @@
+﻿/**
+ * @file Profiler.cpp
+ * @brief 帧内分段计时实现
+ * @author ln1.opensource@gmail.com
+ * 
+ * 【线程局部缓冲区】
+ * 每个线程第一次记录计时区时创建自己的缓冲区，并登记到全局列表（仅此一次加锁）；
+ * 之后的记录只追加到本线程的缓冲区。线程结束时缓冲区标记为已退出但仍保留在列表中，
+ * 其中的记录照常导出，下一次 StartCapture 时才释放。
+ * 缓冲区在登记时一次预留 MAX_EVENTS_PER_THREAD 条记录的空间，采集期间追加记录不会重新分配内存。
+ */
+
+#include "Profiler.h"
+#include "ThreadId.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+std::atomic<bool> Profiler::capturing(false);
+
+namespace {
+
+/**
+ * @struct ThreadBuffer
+ * @brief 一个线程的计时区记录
+ */
+struct ThreadBuffer {
+    uint32_t threadId;                ///< 线程编号（见 ThreadId.h）
+    std::vector<ProfileEvent> events; ///< 已结束的计时区（仅所属线程追加）
+    size_t dropped;                   ///< 因超出 MAX_EVENTS_PER_THREAD 被丢弃的计时区数
+    bool exited;                      ///< 所属线程已结束（在注册表的锁内读写）
+};
+
+/**
+ * @struct BufferRegistry
+ * @brief 所有线程的缓冲区
+ */
+struct BufferRegistry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    int64_t captureStart = 0;         ///< 本次采集的开始时刻（导出时的时间零点）
+};
+
+BufferRegistry& Registry() {
+    static BufferRegistry registry;
+    return registry;
+}
+
+/**
+ * @struct ThreadSlot
+ * @brief 线程局部的缓冲区引用，线程结束时把缓冲区标记为已退出
+ */
+struct ThreadSlot {
+    std::shared_ptr<ThreadBuffer> buffer;
+
+    ~ThreadSlot() {
+        if (!buffer) return;
+        BufferRegistry& registry = Registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        buffer->exited = true;
+    }
+};
+
+thread_local ThreadSlot localSlot;
+
+ThreadBuffer& LocalBuffer() {
+    if (!localSlot.buffer) {
+        std::shared_ptr<ThreadBuffer> buffer = std::make_shared<ThreadBuffer>();
+        buffer->threadId = CurrentThreadId();
+        buffer->events.reserve(Profiler::MAX_EVENTS_PER_THREAD);
+        buffer->dropped = 0;
+        buffer->exited = false;
+        BufferRegistry& registry = Registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.buffers.push_back(buffer);
+        localSlot.buffer = buffer;
+    }
+    return *localSlot.buffer;
+}
+
+/**
+ * @brief 把计时区名称写成JSON字符串内容（转义引号、反斜杠和控制字符）
+ */
+void EscapeJson(const char* text, char* out, size_t size) {
+    size_t n = 0;
+    for (const char* p = text; *p && n + 7 < size; p++) {
+        unsigned char c = (unsigned char)*p;
+        if (c == '"' || c == '\\') {
+            out[n++] = '\\';
+            out[n++] = (char)c;
+        } else if (c < 0x20) {
+            n += snprintf(out + n, size - n, "\\u%04x", c);
+        } else {
+            out[n++] = (char)c;
+        }
+    }
+    out[n] = 0;
+}
+
+}  // namespace
+
+void Profiler::StartCapture() {
+    BufferRegistry& registry = Registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    
+    // 已退出线程的缓冲区不会再被写入，直接释放；其余的清空后继续使用（保留已预留的空间）
+    size_t kept = 0;
+    for (size_t i = 0; i < registry.buffers.size(); i++) {
+        std::shared_ptr<ThreadBuffer>& buffer = registry.buffers[i];
+        if (buffer->exited) continue;
+        buffer->events.clear();
+        buffer->dropped = 0;
+        registry.buffers[kept++] = buffer;
+    }
+    registry.buffers.resize(kept);
+    registry.captureStart = Now();
+    capturing.store(true, std::memory_order_relaxed);
+}
+
+void Profiler::StopCapture() {
+    capturing.store(false, std::memory_order_relaxed);
+}
+
+int64_t Profiler::Now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Profiler::Record(const char* name, int64_t start, int64_t end) {
+    ThreadBuffer& buffer = LocalBuffer();
+    if (buffer.events.size() >= MAX_EVENTS_PER_THREAD) {
+        buffer.dropped++;
+        return;
+    }
+    ProfileEvent event = { name, start, end - start };
+    buffer.events.push_back(event);
+}
+
+size_t Profiler::EventCount() {
+    BufferRegistry& registry = Registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    size_t count = 0;
+    for (size_t i = 0; i < registry.buffers.size(); i++) count += registry.buffers[i]->events.size();
+    return count;
+}
+
+size_t Profiler::DroppedCount() {
+    BufferRegistry& registry = Registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    size_t count = 0;
+    for (size_t i = 0; i < registry.buffers.size(); i++) count += registry.buffers[i]->dropped;
+    return count;
+}
+
+/**
+ * 输出格式（JSON对象格式，事件不要求按时间排序）：
+ * {"displayTimeUnit":"ms","traceEvents":[
+ * {"name":"...","cat":"frame","ph":"X","pid":1,"tid":2,"ts":12.345,"dur":0.678},
+ * ...
+ * ]}
+ */
+bool Profiler::WriteChromeTrace(const char* path) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+    
+    BufferRegistry& registry = Registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    
+    // 只导出本进程的记录，进程号取常量即可
+    const unsigned long pid = 1;
+    char name[256];
+    char line[512];
+    bool first = true;
+    
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for (size_t i = 0; i < registry.buffers.size(); i++) {
+        const ThreadBuffer& buffer = *registry.buffers[i];
+        for (size_t j = 0; j < buffer.events.size(); j++) {
+            const ProfileEvent& event = buffer.events[j];
+            EscapeJson(event.name, name, sizeof(name));
+            int length = snprintf(line, sizeof(line),
+                "%s\n{\"name\":\"%s\",\"cat\":\"frame\",\"ph\":\"X\",\"pid\":%lu,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                first ? "" : ",", name, pid, buffer.threadId,
+                (event.start - registry.captureStart) / 1000.0, event.duration / 1000.0);
+            out.write(line, length);
+            first = false;
+        }
+    }
+    out << "\n]}\n";
+    return (bool)out;
+}
@@ -0,0 +1,125 @@
+﻿#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file Profiler.h
+ * @brief 帧内分段计时（作用域计时区）
+ * @author ln1.opensource@gmail.com
+ */
+
+/**
+ * 编译期开关：为0时 PROFILE_ZONE / PROFILE_FUNCTION 展开为空语句，不留下任何开销。
+ * 默认打开；未采集时每个计时区只多一次原子读取，可以在工程的预处理器定义中覆盖。
+ */
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED 1
+#endif
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#if PROFILER_ENABLED
+/// 从此处到所在作用域结束计为一个计时区，name 必须是字符串字面量
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone_, __LINE__)(name)
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#endif
+
+/// 以所在函数名（MSVC 下含类名）为计时区名称
+#define PROFILE_FUNCTION() PROFILE_ZONE(__FUNCTION__)
+
+/**
+ * @struct ProfileEvent
+ * @brief 一个已结束的计时区
+ */
+struct ProfileEvent {
+    const char* name;  ///< 计时区名称（字符串字面量）
+    int64_t start;     ///< 开始时刻（纳秒，std::chrono::steady_clock）
+    int64_t duration;  ///< 持续时间（纳秒）
+};
+
+/**
+ * @class Profiler
+ * @brief 计时区的采集与导出
+ * 
+ * 每个线程把结束的计时区追加到自己的线程局部缓冲区，写入时不加锁、不与其他线程共享数据。
+ * 只有在 StartCapture 与 StopCapture 之间开始的计时区会被记录。
+ * 
+ * 线程约定：StartCapture、StopCapture、WriteChromeTrace 和 EventCount 会读写所有线程的缓冲区，
+ * 只能在没有其他线程处于计时区内时调用（例如在主线程的消息处理中；
+ * 软件光栅化的工作线程在每帧返回前都已结束）。
+ */
+class Profiler {
+public:
+    static const size_t MAX_EVENTS_PER_THREAD = 1 << 18;  ///< 每个线程最多记录的计时区数，超出的被丢弃
+
+    /**
+     * @brief 清空之前的记录并开始采集
+     */
+    static void StartCapture();
+
+    /**
+     * @brief 停止采集（已记录的计时区保留到下一次 StartCapture）
+     */
+    static void StopCapture();
+
+    static bool IsCapturing() { return capturing.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 当前时刻（纳秒，std::chrono::steady_clock）
+     */
+    static int64_t Now();
+
+    /**
+     * @brief 记录一个已结束的计时区到调用线程的缓冲区（通常由 ProfileZone 调用）
+     */
+    static void Record(const char* name, int64_t start, int64_t end);
+
+    /**
+     * @brief 本次采集记录的计时区总数
+     */
+    static size_t EventCount();
+
+    /**
+     * @brief 本次采集因缓冲区满被丢弃的计时区数
+     */
+    static size_t DroppedCount();
+
+    /**
+     * @brief 把本次采集的全部计时区写成 Chrome trace-event JSON
+     * @param path 输出文件路径
+     * @return 文件写入成功返回true
+     * 
+     * 每个计时区写成一个完整事件（"ph":"X"），时间以采集开始为零点、单位为微秒，
+     * 线程号即系统线程ID。生成的文件可以直接在 chrome://tracing 或 Perfetto 中打开。
+     */
+    static bool WriteChromeTrace(const char* path);
+
+private:
+    static std::atomic<bool> capturing;
+};
+
+/**
+ * @class ProfileZone
+ * @brief 作用域计时区：构造时记下开始时刻，析构时记录一条 ProfileEvent
+ * 
+ * 构造时没有在采集则整个计时区不做任何记录。通常通过 PROFILE_ZONE 宏使用。
+ */
+class ProfileZone {
+public:
+    explicit ProfileZone(const char* zoneName)
+        : name(zoneName), start(Profiler::IsCapturing() ? Profiler::Now() : -1) {}
+
+    ~ProfileZone() {
+        if (start >= 0) Profiler::Record(name, start, Profiler::Now());
+    }
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    const char* name;
+    int64_t start;
+};
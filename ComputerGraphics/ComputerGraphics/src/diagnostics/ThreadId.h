@@ -0,0 +1,22 @@
+﻿#pragma once
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @file ThreadId.h
+ * @brief 不依赖操作系统接口的线程编号
+ * @author ln1.opensource@gmail.com
+ */
+
+/**
+ * @brief 当前线程的编号
+ * 
+ * 每个线程第一次调用时从全局计数器取一个编号（从1开始，按首次调用的先后递增），
+ * 之后直接读取线程局部变量。日志与计时共用同一套编号，同一线程在两边显示相同的值；
+ * 编号只在本进程内有意义，与系统线程ID无关。
+ */
+inline uint32_t CurrentThreadId() {
+    static std::atomic<uint32_t> next(1);
+    thread_local uint32_t id = next.fetch_add(1, std::memory_order_relaxed);
+    return id;
+}
@@ -0,0 +1,173 @@
+﻿/**
+ * @file Camera.cpp
+ * @brief 轨道摄像机及其矩阵缓存实现
+ * @author ln1.opensource@gmail.com
+ * 
+ * 【逆矩阵】
+ * 视图矩阵是刚体变换 [A | t]，A 为正交矩阵，逆矩阵为 [Aᵀ | -Aᵀt]。
+ * 透视投影矩阵只有五个非零元素，逆矩阵可以直接写出：
+ *   x_e = x_c / P00，y_e = y_c / P11，z_e = -w_c，w_e = (z_c + P22 × w_c) / P32
+ * 两者都不需要通用的4×4求逆。
+ */
+
+#include "Camera.h"
+#include "FrustumCuller.h"
+#include <cmath>
+
+const float Camera::FOV_Y = 45.0f;
+const float Camera::NEAR_PLANE = 0.1f;
+const float Camera::FAR_PLANE = 100.0f;
+const float Camera::MIN_DISTANCE = 1.0f;
+const float Camera::MAX_DISTANCE = 50.0f;
+const float Camera::MAX_PITCH = 89.0f;
+
+Camera::Camera()
+    : distance(5.0f), angleX(0.0f), angleY(0.0f), viewportWidth(1), viewportHeight(1),
+      viewDirty(true), projectionDirty(true) {
+    target[0] = target[1] = target[2] = 0.0f;
+}
+
+void Camera::Orbit(float deltaAngleX, float deltaAngleY) {
+    float newAngleY = angleY + deltaAngleY;
+    if (newAngleY > MAX_PITCH) newAngleY = MAX_PITCH;
+    if (newAngleY < -MAX_PITCH) newAngleY = -MAX_PITCH;
+    if (deltaAngleX == 0.0f && newAngleY == angleY) return;
+
+    angleX += deltaAngleX;
+    angleY = newAngleY;
+    viewDirty = true;
+}
+
+void Camera::Zoom(float deltaDistance) {
+    float newDistance = distance + deltaDistance;
+    if (newDistance < MIN_DISTANCE) newDistance = MIN_DISTANCE;
+    if (newDistance > MAX_DISTANCE) newDistance = MAX_DISTANCE;
+    if (newDistance == distance) return;
+
+    distance = newDistance;
+    viewDirty = true;
+}
+
+void Camera::SetViewport(int width, int height) {
+    if (width <= 0 || height <= 0) return;
+    // 投影只依赖宽高比，等比例缩放窗口不需要重算
+    if ((long long)width * viewportHeight != (long long)height * viewportWidth) projectionDirty = true;
+    viewportWidth = width;
+    viewportHeight = height;
+}
+
+/**
+ * @brief 按脏标记重新计算缓存的矩阵和平面
+ * 
+ * 视图矩阵的构造与固定管线一直使用的 gluLookAt 风格矩阵逐项相同：
+ * 先由球坐标求出摄像机位置，再求前向、右向、上向量，
+ * 按列存放 (右, 上, -前, 平移)。
+ */
+void Camera::Update() const {
+    if (!viewDirty && !projectionDirty) return;
+
+    if (viewDirty) {
+        // 球坐标转笛卡尔坐标
+        float radX = angleX * (float)M_PI / 180.0f;
+        float radY = angleY * (float)M_PI / 180.0f;
+        float cameraX = target[0] + distance * cosf(radY) * sinf(radX);
+        float cameraY = target[1] + distance * sinf(radY);
+        float cameraZ = target[2] + distance * cosf(radY) * cosf(radX);
+
+        // 前向向量（指向目标点）
+        float forwardX = target[0] - cameraX;
+        float forwardY = target[1] - cameraY;
+        float forwardZ = target[2] - cameraZ;
+        float forwardLen = sqrtf(forwardX * forwardX + forwardY * forwardY + forwardZ * forwardZ);
+        if (forwardLen > 0.0001f) {
+            forwardX /= forwardLen;
+            forwardY /= forwardLen;
+            forwardZ /= forwardLen;
+        }
+
+        // 右向量 = 前向 × 世界上向量(0, 1, 0)
+        float rightX = -forwardZ;
+        float rightY = 0.0f;
+        float rightZ = forwardX;
+        float rightLen = sqrtf(rightX * rightX + rightZ * rightZ);
+        if (rightLen > 0.0001f) {
+            rightX /= rightLen;
+            rightZ /= rightLen;
+        }
+
+        // 真正的上向量 = 右向 × 前向
+        float upX = rightY * forwardZ - rightZ * forwardY;
+        float upY = rightZ * forwardX - rightX * forwardZ;
+        float upZ = rightX * forwardY - rightY * forwardX;
+
+        const float columns[16] = {
+            rightX,     rightY,     rightZ,     0.0f,  // 第一列
+            upX,        upY,        upZ,        0.0f,  // 第二列
+            -forwardX,  -forwardY,  -forwardZ,  0.0f,  // 第三列
+            -(rightX * cameraX + rightY * cameraY + rightZ * cameraZ),
+            -(upX * cameraX + upY * cameraY + upZ * cameraZ),
+            (forwardX * cameraX + forwardY * cameraY + forwardZ * cameraZ),
+            1.0f                                       // 第四列
+        };
+        for (int i = 0; i < 16; i++) view.m[i] = columns[i];
+
+        // 逆视图矩阵：[Aᵀ | -Aᵀt]
+        const float* t = &view.m[12];
+        for (int row = 0; row < 3; row++) {
+            for (int col = 0; col < 3; col++)
+                inverseView.m[col * 4 + row] = view.m[row * 4 + col];
+            inverseView.m[12 + row] = -(view.m[row * 4 + 0] * t[0] + view.m[row * 4 + 1] * t[1] + view.m[row * 4 + 2] * t[2]);
+            inverseView.m[row * 4 + 3] = 0.0f;
+        }
+        inverseView.m[15] = 1.0f;
+    }
+
+    if (projectionDirty) {
+        float aspectRatio = (float)viewportWidth / (float)viewportHeight;
+        projection = Matrix4::perspective(FOV_Y * (float)M_PI / 180.0f, aspectRatio, NEAR_PLANE, FAR_PLANE);
+
+        const float* p = projection.m;
+        for (int i = 0; i < 16; i++) inverseProjection.m[i] = 0.0f;
+        inverseProjection.m[0] = 1.0f / p[0];
+        inverseProjection.m[5] = 1.0f / p[5];
+        inverseProjection.m[14] = -1.0f;
+        inverseProjection.m[11] = 1.0f / p[14];
+        inverseProjection.m[15] = p[10] / p[14];
+    }
+
+    viewProjection = projection * view;
+    inverseViewProjection = inverseView * inverseProjection;
+    FrustumCuller::ExtractPlanes(viewProjection.m, planes);
+
+    viewDirty = false;
+    projectionDirty = false;
+}
+
+/**
+ * @brief 构造经过视口中某个像素中心的拾取射线
+ * 
+ * 眼睛空间中经过像素中心的方向为 (ndcX / P00, ndcY / P11, -1)，
+ * z 分量为-1，所以射线参数 t 就是眼睛空间深度；再用逆视图矩阵变换到世界空间。
+ */
+void Camera::BuildPickRay(int x, int y, Ray3D& ray) const {
+    Update();
+
+    // 像素中心 → NDC（屏幕Y轴向下，NDC的Y轴向上）
+    float ndcX = 2.0f * ((float)x + 0.5f) / (float)viewportWidth - 1.0f;
+    float ndcY = 1.0f - 2.0f * ((float)y + 0.5f) / (float)viewportHeight;
+    float eyeDir[3] = { ndcX * inverseProjection.m[0], ndcY * inverseProjection.m[5], -1.0f };
+
+    const float* m = inverseView.m;
+    for (int row = 0; row < 3; row++) {
+        ray.origin[row] = m[12 + row];
+        ray.direction[row] = m[row] * eyeDir[0] + m[4 + row] * eyeDir[1] + m[8 + row] * eyeDir[2];
+    }
+    ray.tMin = NEAR_PLANE;
+    ray.tMax = FAR_PLANE;
+}
+
+float Camera::WorldUnitsPerPixel(float depth) const {
+    Update();
+    // 深度 depth 处视口高度对应 2 × depth / P11 个世界单位
+    return 2.0f * depth * inverseProjection.m[5] / (float)viewportHeight;
+}
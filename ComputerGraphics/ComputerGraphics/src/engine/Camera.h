@@ -0,0 +1,113 @@
+﻿#pragma once
+#include "SceneBvh.h"
+#include "../math/Matrix4.h"
+
+/**
+ * @file Camera.h
+ * @brief 轨道摄像机及其矩阵缓存定义
+ * @author ln1.opensource@gmail.com
+ */
+
+/**
+ * @class Camera
+ * @brief 围绕目标点旋转的摄像机，缓存视图、投影矩阵及其逆矩阵和视锥平面
+ * 
+ * 摄像机位于以目标点为球心、distance为半径的球面上，
+ * 由 angleX（水平）、angleY（垂直）两个角度确定位置，始终看向目标点。
+ * 
+ * 所有派生数据（视图、投影、视图投影矩阵，三者的逆矩阵，六个视锥平面，摄像机位置）
+ * 都在第一次读取时才计算，之后一直复用，直到轨道参数或视口宽高比真正发生变化。
+ * 因此渲染、拾取、拖拽和剔除可以随时读取，不改变摄像机的鼠标操作不会触发任何重算。
+ */
+class Camera {
+public:
+    static const float FOV_Y;        ///< 垂直视场角（度）
+    static const float NEAR_PLANE;   ///< 近裁剪面
+    static const float FAR_PLANE;    ///< 远裁剪面
+    static const float MIN_DISTANCE; ///< 最近距离
+    static const float MAX_DISTANCE; ///< 最远距离
+    static const float MAX_PITCH;    ///< 垂直角度上限（度），防止摄像机翻转
+
+    Camera();
+
+    /**
+     * @brief 旋转摄像机
+     * @param deltaAngleX 水平角度增量（度）
+     * @param deltaAngleY 垂直角度增量（度），结果限制在 [-MAX_PITCH, MAX_PITCH]
+     */
+    void Orbit(float deltaAngleX, float deltaAngleY);
+
+    /**
+     * @brief 拉近或推远摄像机
+     * @param deltaDistance 距离增量，结果限制在 [MIN_DISTANCE, MAX_DISTANCE]
+     */
+    void Zoom(float deltaDistance);
+
+    /**
+     * @brief 设置视口尺寸
+     * @param width 视口宽度（像素）
+     * @param height 视口高度（像素）
+     * 
+     * 只有宽高比变化时投影矩阵才失效；尺寸无效时忽略。
+     */
+    void SetViewport(int width, int height);
+
+    float GetDistance() const { return distance; }
+    float GetAngleX() const { return angleX; }
+    float GetAngleY() const { return angleY; }
+    int GetViewportWidth() const { return viewportWidth; }
+    int GetViewportHeight() const { return viewportHeight; }
+
+    const Matrix4& View() const { Update(); return view; }
+    const Matrix4& Projection() const { Update(); return projection; }
+    const Matrix4& ViewProjection() const { Update(); return viewProjection; }
+    const Matrix4& InverseView() const { Update(); return inverseView; }
+    const Matrix4& InverseProjection() const { Update(); return inverseProjection; }
+    const Matrix4& InverseViewProjection() const { Update(); return inverseViewProjection; }
+
+    /**
+     * @brief 视锥平面：左、右、下、上、近、远，(nx, ny, nz, d) 法线指向内部且已归一化
+     */
+    const float (*FrustumPlanes() const)[4] { Update(); return planes; }
+
+    /**
+     * @brief 摄像机在世界空间中的位置（视图矩阵逆变换的平移部分）
+     */
+    const float* Position() const { Update(); return &inverseView.m[12]; }
+
+    /**
+     * @brief 构造经过视口中某个像素中心的拾取射线
+     * @param x 像素X坐标
+     * @param y 像素Y坐标（向下为正）
+     * @param ray 输出的世界空间射线，t 等于眼睛空间深度，范围为 [近裁剪面, 远裁剪面]
+     */
+    void BuildPickRay(int x, int y, Ray3D& ray) const;
+
+    /**
+     * @brief 屏幕上一个像素在指定眼睛空间深度处对应的世界空间长度
+     * @param depth 眼睛空间深度
+     */
+    float WorldUnitsPerPixel(float depth) const;
+
+private:
+    /**
+     * @brief 按脏标记重新计算缓存的矩阵和平面
+     */
+    void Update() const;
+
+    float distance;    ///< 摄像机到目标点的距离
+    float angleX;      ///< 水平旋转角度（绕Y轴，度）
+    float angleY;      ///< 垂直旋转角度（绕X轴，度）
+    float target[3];   ///< 目标点
+    int viewportWidth, viewportHeight;  ///< 视口尺寸（像素）
+
+    mutable bool viewDirty;                    ///< 轨道参数变化后视图矩阵失效
+    mutable bool projectionDirty;              ///< 宽高比变化后投影矩阵失效
+    mutable Matrix4 view;                      ///< 视图矩阵
+    mutable Matrix4 projection;                ///< 投影矩阵
+    mutable Matrix4 viewProjection;            ///< 投影 × 视图
+    mutable Matrix4 inverseView;               ///< 视图矩阵的逆
+    mutable Matrix4 inverseProjection;         ///< 投影矩阵的逆
+    mutable Matrix4 inverseViewProjection;     ///< 视图投影矩阵的逆
+    mutable float planes[6][4];                ///< 视锥平面
+};
@@ -0,0 +1,162 @@
+﻿/**
+ * @file EditHistory.cpp
+ * @brief 2D编辑操作的撤销/重做日志实现
+ * @author ln1.opensource@gmail.com
+ * 
+ * 本文件实现了命令的记录、撤销与重做：
+ * 1. 单个图形的增加/修改只保存图形指针
+ * 2. 批量操作保存操作前的状态（扫描线填充只保存被修改的行），撤销与重做都是交换
+ * 3. 历史层数与像素快照内存的上限控制（内存随命令进出增量统计）
+ */
+
+#include "EditHistory.h"
+#include <utility>
+
+// ============================================================================
+// 记录命令
+// ============================================================================
+
+void EditHistory::RecordAdd(const EditTarget& target) {
+    EditCommand cmd;
+    cmd.kind = EditCommand::ADD_SHAPE;
+    cmd.index = target.shapes.size() - 1;
+    cmd.after = target.shapes.GetHandle(cmd.index);
+    Push(target, std::move(cmd));
+}
+
+void EditHistory::RecordModify(const EditTarget& target, size_t index, const ShapeList::Handle& before) {
+    EditCommand cmd;
+    cmd.kind = EditCommand::MODIFY_SHAPE;
+    cmd.index = index;
+    cmd.before = before;
+    cmd.after = target.shapes.GetHandle(index);
+    Push(target, std::move(cmd));
+}
+
+void EditHistory::RecordSwap(const EditTarget& target, unsigned mask, ShapeList&& shapes,
+                             TiledCanvas&& paintLayer, RunLengthCanvas&& fillLayer) {
+    EditCommand cmd;
+    cmd.kind = EditCommand::SWAP_STATE;
+    cmd.swapMask = mask;
+    if (mask & EditCommand::SWAP_SHAPES) cmd.shapes = std::move(shapes);
+    if (mask & EditCommand::SWAP_PAINT) cmd.paintLayer = std::move(paintLayer);
+    if (mask & EditCommand::SWAP_FILL) cmd.fillLayer = std::move(fillLayer);
+    Push(target, std::move(cmd));
+}
+
+void EditHistory::RecordFillRows(const EditTarget& target, int top, std::vector<std::vector<ColorRun>>&& rows) {
+    EditCommand cmd;
+    cmd.kind = EditCommand::SWAP_STATE;
+    cmd.swapMask = EditCommand::SWAP_FILL_ROWS;
+    cmd.fillTop = top;
+    cmd.fillRows = std::move(rows);
+    Push(target, std::move(cmd));
+}
+
+/**
+ * @brief 压入新命令
+ * 
+ * 新操作使重做栈失效；之后按两个条件从最早的命令开始丢弃：
+ * - 命令条数超过MAX_LEVELS
+ * - 历史中的边界填充图层快照连同当前图层，再加上扫描线填充的行快照，
+ *   占用的内存超过PAINT_BUDGET（共享的块只计一次，至少保留一条命令）
+ * 
+ * 内存总数是增量维护的：当前图层在裁剪期间临时计入，
+ * 每弹出一条命令只扣除它自己的块和填充行，裁剪的总代价与被丢弃的内容成正比
+ */
+void EditHistory::Push(const EditTarget& target, EditCommand&& cmd) {
+    redoStack.clear();
+    undoStack.push_back(std::move(cmd));
+    CountBytes(undoStack.back(), true);
+    if (undoStack.size() > MAX_LEVELS)
+        PopOldest();
+
+    const unsigned pixelParts = EditCommand::SWAP_PAINT | EditCommand::SWAP_FILL | EditCommand::SWAP_FILL_ROWS;
+    if (!(undoStack.back().swapMask & pixelParts)) return;
+    paintBytes.Add(target.paintLayer);
+    while (undoStack.size() > 1 && paintBytes.Bytes() + fillBytes > PAINT_BUDGET)
+        PopOldest();
+    paintBytes.Remove(target.paintLayer);
+}
+
+void EditHistory::CountBytes(const EditCommand& cmd, bool add) {
+    size_t bytes = FillBytes(cmd);
+    if (add) fillBytes += bytes;
+    else fillBytes -= bytes;
+    if (cmd.swapMask & EditCommand::SWAP_PAINT) {
+        if (add) paintBytes.Add(cmd.paintLayer);
+        else paintBytes.Remove(cmd.paintLayer);
+    }
+}
+
+void EditHistory::PopOldest() {
+    CountBytes(undoStack.front(), false);
+    undoStack.pop_front();
+}
+
+size_t EditHistory::FillBytes(const EditCommand& cmd) {
+    size_t bytes = 0;
+    if (cmd.swapMask & EditCommand::SWAP_FILL) bytes += cmd.fillLayer.MemoryBytes();
+    if (cmd.swapMask & EditCommand::SWAP_FILL_ROWS) {
+        bytes += cmd.fillRows.capacity() * sizeof(std::vector<ColorRun>);
+        for (const auto& row : cmd.fillRows) bytes += row.capacity() * sizeof(ColorRun);
+    }
+    return bytes;
+}
+
+void EditHistory::Clear() {
+    undoStack.clear();
+    redoStack.clear();
+    paintBytes.Clear();
+    fillBytes = 0;
+}
+
+// ============================================================================
+// 撤销与重做
+// ============================================================================
+
+/**
+ * @brief 执行命令或其逆操作
+ * 
+ * SWAP_STATE 是自逆的：交换一次进入另一状态，再交换一次回到原状态
+ */
+void EditHistory::Apply(const EditTarget& target, EditCommand& cmd, bool redo) {
+    switch (cmd.kind) {
+        case EditCommand::ADD_SHAPE:
+            if (redo) target.shapes.InsertHandle(cmd.index, cmd.after);
+            else target.shapes.Erase(cmd.index);
+            break;
+        case EditCommand::MODIFY_SHAPE:
+            target.shapes.SetHandle(cmd.index, redo ? cmd.after : cmd.before);
+            break;
+        case EditCommand::SWAP_STATE:
+            if (cmd.swapMask & EditCommand::SWAP_SHAPES) std::swap(target.shapes, cmd.shapes);
+            if (cmd.swapMask & EditCommand::SWAP_PAINT) std::swap(target.paintLayer, cmd.paintLayer);
+            if (cmd.swapMask & EditCommand::SWAP_FILL) std::swap(target.fillLayer, cmd.fillLayer);
+            if (cmd.swapMask & EditCommand::SWAP_FILL_ROWS) {
+                for (size_t i = 0; i < cmd.fillRows.size(); i++)
+                    target.fillLayer.SwapRow(cmd.fillTop + (int)i, cmd.fillRows[i]);
+            }
+            break;
+    }
+}
+
+bool EditHistory::Undo(const EditTarget& target) {
+    if (undoStack.empty()) return false;
+    CountBytes(undoStack.back(), false);
+    EditCommand cmd = std::move(undoStack.back());
+    undoStack.pop_back();
+    Apply(target, cmd, false);
+    redoStack.push_back(std::move(cmd));
+    return true;
+}
+
+bool EditHistory::Redo(const EditTarget& target) {
+    if (redoStack.empty()) return false;
+    EditCommand cmd = std::move(redoStack.back());
+    redoStack.pop_back();
+    Apply(target, cmd, true);
+    undoStack.push_back(std::move(cmd));
+    CountBytes(undoStack.back(), true);
+    return true;
+}
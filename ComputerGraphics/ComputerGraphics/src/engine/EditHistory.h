@@ -0,0 +1,151 @@
+﻿#pragma once
+#include "../core/ShapeList.h"
+#include "../algorithms/TiledCanvas.h"
+#include "../algorithms/RunLengthCanvas.h"
+#include <vector>
+#include <deque>
+
+/**
+ * @file EditHistory.h
+ * @brief 2D编辑操作的撤销/重做日志定义
+ * @author ln1.opensource@gmail.com
+ */
+
+/**
+ * @struct EditTarget
+ * @brief 撤销/重做作用的编辑状态（均为引用）
+ */
+struct EditTarget {
+    ShapeList& shapes;          ///< 图形列表
+    TiledCanvas& paintLayer;    ///< 边界填充图层
+    RunLengthCanvas& fillLayer; ///< 扫描线填充图层
+};
+
+/**
+ * @struct EditCommand
+ * @brief 一条可逆的编辑命令
+ * 
+ * - ADD_SHAPE：在index处加入图形after，逆操作为删除
+ * - MODIFY_SHAPE：index处的图形由before变为after，逆操作换回before
+ * - SWAP_STATE：命令保存另一份状态，执行和撤销都是与当前状态交换，
+ *   用于裁剪、清空画布、像素填充等批量操作；swapMask标明交换哪些部分。
+ *   SWAP_FILL_ROWS只保存扫描线填充图层中被修改的连续若干行
+ */
+struct EditCommand {
+    enum Kind { ADD_SHAPE, MODIFY_SHAPE, SWAP_STATE };
+    enum SwapPart { SWAP_SHAPES = 1, SWAP_PAINT = 2, SWAP_FILL = 4, SWAP_FILL_ROWS = 8 };
+
+    Kind kind;                   ///< 命令类型
+    size_t index;                ///< 图形下标（ADD_SHAPE、MODIFY_SHAPE）
+    ShapeList::Handle before;    ///< 修改前的图形（MODIFY_SHAPE）
+    ShapeList::Handle after;     ///< 加入或修改后的图形
+    unsigned swapMask;           ///< 交换的状态部分（SWAP_STATE）
+    ShapeList shapes;            ///< 另一份图形列表（与当前列表共享未修改的图形）
+    TiledCanvas paintLayer;      ///< 另一份边界填充图层（与当前图层共享未修改的块）
+    RunLengthCanvas fillLayer;   ///< 另一份扫描线填充图层
+    int fillTop;                 ///< fillRows第一行的行号（SWAP_FILL_ROWS）
+    std::vector<std::vector<ColorRun>> fillRows;   ///< 扫描线填充图层中被修改的行的另一份内容
+
+    EditCommand() : kind(SWAP_STATE), index(0), swapMask(0), fillTop(0) {}
+};
+
+/**
+ * @class EditHistory
+ * @brief 撤销/重做命令日志
+ * 
+ * 单个图形的增加和修改记录为命令本身（只保存图形指针），
+ * 批量操作记录为状态交换；图形列表与边界填充图层是结构共享的，
+ * 扫描线填充只保存被修改的行，
+ * 每一步历史占用的内存与该步实际改变的内容成正比，
+ * 撤销和重做都只交换指针，不随图形数量增长。
+ * 撤销栈占用的像素内存随命令进出增量维护，按预算裁剪时从最早的命令逐条弹出。
+ */
+class EditHistory {
+public:
+    EditHistory() : fillBytes(0) {}
+
+    static const size_t MAX_LEVELS = 256;                    ///< 最多保留的历史步数
+    static const size_t PAINT_BUDGET = 64 * 1024 * 1024;     ///< 像素图层快照（含填充行）的内存预算（字节）
+
+    /**
+     * @brief 记录加入图形（图形已加入target.shapes的末尾）
+     */
+    void RecordAdd(const EditTarget& target);
+
+    /**
+     * @brief 记录修改图形
+     * @param before 修改前的图形指针
+     * @param index 图形下标（修改后的图形已在target.shapes中）
+     */
+    void RecordModify(const EditTarget& target, size_t index, const ShapeList::Handle& before);
+
+    /**
+     * @brief 记录批量操作，保存操作前的状态
+     * @param mask 需要保存的部分（EditCommand::SwapPart的组合）
+     * @param shapes 操作前的图形列表（mask含SWAP_SHAPES时使用）
+     * @param paintLayer 操作前的边界填充图层（mask含SWAP_PAINT时使用）
+     * @param fillLayer 操作前的扫描线填充图层（mask含SWAP_FILL时使用）
+     */
+    void RecordSwap(const EditTarget& target, unsigned mask, ShapeList&& shapes,
+                    TiledCanvas&& paintLayer, RunLengthCanvas&& fillLayer);
+
+    /**
+     * @brief 记录扫描线填充，只保存被修改的行
+     * @param top rows第一行的行号
+     * @param rows 操作前第top行起连续若干行的行程列表
+     */
+    void RecordFillRows(const EditTarget& target, int top, std::vector<std::vector<ColorRun>>&& rows);
+
+    /**
+     * @brief 撤销最近一条命令
+     * @return 有可撤销的命令时返回true
+     */
+    bool Undo(const EditTarget& target);
+
+    /**
+     * @brief 重做最近一条被撤销的命令
+     * @return 有可重做的命令时返回true
+     */
+    bool Redo(const EditTarget& target);
+
+    bool CanUndo() const { return !undoStack.empty(); }
+    bool CanRedo() const { return !redoStack.empty(); }
+
+    /**
+     * @brief 清空全部历史
+     */
+    void Clear();
+
+private:
+    /**
+     * @brief 压入新命令，清空重做栈并按层数和内存预算裁剪最早的历史
+     */
+    void Push(const EditTarget& target, EditCommand&& cmd);
+
+    /**
+     * @brief 对当前状态执行命令（redo为false时执行其逆操作）
+     */
+    static void Apply(const EditTarget& target, EditCommand& cmd, bool redo);
+
+    /**
+     * @brief 命令保存的扫描线填充数据占用的内存字节数
+     */
+    static size_t FillBytes(const EditCommand& cmd);
+
+    /**
+     * @brief 命令进入（add为true）或离开撤销栈时更新像素内存统计
+     * 
+     * 命令在撤销栈中不会被修改，进出时统计的字节数相同
+     */
+    void CountBytes(const EditCommand& cmd, bool add);
+
+    /**
+     * @brief 弹出撤销栈中最早的命令
+     */
+    void PopOldest();
+
+    std::deque<EditCommand> undoStack;    ///< 可撤销的命令（最早的在前）
+    std::vector<EditCommand> redoStack;   ///< 可重做的命令
+    TiledCanvas::MemoryCounter paintBytes;   ///< 撤销栈中边界填充快照占用的内存（共享的块只计一次）
+    size_t fillBytes;                        ///< 撤销栈中扫描线填充数据占用的内存
+};
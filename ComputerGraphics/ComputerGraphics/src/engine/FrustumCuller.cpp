@@ -0,0 +1,155 @@
+﻿/**
+ * @file FrustumCuller.cpp
+ * @brief 基于包围球的视锥剔除实现
+ * @author ln1.opensource@gmail.com
+ * 
+ * 【平面提取】
+ * 设 M = 投影 × 视图，其第i行为 row_i。裁剪空间中点在视锥内当且仅当
+ * -w ≤ x, y, z ≤ w，换回世界空间即六个半空间：
+ * - 左 row3 + row0，右 row3 - row0
+ * - 下 row3 + row1，上 row3 - row1
+ * - 近 row3 + row2，远 row3 - row2
+ * 平面归一化后，点到平面的有向距离可以直接与半径比较。
+ * 
+ * 【包围球测试】
+ * 只要有一个平面使 dist(球心) < -半径，球就完全在视锥外。
+ * 这个测试会保留少量位于视锥角落外侧的球，但不会误删可见的图形。
+ */
+
+#include "FrustumCuller.h"
+#include "InstanceBatcher.h"
+#include <cmath>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#include <emmintrin.h>
+#define FRUSTUM_CULLER_SSE2 1
+#endif
+
+namespace {
+
+/**
+ * @brief 标量路径：测试一个包围球
+ * 
+ * 运算顺序与SIMD路径相同，两条路径的结果逐位一致。
+ */
+inline unsigned char TestSphere(const float planes[6][4], float x, float y, float z, float r) {
+    for (int p = 0; p < 6; p++) {
+        float dist = planes[p][0] * x + planes[p][1] * y + planes[p][2] * z + planes[p][3];
+        if (!(dist + r >= 0.0f)) return 0;
+    }
+    return 1;
+}
+
+} // namespace
+
+FrustumCuller::FrustumCuller() : shapeCount(0), visibleCount(0) {
+    // 全零平面不剔除任何有网格的图形
+    for (int p = 0; p < 6; p++)
+        for (int c = 0; c < 4; c++) planes[p][c] = 0.0f;
+}
+
+void FrustumCuller::SetPlanes(const float frustumPlanes[6][4]) {
+    for (int p = 0; p < 6; p++)
+        for (int c = 0; c < 4; c++) planes[p][c] = frustumPlanes[p][c];
+}
+
+void FrustumCuller::ExtractPlanes(const float viewProjection[16], float planes[6][4]) {
+    const float* m = viewProjection;
+    for (int p = 0; p < 6; p++) {
+        int row = p / 2;                          // 左右取第0行，下上取第1行，近远取第2行
+        float sign = (p % 2 == 0) ? 1.0f : -1.0f;
+        for (int c = 0; c < 4; c++)
+            planes[p][c] = m[c * 4 + 3] + sign * m[c * 4 + row];
+
+        float len = sqrtf(planes[p][0] * planes[p][0] + planes[p][1] * planes[p][1] + planes[p][2] * planes[p][2]);
+        if (len > 0.0f) {
+            for (int c = 0; c < 4; c++) planes[p][c] /= len;
+        }
+    }
+}
+
+void FrustumCuller::Cull(const std::vector<Shape3D>& shapes) {
+    shapeCount = shapes.size();
+    centerX.resize(shapeCount);
+    centerY.resize(shapeCount);
+    centerZ.resize(shapeCount);
+    radius.resize(shapeCount);
+    visible.resize(shapeCount);
+
+    for (size_t i = 0; i < shapeCount; i++) {
+        const Shape3D& shape = shapes[i];
+        if (!shape.mesh) {
+            centerX[i] = centerY[i] = centerZ[i] = 0.0f;
+            radius[i] = -1.0f;
+            continue;
+        }
+        float center[3];
+        WorldBoundingSphere(shape, center, radius[i]);
+        centerX[i] = center[0];
+        centerY[i] = center[1];
+        centerZ[i] = center[2];
+    }
+
+    visibleCount = 0;
+    if (shapeCount == 0) return;
+    TestSpheres(planes, &centerX[0], &centerY[0], &centerZ[0], &radius[0], shapeCount, &visible[0]);
+    for (size_t i = 0; i < shapeCount; i++) visibleCount += visible[i];
+}
+
+/**
+ * @brief 计算图形在世界空间中的包围球
+ * 
+ * 基本体的网格都以原点为中心，此时球心就是图形的位置，不必计算旋转；
+ * 否则用模型矩阵变换网格包围球的球心。
+ * 非均匀缩放把球拉成椭球，取最大缩放因子的球把它包住。
+ */
+void FrustumCuller::WorldBoundingSphere(const Shape3D& shape, float center[3], float& radius) {
+    const Mesh3D& mesh = *shape.mesh;
+    const float* c = mesh.boundCenter;
+    if (c[0] == 0.0f && c[1] == 0.0f && c[2] == 0.0f) {
+        center[0] = shape.positionX;
+        center[1] = shape.positionY;
+        center[2] = shape.positionZ;
+    } else {
+        float model[16], normal[9];
+        InstanceBatcher::ComputeMatrices(shape, model, normal);
+        for (int row = 0; row < 3; row++)
+            center[row] = model[row] * c[0] + model[4 + row] * c[1] + model[8 + row] * c[2] + model[12 + row];
+    }
+
+    float scale = fabsf(shape.scaleX);
+    if (fabsf(shape.scaleY) > scale) scale = fabsf(shape.scaleY);
+    if (fabsf(shape.scaleZ) > scale) scale = fabsf(shape.scaleZ);
+    radius = mesh.boundRadius * scale;
+}
+
+void FrustumCuller::TestSpheres(const float planes[6][4], const float* x, const float* y, const float* z,
+                                const float* r, size_t count, unsigned char* visible) {
+    size_t i = 0;
+#ifdef FRUSTUM_CULLER_SSE2
+    __m128 n[6][4];
+    for (int p = 0; p < 6; p++)
+        for (int c = 0; c < 4; c++) n[p][c] = _mm_set1_ps(planes[p][c]);
+    const __m128 zero = _mm_setzero_ps();
+
+    // 每次循环8个包围球：两组各4个，交错计算以隐藏乘加的延迟
+    for (; i + 8 <= count; i += 8) {
+        __m128 x0 = _mm_loadu_ps(x + i), x1 = _mm_loadu_ps(x + i + 4);
+        __m128 y0 = _mm_loadu_ps(y + i), y1 = _mm_loadu_ps(y + i + 4);
+        __m128 z0 = _mm_loadu_ps(z + i), z1 = _mm_loadu_ps(z + i + 4);
+        __m128 r0 = _mm_loadu_ps(r + i), r1 = _mm_loadu_ps(r + i + 4);
+        __m128 in0 = _mm_castsi128_ps(_mm_set1_epi32(-1)), in1 = in0;
+        for (int p = 0; p < 6; p++) {
+            __m128 d0 = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(n[p][0], x0), _mm_mul_ps(n[p][1], y0)),
+                                              _mm_mul_ps(n[p][2], z0)), n[p][3]);
+            __m128 d1 = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(n[p][0], x1), _mm_mul_ps(n[p][1], y1)),
+                                              _mm_mul_ps(n[p][2], z1)), n[p][3]);
+            in0 = _mm_and_ps(in0, _mm_cmpge_ps(_mm_add_ps(d0, r0), zero));
+            in1 = _mm_and_ps(in1, _mm_cmpge_ps(_mm_add_ps(d1, r1), zero));
+        }
+        int bits = _mm_movemask_ps(in0) | (_mm_movemask_ps(in1) << 4);
+        for (int k = 0; k < 8; k++) visible[i + k] = (unsigned char)((bits >> k) & 1);
+    }
+#endif
+    for (; i < count; i++) visible[i] = TestSphere(planes, x[i], y[i], z[i], r[i]);
+}
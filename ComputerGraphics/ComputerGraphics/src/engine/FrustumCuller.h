@@ -0,0 +1,86 @@
+﻿#pragma once
+#include "../core/Shape3D.h"
+#include <vector>
+
+/**
+ * @file FrustumCuller.h
+ * @brief 基于包围球的视锥剔除定义
+ * @author ln1.opensource@gmail.com
+ */
+
+/**
+ * @class FrustumCuller
+ * @brief 用包围球对场景图形做视锥剔除
+ * 
+ * 每个图形的包围球由网格的模型空间包围球经模型变换得到：
+ * 球心随平移和旋转移动，半径乘以三个缩放因子绝对值中的最大者。
+ * 球心和半径按分量分别存放（结构数组），SIMD路径每次循环测试8个包围球。
+ * 
+ * 剔除结果是保守的：被剔除的图形一定完全在视锥之外，
+ * 留下的图形可能只是包围球与视锥相交。
+ * 内部数组在多帧之间复用，稳定状态下每帧不再分配内存。
+ */
+class FrustumCuller {
+public:
+    FrustumCuller();
+
+    /**
+     * @brief 设置剔除使用的六个视锥平面（通常取自 Camera::FrustumPlanes）
+     */
+    void SetPlanes(const float frustumPlanes[6][4]);
+
+    /**
+     * @brief 从 投影矩阵 × 视图矩阵 中提取六个视锥平面
+     * @param viewProjection 列主序4×4矩阵
+     * @param planes 输出的平面：左、右、下、上、近、远
+     * 
+     * 平面法线指向视锥内部并已归一化，点到平面的有向距离即 dot(n, p) + d。
+     */
+    static void ExtractPlanes(const float viewProjection[16], float planes[6][4]);
+
+    /**
+     * @brief 剔除场景图形
+     * @param shapes 场景图形（网格句柄为空的图形视为不可见）
+     * 
+     * 调用前需先 SetPlanes。结果通过 IsVisible / Visibility 读取，
+     * 下标与 shapes 一一对应，直到下一次调用前有效。
+     */
+    void Cull(const std::vector<Shape3D>& shapes);
+
+    bool IsVisible(size_t index) const { return index < shapeCount && visible[index] != 0; }
+    const unsigned char* Visibility() const { return visible.empty() ? nullptr : &visible[0]; }
+    size_t VisibleCount() const { return visibleCount; }
+
+    /**
+     * @brief 计算图形在世界空间中的包围球
+     * @param shape 图形（需有网格）
+     * @param center 输出的球心
+     * @param radius 输出的半径
+     */
+    static void WorldBoundingSphere(const Shape3D& shape, float center[3], float& radius);
+
+    /**
+     * @brief 用六个平面测试一组包围球
+     * @param planes 视锥平面 (nx, ny, nz, d)，法线指向内部且已归一化
+     * @param x 球心X坐标数组
+     * @param y 球心Y坐标数组
+     * @param z 球心Z坐标数组
+     * @param r 半径数组
+     * @param count 包围球个数
+     * @param visible 输出，与视锥相交或在其内部时为1，否则为0
+     * 
+     * SIMD路径每次循环处理8个包围球（两个SSE寄存器），不足8个的尾部用标量路径。
+     */
+    static void TestSpheres(const float planes[6][4], const float* x, const float* y, const float* z,
+                            const float* r, size_t count, unsigned char* visible);
+
+private:
+    float planes[6][4];                 ///< 视锥平面：左、右、下、上、近、远
+    std::vector<float> centerX;         ///< 包围球球心X
+    std::vector<float> centerY;         ///< 包围球球心Y
+    std::vector<float> centerZ;         ///< 包围球球心Z
+    std::vector<float> radius;          ///< 包围球半径（无网格的图形为负，必然被剔除）
+    std::vector<unsigned char> visible; ///< 每个图形的可见性
+    size_t shapeCount;                  ///< 最近一次剔除的图形数
+    size_t visibleCount;                ///< 最近一次剔除后可见的图形数
+};
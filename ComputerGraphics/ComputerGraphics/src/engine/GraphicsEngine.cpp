@@ -19,6 +19,8 @@
 #include "../algorithms/FillAlgorithms.h"
 #include "../algorithms/TransformAlgorithms.h"
 #include "../algorithms/ClippingAlgorithms.h"
+#include "../algorithms/RasterCore.h"
+#include "../diagnostics/Profiler.h"
 #include <cmath>
 
 // ============================================================================
@@ -32,7 +34,9 @@ GraphicsEngine::GraphicsEngine()
     : hdc(nullptr), hwnd(nullptr), currentMode(MODE_NONE), isDrawing(false),
       selectedShapeIndex(-1), hasSelection(false), isTransforming(false),
       initialDistance(0.0), initialAngle(0.0), isDefiningClipWindow(false), 
-      hasClipWindow(false) {}
+      hasClipWindow(false) {
+    SetRectEmpty(&overlayRect);
+}
 
 /**
  * @brief 析构函数
@@ -64,33 +68,54 @@ void GraphicsEngine::SetMode(DrawMode mode) {
 /**
  * @brief 清空画布
  * 
- * 清除所有已绘制的图形，重置选择状态
+ * 清除所有已绘制的图形和像素图层，重置选择状态
+ * 清空前的状态整体移入撤销历史，可以撤销
  */
 void GraphicsEngine::ClearCanvas() {
     RECT rect;
     GetClientRect(hwnd, &rect);
     FillRect(hdc, &rect, (HBRUSH)(COLOR_WINDOW + 1));
-    shapes.clear();
-    hasSelection = false;
-    selectedShapeIndex = -1;
+    int w = paintLayer.Width(), h = paintLayer.Height();
+    int fw = fillLayer.Width(), fh = fillLayer.Height();
+    history.RecordSwap(EditTargets(),
+                       EditCommand::SWAP_SHAPES | EditCommand::SWAP_PAINT | EditCommand::SWAP_FILL,
+                       std::move(shapes), std::move(paintLayer), std::move(fillLayer));
+    shapes = ShapeList();
+    paintLayer = TiledCanvas(w, h);
+    fillLayer = RunLengthCanvas(fw, fh);
+    ClearSelection();
 }
 
 /**
  * @brief 渲染所有图形
  * 
- * 遍历图形集合，绘制每个图形
+ * 先绘制边界填充图层，再绘制扫描线填充图层，最后遍历图形集合绘制每个图形。
+ * 扫描线填充画在边界填充之上，这样在已有颜色上做的扫描线填充不会被盖住
  * 选中的图形用红色显示，并绘制选择指示器
+ * 
+ * 图层和图形都写入帧缓冲（BGRA8格式，颜色每个图形只打包一次），
+ * 选中图形的边框内部叠加一层半透明着色，最后一次性显示到窗口；
+ * 选择指示器使用GDI虚线画笔，在显示之后绘制
  */
 void GraphicsEngine::RenderAll() {
-    for (const auto& shape : shapes) {
-        // 选中的图形用黄色显示
-        COLORREF color = shape.selected ? RGB(255, 0, 0) : shape.color;
-        ShapeRenderer::DrawShape(hdc, shape, color);
-        // 为选中的图形绘制选择指示器
-        if (shape.selected) {
-            ShapeSelector::DrawSelectionIndicator(hdc, shape);
-        }
+    PROFILE_FUNCTION();
+    BeginFrame();
+    RenderPaintLayer();
+    RenderFillLayer();
+    for (size_t i = 0; i < shapes.size(); i++) {
+        PROFILE_ZONE("DrawShape");
+        const Shape& shape = shapes[i];
+        // 选中状态由引擎记录，不写入共享的图形数据
+        bool selected = hasSelection && (int)i == selectedShapeIndex;
+        // 选中的图形用红色显示
+        COLORREF color = selected ? RGB(255, 0, 0) : shape.color;
+        ShapeRenderer::DrawShape(frame, shape, color);
     }
+    RenderSelectionOverlay();
+    PresentFrame();
+    // 为选中的图形绘制选择指示器
+    if (hasSelection && selectedShapeIndex >= 0 && selectedShapeIndex < (int)shapes.size())
+        ShapeSelector::DrawSelectionIndicator(hdc, shapes[selectedShapeIndex]);
 }
 
 // ============================================================================
@@ -127,9 +152,14 @@ void GraphicsEngine::OnLButtonDown(int x, int y) {
         case MODE_POLYGON:
             HandlePolyDrawing(clickPoint);
             break;
+        // B样条/NURBS曲线绘制模式（逐个添加控制点）
+        case MODE_BSPLINE:
+        case MODE_NURBS:
+            HandleBSplineDrawing(clickPoint);
+            break;
         // 边界填充模式
         case MODE_FILL_BOUNDARY:
-            FillAlgorithms::BoundaryFill(hdc, hwnd, x, y, RGB(255, 0, 0), RGB(0, 0, 0));
+            HandleBoundaryFill(clickPoint);
             break;
         // 扫描线填充模式
         case MODE_FILL_SCANLINE:
@@ -221,7 +251,7 @@ void GraphicsEngine::OnMouseMove(int x, int y) {
  * @param x 鼠标x坐标
  * @param y 鼠标y坐标
  * 
- * 右键用于结束多点绘图操作（折线、多边形、扫描线填充）
+ * 右键用于结束多点绘图操作（折线、多边形、B样条/NURBS曲线、扫描线填充）
  * 以及确认旋转操作
  */
 void GraphicsEngine::OnRButtonDown(int x, int y) {
@@ -231,8 +261,7 @@ void GraphicsEngine::OnRButtonDown(int x, int y) {
         polyline.type = SHAPE_POLYLINE;
         polyline.points = tempPoints;
         polyline.color = RGB(0, 0, 0);
-        polyline.selected = false;
-        shapes.push_back(polyline);
+        AddShape(polyline);
         tempPoints.clear();
         isDrawing = false;
     }
@@ -243,17 +272,51 @@ void GraphicsEngine::OnRButtonDown(int x, int y) {
         polygon.type = SHAPE_POLYGON;
         polygon.points = tempPoints;
         polygon.color = RGB(0, 0, 0);
-        polygon.selected = false;
-        shapes.push_back(polygon);
+        AddShape(polygon);
         tempPoints.clear();
         isDrawing = false;
     }
+    // B样条/NURBS曲线模式：右键结束绘制，至少需要4个控制点
+    // NURBS取三次、空节点向量（clamped均匀节点）和空权重（全部为1），曲线经过首末控制点
+    else if ((currentMode == MODE_BSPLINE || currentMode == MODE_NURBS) && tempPoints.size() >= 4) {
+        Shape spline;
+        spline.type = currentMode == MODE_NURBS ? SHAPE_NURBS : SHAPE_BSPLINE;
+        spline.degree = 3;
+        spline.points = tempPoints;
+        spline.color = RGB(0, 0, 0);
+        AddShape(spline);
+        tempPoints.clear();
+        isDrawing = false;
+        // 重绘以擦除控制多边形，只保留曲线
+        InvalidateRect(hwnd, NULL, TRUE);
+    }
     // 扫描线填充模式：右键结束并执行填充
     else if (currentMode == MODE_FILL_SCANLINE && tempPoints.size() >= 3) {
         // 闭合多边形
         DrawLineBresenham(tempPoints.back(), tempPoints.front());
         // 执行扫描线填充
         FillAlgorithms::ScanlineFill(hdc, tempPoints, RGB(255, 0, 0));
+        // 填充结果同时写入填充图层，窗口重绘后仍然保留
+        RECT rect;
+        GetClientRect(hwnd, &rect);
+        if (rect.right > fillLayer.Width() || rect.bottom > fillLayer.Height()) {
+            int w = rect.right > fillLayer.Width() ? (int)rect.right : fillLayer.Width();
+            int h = rect.bottom > fillLayer.Height() ? (int)rect.bottom : fillLayer.Height();
+            fillLayer.Resize(w, h);
+        }
+        // 撤销只需保存多边形纵向范围内的行
+        int top = tempPoints[0].y, bottom = tempPoints[0].y;
+        for (const Point2D& p : tempPoints) {
+            if (p.y < top) top = p.y;
+            if (p.y > bottom) bottom = p.y;
+        }
+        if (top < 0) top = 0;
+        if (bottom >= fillLayer.Height()) bottom = fillLayer.Height() - 1;
+        std::vector<std::vector<ColorRun>> before;
+        for (int y = top; y <= bottom; y++) before.push_back(fillLayer.Row(y));
+        RunLengthSink sink(fillLayer, RGB(255, 0, 0));
+        RasterCore::ScanlineFill(sink, tempPoints);
+        history.RecordFillRows(EditTargets(), top, std::move(before));
         tempPoints.clear();
         isDrawing = false;
     }
@@ -265,7 +328,9 @@ void GraphicsEngine::OnRButtonDown(int x, int y) {
         double angle = atan2(dy, dx);
         
         // 应用旋转变换
-        TransformAlgorithms::ApplyRotation(shapes[selectedShapeIndex], angle - initialAngle, transformAnchorPoint);
+        Shape rotated = shapes[selectedShapeIndex];
+        TransformAlgorithms::ApplyRotation(rotated, angle - initialAngle, transformAnchorPoint);
+        ModifyShape(selectedShapeIndex, std::move(rotated));
         
         isTransforming = false;
         InvalidateRect(hwnd, NULL, TRUE);
@@ -279,6 +344,7 @@ void GraphicsEngine::OnRButtonDown(int x, int y) {
  * 用于演示基本图形绑定功能
  */
 void GraphicsEngine::DrawExpr1Graphics() {
+    PROFILE_FUNCTION();
     HPEN pen = CreatePen(PS_SOLID, 1, RGB(0, 0, 0));
     HPEN oldPen = (HPEN)SelectObject(hdc, pen);
     
@@ -344,8 +410,7 @@ void GraphicsEngine::HandleLineDrawing(Point2D clickPoint) {
         line.type = SHAPE_LINE;
         line.points = tempPoints;
         line.color = RGB(0, 0, 0);
-        line.selected = false;
-        shapes.push_back(line);
+        AddShape(line);
         isDrawing = false;
     }
 }
@@ -378,8 +443,7 @@ void GraphicsEngine::HandleCircleDrawing(Point2D clickPoint) {
         circle.points.push_back(tempPoints[0]);
         circle.radius = radius;
         circle.color = RGB(0, 0, 0);
-        circle.selected = false;
-        shapes.push_back(circle);
+        AddShape(circle);
         isDrawing = false;
     }
 }
@@ -406,8 +470,7 @@ void GraphicsEngine::HandleRectangleDrawing(Point2D clickPoint) {
         rectangle.type = SHAPE_RECTANGLE;
         rectangle.points = tempPoints;
         rectangle.color = RGB(0, 0, 0);
-        rectangle.selected = false;
-        shapes.push_back(rectangle);
+        AddShape(rectangle);
         isDrawing = false;
     }
 }
@@ -428,6 +491,22 @@ void GraphicsEngine::HandlePolyDrawing(Point2D clickPoint) {
     }
 }
 
+/**
+ * @brief 处理B样条/NURBS曲线绘制模式的鼠标点击
+ * @param clickPoint 点击位置
+ * 
+ * 每次点击添加一个控制点，并用灰色绘制控制多边形作为预览
+ * 右键结束绘制后生成曲线
+ */
+void GraphicsEngine::HandleBSplineDrawing(Point2D clickPoint) {
+    tempPoints.push_back(clickPoint);
+    if (!isDrawing) isDrawing = true;
+    // 绘制控制多边形的新边
+    if (tempPoints.size() >= 2) {
+        DrawLineBresenham(tempPoints[tempPoints.size()-2], tempPoints.back(), RGB(192, 192, 192));
+    }
+}
+
 /**
  * @brief 处理扫描线填充模式的鼠标点击
  * @param clickPoint 点击位置
@@ -457,16 +536,12 @@ void GraphicsEngine::HandleScanlineFillDrawing(Point2D clickPoint) {
 void GraphicsEngine::HandleSelection(Point2D clickPoint) {
     int hitIndex = ShapeSelector::SelectShapeAt(clickPoint, shapes);
     if (hitIndex >= 0) {
-        // 取消所有选择，选中点击的图形
-        for (auto& shape : shapes) shape.selected = false;
-        shapes[hitIndex].selected = true;
+        // 选中点击的图形（同时只有一个图形被选中）
         selectedShapeIndex = hitIndex;
         hasSelection = true;
     } else if (hasSelection) {
         // 点击空白处，取消选择
-        for (auto& shape : shapes) shape.selected = false;
-        hasSelection = false;
-        selectedShapeIndex = -1;
+        ClearSelection();
     }
     InvalidateRect(hwnd, NULL, TRUE);
 }
@@ -490,7 +565,9 @@ void GraphicsEngine::HandleTranslation(Point2D clickPoint) {
         // 第二次点击：计算位移并应用平移
         int dx = clickPoint.x - transformStartPoint.x;
         int dy = clickPoint.y - transformStartPoint.y;
-        TransformAlgorithms::ApplyTranslation(shapes[selectedShapeIndex], dx, dy);
+        Shape moved = shapes[selectedShapeIndex];
+        TransformAlgorithms::ApplyTranslation(moved, dx, dy);
+        ModifyShape(selectedShapeIndex, std::move(moved));
         isTransforming = false;
         InvalidateRect(hwnd, NULL, TRUE);
     }
@@ -522,7 +599,9 @@ void GraphicsEngine::HandleScaling(Point2D clickPoint) {
         int dy = clickPoint.y - transformAnchorPoint.y;
         double currentDistance = sqrt(dx * dx + dy * dy);
         double scale = currentDistance / initialDistance;
-        TransformAlgorithms::ApplyScaling(shapes[selectedShapeIndex], scale, transformAnchorPoint);
+        Shape scaled = shapes[selectedShapeIndex];
+        TransformAlgorithms::ApplyScaling(scaled, scale, transformAnchorPoint);
+        ModifyShape(selectedShapeIndex, std::move(scaled));
         isTransforming = false;
         InvalidateRect(hwnd, NULL, TRUE);
     }
@@ -641,30 +720,34 @@ void GraphicsEngine::DrawClipWindow(Point2D p1, Point2D p2) {
  * 裁剪后的直线替换原直线，完全在窗口外的直线被删除
  */
 void GraphicsEngine::ExecuteCohenSutherlandClipping() {
+    PROFILE_FUNCTION();
     // 计算裁剪窗口边界
     int xmin = (clipWindowStart.x < clipWindowEnd.x) ? clipWindowStart.x : clipWindowEnd.x;
     int ymin = (clipWindowStart.y < clipWindowEnd.y) ? clipWindowStart.y : clipWindowEnd.y;
     int xmax = (clipWindowStart.x > clipWindowEnd.x) ? clipWindowStart.x : clipWindowEnd.x;
     int ymax = (clipWindowStart.y > clipWindowEnd.y) ? clipWindowStart.y : clipWindowEnd.y;
 
-    std::vector<Shape> clippedShapes;
-    for (Shape& shape : shapes) {
+    ShapeList clippedShapes;
+    for (size_t i = 0; i < shapes.size(); i++) {
+        const Shape& shape = shapes[i];
         if (shape.type == SHAPE_LINE && shape.points.size() >= 2) {
             // 对直线应用Cohen-Sutherland裁剪
-            Point2D p1 = shape.points[0], p2 = shape.points[1];
-            if (ClippingAlgorithms::ClipLineCohenSutherland(p1, p2, xmin, ymin, xmax, ymax)) {
+            // 在16.16定点坐标下裁剪，端点被多次替换也不累积取整误差，最后取整一次
+            Point2x p1 = shape.points[0].As<Fixed16>(), p2 = shape.points[1].As<Fixed16>();
+            if (ClippingAlgorithms::ClipLineCohenSutherland<Fixed16>(p1, p2, xmin, ymin, xmax, ymax)) {
                 Shape clippedLine = shape;
-                clippedLine.points[0] = p1;
-                clippedLine.points[1] = p2;
+                clippedLine.points[0] = p1.As<int>();
+                clippedLine.points[1] = p2.As<int>();
+                clippedLine.revision++;
                 clippedShapes.push_back(clippedLine);
             }
             // 如果返回false，直线完全在窗口外，不添加到结果中
         } else {
-            // 非直线图形保持不变
-            clippedShapes.push_back(shape);
+            // 非直线图形保持不变（沿用原图形，不复制）
+            clippedShapes.PushHandle(shapes.GetHandle(i));
         }
     }
-    shapes = clippedShapes;
+    CommitShapeList(std::move(clippedShapes));
     hasClipWindow = false;
     InvalidateRect(hwnd, NULL, TRUE);
     MessageBoxW(hwnd, L"Cohen-Sutherland裁剪完成！", L"完成", MB_OK | MB_ICONINFORMATION);
@@ -677,14 +760,16 @@ void GraphicsEngine::ExecuteCohenSutherlandClipping() {
  * 一条直线可能被裁剪成多个线段
  */
 void GraphicsEngine::ExecuteMidpointClipping() {
+    PROFILE_FUNCTION();
     // 计算裁剪窗口边界
     int xmin = (clipWindowStart.x < clipWindowEnd.x) ? clipWindowStart.x : clipWindowEnd.x;
     int ymin = (clipWindowStart.y < clipWindowEnd.y) ? clipWindowStart.y : clipWindowEnd.y;
     int xmax = (clipWindowStart.x > clipWindowEnd.x) ? clipWindowStart.x : clipWindowEnd.x;
     int ymax = (clipWindowStart.y > clipWindowEnd.y) ? clipWindowStart.y : clipWindowEnd.y;
 
-    std::vector<Shape> clippedShapes;
-    for (Shape& shape : shapes) {
+    ShapeList clippedShapes;
+    for (size_t i = 0; i < shapes.size(); i++) {
+        const Shape& shape = shapes[i];
         if (shape.type == SHAPE_LINE && shape.points.size() >= 2) {
             // 对直线应用中点分割裁剪
             std::vector<std::pair<Point2D, Point2D>> segments;
@@ -695,14 +780,15 @@ void GraphicsEngine::ExecuteMidpointClipping() {
                 clippedLine.points.clear();
                 clippedLine.points.push_back(seg.first);
                 clippedLine.points.push_back(seg.second);
+                clippedLine.revision++;
                 clippedShapes.push_back(clippedLine);
             }
         } else {
-            // 非直线图形保持不变
-            clippedShapes.push_back(shape);
+            // 非直线图形保持不变（沿用原图形，不复制）
+            clippedShapes.PushHandle(shapes.GetHandle(i));
         }
     }
-    shapes = clippedShapes;
+    CommitShapeList(std::move(clippedShapes));
     hasClipWindow = false;
     InvalidateRect(hwnd, NULL, TRUE);
     MessageBoxW(hwnd, L"中点分割裁剪完成！", L"完成", MB_OK | MB_ICONINFORMATION);
@@ -715,30 +801,38 @@ void GraphicsEngine::ExecuteMidpointClipping() {
  * 适用于凸多边形裁剪
  */
 void GraphicsEngine::ExecuteSutherlandHodgmanClipping() {
+    PROFILE_FUNCTION();
     // 计算裁剪窗口边界
     int xmin = (clipWindowStart.x < clipWindowEnd.x) ? clipWindowStart.x : clipWindowEnd.x;
     int ymin = (clipWindowStart.y < clipWindowEnd.y) ? clipWindowStart.y : clipWindowEnd.y;
     int xmax = (clipWindowStart.x > clipWindowEnd.x) ? clipWindowStart.x : clipWindowEnd.x;
     int ymax = (clipWindowStart.y > clipWindowEnd.y) ? clipWindowStart.y : clipWindowEnd.y;
 
-    std::vector<Shape> clippedShapes;
-    for (Shape& shape : shapes) {
+    ShapeList clippedShapes;
+    for (size_t i = 0; i < shapes.size(); i++) {
+        const Shape& shape = shapes[i];
         if (shape.type == SHAPE_POLYGON && shape.points.size() >= 3) {
             // 对多边形应用Sutherland-Hodgman裁剪
-            std::vector<Point2D> clipped = ClippingAlgorithms::ClipPolygonSutherlandHodgman(
-                shape.points, xmin, ymin, xmax, ymax);
+            // 在16.16定点坐标下逐边裁剪，交点不逐边累积取整误差，最后取整一次
+            std::vector<Point2x> subpixel;
+            subpixel.reserve(shape.points.size());
+            for (const Point2D& pt : shape.points) subpixel.push_back(pt.As<Fixed16>());
+            std::vector<Point2x> clipped = ClippingAlgorithms::ClipPolygonSutherlandHodgman<Fixed16>(
+                subpixel, xmin, ymin, xmax, ymax);
             // 只有裁剪后仍有至少3个顶点才保留
             if (clipped.size() >= 3) {
                 Shape clippedShape = shape;
-                clippedShape.points = clipped;
+                clippedShape.points.clear();
+                for (const Point2x& pt : clipped) clippedShape.points.push_back(pt.As<int>());
+                clippedShape.revision++;
                 clippedShapes.push_back(clippedShape);
             }
         } else {
-            // 非多边形图形保持不变
-            clippedShapes.push_back(shape);
+            // 非多边形图形保持不变（沿用原图形，不复制）
+            clippedShapes.PushHandle(shapes.GetHandle(i));
         }
     }
-    shapes = clippedShapes;
+    CommitShapeList(std::move(clippedShapes));
     hasClipWindow = false;
     InvalidateRect(hwnd, NULL, TRUE);
     MessageBoxW(hwnd, L"Sutherland-Hodgman裁剪完成！", L"完成", MB_OK | MB_ICONINFORMATION);
@@ -837,6 +931,7 @@ void GraphicsEngine::DrawPolygon(const std::vector<Point2D>& points, COLORREF co
  * 支持凹多边形，可能产生多个裁剪结果
  */
 void GraphicsEngine::ExecuteWeilerAthertonClipping() {
+    PROFILE_FUNCTION();
     if (!hasClipWindow) {
         MessageBoxW(hwnd, L"请先定义裁剪窗口", L"错误", MB_OK | MB_ICONERROR);
         return;
@@ -848,9 +943,10 @@ void GraphicsEngine::ExecuteWeilerAthertonClipping() {
     int xmax = (clipWindowStart.x > clipWindowEnd.x) ? clipWindowStart.x : clipWindowEnd.x;
     int ymax = (clipWindowStart.y > clipWindowEnd.y) ? clipWindowStart.y : clipWindowEnd.y;
 
-    std::vector<Shape> clippedShapes;
+    ShapeList clippedShapes;
     
-    for (Shape& shape : shapes) {
+    for (size_t i = 0; i < shapes.size(); i++) {
+        const Shape& shape = shapes[i];
         if (shape.type == SHAPE_POLYGON && shape.points.size() >= 3) {
             // 检查是否完全在窗口内
             bool allInside = true;
@@ -863,7 +959,7 @@ void GraphicsEngine::ExecuteWeilerAthertonClipping() {
             
             if (allInside) {
                 // 完全在窗口内，保持不变
-                clippedShapes.push_back(shape);
+                clippedShapes.PushHandle(shapes.GetHandle(i));
                 continue;
             }
             
@@ -891,6 +987,7 @@ void GraphicsEngine::ExecuteWeilerAthertonClipping() {
                     if (poly.size() >= 3) {
                         Shape clippedShape = shape;
                         clippedShape.points = poly;
+                        clippedShape.revision++;
                         clippedShapes.push_back(clippedShape);
                     }
                 }
@@ -903,17 +1000,248 @@ void GraphicsEngine::ExecuteWeilerAthertonClipping() {
                     }
                 }
                 if (insideCount > (int)shape.points.size() / 2) {
-                    clippedShapes.push_back(shape);
+                    clippedShapes.PushHandle(shapes.GetHandle(i));
                 }
             }
         } else {
-            // 非多边形图形保持不变
-            clippedShapes.push_back(shape);
+            // 非多边形图形保持不变（沿用原图形，不复制）
+            clippedShapes.PushHandle(shapes.GetHandle(i));
         }
     }
     
-    shapes = clippedShapes;
+    CommitShapeList(std::move(clippedShapes));
     hasClipWindow = false;
     InvalidateRect(hwnd, NULL, TRUE);
     MessageBoxW(hwnd, L"Weiler-Atherton裁剪完成！", L"完成", MB_OK | MB_ICONINFORMATION);
 }
+
+// ============================================================================
+// 私有辅助方法 - 像素图层
+// ============================================================================
+
+/**
+ * @brief 将填充图层写入帧缓冲
+ * 
+ * 按行序解码行程，每个行程是帧缓冲一行内的一次连续区间填充
+ */
+void GraphicsEngine::RenderFillLayer() {
+    PROFILE_FUNCTION();
+    fillLayer.DecodeTo(frame);
+}
+
+/**
+ * @brief 将边界填充图层写入帧缓冲
+ */
+void GraphicsEngine::RenderPaintLayer() {
+    PROFILE_FUNCTION();
+    paintLayer.ForEachRun([&](int y, int x0, int x1, COLORREF color) {
+        frame.FillSpan(y, x0, x1, PixelBGRA8::FromColor(color));
+    });
+}
+
+/**
+ * @brief 帧缓冲对应的32位自顶向下DIB格式描述
+ */
+static BITMAPINFO FrameBitmapInfo(int width, int height) {
+    BITMAPINFO info = {};
+    info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    info.bmiHeader.biWidth = width;
+    info.bmiHeader.biHeight = -height;   // 负高度表示首行在上，与帧缓冲的行顺序一致
+    info.bmiHeader.biPlanes = 1;
+    info.bmiHeader.biBitCount = 32;
+    info.bmiHeader.biCompression = BI_RGB;
+    return info;
+}
+
+/**
+ * @brief 准备本帧的帧缓冲
+ * 
+ * 帧缓冲与客户区同尺寸，初始内容取自窗口当前显示的像素：
+ * 不擦除背景的重绘（如折线绘制过程中）仍保留屏幕上即时绘制的临时图形，
+ * 与直接在设备上下文上绘制时的效果一致。屏幕像素不透明，alpha字节置为255。
+ * 上一帧的选中着色若仍留在屏幕上，还原为着色前的像素，避免半透明着色逐帧叠加变深。
+ */
+void GraphicsEngine::BeginFrame() {
+    RECT rect;
+    GetClientRect(hwnd, &rect);
+    int w = rect.right, h = rect.bottom;
+    if (w != frame.Width() || h != frame.Height()) frame.Resize(w, h);
+    if (w <= 0 || h <= 0) return;
+
+    HDC memDC = CreateCompatibleDC(hdc);
+    HBITMAP bitmap = CreateCompatibleBitmap(hdc, w, h);
+    HGDIOBJ oldBitmap = SelectObject(memDC, bitmap);
+    BitBlt(memDC, 0, 0, w, h, hdc, 0, 0, SRCCOPY);
+    SelectObject(memDC, oldBitmap);
+    BITMAPINFO info = FrameBitmapInfo(w, h);
+    GetDIBits(memDC, bitmap, 0, h, frame.Data(), &info, DIB_RGB_COLORS);
+    DeleteObject(bitmap);
+    DeleteDC(memDC);
+
+    uint32_t* pixels = frame.Data();
+    for (size_t i = 0, n = (size_t)w * h; i < n; i++) pixels[i] |= 0xFF000000u;
+
+    // 仍与上一帧着色结果相同的像素说明未被其他绘制覆盖，换回着色前的内容
+    if (!IsRectEmpty(&overlayRect) && overlayRect.right <= w && overlayRect.bottom <= h) {
+        int ow = overlayRect.right - overlayRect.left;
+        size_t k = 0;
+        for (int y = overlayRect.top; y < overlayRect.bottom; y++) {
+            uint32_t* row = frame.Row(y) + overlayRect.left;
+            for (int x = 0; x < ow; x++, k++) {
+                if (row[x] == overlayShown[k]) row[x] = overlayBase[k];
+            }
+        }
+    }
+}
+
+/**
+ * @brief 在帧缓冲中以半透明蓝色覆盖选中图形的选择边框内部
+ * 
+ * 边框本身由GDI虚线画笔绘制，着色只覆盖边框以内的像素。
+ * 每行是一次单色区间合成，由GammaBlendSink交给Compositor在线性空间完成。
+ */
+void GraphicsEngine::RenderSelectionOverlay() {
+    PROFILE_FUNCTION();
+    SetRectEmpty(&overlayRect);
+    overlayBase.clear();
+    overlayShown.clear();
+    if (!hasSelection || selectedShapeIndex < 0 || selectedShapeIndex >= (int)shapes.size()) return;
+
+    RECT bounds;
+    if (!ShapeSelector::GetSelectionBounds(shapes[selectedShapeIndex], bounds)) return;
+    int x0 = bounds.left + 1, x1 = bounds.right - 1;
+    int y0 = bounds.top + 1, y1 = bounds.bottom - 1;
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 >= frame.Width()) x1 = frame.Width() - 1;
+    if (y1 >= frame.Height()) y1 = frame.Height() - 1;
+    if (x0 > x1 || y0 > y1) return;
+    SetRect(&overlayRect, x0, y0, x1 + 1, y1 + 1);
+
+    const COLORREF SELECTION_TINT = RGB(0, 120, 215);
+    const uint32_t SELECTION_TINT_ALPHA = 40;
+    GammaBlendSink<PixelBGRA8> sink(frame, SELECTION_TINT, SELECTION_TINT_ALPHA);
+    size_t ow = (size_t)(x1 - x0 + 1);
+    overlayBase.reserve(ow * (y1 - y0 + 1));
+    overlayShown.reserve(ow * (y1 - y0 + 1));
+    for (int y = y0; y <= y1; y++) {
+        const uint32_t* row = frame.Row(y) + x0;
+        overlayBase.insert(overlayBase.end(), row, row + ow);
+        sink.Span(y, x0, x1);
+        overlayShown.insert(overlayShown.end(), row, row + ow);
+    }
+}
+
+/**
+ * @brief 将帧缓冲一次性显示到窗口
+ */
+void GraphicsEngine::PresentFrame() {
+    int w = frame.Width(), h = frame.Height();
+    if (w <= 0 || h <= 0) return;
+    BITMAPINFO info = FrameBitmapInfo(w, h);
+    SetDIBitsToDevice(hdc, 0, 0, w, h, 0, 0, 0, h, frame.Data(), &info, DIB_RGB_COLORS);
+}
+
+/**
+ * @brief 执行边界填充并写入像素图层
+ * 
+ * 填充仍在设备上下文上进行（边界由屏幕像素决定），
+ * 填充过的区间同时写入paintLayer，使结果在重绘后保留并可以撤销
+ */
+void GraphicsEngine::HandleBoundaryFill(Point2D clickPoint) {
+    std::vector<RasterSpan> spans;
+    FillAlgorithms::BoundaryFill(hdc, hwnd, clickPoint.x, clickPoint.y, RGB(255, 0, 0), RGB(0, 0, 0), &spans);
+    if (spans.empty()) return;
+
+    TiledCanvas before = paintLayer;   // 只复制块指针
+    RECT rect;
+    GetClientRect(hwnd, &rect);
+    if (rect.right > paintLayer.Width() || rect.bottom > paintLayer.Height()) {
+        int w = rect.right > paintLayer.Width() ? (int)rect.right : paintLayer.Width();
+        int h = rect.bottom > paintLayer.Height() ? (int)rect.bottom : paintLayer.Height();
+        paintLayer.Resize(w, h);
+    }
+    for (const RasterSpan& s : spans)
+        paintLayer.FillSpan(s.y, s.x0, s.x1, RGB(255, 0, 0));
+    history.RecordSwap(EditTargets(), EditCommand::SWAP_PAINT, ShapeList(), std::move(before), RunLengthCanvas());
+}
+
+// ============================================================================
+// 撤销/重做
+// ============================================================================
+
+/**
+ * @brief 撤销上一次编辑操作
+ * 
+ * 撤销后图形下标可能变化，因此同时取消选择和进行中的变换
+ */
+bool GraphicsEngine::Undo() {
+    if (!history.Undo(EditTargets())) return false;
+    ClearSelection();
+    isTransforming = false;
+    InvalidateRect(hwnd, NULL, TRUE);
+    return true;
+}
+
+/**
+ * @brief 重做上一次被撤销的编辑操作
+ */
+bool GraphicsEngine::Redo() {
+    if (!history.Redo(EditTargets())) return false;
+    ClearSelection();
+    isTransforming = false;
+    InvalidateRect(hwnd, NULL, TRUE);
+    return true;
+}
+
+// ============================================================================
+// 私有辅助方法 - 编辑记录
+// ============================================================================
+
+/**
+ * @brief 撤销历史作用的编辑状态
+ */
+EditTarget GraphicsEngine::EditTargets() {
+    EditTarget target = { shapes, paintLayer, fillLayer };
+    return target;
+}
+
+/**
+ * @brief 加入新图形并记录到撤销历史
+ */
+void GraphicsEngine::AddShape(const Shape& shape) {
+    shapes.push_back(shape);
+    history.RecordAdd(EditTargets());
+}
+
+/**
+ * @brief 用修改后的图形替换原图形并记录到撤销历史
+ * 
+ * 原图形的指针保存在历史中，不复制图形数据
+ */
+void GraphicsEngine::ModifyShape(int index, Shape&& shape) {
+    ShapeList::Handle before = shapes.GetHandle(index);
+    shapes.SetHandle(index, std::make_shared<Shape>(std::move(shape)));
+    history.RecordModify(EditTargets(), index, before);
+}
+
+/**
+ * @brief 用批量操作（裁剪）的结果替换整个图形列表并记录到撤销历史
+ * 
+ * 原列表整体移入历史；新列表中未改变的图形与原列表共享，
+ * 撤销时只交换两个列表
+ */
+void GraphicsEngine::CommitShapeList(ShapeList&& newShapes) {
+    ShapeList old = std::move(shapes);
+    shapes = std::move(newShapes);
+    history.RecordSwap(EditTargets(), EditCommand::SWAP_SHAPES, std::move(old), TiledCanvas(), RunLengthCanvas());
+    ClearSelection();
+}
+
+/**
+ * @brief 取消选择
+ */
+void GraphicsEngine::ClearSelection() {
+    hasSelection = false;
+    selectedShapeIndex = -1;
+}
@@ -10,16 +10,26 @@
  * - GraphicsEngine.*    - 2D图形引擎，处理2D绑定和渲染
  * - ShapeRenderer.*     - 图形渲染器，负责具体图形的绘制
  * - ShapeSelector.*     - 图形选择器，处理图形的选中和高亮
+ * - EditHistory.*       - 撤销/重做命令日志
  * 
  * 【3D图形引擎】
  * - GraphicsEngine3D.h          - 3D引擎头文件，类声明
  * - GraphicsEngine3D_Core.cpp   - 3D引擎核心：初始化、OpenGL上下文管理
  * - GraphicsEngine3D_Render.cpp - 3D引擎渲染：场景渲染、光照计算
  * - GraphicsEngine3D_Input.cpp  - 3D引擎输入：鼠标交互、视角控制
+ * - GraphicsEngine3D_Software.cpp - 3D引擎软件渲染：无GPU时离屏渲染到内存
+ * - GraphicsEngine3D_Instanced.cpp - 3D引擎实例化绘制：同一网格的图形一次绘制调用
+ * - Camera.*                    - 轨道摄像机，按脏标记缓存视图/投影矩阵、逆矩阵和视锥平面
+ * - InstanceBatcher.*           - 实例批次构建器（按网格和纹理分组，生成逐实例数据）
+ * - FrustumCuller.*             - 包围球视锥剔除（SIMD每次测试8个包围球）
+ * - LevelOfDetail.*             - 按屏幕投影半径带滞后地选择球体/圆柱体的细分层次
+ * - SceneBvh.*                  - 场景包围盒层次（BVH）与射线拾取，拖拽时增量重新拟合
+ * - MeshRegistry.*              - 共享基本体网格注册表（按类型和参数引用计数共享）
+ * - MeshBuffers.*               - 网格的OpenGL缓冲对象（由 MeshRegistry 的上传函数调用）
  * - OpenGLFunctions.h           - OpenGL函数指针声明
  * 
  * 架构说明：
- * - GraphicsEngine 负责2D图形，使用Windows GDI进行渲染
+ * - GraphicsEngine 负责2D图形，整帧重绘写入BGRA8帧缓冲后一次性显示，交互时的即时绘制使用Windows GDI
  * - GraphicsEngine3D 负责3D图形，使用OpenGL 3.3 Core Profile进行渲染
  * - 两个引擎共享相同的用户界面，通过DrawMode切换工作模式
  */
@@ -28,6 +38,11 @@
 #include "../core/Point2D.h"
 #include "../core/Shape.h"
 #include "../core/DrawMode.h"
+#include "../core/ShapeList.h"
+#include "../algorithms/RunLengthCanvas.h"
+#include "../algorithms/TiledCanvas.h"
+#include "../algorithms/Framebuffer.h"
+#include "EditHistory.h"
 #include <windows.h>
 #include <vector>
 
@@ -112,6 +127,19 @@ public:
      * @brief 绘制实验图形
      */
     void DrawExpr1Graphics();
+
+    // === 撤销/重做 ===
+    /**
+     * @brief 撤销上一次编辑操作（绘制、变换、裁剪、填充、清空画布）
+     * @return 有可撤销的操作时返回true
+     */
+    bool Undo();
+
+    /**
+     * @brief 重做上一次被撤销的编辑操作
+     * @return 有可重做的操作时返回true
+     */
+    bool Redo();
     
     // === 基础绘图方法（算法类的包装接口）===
     /**
@@ -158,10 +186,21 @@ private:
     bool isDrawing;                       ///< 是否正在绘图状态
 
     // === 图形管理 ===
-    std::vector<Shape> shapes;            ///< 所有图形对象的集合
+    ShapeList shapes;                     ///< 所有图形对象的集合（结构共享，供撤销历史引用）
     int selectedShapeIndex;               ///< 当前选中图形的索引
     bool hasSelection;                    ///< 是否有图形被选中
 
+    // === 像素图层 ===
+    RunLengthCanvas fillLayer;            ///< 扫描线填充结果（行程编码，重绘时保留）
+    TiledCanvas paintLayer;               ///< 边界填充结果（分块写时复制，支持撤销）
+    FramebufferBGRA8 frame;               ///< 整帧重绘的离屏帧缓冲（与客户区同尺寸，32位DIB布局）
+    RECT overlayRect;                     ///< 上一帧选中着色覆盖的区域（右、下边界不含）
+    std::vector<uint32_t> overlayBase;    ///< 该区域着色前的像素
+    std::vector<uint32_t> overlayShown;   ///< 该区域着色后显示到窗口的像素
+
+    // === 撤销/重做 ===
+    EditHistory history;                  ///< 编辑命令日志
+
     // === 几何变换状态 ===
     Point2D transformStartPoint;          ///< 变换操作的起始点
     Point2D transformAnchorPoint;         ///< 变换操作的锚点（中心点）
@@ -196,6 +235,11 @@ private:
      */
     void HandlePolyDrawing(Point2D clickPoint);
     
+    /**
+     * @brief 处理B样条曲线绘制模式的鼠标点击
+     */
+    void HandleBSplineDrawing(Point2D clickPoint);
+    
     /**
      * @brief 处理扫描线填充模式的鼠标点击
      */
@@ -251,4 +295,64 @@ private:
      * @brief 绘制裁剪窗口
      */
     void DrawClipWindow(Point2D p1, Point2D p2);
+
+    /**
+     * @brief 准备本帧的帧缓冲：与客户区同尺寸，初始内容取自窗口当前显示的像素
+     */
+    void BeginFrame();
+
+    /**
+     * @brief 将帧缓冲一次性显示到窗口
+     */
+    void PresentFrame();
+
+    /**
+     * @brief 在帧缓冲中以半透明蓝色覆盖选中图形的选择边框内部
+     * 
+     * 在线性空间合成（Compositor），并记录着色前后的像素供下一帧还原
+     */
+    void RenderSelectionOverlay();
+
+    /**
+     * @brief 将填充图层写入帧缓冲
+     * 
+     * 每个行程是一次连续的区间填充，而不是逐像素SetPixel
+     */
+    void RenderFillLayer();
+
+    /**
+     * @brief 将边界填充图层写入帧缓冲
+     */
+    void RenderPaintLayer();
+
+    /**
+     * @brief 执行边界填充，并将结果写入可撤销的像素图层
+     */
+    void HandleBoundaryFill(Point2D clickPoint);
+
+    // === 私有辅助方法 - 编辑记录 ===
+    /**
+     * @brief 撤销历史作用的编辑状态
+     */
+    EditTarget EditTargets();
+
+    /**
+     * @brief 加入新图形并记录到撤销历史
+     */
+    void AddShape(const Shape& shape);
+
+    /**
+     * @brief 替换指定图形并记录到撤销历史（用于几何变换）
+     */
+    void ModifyShape(int index, Shape&& shape);
+
+    /**
+     * @brief 替换整个图形列表并记录到撤销历史（用于裁剪）
+     */
+    void CommitShapeList(ShapeList&& newShapes);
+
+    /**
+     * @brief 取消选择
+     */
+    void ClearSelection();
 };
@@ -1,6 +1,14 @@
 ﻿#pragma once
 #include "../core/Shape3D.h"
+#include "../core/Material3D.h"
+#include "../core/Light3D.h"
 #include "../core/DrawMode.h"
+#include "MeshRegistry.h"
+#include "InstanceBatcher.h"
+#include "FrustumCuller.h"
+#include "SceneBvh.h"
+#include "Camera.h"
+#include "SoftwareSceneRenderer.h"
 #include <windows.h>
 #include <vector>
 
@@ -10,55 +18,6 @@
  * @author ln1.opensource@gmail.com
  */
 
-/**
- * @struct Camera
- * @brief 摄像机参数结构
- * 
- * 定义了3D场景中摄像机的位置、朝向和目标点
- * 使用球坐标系统来简化摄像机控制
- */
-struct Camera {
-    float distance;    ///< 摄像机到目标点的距离
-    float angleX;      ///< 水平旋转角度（绕Y轴）
-    float angleY;      ///< 垂直旋转角度（绕X轴）
-    float targetX;     ///< 目标点X坐标
-    float targetY;     ///< 目标点Y坐标
-    float targetZ;     ///< 目标点Z坐标
-    
-    /**
-     * @brief 默认构造函数
-     * 初始化摄像机位置和朝向
-     */
-    Camera() : distance(5.0f), angleX(0.0f), angleY(0.0f),
-               targetX(0.0f), targetY(0.0f), targetZ(0.0f) {}
-};
-
-/**
- * @struct Light
- * @brief 光源参数结构
- * 
- * 定义了3D场景中光源的位置、颜色和强度参数
- * 支持Phong光照模型的环境光、漫反射和镜面反射
- */
-struct Light {
-    float positionX;           ///< 光源X坐标
-    float positionY;           ///< 光源Y坐标
-    float positionZ;           ///< 光源Z坐标
-    float color[3];            ///< 光源颜色（RGB）
-    float ambientIntensity;    ///< 环境光强度
-    float diffuseIntensity;    ///< 漫反射光强度
-    float specularIntensity;   ///< 镜面反射光强度
-    
-    /**
-     * @brief 默认构造函数
-     * 初始化光源位置和光照参数
-     */
-    Light() : positionX(5.0f), positionY(5.0f), positionZ(5.0f),
-              ambientIntensity(0.2f), diffuseIntensity(0.8f), specularIntensity(1.0f) {
-        color[0] = color[1] = color[2] = 1.0f;  // 白光
-    }
-};
-
 /**
  * @class GraphicsEngine3D
  * @brief 三维图形引擎主类
@@ -151,6 +110,18 @@ public:
      */
     void Render();
     
+    /**
+     * @brief 用CPU软件光栅化渲染当前场景到内存
+     * @param target 输出帧缓冲，输出尺寸取其宽高
+     * @return 尺寸无效时返回false
+     * 
+     * 不需要OpenGL上下文（无需先调用 Initialize），适合无GPU的离屏渲染。
+     * 摄像机、投影、光照和材质与 RenderWithFixedPipeline 相同；
+     * 坐标轴、网格、光源图标和纹理不在输出中。
+     * 渲染由 SoftwareSceneRenderer 完成，不修改摄像机、剔除结果和图形的细节层次。
+     */
+    bool RenderToBuffer(FramebufferRGBA8& target);
+    
     /**
      * @brief 清空3D场景
      */
@@ -178,26 +149,6 @@ public:
      */
     void RenderWithFixedPipeline();
     
-    /**
-     * @brief 使用立即模式渲染立方体
-     */
-    void RenderCubeImmediate(float size);
-    
-    /**
-     * @brief 使用立即模式渲染球体
-     */
-    void RenderSphereImmediate(float radius, int segments, int rings);
-    
-    /**
-     * @brief 使用立即模式渲染圆柱体
-     */
-    void RenderCylinderImmediate(float radius, float height, int segments);
-    
-    /**
-     * @brief 使用立即模式渲染平面
-     */
-    void RenderPlaneImmediate(float width, float height);
-    
     /**
      * @brief 渲染坐标轴
      * 
@@ -260,6 +211,21 @@ public:
      */
     bool GetShowLight() const { return showLight; }
     
+    /**
+     * @brief 设置球体网格的剖分方式，场景中已有的球体立即换成新网格
+     * @param mode 剖分方式（默认经纬球）
+     * @param maxErrorPixels 二十面体球和立方体投影球允许的最大屏幕误差（像素）
+     * 
+     * 后两种方式按各细节层次适用的最大投影半径和 maxErrorPixels 求出细分次数，
+     * 见 MeshGenerator::IcosphereSubdivisions / CubeSphereSubdivisions。
+     */
+    void SetSphereTessellation(SphereTessellation mode, float maxErrorPixels = 0.5f);
+    
+    /**
+     * @brief 获取球体网格的剖分方式
+     */
+    SphereTessellation GetSphereTessellation() const { return sphereTessellation; }
+    
 private:
     // === 核心组件 ===
     HWND hwnd;                            ///< 窗口句柄
@@ -268,12 +234,16 @@ private:
     
     // === 模式和状态管理 ===
     DrawMode currentMode;                 ///< 当前绘图模式
+    MeshRegistry meshRegistry;            ///< 共享基本体网格注册表
+    SphereTessellation sphereTessellation; ///< 球体网格的剖分方式
+    float sphereScreenError;              ///< 球体允许的最大屏幕误差（像素，经纬球不使用）
+    MaterialTable materials;              ///< 场景材质表（图形通过下标引用）
     std::vector<Shape3D> shapes;          ///< 3D图形对象集合
     int selectedShapeIndex;               ///< 当前选中图形的索引
     bool hasSelection;                    ///< 是否有图形被选中
     
     // === 摄像机和光照 ===
-    Camera camera;                        ///< 摄像机对象
+    Camera camera;                        ///< 摄像机（缓存视图、投影矩阵和视锥平面）
     Light light;                          ///< 光源对象
     
     // === 鼠标交互状态 ===
@@ -290,7 +260,79 @@ private:
     bool showGrid;                        ///< 是否显示网格
     bool showLight;                       ///< 是否显示光源可视化
     
+    // === 实例化渲染 ===
+    InstanceBatcher instanceBatcher;      ///< 按网格分组并打包实例数据（纯CPU）
+    unsigned int instanceProgram;         ///< 实例化着色器程序（0表示不支持，退回逐实例绘制）
+    unsigned int instanceVBO;             ///< 每帧一次上传全部实例数据的缓冲对象
+    
+    // === 视锥剔除 ===
+    FrustumCuller frustumCuller;          ///< 渲染和拾取共用的包围球视锥剔除结果
+    
+    // === 拾取 ===
+    SceneBvh sceneBvh;                    ///< 拾取用的场景BVH（增删图形后重建，变换后重新拟合）
+    
+    // === 软件渲染 ===
+    SoftwareSceneRenderer softwareRenderer; ///< RenderToBuffer 使用的CPU渲染器（复用缓冲和工作线程）
+    
     // === 私有辅助方法 ===
+    /**
+     * @brief 用摄像机缓存的视锥平面剔除场景图形
+     * 
+     * 调用前需先 camera.SetViewport，结果保存在 frustumCuller 中，供随后的批次构建或细节层次选择使用。
+     */
+    void CullShapes();
+    
+    /**
+     * @brief 取得图形类型在指定细节层次下的共享网格
+     * @param type 图形类型
+     * @param lodLevel 细节层次（立方体和平面忽略）
+     * 
+     * 基本体的尺寸是固定的（立方体边长1，球体半径0.5，圆柱体半径0.5、高1，平面1×1），
+     * 图形的大小由缩放控制，因此同一层次的所有球体共享同一份网格。
+     */
+    MeshHandle AcquireShapeMesh(Shape3DType type, int lodLevel);
+    
+    /**
+     * @brief 按屏幕上的投影半径更新球体和圆柱体的细节层次
+     * @param viewportHeight 视口高度（像素）
+     * 
+     * 需在 CullShapes 之后调用，只处理可见的图形；层次变化时换成该层次的共享网格。
+     * 各层次网格的包围球相同，剔除结果不受影响。
+     */
+    void UpdateLevelsOfDetail(int viewportHeight);
+    
+    /**
+     * @brief 创建实例化渲染所需的着色器程序和缓冲对象
+     * 
+     * 驱动不支持实例化（缺少 glVertexAttribDivisor / glDrawElementsInstanced）
+     * 或着色器创建失败时 instanceProgram 保持为0，不影响引擎初始化。
+     */
+    void InitInstancing();
+    
+    /**
+     * @brief 释放实例化渲染的缓冲对象（需要OpenGL上下文为当前）
+     */
+    void ReleaseInstancing();
+    
+    /**
+     * @brief 按批次绘制所有图形
+     * 
+     * 调用前投影矩阵、视图矩阵（GL_MODELVIEW）和光源已设置好，并已调用 CullShapes；
+     * 被剔除的图形不进入任何批次。
+     * 支持实例化时每个批次一次绘制调用，否则每个实例一次 glDrawElements。
+     */
+    void RenderInstanceBatches();
+    
+    /**
+     * @brief 用实例化着色器绘制全部批次
+     */
+    void DrawBatchesInstanced();
+    
+    /**
+     * @brief 用固定管线和顶点数组逐实例绘制全部批次（不支持实例化时的退路）
+     */
+    void DrawBatchesFixed();
+    
     /**
      * @brief 处理3D图形创建
      * @param x 鼠标x坐标
@@ -299,7 +341,7 @@ private:
     void HandleShapeCreation(int x, int y);
     
     /**
-     * @brief 处理3D图形选择
+     * @brief 处理3D图形选择（射线拾取最近的图形）
      * @param x 鼠标x坐标
      * @param y 鼠标y坐标
      */
@@ -21,7 +21,9 @@
 
 #include "GraphicsEngine3D.h"
 #include "OpenGLFunctions.h"
+#include "MeshBuffers.h"
 #include "../algorithms/ShaderManager.h"
+#include "../diagnostics/Log.h"
 #include <gl/GL.h>
 #include <cmath>
 
@@ -61,6 +63,11 @@ PFNGLDELETEBUFFERSPROC glDeleteBuffers = nullptr;
 PFNGLVERTEXATTRIBPOINTERPROC glVertexAttribPointer = nullptr;
 PFNGLENABLEVERTEXATTRIBARRAYPROC glEnableVertexAttribArray = nullptr;
 
+// 实例化渲染相关函数 - 可选，驱动不支持时保持为空，渲染退回逐实例绘制
+PFNGLDISABLEVERTEXATTRIBARRAYPROC glDisableVertexAttribArray = nullptr;
+PFNGLVERTEXATTRIBDIVISORPROC glVertexAttribDivisor = nullptr;
+PFNGLDRAWELEMENTSINSTANCEDPROC glDrawElementsInstanced = nullptr;
+
 // 额外的函数指针（未在OpenGLFunctions.h中声明）
 PFNGLDRAWELEMENTSPROC_EXT glDrawElementsExt = nullptr;
 PFNGLUSEPROGRAMPROC_EXT glUseProgramExt = nullptr;
@@ -83,23 +90,16 @@ PFNGLBINDTEXTUREPROC_EXT glBindTextureExt = nullptr;
  * - Windows句柄（hwnd, hdc, hglrc）设为NULL
  * - 绘图模式设为MODE_NONE
  * - 选择状态重置
- * - 摄像机参数设置默认值（距离5.0，角度0，目标点原点）
+ * - 摄像机由 Camera 的默认构造函数初始化（距离5.0，角度0，目标点原点）
  * - 光源参数设置默认值（位置(5,5,5)，白色光，标准强度）
  */
 GraphicsEngine3D::GraphicsEngine3D() 
     : hwnd(NULL), hdc(NULL), hglrc(NULL), 
-      currentMode(MODE_NONE), selectedShapeIndex(-1), hasSelection(false),
+      currentMode(MODE_NONE), sphereTessellation(SPHERE_TESSELLATION_UV), sphereScreenError(0.5f),
+      selectedShapeIndex(-1), hasSelection(false),
       lastMouseX(0), lastMouseY(0), isDragging(false), isRightDragging(false),
-      shaderProgram(0), isInitialized(false), showAxes(true), showGrid(true), showLight(true) {
-    
-    // 初始化摄像机参数
-    // 使用球坐标系统：distance为半径，angleX/Y为角度
-    camera.distance = 5.0f;      // 摄像机距离目标点5个单位
-    camera.angleX = 0.0f;        // 水平角度（绕Y轴旋转）
-    camera.angleY = 0.0f;        // 垂直角度（绕X轴旋转）
-    camera.targetX = 0.0f;       // 目标点在原点
-    camera.targetY = 0.0f;
-    camera.targetZ = 0.0f;
+      shaderProgram(0), isInitialized(false), showAxes(true), showGrid(true), showLight(true),
+      instanceProgram(0), instanceVBO(0) {
     
     // 初始化光源参数
     // 光源位置在(5,5,5)，从右上前方照射场景
@@ -138,9 +138,10 @@ GraphicsEngine3D::~GraphicsEngine3D() {
  * 1. 检查是否已初始化，避免重复初始化
  * 2. 保存窗口句柄，获取设备上下文(HDC)
  * 3. 创建OpenGL渲染上下文
- * 4. 加载OpenGL扩展函数
+ * 4. 加载OpenGL扩展函数，为共享网格注册表安装显存上传函数
  * 5. 设置OpenGL基本状态（深度测试、背景色）
  * 6. 创建着色器程序
+ * 7. 准备实例化渲染（可选，不支持时退回逐实例绘制）
  */
 bool GraphicsEngine3D::Initialize(HWND hwnd) {
     // 防止重复初始化
@@ -166,6 +167,9 @@ bool GraphicsEngine3D::Initialize(HWND hwnd) {
         return false;
     }
     
+    // 之后生成的共享网格自动上传到显存，释放时删除缓冲对象
+    meshRegistry.SetUploader(MeshBuffers::Create, MeshBuffers::Delete);
+    
     // 步骤3：设置OpenGL基本状态
     glEnable(GL_DEPTH_TEST);              // 启用深度测试，确保正确的遮挡关系
     glClearColor(0.2f, 0.4f, 0.8f, 1.0f); // 设置背景色为蓝色
@@ -181,6 +185,9 @@ bool GraphicsEngine3D::Initialize(HWND hwnd) {
         return false;
     }
     
+    // 步骤5：准备实例化渲染（失败不影响初始化）
+    InitInstancing();
+    
     isInitialized = true;
     return true;
 }
@@ -196,6 +203,12 @@ bool GraphicsEngine3D::Initialize(HWND hwnd) {
  */
 void GraphicsEngine3D::Shutdown() {
     if (hglrc) {
+        // 在上下文仍然有效时释放场景，共享网格的缓冲对象随最后一个引用一起删除
+        wglMakeCurrent(hdc, hglrc);
+        ReleaseInstancing();
+        ClearScene();
+        meshRegistry.SetUploader(nullptr, nullptr);  // 上下文销毁后生成的网格只保留CPU端数据
+        
         // 取消当前上下文绑定
         wglMakeCurrent(NULL, NULL);
         // 删除OpenGL渲染上下文
@@ -312,6 +325,16 @@ bool GraphicsEngine3D::LoadOpenGLFunctions() {
     // 加载顶点属性相关函数
     glVertexAttribPointer = (PFNGLVERTEXATTRIBPOINTERPROC)wglGetProcAddress("glVertexAttribPointer");
     glEnableVertexAttribArray = (PFNGLENABLEVERTEXATTRIBARRAYPROC)wglGetProcAddress("glEnableVertexAttribArray");
+    glDisableVertexAttribArray = (PFNGLDISABLEVERTEXATTRIBARRAYPROC)wglGetProcAddress("glDisableVertexAttribArray");
+    
+    // 加载实例化渲染函数（可选，不参与下面的必需函数检查）
+    // OpenGL 3.3以下的驱动可能只以ARB扩展的名字提供
+    glVertexAttribDivisor = (PFNGLVERTEXATTRIBDIVISORPROC)wglGetProcAddress("glVertexAttribDivisor");
+    if (!glVertexAttribDivisor)
+        glVertexAttribDivisor = (PFNGLVERTEXATTRIBDIVISORPROC)wglGetProcAddress("glVertexAttribDivisorARB");
+    glDrawElementsInstanced = (PFNGLDRAWELEMENTSINSTANCEDPROC)wglGetProcAddress("glDrawElementsInstanced");
+    if (!glDrawElementsInstanced)
+        glDrawElementsInstanced = (PFNGLDRAWELEMENTSINSTANCEDPROC)wglGetProcAddress("glDrawElementsInstancedARB");
     
     // 加载绘制和着色器相关函数
     glDrawElementsExt = (PFNGLDRAWELEMENTSPROC_EXT)wglGetProcAddress("glDrawElements");
@@ -355,17 +378,11 @@ bool GraphicsEngine3D::LoadOpenGLFunctions() {
  * - lightSpecularIntensity: 镜面反射强度
  */
 void GraphicsEngine3D::UpdateLight() {
-    // 调试输出缓冲区
-    char debugMsg[512];
-    
-    // 调试输出：检查shapes数量
-    sprintf_s(debugMsg, "UpdateLight开始: shapes数量=%zu, isInitialized=%d", 
-              shapes.size(), isInitialized ? 1 : 0);
-    OutputDebugStringA(debugMsg);
+    LOG_DEBUG("UpdateLight开始: shapes数量=%zu, isInitialized=%d", shapes.size(), isInitialized ? 1 : 0);
     
     // 检查引擎是否已初始化
     if (!isInitialized || shaderProgram == 0) {
-        OutputDebugStringA("UpdateLight: 引擎未初始化，直接返回");
+        LOG_WARN("UpdateLight: 引擎未初始化，直接返回");
         return;
     }
     
@@ -411,17 +428,11 @@ void GraphicsEngine3D::UpdateLight() {
     // 如果不禁用，后续的固定管线渲染会出问题
     glUseProgramExt(0);
     
-    // 调试输出：更新后的shapes数量
-    sprintf_s(debugMsg, "UpdateLight结束: shapes数量=%zu", shapes.size());
-    OutputDebugStringA(debugMsg);
-    
-    // 调试输出
-    sprintf_s(debugMsg, 
-        "光照参数已更新: 位置(%.2f, %.2f, %.2f) 强度(环境:%.2f, 漫反射:%.2f, 镜面:%.2f) 颜色(%.2f, %.2f, %.2f)",
-        light.positionX, light.positionY, light.positionZ,
-        light.ambientIntensity, light.diffuseIntensity, light.specularIntensity,
-        light.color[0], light.color[1], light.color[2]);
-    OutputDebugStringA(debugMsg);
+    LOG_DEBUG("UpdateLight结束: shapes数量=%zu", shapes.size());
+    LOG_DEBUG("光照参数已更新: 位置(%.2f, %.2f, %.2f) 强度(环境:%.2f, 漫反射:%.2f, 镜面:%.2f) 颜色(%.2f, %.2f, %.2f)",
+              light.positionX, light.positionY, light.positionZ,
+              light.ambientIntensity, light.diffuseIntensity, light.specularIntensity,
+              light.color[0], light.color[1], light.color[2]);
 }
 
 // ============================================================================
@@ -445,11 +456,13 @@ void GraphicsEngine3D::ReleaseContext() {
 /**
  * @brief 清空3D场景中的所有图形
  * 
- * 清除shapes容器中的所有3D图形对象，
- * 并重置选择状态。
+ * 清除shapes容器中的所有3D图形对象和材质表，
+ * 标记拾取BVH需要重建，并重置选择状态。
  */
 void GraphicsEngine3D::ClearScene() {
     shapes.clear();
+    materials.Clear();
+    sceneBvh.MarkDirty();
     selectedShapeIndex = -1;
     hasSelection = false;
 }
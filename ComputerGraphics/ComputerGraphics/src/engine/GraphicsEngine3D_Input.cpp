@@ -19,8 +19,8 @@
  */
 
 #include "GraphicsEngine3D.h"
-#include "../algorithms/MeshGenerator.h"
 #include "../ui/Dialogs3D.h"
+#include "../diagnostics/Log.h"
 #include <cmath>
 #include <cfloat>
 
@@ -136,21 +136,29 @@ void GraphicsEngine3D::OnLButtonDoubleClick(int x, int y) {
         
         Shape3D& selectedShape = shapes[selectedShapeIndex];
         
-        // 调试输出
-        char debugMsg[256];
-        sprintf_s(debugMsg, "打开变换对话框，图形索引: %d", selectedShapeIndex);
-        OutputDebugStringA(debugMsg);
+        LOG_DEBUG("打开变换对话框，图形索引: %d", selectedShapeIndex);
+        
+        // 材质在材质表中可能被多个图形共享，对话框只编辑它的副本
+        Material3D material = materials[selectedShape.materialIndex];
         
         // 显示变换对话框
-        if (TransformDialog3D::Show(hwnd, &selectedShape)) {
+        if (TransformDialog3D::Show(hwnd, &selectedShape, &material)) {
             // 用户点击了确定，参数已经被应用
-            OutputDebugStringA("变换对话框: 用户确认，参数已应用");
+            LOG_DEBUG("变换对话框: 用户确认，参数已应用");
         } else {
             // 用户点击了取消
-            OutputDebugStringA("变换对话框: 用户取消");
+            LOG_DEBUG("变换对话框: 用户取消");
+        }
+        
+        // 材质对话框的修改与变换对话框是否确认无关，改动后重新登记到材质表
+        if (material != materials[selectedShape.materialIndex]) {
+            selectedShape.materialIndex = materials.Intern(material);
         }
+        
+        // 变换参数可能已改变，更新拾取BVH中该图形的包围盒
+        sceneBvh.Refit(shapes, selectedShapeIndex);
     } else {
-        OutputDebugStringA("双击: 该位置没有图形");
+        LOG_DEBUG("双击: 该位置没有图形");
     }
 }
 
@@ -209,17 +217,9 @@ void GraphicsEngine3D::OnMouseWheel(int delta) {
     // 视角控制模式或按住Ctrl：调整摄像机距离（缩放视角）
     if (currentMode == MODE_3D_VIEW_CONTROL || ctrlPressed) {
         float zoomSpeed = 0.5f;
-        camera.distance -= (delta / 120.0f) * zoomSpeed;  // 120是标准滚轮增量
+        camera.Zoom(-(delta / 120.0f) * zoomSpeed);  // 120是标准滚轮增量，距离限制在 [1, 50]
         
-        // 限制摄像机距离在合理范围内
-        if (camera.distance < 1.0f) camera.distance = 1.0f;
-        if (camera.distance > 50.0f) camera.distance = 50.0f;
-        
-        // 调试输出
-        char debugMsg[256];
-        sprintf_s(debugMsg, "视角缩放: delta=%d, 摄像机距离=%.2f", 
-                  delta, camera.distance);
-        OutputDebugStringA(debugMsg);
+        LOG_DEBUG("视角缩放: delta=%d, 摄像机距离=%.2f", delta, camera.GetDistance());
     }
     // 选择模式且有选中图形：移动图形的Z轴位置
     else if (currentMode == MODE_3D_SELECT && hasSelection && selectedShapeIndex >= 0 && 
@@ -232,26 +232,15 @@ void GraphicsEngine3D::OnMouseWheel(int delta) {
         // 应用Z轴移动到选中的图形
         Shape3D& selectedShape = shapes[selectedShapeIndex];
         selectedShape.positionZ += zDelta;
+        sceneBvh.Refit(shapes, selectedShapeIndex);
         
-        // 调试输出
-        char debugMsg[256];
-        sprintf_s(debugMsg, "移动图形 %d 的Z轴位置: delta=%d, 新Z=%.2f", 
-                  selectedShapeIndex, delta, selectedShape.positionZ);
-        OutputDebugStringA(debugMsg);
+        LOG_DEBUG("移动图形 %d 的Z轴位置: delta=%d, 新Z=%.2f", selectedShapeIndex, delta, selectedShape.positionZ);
     } else {
         // 默认：调整摄像机距离（缩放视角）
         float zoomSpeed = 0.5f;
-        camera.distance -= (delta / 120.0f) * zoomSpeed;
-        
-        // 限制摄像机距离
-        if (camera.distance < 1.0f) camera.distance = 1.0f;
-        if (camera.distance > 50.0f) camera.distance = 50.0f;
+        camera.Zoom(-(delta / 120.0f) * zoomSpeed);
         
-        // 调试输出
-        char debugMsg[256];
-        sprintf_s(debugMsg, "默认缩放: delta=%d, 摄像机距离=%.2f", 
-                  delta, camera.distance);
-        OutputDebugStringA(debugMsg);
+        LOG_DEBUG("默认缩放: delta=%d, 摄像机距离=%.2f", delta, camera.GetDistance());
     }
 }
 
@@ -280,10 +269,7 @@ void GraphicsEngine3D::OnMouseWheel(int delta) {
  * - 平面：灰色
  */
 void GraphicsEngine3D::HandleShapeCreation(int x, int y) {
-    // 调试输出
-    char debugMsg[256];
-    sprintf_s(debugMsg, "创建图形: 位置(%d, %d), 当前模式: %d", x, y, (int)currentMode);
-    OutputDebugStringA(debugMsg);
+    LOG_DEBUG("创建图形: 位置(%d, %d), 当前模式: %d", x, y, (int)currentMode);
     
     Shape3D newShape;
     
@@ -313,51 +299,49 @@ void GraphicsEngine3D::HandleShapeCreation(int x, int y) {
     newShape.scaleY = 1.0f;
     newShape.scaleZ = 1.0f;
     
-    // 根据当前模式生成网格并设置材质颜色
+    // 根据当前模式取得共享网格并选择材质颜色
+    // 同类型同细节层次的图形共享注册表中的同一份网格，只有第一次会真正生成；
+    // 球体和圆柱体先用默认层次，渲染时再按屏幕尺寸调整（UpdateLevelsOfDetail）
     // 不同类型的图形使用不同的默认颜色，便于区分
+    Material3D material;
     switch (currentMode) {
         case MODE_3D_CUBE:
-            MeshGenerator::GenerateCube(newShape, 1.0f);
+            newShape.type = SHAPE3D_CUBE;
+            newShape.mesh = AcquireShapeMesh(SHAPE3D_CUBE, newShape.lodLevel);
             // 红色立方体
-            newShape.ambient[0] = 0.2f; newShape.ambient[1] = 0.05f; newShape.ambient[2] = 0.05f;
-            newShape.diffuse[0] = 0.8f; newShape.diffuse[1] = 0.2f; newShape.diffuse[2] = 0.2f;
-            newShape.specular[0] = 1.0f; newShape.specular[1] = 0.5f; newShape.specular[2] = 0.5f;
+            material = Material3D(0.2f, 0.05f, 0.05f,  0.8f, 0.2f, 0.2f,  1.0f, 0.5f, 0.5f,  32.0f);
             break;
         case MODE_3D_SPHERE:
-            MeshGenerator::GenerateSphere(newShape, 0.5f, 16, 16);
+            newShape.type = SHAPE3D_SPHERE;
+            newShape.mesh = AcquireShapeMesh(SHAPE3D_SPHERE, newShape.lodLevel);
             // 蓝色球体
-            newShape.ambient[0] = 0.05f; newShape.ambient[1] = 0.05f; newShape.ambient[2] = 0.2f;
-            newShape.diffuse[0] = 0.2f; newShape.diffuse[1] = 0.4f; newShape.diffuse[2] = 0.9f;
-            newShape.specular[0] = 0.5f; newShape.specular[1] = 0.5f; newShape.specular[2] = 1.0f;
+            material = Material3D(0.05f, 0.05f, 0.2f,  0.2f, 0.4f, 0.9f,  0.5f, 0.5f, 1.0f,  32.0f);
             break;
         case MODE_3D_CYLINDER:
-            MeshGenerator::GenerateCylinder(newShape, 0.5f, 1.0f, 16);
+            newShape.type = SHAPE3D_CYLINDER;
+            newShape.mesh = AcquireShapeMesh(SHAPE3D_CYLINDER, newShape.lodLevel);
             // 绿色圆柱体
-            newShape.ambient[0] = 0.05f; newShape.ambient[1] = 0.2f; newShape.ambient[2] = 0.05f;
-            newShape.diffuse[0] = 0.2f; newShape.diffuse[1] = 0.8f; newShape.diffuse[2] = 0.2f;
-            newShape.specular[0] = 0.5f; newShape.specular[1] = 1.0f; newShape.specular[2] = 0.5f;
+            material = Material3D(0.05f, 0.2f, 0.05f,  0.2f, 0.8f, 0.2f,  0.5f, 1.0f, 0.5f,  32.0f);
             break;
         case MODE_3D_PLANE:
-            MeshGenerator::GeneratePlane(newShape, 1.0f, 1.0f);
+            newShape.type = SHAPE3D_PLANE;
+            newShape.mesh = AcquireShapeMesh(SHAPE3D_PLANE, newShape.lodLevel);
             // 灰色平面
-            newShape.ambient[0] = 0.15f; newShape.ambient[1] = 0.15f; newShape.ambient[2] = 0.15f;
-            newShape.diffuse[0] = 0.6f; newShape.diffuse[1] = 0.6f; newShape.diffuse[2] = 0.6f;
-            newShape.specular[0] = 0.3f; newShape.specular[1] = 0.3f; newShape.specular[2] = 0.3f;
+            material = Material3D(0.15f, 0.15f, 0.15f,  0.6f, 0.6f, 0.6f,  0.3f, 0.3f, 0.3f,  32.0f);
             break;
         default:
             return;  // 未知图形类型
     }
     
-    // 设置高光指数（控制高光大小）
-    newShape.shininess = 32.0f;
+    // 同样的材质在材质表中只保存一份，图形只记录下标
+    newShape.materialIndex = materials.Intern(material);
     
-    // 添加到图形集合
-    shapes.push_back(newShape);
+    // 添加到图形集合（图形只能移动，移动只转移网格句柄）
+    shapes.push_back(std::move(newShape));
+    sceneBvh.MarkDirty();  // 下一次拾取前重建BVH
     
-    // 调试输出
-    char debugMsg2[256];
-    sprintf_s(debugMsg2, "图形已添加! 总数: %zu, VAO: %u", shapes.size(), newShape.VAO);
-    OutputDebugStringA(debugMsg2);
+    LOG_DEBUG("图形已添加! 总数: %zu, 共享网格数: %zu, 材质数: %zu, VAO: %u",
+              shapes.size(), meshRegistry.MeshCount(), materials.size(), shapes.back().mesh->VAO);
 }
 
 // ============================================================================
@@ -370,7 +354,11 @@ void GraphicsEngine3D::HandleShapeCreation(int x, int y) {
  * @param y 鼠标Y坐标（屏幕坐标）
  * 
  * 选择算法说明：
- * 使用与渲染代码完全相同的投影计算，确保选择准确
+ * 从摄像机经过点击的像素发出一条射线（Camera::BuildPickRay），在场景BVH中查找最先击中的图形：
+ * - 射线-包围盒测试剪掉不可能相交的子树，平均 O(log n)
+ * - 叶节点按图形的实际形状解析求交，被遮挡的图形不会被选中
+ * - 射线深度限定在近/远裁剪面之间，画面外的图形不参与选择
+ * 图形增删后BVH在这里按需重建。
  */
 void GraphicsEngine3D::HandleSelection(int x, int y) {
     // 获取窗口尺寸
@@ -381,137 +369,28 @@ void GraphicsEngine3D::HandleSelection(int x, int y) {
     
     if (width <= 0 || height <= 0) return;
     
-    float aspectRatio = (float)width / (float)height;
-    
-    // 透视投影参数（与渲染代码一致）
-    float fov = 45.0f;
-    float nearPlane = 0.1f;
-    float top = nearPlane * tanf(fov * (float)M_PI / 360.0f);
-    float right_proj = top * aspectRatio;
-    
-    // 计算摄像机位置（与渲染代码完全一致）
-    float radX = camera.angleX * (float)M_PI / 180.0f;
-    float radY = camera.angleY * (float)M_PI / 180.0f;
-    float cameraX = camera.targetX + camera.distance * cosf(radY) * sinf(radX);
-    float cameraY = camera.targetY + camera.distance * sinf(radY);
-    float cameraZ = camera.targetZ + camera.distance * cosf(radY) * cosf(radX);
-    
-    // 计算视图矩阵的基向量（与渲染代码完全一致）
-    // 前向向量：从摄像机指向目标
-    float fx = camera.targetX - cameraX;
-    float fy = camera.targetY - cameraY;
-    float fz = camera.targetZ - cameraZ;
-    float flen = sqrtf(fx*fx + fy*fy + fz*fz);
-    if (flen > 0.0001f) { fx /= flen; fy /= flen; fz /= flen; }
-    
-    // 世界上向量
-    float worldUpX = 0.0f, worldUpY = 1.0f, worldUpZ = 0.0f;
-    
-    // 右向量 = 前向 × 世界上向（与渲染代码一致）
-    float rx = fy * worldUpZ - fz * worldUpY;
-    float ry = fz * worldUpX - fx * worldUpZ;
-    float rz = fx * worldUpY - fy * worldUpX;
-    float rlen = sqrtf(rx*rx + ry*ry + rz*rz);
-    if (rlen > 0.0001f) { rx /= rlen; ry /= rlen; rz /= rlen; }
-    
-    // 真正的上向量 = 右向 × 前向（与渲染代码一致）
-    float ux = ry * fz - rz * fy;
-    float uy = rz * fx - rx * fz;
-    float uz = rx * fy - ry * fx;
-    
-    // 调试输出摄像机信息
-    char camDebug[256];
-    sprintf_s(camDebug, "摄像机: 位置(%.2f, %.2f, %.2f), 角度(%.1f, %.1f), 距离=%.1f", 
-              cameraX, cameraY, cameraZ, camera.angleX, camera.angleY, camera.distance);
-    OutputDebugStringA(camDebug);
-    
-    // 简单选择：找到距离点击位置最近的图形
-    int closestShapeIndex = -1;
-    float minDistance = FLT_MAX;
-    
-    for (size_t i = 0; i < shapes.size(); i++) {
-        const Shape3D& shape = shapes[i];
-        
-        // 将图形位置从世界坐标转换到眼睛坐标
-        // 这与视图矩阵的变换一致
-        float dx = shape.positionX - cameraX;
-        float dy = shape.positionY - cameraY;
-        float dz = shape.positionZ - cameraZ;
-        
-        // 在眼睛坐标系中的位置（与视图矩阵变换一致）
-        // eyeX = dot(right, worldPos - cameraPos)
-        // eyeY = dot(up, worldPos - cameraPos)
-        // eyeZ = dot(-forward, worldPos - cameraPos) = -dot(forward, worldPos - cameraPos)
-        float eyeX = rx * dx + ry * dy + rz * dz;
-        float eyeY = ux * dx + uy * dy + uz * dz;
-        float eyeZ = -(fx * dx + fy * dy + fz * dz);  // 注意：取负，因为眼睛空间Z轴指向摄像机后方
-        
-        // 如果在摄像机后面（eyeZ >= -nearPlane，因为眼睛空间中物体在-Z方向）
-        // 在眼睛空间中，摄像机看向-Z方向，所以物体的Z应该是负的
-        if (eyeZ >= -nearPlane) {
-            char skipMsg[128];
-            sprintf_s(skipMsg, "图形 %zu: 在摄像机后面 (eyeZ=%.2f)", i, eyeZ);
-            OutputDebugStringA(skipMsg);
-            continue;
-        }
-        
-        // 透视投影（与glFrustum一致）
-        // 在眼睛空间中，物体Z是负的，投影公式：
-        // NDC_x = eyeX * nearPlane / (right_proj * (-eyeZ))
-        // NDC_y = eyeY * nearPlane / (top * (-eyeZ))
-        float depth = -eyeZ;  // 转换为正的深度值
-        float ndcX = (eyeX * nearPlane) / (right_proj * depth);
-        float ndcY = (eyeY * nearPlane) / (top * depth);
-        
-        // NDC转屏幕坐标
-        float screenX = (ndcX + 1.0f) * 0.5f * width;
-        float screenY = (1.0f - ndcY) * 0.5f * height;  // Y轴反转
-        
-        // 计算点击位置与图形中心的距离
-        float distX = (float)x - screenX;
-        float distY = (float)y - screenY;
-        float distance = sqrtf(distX * distX + distY * distY);
-        
-        // 选择容差（像素）
-        float selectionRadius = 100.0f;
-        
-        // 调试输出
-        char debugMsg[256];
-        sprintf_s(debugMsg, "图形 %zu: 世界(%.2f,%.2f,%.2f) 眼睛(%.2f,%.2f,%.2f) NDC(%.2f,%.2f) 屏幕(%.1f,%.1f) 点击(%d,%d) 距离=%.1f", 
-                  i, shape.positionX, shape.positionY, shape.positionZ,
-                  eyeX, eyeY, eyeZ, ndcX, ndcY, screenX, screenY, x, y, distance);
-        OutputDebugStringA(debugMsg);
-        
-        // 如果在选择半径内且是最近的图形
-        if (distance < selectionRadius && distance < minDistance) {
-            minDistance = distance;
-            closestShapeIndex = (int)i;
-        }
+    if (sceneBvh.IsDirty()) {
+        sceneBvh.Build(shapes);
     }
     
-    // 清除之前的选择
-    for (size_t i = 0; i < shapes.size(); i++) {
-        shapes[i].selected = false;
-    }
+    camera.SetViewport(width, height);
+    Ray3D ray;
+    camera.BuildPickRay(x, y, ray);
+    float hitDepth = 0.0f;
+    int closestShapeIndex = sceneBvh.Pick(shapes, ray, hitDepth);
     
-    // 选择最近的图形（如果找到）
+    // 选择最近的图形（如果找到）；选中状态只由 selectedShapeIndex 记录，不写入图形
     if (closestShapeIndex >= 0) {
-        shapes[closestShapeIndex].selected = true;
         selectedShapeIndex = closestShapeIndex;
         hasSelection = true;
         
-        // 调试输出
-        char debugMsg[256];
-        sprintf_s(debugMsg, ">>> 选中图形 %d，位置 (%.2f, %.2f, %.2f)", 
-                  closestShapeIndex, 
-                  shapes[closestShapeIndex].positionX,
-                  shapes[closestShapeIndex].positionY,
-                  shapes[closestShapeIndex].positionZ);
-        OutputDebugStringA(debugMsg);
+        LOG_DEBUG(">>> 选中图形 %d，位置 (%.2f, %.2f, %.2f)，深度 %.2f", closestShapeIndex,
+                  shapes[closestShapeIndex].positionX, shapes[closestShapeIndex].positionY,
+                  shapes[closestShapeIndex].positionZ, hitDepth);
     } else {
         selectedShapeIndex = -1;
         hasSelection = false;
-        OutputDebugStringA(">>> 未选中任何图形");
+        LOG_DEBUG(">>> 未选中任何图形");
     }
 }
 
@@ -534,12 +413,8 @@ void GraphicsEngine3D::HandleViewControl(int deltaX, int deltaY) {
     // 根据鼠标移动更新摄像机角度
     // 鼠标向右移动 -> angleX增加 -> 摄像机向右旋转（场景向左转）
     // 鼠标向下移动 -> angleY减少 -> 摄像机向下看（更符合直觉）
-    camera.angleX += deltaX * 0.5f;   // 水平旋转
-    camera.angleY -= deltaY * 0.5f;   // 垂直旋转（取反，使鼠标下移时视角向下）
-    
-    // 限制垂直角度，防止摄像机翻转
-    if (camera.angleY > 89.0f) camera.angleY = 89.0f;
-    if (camera.angleY < -89.0f) camera.angleY = -89.0f;
+    // 垂直角度在 Camera::Orbit 中限制，防止摄像机翻转
+    camera.Orbit(deltaX * 0.5f, -deltaY * 0.5f);
 }
 
 // ============================================================================
@@ -552,9 +427,12 @@ void GraphicsEngine3D::HandleViewControl(int deltaX, int deltaY) {
  * @param deltaY 鼠标Y方向移动量
  * 
  * 将鼠标移动转换为世界空间中的物体移动：
- * - 鼠标X移动 → 物体X移动
- * - 鼠标Y移动 → 物体Y移动（Y轴反转）
- * - Z轴位置通过滚轮控制
+ * 物体在经过其中心、平行于屏幕的平面内沿摄像机的右向和上向移动，
+ * 每像素的移动量按物体的眼睛空间深度换算（Camera::WorldUnitsPerPixel），
+ * 因此无论摄像机转到哪个角度、离得多远，物体都跟随鼠标。
+ * 沿Z轴的移动通过滚轮控制。
+ * 
+ * 移动后就地重新拟合拾取BVH（SceneBvh::Refit）。
  */
 void GraphicsEngine3D::HandleObjectDragging(int deltaX, int deltaY) {
     // 检查是否有有效的选中图形
@@ -572,25 +450,30 @@ void GraphicsEngine3D::HandleObjectDragging(int deltaX, int deltaY) {
     
     if (width <= 0 || height <= 0) return;
     
-    // 将鼠标移动转换为世界空间移动
-    // 移动灵敏度系数
-    float movementScale = 0.01f;
+    camera.SetViewport(width, height);
+    
+    // 物体中心的眼睛空间深度（视图矩阵第三行，摄像机看向-Z）
+    const float* view = camera.View().m;
+    float depth = -(view[2] * selectedShape.positionX + view[6] * selectedShape.positionY +
+                    view[10] * selectedShape.positionZ + view[14]);
+    if (depth < Camera::NEAR_PLANE) depth = Camera::NEAR_PLANE;
+    float movementScale = camera.WorldUnitsPerPixel(depth);
+    
+    // 屏幕X向右对应摄像机右向，屏幕Y向下对应摄像机上向的反方向
+    const float* inverseView = camera.InverseView().m;
+    float screenRight = (float)deltaX * movementScale;
+    float screenUp = -(float)deltaY * movementScale;
     
-    // 计算世界坐标移动量
-    // X移动：正deltaX向右移动
-    float worldDeltaX = (float)deltaX * movementScale;
-    // Y移动：正deltaY向下移动，但3D世界Y轴向上，所以取反
-    float worldDeltaY = -(float)deltaY * movementScale;
+    // 应用移动到选中图形的位置（逆视图矩阵的第一、二列即摄像机的右向和上向）
+    selectedShape.positionX += inverseView[0] * screenRight + inverseView[4] * screenUp;
+    selectedShape.positionY += inverseView[1] * screenRight + inverseView[5] * screenUp;
+    selectedShape.positionZ += inverseView[2] * screenRight + inverseView[6] * screenUp;
     
-    // 应用移动到选中图形的位置
-    selectedShape.positionX += worldDeltaX;
-    selectedShape.positionY += worldDeltaY;
-    // Z轴位置在XY平面拖拽时保持不变
+    // 只更新该图形的叶节点及其祖先的包围盒，O(log n)，不重建BVH
+    sceneBvh.Refit(shapes, selectedShapeIndex);
     
-    // 调试输出
-    char debugMsg[256];
-    sprintf_s(debugMsg, "拖拽图形 %d: deltaX=%d, deltaY=%d, 新位置=(%.2f, %.2f, %.2f)", 
-              selectedShapeIndex, deltaX, deltaY, 
+    // 每次鼠标移动都会触发，使用TRACE级别
+    LOG_TRACE("拖拽图形 %d: deltaX=%d, deltaY=%d, 新位置=(%.2f, %.2f, %.2f)",
+              selectedShapeIndex, deltaX, deltaY,
               selectedShape.positionX, selectedShape.positionY, selectedShape.positionZ);
-    OutputDebugStringA(debugMsg);
 }
@@ -0,0 +1,292 @@
+﻿/**
+ * @file GraphicsEngine3D_Instanced.cpp
+ * @brief 3D图形引擎实例化渲染模块
+ * 
+ * 本文件包含按网格分组的批次渲染：
+ * - 实例化渲染资源的创建和释放(InitInstancing / ReleaseInstancing)
+ * - 批次渲染入口(RenderInstanceBatches)
+ * - 实例化绘制(DrawBatchesInstanced)：每个批次一次 glDrawElementsInstanced
+ * - 退路(DrawBatchesFixed)：固定管线 + 顶点数组，每个实例一次 glDrawElements
+ * 
+ * 分组和打包由 InstanceBatcher 在CPU上完成，全部实例数据每帧一次上传到 instanceVBO，
+ * 每个批次用属性指针的偏移量选中自己的那一段。
+ * 两条路径绘制的都是共享网格（MeshRegistry）的顶点/索引数据，
+ * 不再每帧用立即模式重新细分基本体。
+ * 
+ * @author ln1.opensource@gmail.com
+ */
+
+#include "GraphicsEngine3D.h"
+#include "OpenGLFunctions.h"
+#include "../algorithms/ShaderManager.h"
+#include "MeshBuffers.h"
+#include "../diagnostics/Log.h"
+#include "../diagnostics/Profiler.h"
+#include <gl/GL.h>
+#include <cstddef>
+#include <cstring>
+
+// 外部声明OpenGL函数指针（在GraphicsEngine3D_Core.cpp中定义）
+typedef void (APIENTRY *PFNGLUSEPROGRAMPROC_EXT)(GLuint program);
+typedef GLint (APIENTRY *PFNGLGETUNIFORMLOCATIONPROC_EXT)(GLuint program, const GLchar *name);
+typedef void (APIENTRY *PFNGLUNIFORM1IPROC_EXT)(GLint location, GLint v0);
+typedef void (APIENTRY *PFNGLUNIFORM3FPROC_EXT)(GLint location, GLfloat v0, GLfloat v1, GLfloat v2);
+extern PFNGLUSEPROGRAMPROC_EXT glUseProgramExt;
+extern PFNGLGETUNIFORMLOCATIONPROC_EXT glGetUniformLocationExt;
+extern PFNGLUNIFORM1IPROC_EXT glUniform1iExt;
+extern PFNGLUNIFORM3FPROC_EXT glUniform3fExt;
+
+namespace {
+
+/**
+ * @brief 实例化着色器的顶点属性位置
+ * 
+ * 创建着色器程序时按 ATTRIBUTE_NAMES 的顺序绑定，前三个逐顶点，其余逐实例。
+ */
+enum InstanceAttribute {
+    ATTR_POSITION, ATTR_NORMAL, ATTR_TEXCOORD,
+    ATTR_MODEL0, ATTR_MODEL1, ATTR_MODEL2, ATTR_MODEL3,
+    ATTR_NORMAL0, ATTR_NORMAL1, ATTR_NORMAL2,
+    ATTR_AMBIENT, ATTR_DIFFUSE, ATTR_SPECULAR,
+    ATTR_COUNT
+};
+
+const char* const ATTRIBUTE_NAMES[ATTR_COUNT] = {
+    "aPos", "aNormal", "aTexCoord",
+    "iModel0", "iModel1", "iModel2", "iModel3",
+    "iNormal0", "iNormal1", "iNormal2",
+    "iAmbient", "iDiffuse", "iSpecular"
+};
+
+const GLsizei VERTEX_STRIDE = 8 * sizeof(float);  // CPU端网格顶点格式 [x, y, z, nx, ny, nz, u, v]
+
+/**
+ * @brief 设置一个float顶点属性指针（缓冲区内偏移量）
+ */
+void AttribPointer(int attribute, GLint size, GLsizei stride, size_t offset) {
+    glVertexAttribPointer((GLuint)attribute, size, GL_FLOAT, GL_FALSE, stride, (const void*)offset);
+}
+
+} // namespace
+
+// ============================================================================
+// 资源创建和释放
+// ============================================================================
+
+/**
+ * @brief 创建实例化渲染所需的着色器程序和缓冲对象
+ */
+void GraphicsEngine3D::InitInstancing() {
+    if (!glVertexAttribDivisor || !glDrawElementsInstanced || !glDisableVertexAttribArray) {
+        LOG_WARN("InitInstancing: 驱动不支持实例化，使用逐实例绘制");
+        return;
+    }
+    
+    instanceProgram = ShaderManager::CreateShaderProgram(
+        ShaderManager::GetInstancedVertexShader(), ShaderManager::GetInstancedFragmentShader(),
+        ATTRIBUTE_NAMES, ATTR_COUNT);
+    if (instanceProgram == 0) {
+        LOG_WARN("InitInstancing: 实例化着色器创建失败，使用逐实例绘制");
+        return;
+    }
+    
+    glGenBuffers(1, &instanceVBO);
+}
+
+/**
+ * @brief 释放实例化渲染的缓冲对象
+ * 
+ * 着色器程序与其他着色器一样随OpenGL上下文一起释放。
+ */
+void GraphicsEngine3D::ReleaseInstancing() {
+    if (instanceVBO != 0 && glDeleteBuffers) {
+        glDeleteBuffers(1, &instanceVBO);
+    }
+    instanceVBO = 0;
+    instanceProgram = 0;
+}
+
+// ============================================================================
+// 批次渲染
+// ============================================================================
+
+/**
+ * @brief 按批次绘制所有图形
+ * 
+ * 先在CPU上重建批次（跳过被视锥剔除的图形，按 (网格, 纹理) 分组并打包矩阵和材质），
+ * 再根据驱动能力选择实例化绘制或逐实例绘制。
+ */
+void GraphicsEngine3D::RenderInstanceBatches() {
+    PROFILE_FUNCTION();
+    {
+        PROFILE_ZONE("InstanceBatcher::Build");
+        instanceBatcher.Build(shapes, materials, hasSelection ? selectedShapeIndex : -1,
+                              frustumCuller.Visibility());
+    }
+    if (instanceBatcher.Batches().empty()) return;
+    
+    if (instanceProgram != 0 && instanceVBO != 0) {
+        DrawBatchesInstanced();
+    } else {
+        DrawBatchesFixed();
+    }
+}
+
+/**
+ * @brief 用实例化着色器绘制全部批次
+ * 
+ * 全部实例数据一次上传；每个批次：
+ * 1. 逐顶点属性按网格的顶点格式指向网格的VBO，并设置该格式的解码参数
+ * 2. 逐实例属性指向 instanceVBO 中本批次的起始位置
+ * 3. 一次 glDrawElementsInstanced 画出整批（索引类型取自网格，16位或32位）
+ * 
+ * 不使用网格自带的VAO（其中的属性位置属于默认着色器），
+ * 属性指针直接设置在默认顶点数组对象上，绘制结束后恢复。
+ */
+void GraphicsEngine3D::DrawBatchesInstanced() {
+    PROFILE_FUNCTION();
+    const std::vector<InstanceBatch>& batches = instanceBatcher.Batches();
+    const std::vector<InstanceData>& instances = instanceBatcher.Instances();
+    
+    glUseProgramExt(instanceProgram);
+    glEnable(GL_VERTEX_PROGRAM_TWO_SIDE);  // 着色器分别输出正反面颜色（同固定管线的双面光照）
+    if (glBindVertexArray) glBindVertexArray(0);
+    
+    GLint useTextureLoc = glGetUniformLocationExt(instanceProgram, "useTexture");
+    GLint samplerLoc = glGetUniformLocationExt(instanceProgram, "textureSampler");
+    GLint positionScaleLoc = glGetUniformLocationExt(instanceProgram, "positionScale");
+    GLint positionOffsetLoc = glGetUniformLocationExt(instanceProgram, "positionOffset");
+    GLint octNormalsLoc = glGetUniformLocationExt(instanceProgram, "octNormals");
+    if (samplerLoc >= 0) glUniform1iExt(samplerLoc, 0);
+    
+    // 一次上传全部实例数据
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(instances.size() * sizeof(InstanceData)),
+                 instances.data(), GL_STREAM_DRAW);
+    
+    for (int a = 0; a < ATTR_COUNT; a++) {
+        glEnableVertexAttribArray((GLuint)a);
+        glVertexAttribDivisor((GLuint)a, a >= ATTR_MODEL0 ? 1 : 0);
+    }
+    
+    const GLsizei instanceStride = sizeof(InstanceData);
+    for (size_t b = 0; b < batches.size(); b++) {
+        const InstanceBatch& batch = batches[b];
+        const Mesh3D& mesh = *batch.mesh;
+        if (mesh.VBO == 0 || mesh.EBO == 0) continue;  // 网格缓冲对象未创建（创建时无上下文）
+        PROFILE_ZONE("DrawBatch");
+        
+        // 逐顶点属性：网格VBO（float或紧凑格式）
+        glBindBuffer(GL_ARRAY_BUFFER, mesh.VBO);
+        MeshBuffers::SetVertexAttributes(mesh, ATTR_POSITION, ATTR_NORMAL, ATTR_TEXCOORD);
+        if (positionScaleLoc >= 0)
+            glUniform3fExt(positionScaleLoc, mesh.positionScale[0], mesh.positionScale[1], mesh.positionScale[2]);
+        if (positionOffsetLoc >= 0)
+            glUniform3fExt(positionOffsetLoc, mesh.positionOffset[0], mesh.positionOffset[1], mesh.positionOffset[2]);
+        if (octNormalsLoc >= 0) glUniform1iExt(octNormalsLoc, (mesh.vertexFormat & VERTEX_NORMAL_OCT16) ? 1 : 0);
+        
+        // 逐实例属性：instanceVBO 中本批次的一段
+        glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+        size_t base = batch.first * sizeof(InstanceData);
+        for (int c = 0; c < 4; c++)
+            AttribPointer(ATTR_MODEL0 + c, 4, instanceStride, base + offsetof(InstanceData, model) + c * 4 * sizeof(float));
+        for (int c = 0; c < 3; c++)
+            AttribPointer(ATTR_NORMAL0 + c, 3, instanceStride, base + offsetof(InstanceData, normal) + c * 3 * sizeof(float));
+        AttribPointer(ATTR_AMBIENT, 4, instanceStride, base + offsetof(InstanceData, ambient));
+        AttribPointer(ATTR_DIFFUSE, 4, instanceStride, base + offsetof(InstanceData, diffuse));
+        AttribPointer(ATTR_SPECULAR, 4, instanceStride, base + offsetof(InstanceData, specular));  // rgb + shininess
+        
+        if (batch.textureID != 0) {
+            glEnable(GL_TEXTURE_2D);
+            glBindTexture(GL_TEXTURE_2D, batch.textureID);
+        }
+        if (useTextureLoc >= 0) glUniform1iExt(useTextureLoc, batch.textureID != 0 ? 1 : 0);
+        
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.EBO);
+        glDrawElementsInstanced(GL_TRIANGLES, (GLsizei)mesh.indices.size(), MeshBuffers::IndexType(mesh), 0,
+                                (GLsizei)batch.count);
+        
+        if (batch.textureID != 0) {
+            glDisable(GL_TEXTURE_2D);
+        }
+    }
+    
+    // 恢复状态，避免影响之后的固定管线绘制（坐标轴、网格等）
+    for (int a = 0; a < ATTR_COUNT; a++) {
+        glVertexAttribDivisor((GLuint)a, 0);
+        glDisableVertexAttribArray((GLuint)a);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    glDisable(GL_VERTEX_PROGRAM_TWO_SIDE);
+    glUseProgramExt(0);
+}
+
+/**
+ * @brief 用固定管线和顶点数组逐实例绘制全部批次
+ * 
+ * 顶点数组在每个批次设置一次；材质只在与上一个实例不同时才重新设置，
+ * 因此同一批次中材质相同的实例之间只有 glMultMatrixf 和 glDrawElements。
+ */
+void GraphicsEngine3D::DrawBatchesFixed() {
+    PROFILE_FUNCTION();
+    const std::vector<InstanceBatch>& batches = instanceBatcher.Batches();
+    const std::vector<InstanceData>& instances = instanceBatcher.Instances();
+    
+    // 客户端顶点数组要求没有绑定缓冲对象，否则指针会被当作缓冲区偏移量
+    if (glBindVertexArray) glBindVertexArray(0);
+    if (glBindBuffer) {
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    }
+    
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_NORMAL_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    
+    const InstanceData* lastMaterial = nullptr;
+    for (size_t b = 0; b < batches.size(); b++) {
+        const InstanceBatch& batch = batches[b];
+        const Mesh3D& mesh = *batch.mesh;
+        if (mesh.indices.empty()) continue;
+        PROFILE_ZONE("DrawBatch");
+        
+        const float* vertices = mesh.vertices.data();
+        glVertexPointer(3, GL_FLOAT, VERTEX_STRIDE, vertices);
+        glNormalPointer(GL_FLOAT, VERTEX_STRIDE, vertices + 3);
+        glTexCoordPointer(2, GL_FLOAT, VERTEX_STRIDE, vertices + 6);
+        
+        if (batch.textureID != 0) {
+            glEnable(GL_TEXTURE_2D);
+            glBindTexture(GL_TEXTURE_2D, batch.textureID);
+        }
+        
+        for (unsigned int i = 0; i < batch.count; i++) {
+            const InstanceData& inst = instances[batch.first + i];
+            
+            // 材质与上一个实例相同时跳过（ambient 到 shininess 在结构体中连续存放）
+            const size_t materialBytes = offsetof(InstanceData, shininess) + sizeof(float) - offsetof(InstanceData, ambient);
+            if (!lastMaterial || memcmp(inst.ambient, lastMaterial->ambient, materialBytes) != 0) {
+                float specular[4] = { inst.specular[0], inst.specular[1], inst.specular[2], 1.0f };
+                glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT, inst.ambient);
+                glMaterialfv(GL_FRONT_AND_BACK, GL_DIFFUSE, inst.diffuse);
+                glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR, specular);
+                glMaterialf(GL_FRONT_AND_BACK, GL_SHININESS, inst.shininess);
+                lastMaterial = &inst;
+            }
+            
+            glPushMatrix();
+            glMultMatrixf(inst.model);
+            glDrawElements(GL_TRIANGLES, (GLsizei)mesh.indices.size(), GL_UNSIGNED_INT, mesh.indices.data());
+            glPopMatrix();
+        }
+        
+        if (batch.textureID != 0) {
+            glDisable(GL_TEXTURE_2D);
+        }
+    }
+    
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glDisableClientState(GL_NORMAL_ARRAY);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+}
@@ -4,15 +4,15 @@
  * 
  * 本文件包含3D图形引擎的渲染功能：
  * - 主渲染函数(Render)
- * - 固定管线渲染(RenderWithFixedPipeline)
- * - 立即模式图元渲染(RenderCubeImmediate等)
+ * - 视锥剔除与细节层次选择(CullShapes、UpdateLevelsOfDetail，与软件渲染共用)
+ * - 固定管线渲染(RenderWithFixedPipeline)，图形按批次绘制(见 GraphicsEngine3D_Instanced.cpp)
  * 
  * 渲染流程说明：
  * 1. 清除颜色缓冲和深度缓冲
  * 2. 设置投影矩阵（透视投影）
  * 3. 设置视图矩阵（摄像机位置和朝向）
  * 4. 设置光照参数
- * 5. 遍历所有图形，设置模型矩阵和材质，执行绘制
+ * 5. 剔除视锥外的图形，其余按网格分组设置模型矩阵和材质，执行绘制
  * 6. 交换前后缓冲
  * 
  * Phong光照模型说明：
@@ -28,7 +28,9 @@
 
 #include "GraphicsEngine3D.h"
 #include "OpenGLFunctions.h"
-#include "../math/Matrix4.h"
+#include "LevelOfDetail.h"
+#include "../diagnostics/Log.h"
+#include "../diagnostics/Profiler.h"
 #include <gl/GL.h>
 #include <cmath>
 
@@ -36,31 +38,9 @@
 #undef near
 #undef far
 
-// 外部声明OpenGL函数指针（在GraphicsEngine3D_Core.cpp中定义）
-extern PFNGLGENVERTEXARRAYSPROC glGenVertexArrays;
-extern PFNGLBINDVERTEXARRAYPROC glBindVertexArray;
-
-// 额外的OpenGL函数指针类型
-typedef void (APIENTRY *PFNGLDRAWELEMENTSPROC_EXT)(GLenum mode, GLsizei count, GLenum type, const void *indices);
+// 额外的OpenGL函数指针类型（在GraphicsEngine3D_Core.cpp中定义）
 typedef void (APIENTRY *PFNGLUSEPROGRAMPROC_EXT)(GLuint program);
-typedef GLint (APIENTRY *PFNGLGETUNIFORMLOCATIONPROC_EXT)(GLuint program, const GLchar *name);
-typedef void (APIENTRY *PFNGLUNIFORMMATRIX4FVPROC_EXT)(GLint location, GLsizei count, GLboolean transpose, const GLfloat *value);
-typedef void (APIENTRY *PFNGLUNIFORM3FPROC_EXT)(GLint location, GLfloat v0, GLfloat v1, GLfloat v2);
-typedef void (APIENTRY *PFNGLUNIFORM1FPROC_EXT)(GLint location, GLfloat v0);
-typedef void (APIENTRY *PFNGLUNIFORM1IPROC_EXT)(GLint location, GLint v0);
-typedef void (APIENTRY *PFNGLACTIVETEXTUREPROC_EXT)(GLenum texture);
-typedef void (APIENTRY *PFNGLBINDTEXTUREPROC_EXT)(GLenum target, GLuint texture);
-
-// 外部声明额外的OpenGL函数指针
-extern PFNGLDRAWELEMENTSPROC_EXT glDrawElementsExt;
 extern PFNGLUSEPROGRAMPROC_EXT glUseProgramExt;
-extern PFNGLGETUNIFORMLOCATIONPROC_EXT glGetUniformLocationExt;
-extern PFNGLUNIFORMMATRIX4FVPROC_EXT glUniformMatrix4fvExt;
-extern PFNGLUNIFORM3FPROC_EXT glUniform3fExt;
-extern PFNGLUNIFORM1FPROC_EXT glUniform1fExt;
-extern PFNGLUNIFORM1IPROC_EXT glUniform1iExt;
-extern PFNGLACTIVETEXTUREPROC_EXT glActiveTextureExt;
-extern PFNGLBINDTEXTUREPROC_EXT glBindTextureExt;
 
 // ============================================================================
 // 主渲染函数
@@ -80,14 +60,12 @@ extern PFNGLBINDTEXTUREPROC_EXT glBindTextureExt;
  * 5. 交换前后缓冲（双缓冲）
  */
 void GraphicsEngine3D::Render() {
-    // 调试输出：检查shapes数量
-    char debugMsg[256];
-    sprintf_s(debugMsg, "Render开始: shapes数量=%zu, isInitialized=%d", 
-              shapes.size(), isInitialized ? 1 : 0);
-    OutputDebugStringA(debugMsg);
+    PROFILE_FUNCTION();
+    // 每帧日志默认在编译期裁剪掉（TRACE级别）
+    LOG_TRACE("Render开始: shapes数量=%zu, isInitialized=%d", shapes.size(), isInitialized ? 1 : 0);
     
     if (!isInitialized) {
-        OutputDebugStringA("Render: 引擎未初始化，直接返回");
+        LOG_TRACE("Render: 引擎未初始化，直接返回");
         return;
     }
     
@@ -100,132 +78,91 @@ void GraphicsEngine3D::Render() {
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     
     // 使用固定管线渲染（兼容性更好）
-    // 注：可编程管线渲染代码保留在下方，但当前未启用
     RenderWithFixedPipeline();
     
-    // 交换前后缓冲，显示渲染结果
-    SwapBuffers(hdc);
-    return;
-    
-    // ========================================================================
-    // 以下是可编程管线渲染代码（当前未启用）
-    // 使用着色器程序进行渲染，支持更高级的光照效果
-    // ========================================================================
-    
-    if (shaderProgram == 0) {
-        RenderWithFixedPipeline();
+    // 交换前后缓冲，显示渲染结果（开启垂直同步时在这里等待）
+    {
+        PROFILE_ZONE("SwapBuffers");
         SwapBuffers(hdc);
-        return;
     }
+}
+
+// ============================================================================
+// 固定管线渲染
+// ============================================================================
+
+/**
+ * @brief 用摄像机缓存的视锥平面剔除场景图形
+ * 
+ * 视锥平面取自摄像机的 投影矩阵 × 视图矩阵，与实际绘制所用的矩阵相同，
+ * 因此被剔除的图形一定不会出现在画面上。摄像机不动时平面不会重新提取。
+ */
+void GraphicsEngine3D::CullShapes() {
+    PROFILE_FUNCTION();
+    frustumCuller.SetPlanes(camera.FrustumPlanes());
+    frustumCuller.Cull(shapes);
+}
+
+// ============================================================================
+// 细节层次（LOD）
+// ============================================================================
+
+/**
+ * @brief 取得图形类型在指定细节层次下的共享网格
+ * 
+ * 按引擎当前的球体剖分方式和屏幕误差向注册表请求，
+ * 注册表按 (类型, 参数) 共享，每个层次只生成一次。
+ */
+MeshHandle GraphicsEngine3D::AcquireShapeMesh(Shape3DType type, int lodLevel) {
+    return meshRegistry.ForShape(type, lodLevel, sphereTessellation, sphereScreenError);
+}
+
+/**
+ * @brief 设置球体网格的剖分方式
+ * 
+ * 已有球体保留各自的细节层次，只换成新剖分方式下同一层次的共享网格；
+ * 旧网格在最后一个句柄释放时由注册表回收。
+ */
+void GraphicsEngine3D::SetSphereTessellation(SphereTessellation mode, float maxErrorPixels) {
+    sphereTessellation = mode;
+    sphereScreenError = maxErrorPixels > 0.0f ? maxErrorPixels : 0.5f;
     
-    // 获取窗口尺寸，计算宽高比
-    RECT rect;
-    GetClientRect(hwnd, &rect);
-    int width = rect.right - rect.left;
-    int height = rect.bottom - rect.top;
-    if (width == 0 || height == 0) return;
-    
-    float aspectRatio = (float)width / (float)height;
-    
-    // 设置视口
-    glViewport(0, 0, width, height);
-    
-    // 激活着色器程序
-    glUseProgramExt(shaderProgram);
-    
-    // 计算摄像机位置（球坐标转笛卡尔坐标）
-    float cameraX = camera.targetX + camera.distance * cosf(camera.angleY * (float)M_PI / 180.0f) * cosf(camera.angleX * (float)M_PI / 180.0f);
-    float cameraY = camera.targetY + camera.distance * sinf(camera.angleY * (float)M_PI / 180.0f);
-    float cameraZ = camera.targetZ + camera.distance * cosf(camera.angleY * (float)M_PI / 180.0f) * sinf(camera.angleX * (float)M_PI / 180.0f);
-    
-    // 创建投影矩阵和视图矩阵
-    Matrix4 projection = Matrix4::perspective(45.0f * (float)M_PI / 180.0f, aspectRatio, 0.1f, 100.0f);
-    Matrix4 view = Matrix4::lookAt(cameraX, cameraY, cameraZ,
-                                   camera.targetX, camera.targetY, camera.targetZ,
-                                   0.0f, 1.0f, 0.0f);
-    
-    // 设置投影和视图矩阵uniform
-    int projLoc = glGetUniformLocationExt(shaderProgram, "projection");
-    int viewLoc = glGetUniformLocationExt(shaderProgram, "view");
-    int modelLoc = glGetUniformLocationExt(shaderProgram, "model");
-    
-    if (projLoc >= 0) glUniformMatrix4fvExt(projLoc, 1, GL_FALSE, projection.m);
-    if (viewLoc >= 0) glUniformMatrix4fvExt(viewLoc, 1, GL_FALSE, view.m);
-    
-    // 设置Phong光照模型参数
-    int lightPosLoc = glGetUniformLocationExt(shaderProgram, "lightPos");
-    int lightColorLoc = glGetUniformLocationExt(shaderProgram, "lightColor");
-    int lightAmbientIntensityLoc = glGetUniformLocationExt(shaderProgram, "lightAmbientIntensity");
-    int lightDiffuseIntensityLoc = glGetUniformLocationExt(shaderProgram, "lightDiffuseIntensity");
-    int lightSpecularIntensityLoc = glGetUniformLocationExt(shaderProgram, "lightSpecularIntensity");
-    int viewPosLoc = glGetUniformLocationExt(shaderProgram, "viewPos");
-    
-    if (lightPosLoc >= 0) glUniform3fExt(lightPosLoc, light.positionX, light.positionY, light.positionZ);
-    if (lightColorLoc >= 0) glUniform3fExt(lightColorLoc, light.color[0], light.color[1], light.color[2]);
-    if (lightAmbientIntensityLoc >= 0) glUniform1fExt(lightAmbientIntensityLoc, light.ambientIntensity);
-    if (lightDiffuseIntensityLoc >= 0) glUniform1fExt(lightDiffuseIntensityLoc, light.diffuseIntensity);
-    if (lightSpecularIntensityLoc >= 0) glUniform1fExt(lightSpecularIntensityLoc, light.specularIntensity);
-    if (viewPosLoc >= 0) glUniform3fExt(viewPosLoc, cameraX, cameraY, cameraZ);
+    for (size_t i = 0; i < shapes.size(); i++) {
+        if (shapes[i].type == SHAPE3D_SPHERE)
+            shapes[i].mesh = AcquireShapeMesh(SHAPE3D_SPHERE, shapes[i].lodLevel);
+    }
+}
+
+/**
+ * @brief 按屏幕上的投影半径更新球体和圆柱体的细节层次
+ * 
+ * 投影半径由世界空间包围球和摄像机到球心的距离求出（与剔除用的包围球相同），
+ * LevelOfDetail::SelectLevel 带滞后地决定层次。
+ * 只有层次真正变化的图形才更换网格句柄，稳定状态下本函数不修改任何图形。
+ */
+void GraphicsEngine3D::UpdateLevelsOfDetail(int viewportHeight) {
+    PROFILE_FUNCTION();
+    const float* eye = camera.Position();
     
-    // 渲染所有图形
     for (size_t i = 0; i < shapes.size(); i++) {
-        const Shape3D& shape = shapes[i];
-        
-        // 计算模型矩阵（平移 * 旋转 * 缩放）
-        Matrix4 model = Matrix4::translate(shape.positionX, shape.positionY, shape.positionZ);
-        model = model.multiply(Matrix4::rotateZ(shape.rotationZ * (float)M_PI / 180.0f));
-        model = model.multiply(Matrix4::rotateY(shape.rotationY * (float)M_PI / 180.0f));
-        model = model.multiply(Matrix4::rotateX(shape.rotationX * (float)M_PI / 180.0f));
-        model = model.multiply(Matrix4::scale(shape.scaleX, shape.scaleY, shape.scaleZ));
-        
-        if (modelLoc >= 0) glUniformMatrix4fvExt(modelLoc, 1, GL_FALSE, model.m);
-        
-        // 设置材质属性
-        int ambientLoc = glGetUniformLocationExt(shaderProgram, "ambient");
-        int diffuseLoc = glGetUniformLocationExt(shaderProgram, "diffuse");
-        int specularLoc = glGetUniformLocationExt(shaderProgram, "specular");
-        int shininessLoc = glGetUniformLocationExt(shaderProgram, "shininess");
-        int useTextureLoc = glGetUniformLocationExt(shaderProgram, "useTexture");
-        
-        // 选中的图形使用黄色高亮显示
-        float ambient[3], diffuse[3], specular[3];
-        if (shape.selected) {
-            ambient[0] = 0.3f; ambient[1] = 0.3f; ambient[2] = 0.1f;
-            diffuse[0] = 1.0f; diffuse[1] = 1.0f; diffuse[2] = 0.3f;
-            specular[0] = 1.0f; specular[1] = 1.0f; specular[2] = 0.5f;
-        } else {
-            ambient[0] = shape.ambient[0]; ambient[1] = shape.ambient[1]; ambient[2] = shape.ambient[2];
-            diffuse[0] = shape.diffuse[0]; diffuse[1] = shape.diffuse[1]; diffuse[2] = shape.diffuse[2];
-            specular[0] = shape.specular[0]; specular[1] = shape.specular[1]; specular[2] = shape.specular[2];
-        }
-        
-        if (ambientLoc >= 0) glUniform3fExt(ambientLoc, ambient[0], ambient[1], ambient[2]);
-        if (diffuseLoc >= 0) glUniform3fExt(diffuseLoc, diffuse[0], diffuse[1], diffuse[2]);
-        if (specularLoc >= 0) glUniform3fExt(specularLoc, specular[0], specular[1], specular[2]);
-        if (shininessLoc >= 0) glUniform1fExt(shininessLoc, shape.shininess);
-        if (useTextureLoc >= 0) glUniform1iExt(useTextureLoc, shape.hasTexture ? 1 : 0);
+        Shape3D& shape = shapes[i];
+        if (shape.type != SHAPE3D_SPHERE && shape.type != SHAPE3D_CYLINDER) continue;
+        if (!frustumCuller.IsVisible(i)) continue;
         
-        // 绑定纹理
-        if (shape.hasTexture && shape.textureID != 0) {
-            glActiveTextureExt(GL_TEXTURE0);
-            glBindTextureExt(GL_TEXTURE_2D, shape.textureID);
-        }
+        float center[3], radius;
+        FrustumCuller::WorldBoundingSphere(shape, center, radius);
+        float dx = center[0] - eye[0], dy = center[1] - eye[1], dz = center[2] - eye[2];
+        float distance = sqrtf(dx * dx + dy * dy + dz * dz);
         
-        // 绘制图形
-        if (shape.VAO != 0) {
-            glBindVertexArray(shape.VAO);
-            glDrawElementsExt(GL_TRIANGLES, (GLsizei)shape.indices.size(), GL_UNSIGNED_INT, 0);
-            glBindVertexArray(0);
+        float pixelRadius = LevelOfDetail::ProjectedRadius(radius, distance, viewportHeight, Camera::FOV_Y);
+        int level = LevelOfDetail::SelectLevel(pixelRadius, shape.lodLevel);
+        if (level != shape.lodLevel) {
+            shape.lodLevel = level;
+            shape.mesh = AcquireShapeMesh(shape.type, level);
         }
     }
-    
-    SwapBuffers(hdc);
 }
 
-// ============================================================================
-// 固定管线渲染
-// ============================================================================
-
 /**
  * @brief 使用OpenGL固定管线渲染3D场景
  * 
@@ -236,7 +173,8 @@ void GraphicsEngine3D::Render() {
  * 1. 设置视口和投影矩阵（透视投影）
  * 2. 设置视图矩阵（摄像机变换）
  * 3. 启用光照并配置光源参数
- * 4. 遍历所有图形，应用变换和材质，绘制图元
+ * 4. 视锥剔除（CullShapes），按投影尺寸选择细节层次（UpdateLevelsOfDetail），
+ *    按网格分组批量绘制可见图形（RenderInstanceBatches）
  * 5. 禁用光照
  * 
  * Phong光照模型在固定管线中的实现：
@@ -246,6 +184,8 @@ void GraphicsEngine3D::Render() {
  * - GL_SHININESS: 高光指数（控制高光大小）
  */
 void GraphicsEngine3D::RenderWithFixedPipeline() {
+    PROFILE_FUNCTION();
+    
     // 确保禁用着色器程序，使用固定管线
     // 这是必要的，因为如果着色器程序处于激活状态，
     // 固定管线的光照和材质设置会被忽略
@@ -260,226 +200,96 @@ void GraphicsEngine3D::RenderWithFixedPipeline() {
     int height = rect.bottom - rect.top;
     if (width == 0 || height == 0) return;
     
-    float aspectRatio = (float)width / (float)height;
-    
-    // 设置视口
-    glViewport(0, 0, width, height);
-    
-    // ========================================================================
-    // 设置投影矩阵（透视投影）
-    // ========================================================================
-    glMatrixMode(GL_PROJECTION);
-    glLoadIdentity();
-    
-    // 透视投影参数
-    float fov = 45.0f;           // 视场角（Field of View）
-    float nearPlane = 0.1f;      // 近裁剪面
-    float farPlane = 100.0f;     // 远裁剪面
-    
-    // 计算视锥体边界
-    float top = nearPlane * tanf(fov * (float)M_PI / 360.0f);
-    float bottom = -top;
-    float right = top * aspectRatio;
-    float left = -right;
-    
-    // 设置透视投影矩阵
-    glFrustum(left, right, bottom, top, nearPlane, farPlane);
-    
-    // ========================================================================
-    // 设置视图矩阵（摄像机变换）
-    // ========================================================================
-    glMatrixMode(GL_MODELVIEW);
-    glLoadIdentity();
-    
-    // 计算摄像机位置（球坐标转笛卡尔坐标）
-    float radX = camera.angleX * (float)M_PI / 180.0f;
-    float radY = camera.angleY * (float)M_PI / 180.0f;
-    float cameraX = camera.targetX + camera.distance * cosf(radY) * sinf(radX);
-    float cameraY = camera.targetY + camera.distance * sinf(radY);
-    float cameraZ = camera.targetZ + camera.distance * cosf(radY) * cosf(radX);
-    
-    // ========================================================================
-    // 在设置视图矩阵之前，先设置光源位置（世界坐标系）
-    // 这样光源位置就是固定在世界空间中的
-    // ========================================================================
-    glEnable(GL_LIGHTING);
-    glEnable(GL_LIGHT0);
-    glEnable(GL_NORMALIZE);
-    
-    float globalAmbient[] = {0.1f, 0.1f, 0.1f, 1.0f};
-    glLightModelfv(GL_LIGHT_MODEL_AMBIENT, globalAmbient);
-    
-    // 使用gluLookAt风格的视图矩阵
-    // 计算摄像机的前向、右向、上向向量
-    float forwardX = camera.targetX - cameraX;
-    float forwardY = camera.targetY - cameraY;
-    float forwardZ = camera.targetZ - cameraZ;
-    
-    // 归一化前向向量
-    float forwardLen = sqrtf(forwardX * forwardX + forwardY * forwardY + forwardZ * forwardZ);
-    if (forwardLen > 0.0001f) {
-        forwardX /= forwardLen;
-        forwardY /= forwardLen;
-        forwardZ /= forwardLen;
-    }
-    
-    // 世界上向量
-    float worldUpX = 0.0f, worldUpY = 1.0f, worldUpZ = 0.0f;
-    
-    // 右向量 = 前向 × 上向
-    float rightX = forwardY * worldUpZ - forwardZ * worldUpY;
-    float rightY = forwardZ * worldUpX - forwardX * worldUpZ;
-    float rightZ = forwardX * worldUpY - forwardY * worldUpX;
-    
-    // 归一化右向量
-    float rightLen = sqrtf(rightX * rightX + rightY * rightY + rightZ * rightZ);
-    if (rightLen > 0.0001f) {
-        rightX /= rightLen;
-        rightY /= rightLen;
-        rightZ /= rightLen;
-    }
-    
-    // 真正的上向量 = 右向 × 前向
-    float upX = rightY * forwardZ - rightZ * forwardY;
-    float upY = rightZ * forwardX - rightX * forwardZ;
-    float upZ = rightX * forwardY - rightY * forwardX;
-    
-    // 计算平移分量（将摄像机位置变换到眼睛空间原点）
-    float tx = -(rightX * cameraX + rightY * cameraY + rightZ * cameraZ);
-    float ty = -(upX * cameraX + upY * cameraY + upZ * cameraZ);
-    float tz = (forwardX * cameraX + forwardY * cameraY + forwardZ * cameraZ);
-    
-    // 构建视图矩阵（lookAt矩阵）
-    // OpenGL使用列主序（column-major）
-    // 矩阵布局（行主序表示）：
-    // | rightX   rightY   rightZ   tx |
-    // | upX      upY      upZ      ty |
-    // | -forwardX -forwardY -forwardZ tz |
-    // | 0        0        0        1  |
-    // 
-    // 列主序存储：先存第一列，再存第二列...
-    float viewMatrix[16] = {
-        rightX,     rightY,     rightZ,     0.0f,  // 第一列
-        upX,        upY,        upZ,        0.0f,  // 第二列
-        -forwardX,  -forwardY,  -forwardZ,  0.0f,  // 第三列
-        tx,         ty,         tz,         1.0f   // 第四列
-    };
-    
-    glLoadMatrixf(viewMatrix);
-    
-    // 设置光源位置（在视图矩阵设置后，光源位置会被变换到眼睛空间）
-    // 使用w=1.0表示点光源（位置光源）
-    float lightPos[] = {light.positionX, light.positionY, light.positionZ, 1.0f};
-    glLightfv(GL_LIGHT0, GL_POSITION, lightPos);
-    
-    // 设置环境光分量（Ambient）
-    // 环境光模拟间接光照，使物体在阴影中也可见
-    float ambientLight[] = {
-        light.color[0] * light.ambientIntensity, 
-        light.color[1] * light.ambientIntensity, 
-        light.color[2] * light.ambientIntensity, 
-        1.0f
-    };
-    glLightfv(GL_LIGHT0, GL_AMBIENT, ambientLight);
-    
-    // 设置漫反射分量（Diffuse）
-    // 漫反射是光照的主要贡献，与表面法线和光线方向的夹角有关
-    float diffuseLight[] = {
-        light.color[0] * light.diffuseIntensity, 
-        light.color[1] * light.diffuseIntensity, 
-        light.color[2] * light.diffuseIntensity, 
-        1.0f
-    };
-    glLightfv(GL_LIGHT0, GL_DIFFUSE, diffuseLight);
-    
-    // 设置镜面反射分量（Specular）
-    // 镜面反射产生高光效果，与视线方向和反射方向有关
-    float specularLight[] = {
-        light.color[0] * light.specularIntensity, 
-        light.color[1] * light.specularIntensity, 
-        light.color[2] * light.specularIntensity, 
-        1.0f
-    };
-    glLightfv(GL_LIGHT0, GL_SPECULAR, specularLight);
-    
-    // 设置光照模型参数
-    // GL_LIGHT_MODEL_LOCAL_VIEWER: 使用局部观察者模型，镜面反射更准确
-    // GL_LIGHT_MODEL_TWO_SIDE: 双面光照，背面也能正确计算光照
-    glLightModeli(GL_LIGHT_MODEL_LOCAL_VIEWER, GL_TRUE);
-    glLightModeli(GL_LIGHT_MODEL_TWO_SIDE, GL_TRUE);
-    
-    // ========================================================================
-    // 渲染所有3D图形
-    // ========================================================================
-    char renderDebug[256];
-    sprintf_s(renderDebug, "RenderWithFixedPipeline: 准备渲染 %zu 个图形", shapes.size());
-    OutputDebugStringA(renderDebug);
-    
-    for (size_t i = 0; i < shapes.size(); i++) {
-        const Shape3D& shape = shapes[i];
+    {
+        PROFILE_ZONE("Camera setup");
+        // 设置视口
+        glViewport(0, 0, width, height);
+        camera.SetViewport(width, height);
         
-        glPushMatrix();  // 保存当前矩阵
+        // ========================================================================
+        // 设置投影矩阵（透视投影）
+        // ========================================================================
+        // 视场角45°、近裁剪面0.1、远裁剪面100的对称透视投影，
+        // 与 glFrustum(-right, right, -top, top, near, far) 等价，由摄像机缓存
+        glMatrixMode(GL_PROJECTION);
+        glLoadMatrixf(camera.Projection().m);
         
-        // 应用模型变换（平移 → 旋转 → 缩放）
-        glTranslatef(shape.positionX, shape.positionY, shape.positionZ);
-        glRotatef(shape.rotationZ, 0.0f, 0.0f, 1.0f);  // 绕Z轴旋转
-        glRotatef(shape.rotationY, 0.0f, 1.0f, 0.0f);  // 绕Y轴旋转
-        glRotatef(shape.rotationX, 1.0f, 0.0f, 0.0f);  // 绕X轴旋转
-        glScalef(shape.scaleX, shape.scaleY, shape.scaleZ);
+        // ========================================================================
+        // 设置视图矩阵（摄像机变换）
+        // ========================================================================
+        glMatrixMode(GL_MODELVIEW);
+        glLoadIdentity();
+    }
+    
+    {
+        PROFILE_ZONE("Lighting");
+        // ========================================================================
+        // 在设置视图矩阵之前，先设置光源位置（世界坐标系）
+        // 这样光源位置就是固定在世界空间中的
+        // ========================================================================
+        glEnable(GL_LIGHTING);
+        glEnable(GL_LIGHT0);
+        glEnable(GL_NORMALIZE);
         
-        // 设置材质属性
-        float ambient[4], diffuse[4], specular[4];
+        float globalAmbient[] = {0.1f, 0.1f, 0.1f, 1.0f};
+        glLightModelfv(GL_LIGHT_MODEL_AMBIENT, globalAmbient);
         
-        if (shape.selected) {
-            // 选中的图形使用黄色高亮
-            ambient[0] = 0.3f; ambient[1] = 0.3f; ambient[2] = 0.1f; ambient[3] = 1.0f;
-            diffuse[0] = 1.0f; diffuse[1] = 1.0f; diffuse[2] = 0.3f; diffuse[3] = 1.0f;
-            specular[0] = 1.0f; specular[1] = 1.0f; specular[2] = 0.5f; specular[3] = 1.0f;
-        } else {
-            // 使用图形自身的材质颜色
-            ambient[0] = shape.ambient[0]; ambient[1] = shape.ambient[1]; ambient[2] = shape.ambient[2]; ambient[3] = 1.0f;
-            diffuse[0] = shape.diffuse[0]; diffuse[1] = shape.diffuse[1]; diffuse[2] = shape.diffuse[2]; diffuse[3] = 1.0f;
-            specular[0] = shape.specular[0]; specular[1] = shape.specular[1]; specular[2] = shape.specular[2]; specular[3] = 1.0f;
-        }
+        // 视图矩阵取自摄像机缓存（与软件光栅化后端、拾取和剔除共用）
+        glLoadMatrixf(camera.View().m);
         
-        // 设置材质属性（正面和背面）
-        glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT, ambient);
-        glMaterialfv(GL_FRONT_AND_BACK, GL_DIFFUSE, diffuse);
-        glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR, specular);
-        glMaterialf(GL_FRONT_AND_BACK, GL_SHININESS, shape.shininess);
+        // 设置光源位置（在视图矩阵设置后，光源位置会被变换到眼睛空间）
+        // 使用w=1.0表示点光源（位置光源）
+        float lightPos[] = {light.positionX, light.positionY, light.positionZ, 1.0f};
+        glLightfv(GL_LIGHT0, GL_POSITION, lightPos);
         
-        // 启用纹理（如果有）
-        bool textureEnabled = false;
-        if (shape.hasTexture && shape.textureID != 0) {
-            glEnable(GL_TEXTURE_2D);
-            glBindTexture(GL_TEXTURE_2D, shape.textureID);
-            textureEnabled = true;
-        }
+        // 设置环境光分量（Ambient）
+        // 环境光模拟间接光照，使物体在阴影中也可见
+        float ambientLight[] = {
+            light.color[0] * light.ambientIntensity, 
+            light.color[1] * light.ambientIntensity, 
+            light.color[2] * light.ambientIntensity, 
+            1.0f
+        };
+        glLightfv(GL_LIGHT0, GL_AMBIENT, ambientLight);
         
-        // 根据图形类型调用相应的渲染函数
-        switch (shape.type) {
-            case SHAPE3D_CUBE:
-                RenderCubeImmediate(1.0f);
-                break;
-            case SHAPE3D_SPHERE:
-                RenderSphereImmediate(0.5f, 16, 16);
-                break;
-            case SHAPE3D_CYLINDER:
-                RenderCylinderImmediate(0.5f, 1.0f, 16);
-                break;
-            case SHAPE3D_PLANE:
-                RenderPlaneImmediate(1.0f, 1.0f);
-                break;
-        }
+        // 设置漫反射分量（Diffuse）
+        // 漫反射是光照的主要贡献，与表面法线和光线方向的夹角有关
+        float diffuseLight[] = {
+            light.color[0] * light.diffuseIntensity, 
+            light.color[1] * light.diffuseIntensity, 
+            light.color[2] * light.diffuseIntensity, 
+            1.0f
+        };
+        glLightfv(GL_LIGHT0, GL_DIFFUSE, diffuseLight);
         
-        // 禁用纹理
-        if (textureEnabled) {
-            glDisable(GL_TEXTURE_2D);
-        }
+        // 设置镜面反射分量（Specular）
+        // 镜面反射产生高光效果，与视线方向和反射方向有关
+        float specularLight[] = {
+            light.color[0] * light.specularIntensity, 
+            light.color[1] * light.specularIntensity, 
+            light.color[2] * light.specularIntensity, 
+            1.0f
+        };
+        glLightfv(GL_LIGHT0, GL_SPECULAR, specularLight);
         
-        glPopMatrix();  // 恢复矩阵
+        // 设置光照模型参数
+        // GL_LIGHT_MODEL_LOCAL_VIEWER: 使用局部观察者模型，镜面反射更准确
+        // GL_LIGHT_MODEL_TWO_SIDE: 双面光照，背面也能正确计算光照
+        glLightModeli(GL_LIGHT_MODEL_LOCAL_VIEWER, GL_TRUE);
+        glLightModeli(GL_LIGHT_MODEL_TWO_SIDE, GL_TRUE);
     }
     
+    // ========================================================================
+    // 渲染所有3D图形
+    // ========================================================================
+    LOG_TRACE("RenderWithFixedPipeline: 准备渲染 %zu 个图形", shapes.size());
+    
+    // 剔除视锥外的图形，按屏幕尺寸选择球体和圆柱体的细分层次，其余按 (网格, 纹理) 分组，每组一次实例化绘制（不支持时逐实例绘制），
+    // 见 GraphicsEngine3D_Instanced.cpp
+    CullShapes();
+    UpdateLevelsOfDetail(height);
+    RenderInstanceBatches();
+    
     // ========================================================================
     // 渲染坐标轴和网格（不受光照影响）
     // ========================================================================
@@ -504,263 +314,6 @@ void GraphicsEngine3D::RenderWithFixedPipeline() {
 }
 
 
-// ============================================================================
-// 立即模式图元渲染函数
-// 这些函数使用OpenGL立即模式(glBegin/glEnd)绘制基本3D图元
-// ============================================================================
-
-/**
- * @brief 使用立即模式渲染立方体
- * @param size 立方体边长
- * 
- * 立方体由6个面组成，每个面是一个四边形。
- * 每个顶点需要指定：
- * - 法线向量（用于光照计算）
- * - 纹理坐标（用于纹理映射）
- * - 顶点位置
- */
-void GraphicsEngine3D::RenderCubeImmediate(float size) {
-    float h = size * 0.5f;
-    
-    glBegin(GL_QUADS);
-    
-    // 前面 (Z+) - 从前面看逆时针
-    glNormal3f(0.0f, 0.0f, 1.0f);
-    glVertex3f(-h, -h,  h);
-    glVertex3f( h, -h,  h);
-    glVertex3f( h,  h,  h);
-    glVertex3f(-h,  h,  h);
-    
-    // 后面 (Z-) - 从后面看逆时针
-    glNormal3f(0.0f, 0.0f, -1.0f);
-    glVertex3f( h, -h, -h);
-    glVertex3f(-h, -h, -h);
-    glVertex3f(-h,  h, -h);
-    glVertex3f( h,  h, -h);
-    
-    // 顶面 (Y+) - 从上面看逆时针
-    glNormal3f(0.0f, 1.0f, 0.0f);
-    glVertex3f(-h,  h,  h);
-    glVertex3f( h,  h,  h);
-    glVertex3f( h,  h, -h);
-    glVertex3f(-h,  h, -h);
-    
-    // 底面 (Y-) - 从下面看逆时针
-    glNormal3f(0.0f, -1.0f, 0.0f);
-    glVertex3f(-h, -h, -h);
-    glVertex3f( h, -h, -h);
-    glVertex3f( h, -h,  h);
-    glVertex3f(-h, -h,  h);
-    
-    // 右面 (X+) - 从右面看逆时针
-    glNormal3f(1.0f, 0.0f, 0.0f);
-    glVertex3f( h, -h,  h);
-    glVertex3f( h, -h, -h);
-    glVertex3f( h,  h, -h);
-    glVertex3f( h,  h,  h);
-    
-    // 左面 (X-) - 从左面看逆时针
-    glNormal3f(-1.0f, 0.0f, 0.0f);
-    glVertex3f(-h, -h, -h);
-    glVertex3f(-h, -h,  h);
-    glVertex3f(-h,  h,  h);
-    glVertex3f(-h,  h, -h);
-    
-    glEnd();
-}
-
-/**
- * @brief 使用立即模式渲染球体
- * @param radius 球体半径
- * @param segments 经度方向的分段数（水平方向）
- * @param rings 纬度方向的分段数（垂直方向）
- * 
- * 球体使用球坐标系生成顶点：
- * - phi: 纬度角，从0到π（北极到南极）
- * - theta: 经度角，从0到2π（绕Y轴一圈）
- * 
- * 顶点位置公式：
- * x = r * sin(phi) * cos(theta)
- * y = r * cos(phi)
- * z = r * sin(phi) * sin(theta)
- * 
- * 法线向量等于归一化的顶点位置（球心在原点）
- */
-void GraphicsEngine3D::RenderSphereImmediate(float radius, int segments, int rings) {
-    glBegin(GL_TRIANGLES);
-    
-    for (int ring = 0; ring < rings; ring++) {
-        // 当前环和下一环的纬度角
-        float phi1 = (float)M_PI * ring / rings;
-        float phi2 = (float)M_PI * (ring + 1) / rings;
-        
-        for (int seg = 0; seg < segments; seg++) {
-            // 当前段和下一段的经度角
-            float theta1 = 2.0f * (float)M_PI * seg / segments;
-            float theta2 = 2.0f * (float)M_PI * (seg + 1) / segments;
-            
-            // 计算纹理坐标（球面映射）
-            float u1 = (float)seg / segments;
-            float u2 = (float)(seg + 1) / segments;
-            float v1 = (float)ring / rings;
-            float v2 = (float)(ring + 1) / rings;
-            
-            // 计算四个顶点位置和法线
-            // 顶点1: 当前环，当前段
-            float x1 = radius * sinf(phi1) * cosf(theta1);
-            float y1 = radius * cosf(phi1);
-            float z1 = radius * sinf(phi1) * sinf(theta1);
-            float nx1 = x1 / radius, ny1 = y1 / radius, nz1 = z1 / radius;
-            
-            // 顶点2: 下一环，当前段
-            float x2 = radius * sinf(phi2) * cosf(theta1);
-            float y2 = radius * cosf(phi2);
-            float z2 = radius * sinf(phi2) * sinf(theta1);
-            float nx2 = x2 / radius, ny2 = y2 / radius, nz2 = z2 / radius;
-            
-            // 顶点3: 当前环，下一段
-            float x3 = radius * sinf(phi1) * cosf(theta2);
-            float y3 = radius * cosf(phi1);
-            float z3 = radius * sinf(phi1) * sinf(theta2);
-            float nx3 = x3 / radius, ny3 = y3 / radius, nz3 = z3 / radius;
-            
-            // 顶点4: 下一环，下一段
-            float x4 = radius * sinf(phi2) * cosf(theta2);
-            float y4 = radius * cosf(phi2);
-            float z4 = radius * sinf(phi2) * sinf(theta2);
-            float nx4 = x4 / radius, ny4 = y4 / radius, nz4 = z4 / radius;
-            
-            // 第一个三角形: 1-3-2 (逆时针顺序，从外部看)
-            glTexCoord2f(u1, v1); glNormal3f(nx1, ny1, nz1); glVertex3f(x1, y1, z1);
-            glTexCoord2f(u2, v1); glNormal3f(nx3, ny3, nz3); glVertex3f(x3, y3, z3);
-            glTexCoord2f(u1, v2); glNormal3f(nx2, ny2, nz2); glVertex3f(x2, y2, z2);
-            
-            // 第二个三角形: 3-4-2 (逆时针顺序，从外部看)
-            glTexCoord2f(u2, v1); glNormal3f(nx3, ny3, nz3); glVertex3f(x3, y3, z3);
-            glTexCoord2f(u2, v2); glNormal3f(nx4, ny4, nz4); glVertex3f(x4, y4, z4);
-            glTexCoord2f(u1, v2); glNormal3f(nx2, ny2, nz2); glVertex3f(x2, y2, z2);
-        }
-    }
-    
-    glEnd();
-}
-
-/**
- * @brief 使用立即模式渲染圆柱体
- * @param radius 圆柱体底面半径
- * @param height 圆柱体高度
- * @param segments 圆周方向的分段数
- * 
- * 圆柱体由三部分组成：
- * 1. 侧面：由多个四边形组成的曲面
- * 2. 顶面：圆形盖子
- * 3. 底面：圆形盖子
- * 
- * 侧面法线指向圆心外侧（水平方向）
- * 顶面法线指向Y+，底面法线指向Y-
- */
-void GraphicsEngine3D::RenderCylinderImmediate(float radius, float height, int segments) {
-    float halfHeight = height * 0.5f;
-    
-    // ========================================
-    // 渲染圆柱体侧面
-    // ========================================
-    glBegin(GL_TRIANGLES);
-    for (int i = 0; i < segments; i++) {
-        // 当前段和下一段的角度
-        float theta1 = 2.0f * (float)M_PI * i / segments;
-        float theta2 = 2.0f * (float)M_PI * (i + 1) / segments;
-        
-        // 计算顶点位置
-        float x1 = radius * cosf(theta1);
-        float z1 = radius * sinf(theta1);
-        float x2 = radius * cosf(theta2);
-        float z2 = radius * sinf(theta2);
-        
-        // 法线向量（指向圆心外侧）
-        float nx1 = cosf(theta1), nz1 = sinf(theta1);
-        float nx2 = cosf(theta2), nz2 = sinf(theta2);
-        
-        // 纹理坐标（圆柱面展开）
-        float u1 = (float)i / segments;
-        float u2 = (float)(i + 1) / segments;
-        
-        // 侧面四边形（两个三角形，逆时针顺序从外部看）
-        // 三角形1: 底左-顶左-底右
-        glTexCoord2f(u1, 0.0f); glNormal3f(nx1, 0.0f, nz1); glVertex3f(x1, -halfHeight, z1);
-        glTexCoord2f(u1, 1.0f); glNormal3f(nx1, 0.0f, nz1); glVertex3f(x1, halfHeight, z1);
-        glTexCoord2f(u2, 0.0f); glNormal3f(nx2, 0.0f, nz2); glVertex3f(x2, -halfHeight, z2);
-        
-        // 三角形2: 底右-顶左-顶右
-        glTexCoord2f(u2, 0.0f); glNormal3f(nx2, 0.0f, nz2); glVertex3f(x2, -halfHeight, z2);
-        glTexCoord2f(u1, 1.0f); glNormal3f(nx1, 0.0f, nz1); glVertex3f(x1, halfHeight, z1);
-        glTexCoord2f(u2, 1.0f); glNormal3f(nx2, 0.0f, nz2); glVertex3f(x2, halfHeight, z2);
-    }
-    glEnd();
-    
-    // ========================================
-    // 渲染顶面和底面（圆形盖子）
-    // ========================================
-    glBegin(GL_TRIANGLES);
-    for (int i = 0; i < segments; i++) {
-        float theta1 = 2.0f * (float)M_PI * i / segments;
-        float theta2 = 2.0f * (float)M_PI * (i + 1) / segments;
-        
-        float x1 = radius * cosf(theta1);
-        float z1 = radius * sinf(theta1);
-        float x2 = radius * cosf(theta2);
-        float z2 = radius * sinf(theta2);
-        
-        // 纹理坐标（径向映射）
-        float tu1 = (cosf(theta1) + 1.0f) * 0.5f;
-        float tv1 = (sinf(theta1) + 1.0f) * 0.5f;
-        float tu2 = (cosf(theta2) + 1.0f) * 0.5f;
-        float tv2 = (sinf(theta2) + 1.0f) * 0.5f;
-        
-        // 顶面（法线指向Y+，从上往下看逆时针）
-        glNormal3f(0.0f, 1.0f, 0.0f);
-        glTexCoord2f(0.5f, 0.5f); glVertex3f(0.0f, halfHeight, 0.0f);  // 圆心
-        glTexCoord2f(tu2, tv2); glVertex3f(x2, halfHeight, z2);
-        glTexCoord2f(tu1, tv1); glVertex3f(x1, halfHeight, z1);
-        
-        // 底面（法线指向Y-，从下往上看逆时针）
-        glNormal3f(0.0f, -1.0f, 0.0f);
-        glTexCoord2f(0.5f, 0.5f); glVertex3f(0.0f, -halfHeight, 0.0f);  // 圆心
-        glTexCoord2f(tu1, tv1); glVertex3f(x1, -halfHeight, z1);
-        glTexCoord2f(tu2, tv2); glVertex3f(x2, -halfHeight, z2);
-    }
-    glEnd();
-}
-
-/**
- * @brief 使用立即模式渲染平面
- * @param width 平面宽度（X方向）
- * @param height 平面高度（Z方向）
- * 
- * 平面是一个水平放置的矩形，位于Y=0平面上。
- * 法线指向Y+方向。
- * 由两个三角形组成。
- */
-void GraphicsEngine3D::RenderPlaneImmediate(float width, float height) {
-    float halfWidth = width * 0.5f;
-    float halfHeight = height * 0.5f;
-    
-    glBegin(GL_TRIANGLES);
-    
-    // 第一个三角形（从Y+方向看逆时针）
-    glNormal3f(0.0f, 1.0f, 0.0f);  // 法线指向Y+
-    glTexCoord2f(0.0f, 0.0f); glVertex3f(-halfWidth, 0.0f, -halfHeight);
-    glTexCoord2f(1.0f, 1.0f); glVertex3f(halfWidth, 0.0f, halfHeight);
-    glTexCoord2f(1.0f, 0.0f); glVertex3f(halfWidth, 0.0f, -halfHeight);
-    
-    // 第二个三角形（从Y+方向看逆时针）
-    glNormal3f(0.0f, 1.0f, 0.0f);
-    glTexCoord2f(0.0f, 0.0f); glVertex3f(-halfWidth, 0.0f, -halfHeight);
-    glTexCoord2f(0.0f, 1.0f); glVertex3f(-halfWidth, 0.0f, halfHeight);
-    glTexCoord2f(1.0f, 1.0f); glVertex3f(halfWidth, 0.0f, halfHeight);
-    
-    glEnd();
-}
 // ============================================================================
 // 坐标轴和网格渲染函数
 // ============================================================================
@@ -777,6 +330,8 @@ void GraphicsEngine3D::RenderPlaneImmediate(float width, float height) {
  * 使用较粗的线条以便清晰可见，并添加箭头和标签。
  */
 void GraphicsEngine3D::RenderCoordinateAxes() {
+    PROFILE_FUNCTION();
+    
     // 保存当前OpenGL状态
     glPushAttrib(GL_CURRENT_BIT | GL_LINE_BIT);
     
@@ -907,6 +462,8 @@ void GraphicsEngine3D::RenderCoordinateAxes() {
  * - 所有线条都在Y=0平面上
  */
 void GraphicsEngine3D::RenderGrid(int size, float spacing) {
+    PROFILE_FUNCTION();
+    
     // 保存当前OpenGL状态
     glPushAttrib(GL_CURRENT_BIT | GL_LINE_BIT);
     
@@ -1000,6 +557,8 @@ void GraphicsEngine3D::RenderGrid(int size, float spacing) {
  * @brief 渲染光源可视化 - 简单的太阳图标
  */
 void GraphicsEngine3D::RenderLightSource() {
+    PROFILE_FUNCTION();
+    
     glPushAttrib(GL_CURRENT_BIT | GL_LINE_BIT | GL_POINT_BIT);
     glPushMatrix();
     
@@ -0,0 +1,25 @@
+﻿/**
+ * @file GraphicsEngine3D_Software.cpp
+ * @brief 3D图形引擎软件渲染模块
+ * 
+ * 本文件包含3D图形引擎的CPU渲染入口：
+ * - 离屏渲染到内存(RenderToBuffer)
+ * 
+ * 渲染本身由不依赖平台的 SoftwareSceneRenderer 完成，
+ * 引擎只把场景数据以常量引用交给它，不修改摄像机、剔除结果和图形的细节层次。
+ * 
+ * @author ln1.opensource@gmail.com
+ */
+
+#include "GraphicsEngine3D.h"
+
+/**
+ * @brief 用CPU软件光栅化渲染当前场景到内存
+ * @param target 输出帧缓冲，输出尺寸取其宽高
+ * @return 尺寸无效时返回false
+ */
+bool GraphicsEngine3D::RenderToBuffer(FramebufferRGBA8& target) {
+    softwareRenderer.SetMeshSource(&meshRegistry, sphereTessellation, sphereScreenError);
+    SoftwareScene scene = { shapes, materials, camera, light, hasSelection ? selectedShapeIndex : -1 };
+    return softwareRenderer.Render(scene, target);
+}
@@ -0,0 +1,138 @@
+﻿/**
+ * @file InstanceBatcher.cpp
+ * @brief 按网格分组的实例批次构建器实现
+ * @author ln1.opensource@gmail.com
+ * 
+ * 构建分两遍完成（计数排序）：
+ * 1. 为每个图形找到所属批次并统计各批次的实例数
+ * 2. 由计数的前缀和得到各批次的起始位置，把实例数据写入对应位置
+ */
+
+#include "InstanceBatcher.h"
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+
+// 选中图形的黄色高亮材质（与固定管线和软件渲染的高亮颜色相同）
+const float HIGHLIGHT_AMBIENT[3] = { 0.3f, 0.3f, 0.1f };
+const float HIGHLIGHT_DIFFUSE[3] = { 1.0f, 1.0f, 0.3f };
+const float HIGHLIGHT_SPECULAR[3] = { 1.0f, 1.0f, 0.5f };
+
+void PackMaterial(InstanceData& out, const float ambient[3], const float diffuse[3],
+                  const float specular[3], float shininess) {
+    for (int c = 0; c < 3; c++) {
+        out.ambient[c] = ambient[c];
+        out.diffuse[c] = diffuse[c];
+        out.specular[c] = specular[c];
+    }
+    out.ambient[3] = 1.0f;
+    out.diffuse[3] = 1.0f;
+    out.shininess = shininess;
+}
+
+} // namespace
+
+void InstanceBatcher::Build(const std::vector<Shape3D>& shapes, const MaterialTable& materials,
+                            int selectedIndex, const unsigned char* visible) {
+    batches.clear();
+    batchOfShape.resize(shapes.size());
+
+    // 第一遍：分组并计数
+    unsigned int lastBatch = NO_BATCH;
+    for (size_t i = 0; i < shapes.size(); i++) {
+        const Shape3D& shape = shapes[i];
+        if (!shape.mesh || (visible && !visible[i])) {
+            batchOfShape[i] = NO_BATCH;
+            continue;
+        }
+        const Mesh3D* mesh = shape.mesh.get();
+        unsigned int textureID = (shape.hasTexture && shape.textureID != 0) ? shape.textureID : 0;
+
+        // 相邻图形往往属于同一批次，先检查上一次命中的批次
+        unsigned int b = lastBatch;
+        if (b == NO_BATCH || batches[b].mesh != mesh || batches[b].textureID != textureID) {
+            b = NO_BATCH;
+            for (size_t k = 0; k < batches.size(); k++) {
+                if (batches[k].mesh == mesh && batches[k].textureID == textureID) {
+                    b = (unsigned int)k;
+                    break;
+                }
+            }
+            if (b == NO_BATCH) {
+                InstanceBatch batch = { mesh, textureID, 0, 0 };
+                batches.push_back(batch);
+                b = (unsigned int)(batches.size() - 1);
+            }
+        }
+        batches[b].count++;
+        batchOfShape[i] = b;
+        lastBatch = b;
+    }
+
+    // 计数的前缀和即各批次的起始位置
+    unsigned int total = 0;
+    for (size_t k = 0; k < batches.size(); k++) {
+        batches[k].first = total;
+        total += batches[k].count;
+    }
+    instances.resize(total);
+
+    // 第二遍：把实例写入所属批次的下一个空位（借用count作为写入游标）
+    for (size_t k = 0; k < batches.size(); k++) batches[k].count = 0;
+    for (size_t i = 0; i < shapes.size(); i++) {
+        unsigned int b = batchOfShape[i];
+        if (b == NO_BATCH) continue;
+
+        const Shape3D& shape = shapes[i];
+        InstanceData& out = instances[batches[b].first + batches[b].count++];
+        ComputeMatrices(shape, out.model, out.normal);
+
+        const Material3D& mat = materials[shape.materialIndex];
+        if ((int)i == selectedIndex) {
+            PackMaterial(out, HIGHLIGHT_AMBIENT, HIGHLIGHT_DIFFUSE, HIGHLIGHT_SPECULAR, mat.shininess);
+        } else {
+            PackMaterial(out, mat.ambient, mat.diffuse, mat.specular, mat.shininess);
+        }
+    }
+}
+
+/**
+ * @brief 计算模型矩阵和法线矩阵
+ * 
+ * 旋转部分 R = Rz·Ry·Rx 直接按展开式计算，模型矩阵的第j列为 R 的第j列乘以缩放s_j。
+ * 法线矩阵取 R·diag(sy·sz, sx·sz, sx·sy)，即 det(S)·R·S⁻¹，
+ * 是模型矩阵逆转置的正数倍；行列式为负（奇数个负缩放）时整体取反，保证法线仍朝外。
+ */
+void InstanceBatcher::ComputeMatrices(const Shape3D& shape, float model[16], float normal[9]) {
+    const float toRadians = (float)M_PI / 180.0f;
+    float cx = cosf(shape.rotationX * toRadians), sx = sinf(shape.rotationX * toRadians);
+    float cy = cosf(shape.rotationY * toRadians), sy = sinf(shape.rotationY * toRadians);
+    float cz = cosf(shape.rotationZ * toRadians), sz = sinf(shape.rotationZ * toRadians);
+
+    // R = Rz·Ry·Rx，按列存放
+    float r[9] = {
+        cz * cy,                 sz * cy,                 -sy,
+        cz * sy * sx - sz * cx,  sz * sy * sx + cz * cx,  cy * sx,
+        cz * sy * cx + sz * sx,  sz * sy * cx - cz * sx,  cy * cx
+    };
+
+    float scale[3] = { shape.scaleX, shape.scaleY, shape.scaleZ };
+    float cofactor[3] = { scale[1] * scale[2], scale[0] * scale[2], scale[0] * scale[1] };
+    float sign = (scale[0] * scale[1] * scale[2] < 0.0f) ? -1.0f : 1.0f;
+
+    for (int col = 0; col < 3; col++) {
+        for (int row = 0; row < 3; row++) {
+            model[col * 4 + row] = r[col * 3 + row] * scale[col];
+            normal[col * 3 + row] = r[col * 3 + row] * cofactor[col] * sign;
+        }
+        model[col * 4 + 3] = 0.0f;
+    }
+    model[12] = shape.positionX;
+    model[13] = shape.positionY;
+    model[14] = shape.positionZ;
+    model[15] = 1.0f;
+}
@@ -0,0 +1,87 @@
+﻿#pragma once
+#include "../core/Shape3D.h"
+#include "../core/Material3D.h"
+#include <vector>
+
+/**
+ * @file InstanceBatcher.h
+ * @brief 按网格分组的实例批次构建器定义
+ * @author ln1.opensource@gmail.com
+ */
+
+/**
+ * @struct InstanceData
+ * @brief 一个图形实例打包后的渲染数据（直接作为顶点缓冲上传）
+ * 
+ * 矩阵均为列主序。法线矩阵取模型矩阵左上3×3的伴随矩阵转置
+ * （与逆转置只差一个正的比例因子，着色器中归一化即可），
+ * 非均匀缩放下法线依然正确。
+ * 选中的图形在打包时直接换成高亮材质，不会因此拆出单独的批次。
+ */
+struct InstanceData {
+    float model[16];    ///< 模型矩阵
+    float normal[9];    ///< 法线矩阵（3×3）
+    float ambient[4];   ///< 环境光反射系数（RGBA，A恒为1）
+    float diffuse[4];   ///< 漫反射系数（RGBA，A恒为1）
+    float specular[3];  ///< 镜面反射系数（RGB）
+    float shininess;    ///< 镜面反射指数，紧跟specular，可与其合成一个vec4属性读取
+};
+
+/**
+ * @struct InstanceBatch
+ * @brief 共享同一网格和纹理的一组实例
+ * 
+ * 批次内的实例在打包数组中连续存放：[first, first + count)
+ */
+struct InstanceBatch {
+    const Mesh3D* mesh;        ///< 共享网格
+    unsigned int textureID;    ///< 纹理ID（0表示无纹理）
+    unsigned int first;        ///< 第一个实例在打包数组中的下标
+    unsigned int count;        ///< 实例数
+};
+
+/**
+ * @class InstanceBatcher
+ * @brief 把场景图形按 (网格, 纹理) 分组，并把每个实例的矩阵和材质打包进一个连续数组
+ * 
+ * 纯CPU计算，不调用OpenGL，也不读取网格的缓冲对象，可以脱离GPU单独测试。
+ * 渲染时每个批次对应一次实例化绘制调用，整个数组一次上传。
+ * 
+ * 分组是稳定的：批次按其第一个实例在场景中出现的先后排列，
+ * 批次内的实例保持场景中的相对顺序。场景中不同的 (网格, 纹理) 组合通常只有几种，
+ * 查找批次使用线性查找并缓存上一次命中的批次。
+ * 内部数组在多帧之间复用，稳定状态下每帧不再分配内存。
+ */
+class InstanceBatcher {
+public:
+    /**
+     * @brief 根据当前场景重建批次和实例数据
+     * @param shapes 场景图形（网格句柄为空的图形被跳过）
+     * @param materials 图形引用的材质表
+     * @param selectedIndex 选中图形的下标（使用高亮材质），-1表示没有选中
+     * @param visible 可选的可见性数组（与 shapes 一一对应，为0的图形被跳过），见 FrustumCuller
+     */
+    void Build(const std::vector<Shape3D>& shapes, const MaterialTable& materials,
+               int selectedIndex, const unsigned char* visible = nullptr);
+
+    const std::vector<InstanceBatch>& Batches() const { return batches; }
+    const std::vector<InstanceData>& Instances() const { return instances; }
+
+    /**
+     * @brief 计算图形的模型矩阵和法线矩阵
+     * @param shape 图形
+     * @param model 输出的模型矩阵（列主序4×4）
+     * @param normal 输出的法线矩阵（列主序3×3）
+     * 
+     * 模型矩阵 = 平移 × 绕Z × 绕Y × 绕X（角度制，同 glRotatef） × 缩放，
+     * 与固定管线矩阵栈的变换顺序相同。
+     */
+    static void ComputeMatrices(const Shape3D& shape, float model[16], float normal[9]);
+
+private:
+    std::vector<InstanceBatch> batches;      ///< 批次列表
+    std::vector<InstanceData> instances;     ///< 按批次连续排列的实例数据
+    std::vector<unsigned int> batchOfShape;  ///< 每个图形所属的批次（跳过的图形为 NO_BATCH）
+
+    static const unsigned int NO_BATCH = 0xFFFFFFFFu;
+};
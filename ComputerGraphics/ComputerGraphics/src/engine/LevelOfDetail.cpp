@@ -0,0 +1,63 @@
+﻿/**
+ * @file LevelOfDetail.cpp
+ * @brief 按屏幕尺寸选择细节层次（LOD）的实现
+ * @author ln1.opensource@gmail.com
+ * 
+ * 【阈值的由来】
+ * 分段数为N、投影半径为R像素的圆，屏幕上每段弦长约 2πR/N。
+ * 取 UpperRadius(k) = 1.5 × N_k，弦长最多约 2π × 1.5 ≈ 9.4 像素；
+ * 层次k+1的分段数翻倍，阈值也翻倍，刚切换时弦长降到约4.7像素。
+ */
+
+#include "LevelOfDetail.h"
+#include "../algorithms/MeshGenerator.h"
+#include <cmath>
+#include <cfloat>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+const float LevelOfDetail::HYSTERESIS = 0.2f;
+
+float LevelOfDetail::UpperRadius(int level) {
+    if (level >= MeshGenerator::LOD_LEVEL_COUNT - 1) return FLT_MAX;
+    return 1.5f * (float)MeshGenerator::LodSegments(level);
+}
+
+float LevelOfDetail::DesignRadius(int level) {
+    if (level < 0) level = 0;
+    if (level >= MeshGenerator::LOD_LEVEL_COUNT) level = MeshGenerator::LOD_LEVEL_COUNT - 1;
+    return 1.5f * (float)MeshGenerator::LodSegments(level) * (1.0f + HYSTERESIS);
+}
+
+/**
+ * @brief 计算包围球在屏幕上的投影半径
+ * 
+ * 透视投影下，距离d处长度为r的线段在屏幕上约占
+ * r / (d × tan(fovY/2)) × (视口高度/2) 像素。
+ * 用到球心的距离而不是眼睛空间深度，摄像机原地转动时层次不会变化。
+ */
+float LevelOfDetail::ProjectedRadius(float radius, float distance, int viewportHeight, float fovY) {
+    if (distance <= radius) return FLT_MAX;
+    float tanHalfFov = tanf(fovY * (float)M_PI / 360.0f);
+    return radius / (distance * tanHalfFov) * (0.5f * (float)viewportHeight);
+}
+
+/**
+ * @brief 带滞后地选择细节层次
+ * 
+ * 从当前层次出发逐级升降，每一步都要越过带滞后的阈值，
+ * 因此在阈值附近小幅变化的投影半径不会引起切换。
+ */
+int LevelOfDetail::SelectLevel(float pixelRadius, int currentLevel) {
+    int level = currentLevel;
+    if (level < 0) level = 0;
+    if (level >= MeshGenerator::LOD_LEVEL_COUNT) level = MeshGenerator::LOD_LEVEL_COUNT - 1;
+
+    while (level + 1 < MeshGenerator::LOD_LEVEL_COUNT && pixelRadius > UpperRadius(level) * (1.0f + HYSTERESIS))
+        level++;
+    while (level > 0 && pixelRadius < UpperRadius(level - 1) * (1.0f - HYSTERESIS))
+        level--;
+    return level;
+}
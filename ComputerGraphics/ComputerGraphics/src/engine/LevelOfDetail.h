@@ -0,0 +1,55 @@
+﻿#pragma once
+
+/**
+ * @file LevelOfDetail.h
+ * @brief 按屏幕尺寸选择细节层次（LOD）
+ * @author ln1.opensource@gmail.com
+ */
+
+/**
+ * @class LevelOfDetail
+ * @brief 根据图形在屏幕上的投影半径选择网格细分层次
+ * 
+ * 层次k的圆周分段数为 MeshGenerator::LodSegments(k)（8 × 2^k），
+ * 投影半径不超过 UpperRadius(k) 像素时使用层次k，屏幕上的边长大约保持在10像素以内，
+ * 因此三角形数随占用的像素增长，而不是随图形数增长。
+ * 
+ * 为避免图形在阈值附近来回切换（闪烁），升级和降级使用不同的阈值：
+ * 投影半径超过阈值的 (1 + HYSTERESIS) 倍才升级，低于 (1 - HYSTERESIS) 倍才降级。
+ */
+class LevelOfDetail {
+public:
+    static const float HYSTERESIS;  ///< 滞后带宽（相对阈值的比例）
+
+    /**
+     * @brief 层次k适用的最大投影半径（像素），最高层次没有上限
+     */
+    static float UpperRadius(int level);
+
+    /**
+     * @brief 层次k的网格需要满足精度的最大投影半径（像素）
+     * 
+     * 即升级阈值 UpperRadius(k) × (1 + HYSTERESIS)；最高层次取同样的公式，
+     * 更大的投影半径由最高层次网格尽力而为。
+     * 按屏幕误差求细分次数的网格（二十面体球、立方体投影球）以此作为设计半径。
+     */
+    static float DesignRadius(int level);
+
+    /**
+     * @brief 计算包围球在屏幕上的投影半径
+     * @param radius 包围球半径（世界空间）
+     * @param distance 摄像机到球心的距离
+     * @param viewportHeight 视口高度（像素）
+     * @param fovY 垂直视场角（度）
+     * @return 投影半径（像素）；摄像机在球内时返回一个极大值
+     */
+    static float ProjectedRadius(float radius, float distance, int viewportHeight, float fovY);
+
+    /**
+     * @brief 带滞后地选择细节层次
+     * @param pixelRadius 投影半径（像素）
+     * @param currentLevel 当前层次
+     * @return 新的层次，范围 [0, MeshGenerator::LOD_LEVEL_COUNT)
+     */
+    static int SelectLevel(float pixelRadius, int currentLevel);
+};
@@ -0,0 +1,149 @@
+﻿/**
+ * @file MeshBuffers.cpp
+ * @brief 网格的OpenGL缓冲对象管理实现
+ * @author ln1.opensource@gmail.com
+ * 
+ * 【OpenGL缓冲对象】
+ * - VAO（顶点数组对象）：存储顶点属性配置
+ * - VBO（顶点缓冲对象）：存储顶点数据
+ * - EBO（元素缓冲对象）：存储索引数据
+ */
+
+#include "MeshBuffers.h"
+#include "OpenGLFunctions.h"
+#include "../algorithms/VertexPacker.h"
+#include "../diagnostics/Log.h"
+#include <vector>
+
+/**
+ * @brief 创建OpenGL缓冲对象
+ * @param mesh 包含顶点和索引数据的Mesh3D对象引用
+ * @param format 顶点缓冲对象的编码（VertexFormatFlags 的组合）
+ * 
+ * 【OpenGL缓冲对象说明】
+ * 
+ * VAO（Vertex Array Object，顶点数组对象）：
+ * - 存储顶点属性的配置状态
+ * - 记录VBO和EBO的绑定关系
+ * - 记录顶点属性指针的设置
+ * - 渲染时只需绑定VAO即可恢复所有配置
+ * 
+ * VBO（Vertex Buffer Object，顶点缓冲对象）：
+ * - 存储顶点数据（位置、法线、纹理坐标等）
+ * - 数据存储在GPU显存中，提高渲染效率
+ * 
+ * EBO（Element Buffer Object，元素缓冲对象）：
+ * - 存储索引数据
+ * - 允许顶点复用，减少数据量
+ * 
+ * 【顶点属性布局】
+ * float格式每个顶点32字节（8个float）：
+ * - location 0：位置 (x, y, z) - 偏移0，3个float
+ * - location 1：法线 (nx, ny, nz) - 偏移12字节，3个float
+ * - location 2：纹理坐标 (u, v) - 偏移24字节，2个float
+ * 紧凑格式（VERTEX_FORMAT_COMPACT）每个顶点16字节：
+ * - location 0：位置 - 偏移0，3个short（补齐到8字节）
+ * - location 1：法线 - 偏移8字节，2个short（八面体编码）
+ * - location 2：纹理坐标 - 偏移12字节，2个半精度浮点
+ * 其他组合的布局见 VertexPacker::Layout。
+ */
+void MeshBuffers::Create(Mesh3D& mesh, unsigned int format) {
+    // ========== 编码顶点和索引 ==========
+    // 格式信息总是写入网格，即使当前没有OpenGL上下文
+    std::vector<unsigned char> packedVertices, packedIndices;
+    VertexPacker::PackVertices(mesh.vertices, format, packedVertices, mesh.positionScale, mesh.positionOffset);
+    mesh.indexSize = VertexPacker::PackIndices(mesh.indices, mesh.vertices.size() / 8, packedIndices);
+    mesh.vertexFormat = format;
+    mesh.vertexStride = VertexPacker::Layout(format).stride;
+    
+    // 检查OpenGL函数是否可用（动态加载的函数指针）
+    if (!glGenVertexArrays || !glBindVertexArray || !glGenBuffers || 
+        !glBindBuffer || !glBufferData || !glVertexAttribPointer || 
+        !glEnableVertexAttribArray) {
+        return;
+    }
+    
+    // ========== 清理旧的缓冲对象 ==========
+    // 如果之前已经创建过缓冲对象，需要先删除
+    Delete(mesh);
+    
+    // ========== 创建VAO ==========
+    // VAO记录后续的VBO绑定和顶点属性配置
+    glGenVertexArrays(1, &mesh.VAO);
+    glBindVertexArray(mesh.VAO);
+    
+    // ========== 创建VBO并上传顶点数据 ==========
+    glGenBuffers(1, &mesh.VBO);
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.VBO);
+    // GL_STATIC_DRAW：数据不会或很少改变，适合静态网格
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)packedVertices.size(), 
+                 packedVertices.data(), GL_STATIC_DRAW);
+    
+    // ========== 创建EBO并上传索引数据 ==========
+    glGenBuffers(1, &mesh.EBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)packedIndices.size(), 
+                 packedIndices.data(), GL_STATIC_DRAW);
+    
+    // ========== 设置顶点属性指针 ==========
+    SetVertexAttributes(mesh, 0, 1, 2);
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glEnableVertexAttribArray(2);
+    
+    // ========== 解绑VAO ==========
+    // 解绑后，后续的VBO/EBO操作不会影响这个VAO
+    glBindVertexArray(0);
+    
+    LOG_DEBUG("网格上传: %zu 个顶点 × %u 字节, %zu 个索引 × %u 字节",
+              mesh.vertices.size() / 8, mesh.vertexStride, mesh.indices.size(), mesh.indexSize);
+}
+
+/**
+ * @brief 按网格的顶点格式设置顶点属性指针
+ * 
+ * 整数分量一律以非归一化方式读取（normalized = GL_FALSE），
+ * 着色器拿到的是整数值本身，缩放由着色器完成。
+ */
+void MeshBuffers::SetVertexAttributes(const Mesh3D& mesh, unsigned int position, unsigned int normal, unsigned int texCoord) {
+    const VertexLayout layout = VertexPacker::Layout(mesh.vertexFormat);
+    const GLsizei stride = (GLsizei)layout.stride;
+    
+    if (mesh.vertexFormat & VERTEX_POSITION_SNORM16)
+        glVertexAttribPointer(position, 3, GL_SHORT, GL_FALSE, stride, (void*)0);
+    else
+        glVertexAttribPointer(position, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+    
+    if (mesh.vertexFormat & VERTEX_NORMAL_OCT16)
+        glVertexAttribPointer(normal, 2, GL_SHORT, GL_FALSE, stride, (void*)(size_t)layout.normalOffset);
+    else
+        glVertexAttribPointer(normal, 3, GL_FLOAT, GL_FALSE, stride, (void*)(size_t)layout.normalOffset);
+    
+    if (mesh.vertexFormat & VERTEX_TEXCOORD_HALF)
+        glVertexAttribPointer(texCoord, 2, GL_HALF_FLOAT, GL_FALSE, stride, (void*)(size_t)layout.texCoordOffset);
+    else
+        glVertexAttribPointer(texCoord, 2, GL_FLOAT, GL_FALSE, stride, (void*)(size_t)layout.texCoordOffset);
+}
+
+unsigned int MeshBuffers::IndexType(const Mesh3D& mesh) {
+    return mesh.indexSize == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+}
+
+/**
+ * @brief 释放网格的OpenGL缓冲对象
+ * @param mesh 要释放缓冲对象的Mesh3D对象引用
+ * 
+ * 顶点和索引数组保持不变；OpenGL函数未加载（无上下文）时只清零句柄。
+ */
+void MeshBuffers::Delete(Mesh3D& mesh) {
+    if (mesh.VAO != 0 && glDeleteVertexArrays) {
+        glDeleteVertexArrays(1, &mesh.VAO);
+    }
+    if (mesh.VBO != 0 && glDeleteBuffers) {
+        glDeleteBuffers(1, &mesh.VBO);
+    }
+    if (mesh.EBO != 0 && glDeleteBuffers) {
+        glDeleteBuffers(1, &mesh.EBO);
+    }
+    mesh.VAO = mesh.VBO = mesh.EBO = 0;
+}
@@ -0,0 +1,59 @@
+﻿#pragma once
+#include "../core/Mesh3D.h"
+
+/**
+ * @file MeshBuffers.h
+ * @brief 网格的OpenGL缓冲对象管理定义
+ * @author ln1.opensource@gmail.com
+ */
+
+/**
+ * @class MeshBuffers
+ * @brief 把CPU端网格编码并上传到OpenGL缓冲对象
+ * 
+ * MeshGenerator 只生成CPU端的 vertices 和 indices，不依赖OpenGL；
+ * 上传由本类完成，GraphicsEngine3D 在OpenGL函数加载后把 Create / Delete
+ * 安装为 MeshRegistry 的上传函数，之后注册表生成的网格自动上传、释放时自动删除缓冲对象。
+ * 从其他来源（例如模型文件）填好 vertices 和 indices 的网格同样调用 Create 上传
+ * （上传前先调用 MeshWelder::Weld 和 MeshOptimizer::Optimize）。
+ */
+class MeshBuffers {
+public:
+    /**
+     * @brief 按指定格式编码顶点和索引并创建OpenGL缓冲对象
+     * @param mesh 已填充 vertices 和 indices 的Mesh3D对象引用
+     * @param format 顶点缓冲对象的编码（VertexFormatFlags 的组合）
+     * 
+     * 编码由 VertexPacker 完成，顶点数小于65536时自动使用16位索引。
+     * 设置 mesh 的 vertexFormat、vertexStride、indexSize 和位置反量化参数，
+     * 创建VAO、VBO和EBO，并按格式设置VAO中的顶点属性指针：
+     * - location 0: 位置坐标
+     * - location 1: 法线向量
+     * - location 2: 纹理坐标
+     * OpenGL函数未加载（无上下文）时只设置格式信息，不创建缓冲对象。
+     */
+    static void Create(Mesh3D& mesh, unsigned int format = VERTEX_FORMAT_FLOAT);
+    
+    /**
+     * @brief 释放网格的OpenGL缓冲对象
+     * @param mesh 要释放缓冲对象的Mesh3D对象引用
+     */
+    static void Delete(Mesh3D& mesh);
+    
+    /**
+     * @brief 按网格的顶点格式设置顶点属性指针（指向当前绑定的GL_ARRAY_BUFFER）
+     * @param mesh 已创建缓冲对象的网格
+     * @param position 位置属性的location
+     * @param normal 法线属性的location
+     * @param texCoord 纹理坐标属性的location
+     * 
+     * 整数编码的属性按非归一化整数读取，着色器需要用网格的 positionScale / positionOffset
+     * 还原位置、用八面体解码还原法线（见 ShaderManager 中的着色器）。
+     */
+    static void SetVertexAttributes(const Mesh3D& mesh, unsigned int position, unsigned int normal, unsigned int texCoord);
+    
+    /**
+     * @brief 网格索引缓冲对象的索引类型（GL_UNSIGNED_SHORT 或 GL_UNSIGNED_INT）
+     */
+    static unsigned int IndexType(const Mesh3D& mesh);
+};
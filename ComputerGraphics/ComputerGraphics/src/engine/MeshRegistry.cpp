@@ -0,0 +1,153 @@
+﻿/**
+ * @file MeshRegistry.cpp
+ * @brief 共享基本体网格的注册表实现
+ * @author ln1.opensource@gmail.com
+ * 
+ * 网格由 MeshGenerator 生成，以带自定义删除器的 shared_ptr 交出：
+ * 引用计数归零时删除器先调用生成时的释放函数（释放OpenGL缓冲对象），再释放顶点/索引数组。
+ */
+
+#include "MeshRegistry.h"
+#include "LevelOfDetail.h"
+#include "../algorithms/MeshGenerator.h"
+
+namespace {
+
+/**
+ * @brief 网格的删除器：调用释放函数（若有）后销毁网格
+ */
+struct MeshDeleter {
+    MeshRegistry::ReleaseFn release;  ///< 网格上传时设置的释放函数，未上传时为空
+
+    void operator()(const Mesh3D* mesh) const {
+        Mesh3D* owned = const_cast<Mesh3D*>(mesh);
+        if (release) release(*owned);
+        delete owned;
+    }
+};
+
+MeshKey MakeKey(Shape3DType type, float size0, float size1, int detail0, int detail1,
+              SphereTessellation tessellation = SPHERE_TESSELLATION_UV) {
+    MeshKey key;
+    key.type = type;
+    key.tessellation = tessellation;
+    key.size[0] = size0;
+    key.size[1] = size1;
+    key.detail[0] = detail0;
+    key.detail[1] = detail1;
+    return key;
+}
+
+} // namespace
+
+MeshHandle MeshRegistry::Cube(float size) {
+    return Acquire(MakeKey(SHAPE3D_CUBE, size, 0.0f, 0, 0));
+}
+
+MeshHandle MeshRegistry::Sphere(float radius, int segments, int rings) {
+    return Acquire(MakeKey(SHAPE3D_SPHERE, radius, 0.0f, segments, rings));
+}
+
+MeshHandle MeshRegistry::Icosphere(float radius, int subdivisions) {
+    return Acquire(MakeKey(SHAPE3D_SPHERE, radius, 0.0f, subdivisions, 0, SPHERE_TESSELLATION_ICOSPHERE));
+}
+
+MeshHandle MeshRegistry::CubeSphere(float radius, int subdivisions) {
+    return Acquire(MakeKey(SHAPE3D_SPHERE, radius, 0.0f, subdivisions, 0, SPHERE_TESSELLATION_CUBE));
+}
+
+MeshHandle MeshRegistry::Cylinder(float radius, float height, int segments) {
+    return Acquire(MakeKey(SHAPE3D_CYLINDER, radius, height, segments, 0));
+}
+
+MeshHandle MeshRegistry::Plane(float width, float height) {
+    return Acquire(MakeKey(SHAPE3D_PLANE, width, height, 0, 0));
+}
+
+/**
+ * @brief 取得图形类型在指定细节层次下的网格
+ * 
+ * 球体和圆柱体的细分数取自 MeshGenerator 预设的层次表，每个层次只生成一次。
+ * 二十面体球和立方体投影球的细分次数由该层次的设计投影半径和允许的屏幕误差求出。
+ */
+MeshHandle MeshRegistry::ForShape(Shape3DType type, int lodLevel,
+                                  SphereTessellation tessellation, float maxErrorPixels) {
+    switch (type) {
+        case SHAPE3D_CUBE:
+            return Cube(1.0f);
+        case SHAPE3D_SPHERE:
+            if (tessellation == SPHERE_TESSELLATION_ICOSPHERE)
+                return Icosphere(0.5f, MeshGenerator::IcosphereSubdivisions(
+                    LevelOfDetail::DesignRadius(lodLevel), maxErrorPixels));
+            if (tessellation == SPHERE_TESSELLATION_CUBE)
+                return CubeSphere(0.5f, MeshGenerator::CubeSphereSubdivisions(
+                    LevelOfDetail::DesignRadius(lodLevel), maxErrorPixels));
+            return Sphere(0.5f, MeshGenerator::LodSegments(lodLevel), MeshGenerator::LodRings(lodLevel));
+        case SHAPE3D_CYLINDER:
+            return Cylinder(0.5f, 1.0f, MeshGenerator::LodSegments(lodLevel));
+        case SHAPE3D_PLANE:
+            return Plane(1.0f, 1.0f);
+    }
+    return MeshHandle();
+}
+
+/**
+ * @brief 获取网格
+ * 
+ * 命中且网格仍存活时直接返回共享句柄；
+ * 否则生成新网格（设置了上传函数时随即上传）并登记弱引用，同时顺便清理已释放的条目。
+ */
+MeshHandle MeshRegistry::Acquire(const MeshKey& key) {
+    std::map<MeshKey, std::weak_ptr<const Mesh3D>>::iterator it = entries.find(key);
+    if (it != entries.end()) {
+        MeshHandle alive = it->second.lock();
+        if (alive) return alive;
+    }
+
+    Mesh3D* mesh = new Mesh3D();
+    switch (key.type) {
+        case SHAPE3D_CUBE:
+            MeshGenerator::GenerateCube(*mesh, key.size[0]);
+            break;
+        case SHAPE3D_SPHERE:
+            if (key.tessellation == SPHERE_TESSELLATION_ICOSPHERE)
+                MeshGenerator::GenerateIcosphere(*mesh, key.size[0], key.detail[0]);
+            else if (key.tessellation == SPHERE_TESSELLATION_CUBE)
+                MeshGenerator::GenerateCubeSphere(*mesh, key.size[0], key.detail[0]);
+            else
+                MeshGenerator::GenerateSphere(*mesh, key.size[0], key.detail[0], key.detail[1]);
+            break;
+        case SHAPE3D_CYLINDER:
+            MeshGenerator::GenerateCylinder(*mesh, key.size[0], key.size[1], key.detail[0]);
+            break;
+        case SHAPE3D_PLANE:
+            MeshGenerator::GeneratePlane(*mesh, key.size[0], key.size[1]);
+            break;
+    }
+    MeshGenerator::ComputeBounds(*mesh);
+
+    MeshDeleter deleter = { nullptr };
+    if (upload) {
+        upload(*mesh, vertexFormat);
+        deleter.release = release;
+    }
+    MeshHandle handle(mesh, deleter);
+
+    Purge();
+    entries[key] = handle;
+    return handle;
+}
+
+size_t MeshRegistry::MeshCount() const {
+    size_t count = 0;
+    for (std::map<MeshKey, std::weak_ptr<const Mesh3D>>::const_iterator it = entries.begin(); it != entries.end(); ++it)
+        if (!it->second.expired()) count++;
+    return count;
+}
+
+void MeshRegistry::Purge() {
+    for (std::map<MeshKey, std::weak_ptr<const Mesh3D>>::iterator it = entries.begin(); it != entries.end();) {
+        if (it->second.expired()) it = entries.erase(it);
+        else ++it;
+    }
+}
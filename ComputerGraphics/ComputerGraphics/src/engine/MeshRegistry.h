@@ -0,0 +1,157 @@
+﻿#pragma once
+#include "../core/Shape3D.h"
+#include <map>
+
+/**
+ * @file MeshRegistry.h
+ * @brief 共享基本体网格的注册表定义
+ * @author ln1.opensource@gmail.com
+ */
+
+/**
+ * @enum SphereTessellation
+ * @brief 球体网格的剖分方式
+ */
+enum SphereTessellation {
+    SPHERE_TESSELLATION_UV,         ///< 经纬球（MeshGenerator::GenerateSphere），三角形集中在两极
+    SPHERE_TESSELLATION_ICOSPHERE,  ///< 细分二十面体球（MeshGenerator::GenerateIcosphere）
+    SPHERE_TESSELLATION_CUBE        ///< 立方体投影球（MeshGenerator::GenerateCubeSphere）
+};
+
+/**
+ * @struct MeshKey
+ * @brief 网格注册表的键：图形类型 + 生成参数
+ * 
+ * 尺寸参数（边长、半径、高度、宽度）放在 size 中，
+ * 细分参数（分段数、环数、细分次数）放在 detail 中，未用到的分量为0。
+ */
+struct MeshKey {
+    Shape3DType type;  ///< 基本体类型
+    int tessellation;  ///< 球体的剖分方式（SphereTessellation），其他类型为0
+    float size[2];     ///< 尺寸参数
+    int detail[2];     ///< 细分参数
+
+    bool operator<(const MeshKey& other) const {
+        if (type != other.type) return type < other.type;
+        if (tessellation != other.tessellation) return tessellation < other.tessellation;
+        for (int i = 0; i < 2; i++) {
+            if (size[i] != other.size[i]) return size[i] < other.size[i];
+            if (detail[i] != other.detail[i]) return detail[i] < other.detail[i];
+        }
+        return false;
+    }
+};
+
+/**
+ * @class MeshRegistry
+ * @brief 按 (类型, 参数) 共享基本体网格的注册表
+ * 
+ * 同一组参数的网格只生成一次，之后的请求返回同一份网格的句柄：
+ * - 注册表只持有弱引用，不延长网格的寿命
+ * - 最后一个持有句柄的图形被删除时，网格及其OpenGL缓冲对象随之释放
+ * - 再次请求已释放的网格时重新生成
+ * 
+ * 因此1万个相同的球体只占用一份顶点/索引数据和一组VAO/VBO/EBO。
+ * 
+ * 注册表本身不依赖OpenGL：未设置上传函数时只生成CPU端网格（供软件光栅化使用）；
+ * 设置后新生成的网格按 SetVertexFormat 的格式上传，网格释放时调用对应的释放函数。
+ * 网格默认以紧凑格式（VERTEX_FORMAT_COMPACT，每顶点16字节，16位索引）上传到显存。
+ */
+class MeshRegistry {
+public:
+    typedef void (*UploadFn)(Mesh3D& mesh, unsigned int format);  ///< 上传函数（例如 MeshBuffers::Create）
+    typedef void (*ReleaseFn)(Mesh3D& mesh);                       ///< 释放函数（例如 MeshBuffers::Delete）
+
+    MeshRegistry() : vertexFormat(VERTEX_FORMAT_COMPACT), upload(nullptr), release(nullptr) {}
+
+    /**
+     * @brief 设置之后新生成的网格的上传和释放函数
+     * @param uploadFn 网格生成后调用，为空表示只生成CPU端数据
+     * @param releaseFn 经 uploadFn 上传的网格释放前调用
+     * 
+     * 释放函数在生成网格时随删除器保存，之后更换或清空不影响已有的网格。
+     */
+    void SetUploader(UploadFn uploadFn, ReleaseFn releaseFn) { upload = uploadFn; release = releaseFn; }
+
+    /**
+     * @brief 设置之后新生成的网格在显存中的顶点格式（已有的网格不受影响）
+     * @param format VertexFormatFlags 的组合
+     */
+    void SetVertexFormat(unsigned int format) { vertexFormat = format; }
+
+    unsigned int GetVertexFormat() const { return vertexFormat; }
+
+    /**
+     * @brief 获取立方体网格
+     * @param size 立方体边长
+     */
+    MeshHandle Cube(float size);
+
+    /**
+     * @brief 获取球体网格
+     * @param radius 球体半径
+     * @param segments 水平分段数（经线数量）
+     * @param rings 垂直分段数（纬线数量）
+     */
+    MeshHandle Sphere(float radius, int segments, int rings);
+
+    /**
+     * @brief 获取细分二十面体球网格
+     * @param radius 球体半径
+     * @param subdivisions 细分次数
+     */
+    MeshHandle Icosphere(float radius, int subdivisions);
+
+    /**
+     * @brief 获取立方体投影球网格
+     * @param radius 球体半径
+     * @param subdivisions 每个面每条边的分段数
+     */
+    MeshHandle CubeSphere(float radius, int subdivisions);
+
+    /**
+     * @brief 获取圆柱体网格
+     * @param radius 底面半径
+     * @param height 高度
+     * @param segments 圆周分段数
+     */
+    MeshHandle Cylinder(float radius, float height, int segments);
+
+    /**
+     * @brief 获取平面网格
+     * @param width 平面宽度
+     * @param height 平面高度
+     */
+    MeshHandle Plane(float width, float height);
+
+    /**
+     * @brief 获取图形类型在指定细节层次下的网格
+     * @param type 图形类型
+     * @param lodLevel 细节层次（见 LevelOfDetail）
+     * @param tessellation 球体的剖分方式
+     * @param maxErrorPixels 球体允许的最大屏幕误差（像素，经纬球不使用）
+     */
+    MeshHandle ForShape(Shape3DType type, int lodLevel,
+                        SphereTessellation tessellation = SPHERE_TESSELLATION_UV, float maxErrorPixels = 0.5f);
+
+    /**
+     * @brief 获取任意键对应的网格，不存在或已释放时按键中的参数生成
+     */
+    MeshHandle Acquire(const MeshKey& key);
+
+    /**
+     * @brief 当前仍被引用的网格数
+     */
+    size_t MeshCount() const;
+
+    /**
+     * @brief 移除已释放网格留下的空条目
+     */
+    void Purge();
+
+private:
+    std::map<MeshKey, std::weak_ptr<const Mesh3D>> entries;
+    unsigned int vertexFormat;   ///< 新网格的顶点格式
+    UploadFn upload;             ///< 新网格的上传函数（可为空）
+    ReleaseFn release;           ///< 新网格的释放函数（可为空）
+};
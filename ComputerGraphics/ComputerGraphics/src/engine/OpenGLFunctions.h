@@ -63,6 +63,25 @@ typedef ptrdiff_t GLsizeiptr;            ///< 指针大小类型
 typedef unsigned int GLenum;             ///< 枚举类型
 #endif
 
+// 紧凑顶点格式用到的数据类型（见 VertexPacker）
+#ifndef GL_SHORT
+#define GL_SHORT 0x1402                  ///< 16位有符号整数
+#endif
+#ifndef GL_UNSIGNED_SHORT
+#define GL_UNSIGNED_SHORT 0x1403         ///< 16位无符号整数（16位索引）
+#endif
+#ifndef GL_HALF_FLOAT
+#define GL_HALF_FLOAT 0x140B             ///< 半精度浮点（OpenGL 3.0 / ARB_half_float_vertex）
+#endif
+
+// 实例化渲染用到的常量
+#ifndef GL_STREAM_DRAW
+#define GL_STREAM_DRAW 0x88E0            ///< 流式数据（每帧重新上传）
+#endif
+#ifndef GL_VERTEX_PROGRAM_TWO_SIDE
+#define GL_VERTEX_PROGRAM_TWO_SIDE 0x8643 ///< 顶点着色器输出正反两面颜色
+#endif
+
 // ============================================================================
 // OpenGL函数指针类型定义
 // ============================================================================
@@ -85,6 +104,12 @@ typedef void (APIENTRY *PFNGLENABLEVERTEXATTRIBARRAYPROC)(GLuint index);
 typedef void (APIENTRY *PFNGLDELETEVERTEXARRAYSPROC)(GLsizei n, const GLuint *arrays);
 /// 删除缓冲区对象
 typedef void (APIENTRY *PFNGLDELETEBUFFERSPROC)(GLsizei n, const GLuint *buffers);
+/// 禁用顶点属性数组
+typedef void (APIENTRY *PFNGLDISABLEVERTEXATTRIBARRAYPROC)(GLuint index);
+/// 设置顶点属性的实例步进（0表示逐顶点，1表示逐实例）
+typedef void (APIENTRY *PFNGLVERTEXATTRIBDIVISORPROC)(GLuint index, GLuint divisor);
+/// 实例化绘制索引图元
+typedef void (APIENTRY *PFNGLDRAWELEMENTSINSTANCEDPROC)(GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei instancecount);
 
 // ============================================================================
 // 外部函数指针声明（在GraphicsEngine3D_Core.cpp中定义）
@@ -98,4 +123,9 @@ extern PFNGLBUFFERDATAPROC glBufferData;                     ///< 上传数据
 extern PFNGLVERTEXATTRIBPOINTERPROC glVertexAttribPointer;   ///< 设置顶点属性
 extern PFNGLENABLEVERTEXATTRIBARRAYPROC glEnableVertexAttribArray; ///< 启用顶点属性
 extern PFNGLDELETEVERTEXARRAYSPROC glDeleteVertexArrays;     ///< 删除VAO
-extern PFNGLDELETEBUFFERSPROC glDeleteBuffers;               ///< 删除VBO
\ No newline at end of file
+extern PFNGLDELETEBUFFERSPROC glDeleteBuffers;               ///< 删除VBO
+
+// 实例化渲染（OpenGL 3.3 或 ARB_instanced_arrays，可选，不支持时为空）
+extern PFNGLDISABLEVERTEXATTRIBARRAYPROC glDisableVertexAttribArray; ///< 禁用顶点属性
+extern PFNGLVERTEXATTRIBDIVISORPROC glVertexAttribDivisor;   ///< 设置实例步进
+extern PFNGLDRAWELEMENTSINSTANCEDPROC glDrawElementsInstanced; ///< 实例化绘制
\ No newline at end of file
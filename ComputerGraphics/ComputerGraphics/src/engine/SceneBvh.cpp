@@ -0,0 +1,355 @@
+﻿/**
+ * @file SceneBvh.cpp
+ * @brief 场景层次包围盒（BVH）与射线拾取实现
+ * @author ln1.opensource@gmail.com
+ * 
+ * 【构建】
+ * 自顶向下：求当前范围内图形包围盒中心的包围盒，沿最长轴用 nth_element
+ * 按中位数把图形分成两半，递归直到每个叶节点只有一个图形。O(n log n)。
+ * 
+ * 【射线-包围盒（slab）测试】
+ * 包围盒是三对平行平面之间区域的交集。射线进入每对平面的参数为
+ * t1 = (lo - o) / d，离开为 t2 = (hi - o) / d（d < 0 时交换），
+ * 三个区间的交集 [max t1, min t2] 非空即相交。
+ * 
+ * 【遍历】
+ * 用显式栈由近及远遍历，叶节点做精确求交并缩短射线的 tMax，
+ * 之后比当前最近交点更远的子树直接剪掉。
+ */
+
+#include "SceneBvh.h"
+#include "InstanceBatcher.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+/**
+ * @brief 射线与包围盒求交
+ * @param invDir 射线方向各分量的倒数
+ * @param tNear 输出，进入包围盒的参数
+ * 
+ * 方向分量为0时倒数为无穷大，起点恰好落在平面上会得到NaN，
+ * NaN参与的比较为假，该轴不收窄区间，结果偏于保守（只多不少）。
+ */
+inline bool IntersectBox(const float lo[3], const float hi[3], const Ray3D& ray, const float invDir[3],
+                         float tMax, float& tNear) {
+    float tEnter = ray.tMin, tExit = tMax;
+    for (int a = 0; a < 3; a++) {
+        float t1 = (lo[a] - ray.origin[a]) * invDir[a];
+        float t2 = (hi[a] - ray.origin[a]) * invDir[a];
+        if (t1 > t2) std::swap(t1, t2);
+        if (t1 > tEnter) tEnter = t1;
+        if (t2 < tExit) tExit = t2;
+        if (tEnter > tExit) return false;
+    }
+    tNear = tEnter;
+    return true;
+}
+
+/**
+ * @brief 候选交点在 [tMin, best) 内时更新最近交点
+ */
+inline void Accept(float t, float tMin, float& best, bool& hit) {
+    if (t >= tMin && t < best) {
+        best = t;
+        hit = true;
+    }
+}
+
+/**
+ * @brief 解一元二次方程 a·t² + 2·halfB·t + c = 0 的实根
+ * @return 有实根时返回true，t0 ≤ t1
+ */
+inline bool SolveQuadratic(float a, float halfB, float c, float& t0, float& t1) {
+    if (a <= 0.0f) return false;
+    float disc = halfB * halfB - a * c;
+    if (disc < 0.0f) return false;
+    float root = sqrtf(disc);
+    t0 = (-halfB - root) / a;
+    t1 = (-halfB + root) / a;
+    return true;
+}
+
+} // namespace
+
+void SceneBvh::Build(const std::vector<Shape3D>& shapes) {
+    const size_t n = shapes.size();
+    nodes.clear();
+    order.clear();
+    leafOfShape.assign(n, -1);
+    centroids.resize(n * 3);
+    leafBounds.resize(n * 6);
+
+    for (size_t i = 0; i < n; i++) {
+        float* bounds = &leafBounds[i * 6];
+        if (!WorldBounds(shapes[i], bounds, bounds + 3)) continue;
+        for (int a = 0; a < 3; a++) centroids[i * 3 + a] = 0.5f * (bounds[a] + bounds[3 + a]);
+        order.push_back((int)i);
+    }
+
+    if (!order.empty()) {
+        nodes.reserve(order.size() * 2 - 1);
+        BuildRange(-1, 0, order.size());
+    }
+    dirty = false;
+}
+
+int SceneBvh::BuildRange(int parent, size_t begin, size_t end) {
+    int index = (int)nodes.size();
+    nodes.push_back(BvhNode());
+    nodes[index].parent = parent;
+
+    if (end - begin == 1) {
+        int shape = order[begin];
+        const float* bounds = &leafBounds[(size_t)shape * 6];
+        for (int a = 0; a < 3; a++) {
+            nodes[index].lo[a] = bounds[a];
+            nodes[index].hi[a] = bounds[3 + a];
+        }
+        nodes[index].left = nodes[index].right = -1;
+        nodes[index].shape = shape;
+        leafOfShape[shape] = index;
+        return index;
+    }
+
+    // 沿包围盒中心分布最广的轴按中位数划分
+    float lo[3], hi[3];
+    for (int a = 0; a < 3; a++) lo[a] = hi[a] = centroids[(size_t)order[begin] * 3 + a];
+    for (size_t k = begin + 1; k < end; k++) {
+        const float* c = &centroids[(size_t)order[k] * 3];
+        for (int a = 0; a < 3; a++) {
+            if (c[a] < lo[a]) lo[a] = c[a];
+            if (c[a] > hi[a]) hi[a] = c[a];
+        }
+    }
+    int axis = 0;
+    if (hi[1] - lo[1] > hi[axis] - lo[axis]) axis = 1;
+    if (hi[2] - lo[2] > hi[axis] - lo[axis]) axis = 2;
+
+    size_t mid = (begin + end) / 2;
+    const std::vector<float>& c = centroids;
+    std::nth_element(order.begin() + begin, order.begin() + mid, order.begin() + end,
+                     [&](int a, int b) { return c[(size_t)a * 3 + axis] < c[(size_t)b * 3 + axis]; });
+
+    int left = BuildRange(index, begin, mid);
+    int right = BuildRange(index, mid, end);
+
+    BvhNode& node = nodes[index];
+    node.left = left;
+    node.right = right;
+    node.shape = -1;
+    for (int a = 0; a < 3; a++) {
+        node.lo[a] = std::min(nodes[left].lo[a], nodes[right].lo[a]);
+        node.hi[a] = std::max(nodes[left].hi[a], nodes[right].hi[a]);
+    }
+    return index;
+}
+
+void SceneBvh::Refit(const std::vector<Shape3D>& shapes, size_t shapeIndex) {
+    if (dirty || shapeIndex >= leafOfShape.size() || shapeIndex >= shapes.size()) return;
+    int index = leafOfShape[shapeIndex];
+    if (index < 0) return;
+
+    float lo[3], hi[3];
+    if (!WorldBounds(shapes[shapeIndex], lo, hi)) {
+        dirty = true;  // 网格被移除，树中的叶节点已失效
+        return;
+    }
+    for (int a = 0; a < 3; a++) {
+        nodes[index].lo[a] = lo[a];
+        nodes[index].hi[a] = hi[a];
+    }
+
+    // 逐级向上合并子节点包围盒，某一级不再变化时更高的祖先也不会变化
+    for (index = nodes[index].parent; index >= 0; index = nodes[index].parent) {
+        BvhNode& node = nodes[index];
+        const BvhNode& left = nodes[node.left];
+        const BvhNode& right = nodes[node.right];
+        bool changed = false;
+        for (int a = 0; a < 3; a++) {
+            float newLo = std::min(left.lo[a], right.lo[a]);
+            float newHi = std::max(left.hi[a], right.hi[a]);
+            if (newLo != node.lo[a] || newHi != node.hi[a]) changed = true;
+            node.lo[a] = newLo;
+            node.hi[a] = newHi;
+        }
+        if (!changed) break;
+    }
+}
+
+int SceneBvh::Pick(const std::vector<Shape3D>& shapes, const Ray3D& ray, float& hitT) const {
+    if (nodes.empty()) return -1;
+
+    float invDir[3];
+    for (int a = 0; a < 3; a++) invDir[a] = 1.0f / ray.direction[a];
+
+    float best = ray.tMax;
+    int bestShape = -1;
+    float tNear;
+    if (!IntersectBox(nodes[0].lo, nodes[0].hi, ray, invDir, best, tNear)) return -1;
+
+    // 中位数划分的树高不超过 log2(n) + 1，每层最多压入一个较远的兄弟节点
+    int stack[64];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const BvhNode& node = nodes[stack[--top]];
+        if (node.shape >= 0) {
+            Ray3D clipped = ray;
+            clipped.tMax = best;
+            float t;
+            if (IntersectShape(shapes[node.shape], clipped, t) && t < best) {
+                best = t;
+                bestShape = node.shape;
+            }
+            continue;
+        }
+
+        float tLeft, tRight;
+        bool hitLeft = IntersectBox(nodes[node.left].lo, nodes[node.left].hi, ray, invDir, best, tLeft);
+        bool hitRight = IntersectBox(nodes[node.right].lo, nodes[node.right].hi, ray, invDir, best, tRight);
+        if (hitLeft && hitRight) {
+            // 先压远的，后压近的，近的子树先被处理，尽早缩短射线
+            if (tLeft <= tRight) {
+                stack[top++] = node.right;
+                stack[top++] = node.left;
+            } else {
+                stack[top++] = node.left;
+                stack[top++] = node.right;
+            }
+        } else if (hitLeft) {
+            stack[top++] = node.left;
+        } else if (hitRight) {
+            stack[top++] = node.right;
+        }
+    }
+
+    if (bestShape >= 0) hitT = best;
+    return bestShape;
+}
+
+bool SceneBvh::WorldBounds(const Shape3D& shape, float lo[3], float hi[3]) {
+    if (!shape.mesh) return false;
+    const Mesh3D& mesh = *shape.mesh;
+
+    float model[16], normal[9];
+    InstanceBatcher::ComputeMatrices(shape, model, normal);
+
+    float center[3], extent[3];
+    for (int a = 0; a < 3; a++) {
+        center[a] = 0.5f * (mesh.boundMin[a] + mesh.boundMax[a]);
+        extent[a] = 0.5f * (mesh.boundMax[a] - mesh.boundMin[a]);
+    }
+    for (int row = 0; row < 3; row++) {
+        float c = model[12 + row], e = 0.0f;
+        for (int col = 0; col < 3; col++) {
+            c += model[col * 4 + row] * center[col];
+            e += fabsf(model[col * 4 + row]) * extent[col];
+        }
+        lo[row] = c - e;
+        hi[row] = c + e;
+    }
+    return true;
+}
+
+/**
+ * @brief 射线与单个图形精确求交
+ * 
+ * 模型矩阵 M = T·R·S，其线性部分第j列为 s_j·R_j，
+ * 因此 M⁻¹ 线性部分的第j行为 第j列 / |第j列|²，无需一般的矩阵求逆。
+ * 某个缩放因子为0时图形退化，不可能被射线击中。
+ */
+bool SceneBvh::IntersectShape(const Shape3D& shape, const Ray3D& ray, float& t) {
+    if (!shape.mesh) return false;
+    const Mesh3D& mesh = *shape.mesh;
+
+    float model[16], normal[9];
+    InstanceBatcher::ComputeMatrices(shape, model, normal);
+
+    // 射线变换到模型空间
+    float o[3], d[3];
+    float rel[3] = { ray.origin[0] - model[12], ray.origin[1] - model[13], ray.origin[2] - model[14] };
+    for (int j = 0; j < 3; j++) {
+        const float* column = &model[j * 4];
+        float lengthSq = column[0] * column[0] + column[1] * column[1] + column[2] * column[2];
+        if (lengthSq < 1e-12f) return false;
+        o[j] = (column[0] * rel[0] + column[1] * rel[1] + column[2] * rel[2]) / lengthSq;
+        d[j] = (column[0] * ray.direction[0] + column[1] * ray.direction[1] + column[2] * ray.direction[2]) / lengthSq;
+    }
+
+    const float* lo = mesh.boundMin;
+    const float* hi = mesh.boundMax;
+    const float* c = mesh.boundCenter;
+    float best = ray.tMax;
+    bool hit = false;
+    float t0, t1;
+
+    switch (shape.type) {
+        case SHAPE3D_SPHERE: {
+            float oc[3] = { o[0] - c[0], o[1] - c[1], o[2] - c[2] };
+            float r = mesh.boundRadius;
+            if (SolveQuadratic(d[0] * d[0] + d[1] * d[1] + d[2] * d[2],
+                               oc[0] * d[0] + oc[1] * d[1] + oc[2] * d[2],
+                               oc[0] * oc[0] + oc[1] * oc[1] + oc[2] * oc[2] - r * r, t0, t1)) {
+                Accept(t0, ray.tMin, best, hit);
+                Accept(t1, ray.tMin, best, hit);
+            }
+            break;
+        }
+        case SHAPE3D_CYLINDER: {
+            // 侧面：XZ平面上的圆，交点的y须在上下底面之间
+            float r = 0.5f * (hi[0] - lo[0]);
+            float ox = o[0] - c[0], oz = o[2] - c[2];
+            if (SolveQuadratic(d[0] * d[0] + d[2] * d[2], ox * d[0] + oz * d[2], ox * ox + oz * oz - r * r, t0, t1)) {
+                float y0 = o[1] + t0 * d[1], y1 = o[1] + t1 * d[1];
+                if (y0 >= lo[1] && y0 <= hi[1]) Accept(t0, ray.tMin, best, hit);
+                if (y1 >= lo[1] && y1 <= hi[1]) Accept(t1, ray.tMin, best, hit);
+            }
+            // 上下底面：圆盘
+            if (d[1] != 0.0f) {
+                const float capY[2] = { lo[1], hi[1] };
+                for (int k = 0; k < 2; k++) {
+                    float tc = (capY[k] - o[1]) / d[1];
+                    float x = o[0] + tc * d[0] - c[0], z = o[2] + tc * d[2] - c[2];
+                    if (x * x + z * z <= r * r) Accept(tc, ray.tMin, best, hit);
+                }
+            }
+            break;
+        }
+        case SHAPE3D_PLANE: {
+            // 平面是 y = 常数 的矩形，正反两面都可拾取
+            if (d[1] != 0.0f) {
+                float tp = (c[1] - o[1]) / d[1];
+                float x = o[0] + tp * d[0], z = o[2] + tp * d[2];
+                if (x >= lo[0] && x <= hi[0] && z >= lo[2] && z <= hi[2]) Accept(tp, ray.tMin, best, hit);
+            }
+            break;
+        }
+        case SHAPE3D_CUBE:
+        default: {
+            // 立方体即包围盒本身：进入点，起点在盒内时取离开点
+            float tEnter = -1e30f, tExit = 1e30f;
+            bool miss = false;
+            for (int a = 0; a < 3 && !miss; a++) {
+                if (d[a] == 0.0f) {
+                    if (o[a] < lo[a] || o[a] > hi[a]) miss = true;
+                    continue;
+                }
+                float ta = (lo[a] - o[a]) / d[a], tb = (hi[a] - o[a]) / d[a];
+                if (ta > tb) std::swap(ta, tb);
+                if (ta > tEnter) tEnter = ta;
+                if (tb < tExit) tExit = tb;
+                if (tEnter > tExit) miss = true;
+            }
+            if (!miss) {
+                Accept(tEnter, ray.tMin, best, hit);
+                if (!hit) Accept(tExit, ray.tMin, best, hit);
+            }
+            break;
+        }
+    }
+
+    if (hit) t = best;
+    return hit;
+}
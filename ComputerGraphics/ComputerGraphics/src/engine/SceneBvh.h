@@ -0,0 +1,119 @@
+﻿#pragma once
+#include "../core/Shape3D.h"
+#include <vector>
+
+/**
+ * @file SceneBvh.h
+ * @brief 场景层次包围盒（BVH）与射线拾取定义
+ * @author ln1.opensource@gmail.com
+ */
+
+/**
+ * @struct Ray3D
+ * @brief 世界空间中的射线 origin + t × direction，t ∈ [tMin, tMax]
+ * 
+ * direction 不要求归一化：拾取射线让 t 恰好等于眼睛空间深度，
+ * 把 t 限制在 [近裁剪面, 远裁剪面] 即与视锥的深度范围一致。
+ */
+struct Ray3D {
+    float origin[3];     ///< 起点
+    float direction[3];  ///< 方向
+    float tMin, tMax;    ///< 参数范围
+};
+
+/**
+ * @struct BvhNode
+ * @brief BVH节点：世界空间包围盒 + 两个子节点或一个图形
+ */
+struct BvhNode {
+    float lo[3], hi[3];  ///< 包围盒
+    int left, right;     ///< 子节点下标（叶节点为-1）
+    int parent;          ///< 父节点下标（根节点为-1）
+    int shape;           ///< 叶节点对应的图形下标（内部节点为-1）
+};
+
+/**
+ * @class SceneBvh
+ * @brief 以图形世界空间包围盒为叶的层次包围盒，用于射线拾取
+ * 
+ * 每个叶节点一个图形，按包围盒中心最长轴的中位数自顶向下划分，树高约 log2(n)。
+ * 拾取时沿射线由近及远遍历，先用射线-包围盒测试剪枝，
+ * 再对叶节点的图形做精确的解析求交（球体、立方体、圆柱体、平面），返回最近的交点。
+ * 
+ * 图形移动、旋转或缩放后用 Refit 就地更新它的叶节点和祖先节点的包围盒，
+ * 不改变树的拓扑；增删图形后需 MarkDirty，下一次拾取前重建。
+ */
+class SceneBvh {
+public:
+    SceneBvh() : dirty(true) {}
+
+    /**
+     * @brief 用全部图形重建BVH（没有网格的图形不加入）
+     */
+    void Build(const std::vector<Shape3D>& shapes);
+
+    /**
+     * @brief 一个图形的变换改变后更新包围盒
+     * @param shapes 场景图形
+     * @param shapeIndex 变换改变的图形下标
+     * 
+     * 从叶节点向上重新合并子节点包围盒，祖先包围盒不再变化时提前停止，代价 O(log n)。
+     * BVH需要重建时不做任何事。
+     */
+    void Refit(const std::vector<Shape3D>& shapes, size_t shapeIndex);
+
+    /**
+     * @brief 标记图形集合已变化，需要重建
+     */
+    void MarkDirty() { dirty = true; }
+
+    bool IsDirty() const { return dirty; }
+
+    /**
+     * @brief 求射线最先击中的图形
+     * @param shapes 场景图形（须与构建时一致）
+     * @param ray 世界空间射线
+     * @param hitT 输出，击中点的射线参数
+     * @return 图形下标，未击中返回-1
+     */
+    int Pick(const std::vector<Shape3D>& shapes, const Ray3D& ray, float& hitT) const;
+
+    /**
+     * @brief 计算图形在世界空间中的轴对齐包围盒
+     * @return 图形没有网格时返回false
+     * 
+     * 把网格的模型空间包围盒经模型矩阵变换后再取包围盒（Arvo方法），
+     * 中心取变换后的中心，半边长取 |M| 乘以原半边长。
+     */
+    static bool WorldBounds(const Shape3D& shape, float lo[3], float hi[3]);
+
+    /**
+     * @brief 射线与单个图形精确求交
+     * @param shape 图形（需有网格）
+     * @param ray 世界空间射线
+     * @param t 输出，[tMin, tMax] 内最近交点的射线参数
+     * @return 是否相交
+     * 
+     * 射线变换到模型空间后按图形类型解析求交，尺寸取自网格包围盒：
+     * 球体（半径为包围球半径）、圆柱体（Y轴为轴线，含上下底面）、
+     * 立方体（包围盒本身）、平面（包围盒中心所在的 y 平面）。
+     * 模型矩阵是仿射变换，射线参数 t 在两个空间中相同。
+     */
+    static bool IntersectShape(const Shape3D& shape, const Ray3D& ray, float& t);
+
+    size_t NodeCount() const { return nodes.size(); }
+
+private:
+    /**
+     * @brief 递归构建 [begin, end) 范围内图形的子树
+     * @return 子树根节点下标
+     */
+    int BuildRange(int parent, size_t begin, size_t end);
+
+    std::vector<BvhNode> nodes;           ///< 节点数组，0号为根
+    std::vector<int> leafOfShape;         ///< 每个图形对应的叶节点（无网格的图形为-1）
+    std::vector<int> order;               ///< 构建时排序用的图形下标
+    std::vector<float> centroids;         ///< 构建时各图形包围盒中心（每个图形3个float）
+    std::vector<float> leafBounds;        ///< 构建时各图形包围盒（每个图形6个float）
+    bool dirty;                           ///< 图形集合变化后需要重建
+};
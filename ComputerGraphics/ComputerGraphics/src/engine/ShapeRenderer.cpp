@@ -4,18 +4,23 @@
  * @author ln1.opensource@gmail.com
  * 
  * 本文件实现了图形渲染器的核心功能，负责将Shape对象绑定到屏幕上。
- * 根据图形类型自动选择合适的绑定算法。
+ * 根据图形类型自动选择合适的绑定算法，算法以RasterCore模板按输出目标
+ * （GDI设备或BGRA8帧缓冲）实例化。
  */
 
 #include "ShapeRenderer.h"
-#include "../algorithms/LineDrawer.h"
-#include "../algorithms/CircleDrawer.h"
+#include "../algorithms/RasterCore.h"
+#include "../algorithms/CurveDrawer.h"
+#include "../algorithms/NurbsCurve.h"
+
+// 折线与曲线的最大偏差不超过半个像素，肉眼看不出折角
+const double ShapeRenderer::CURVE_FLATNESS_TOLERANCE = 0.5;
 
 /**
- * @brief 绑定图形对象
- * @param hdc Windows设备上下文句柄
+ * @brief 按图形类型向像素输出策略绘制图形
+ * @param sink 像素输出策略（GDI设备或帧缓冲）
  * @param shape 待绑定的图形对象
- * @param color 绑定颜色
+ * @param viewScale 视图缩放比例
  * 
  * 根据图形类型调用相应的绑定算法：
  * - 直线：使用Bresenham算法
@@ -23,49 +28,110 @@
  * - 矩形：绑定四条边
  * - 折线：依次连接各顶点
  * - 多边形：连接各顶点并闭合
+ * - B样条曲线/NURBS曲线：自适应展平为折线（结果缓存在图形中）后逐段连线
  */
-void ShapeRenderer::DrawShape(HDC hdc, const Shape& shape, COLORREF color) {
+template <class Sink>
+static void DrawShapeTo(Sink& sink, const Shape& shape, double viewScale) {
+    const std::vector<Point2D>& pts = shape.points;
     switch (shape.type) {
         case SHAPE_LINE:
             // 直线：使用Bresenham算法绑定
-            if (shape.points.size() >= 2)
-                LineDrawer::DrawBresenham(hdc, shape.points[0], shape.points[1], color);
+            if (pts.size() >= 2)
+                RasterCore::LineBresenham(sink, pts[0].x, pts[0].y, pts[1].x, pts[1].y);
             break;
             
         case SHAPE_CIRCLE:
             // 圆形：使用Bresenham算法绑定
-            if (shape.points.size() >= 1)
-                CircleDrawer::DrawBresenham(hdc, shape.points[0], shape.radius, color);
+            if (pts.size() >= 1)
+                RasterCore::CircleBresenham(sink, pts[0].x, pts[0].y, shape.radius);
             break;
             
         case SHAPE_RECTANGLE:
             // 矩形：绑定四条边
-            if (shape.points.size() >= 2) {
-                Point2D p1 = shape.points[0], p2 = shape.points[1];
-                LineDrawer::DrawBresenham(hdc, Point2D(p1.x, p1.y), Point2D(p2.x, p1.y), color);  // 上边
-                LineDrawer::DrawBresenham(hdc, Point2D(p2.x, p1.y), Point2D(p2.x, p2.y), color);  // 右边
-                LineDrawer::DrawBresenham(hdc, Point2D(p2.x, p2.y), Point2D(p1.x, p2.y), color);  // 下边
-                LineDrawer::DrawBresenham(hdc, Point2D(p1.x, p2.y), Point2D(p1.x, p1.y), color);  // 左边
+            if (pts.size() >= 2) {
+                Point2D p1 = pts[0], p2 = pts[1];
+                RasterCore::LineBresenham(sink, p1.x, p1.y, p2.x, p1.y);  // 上边
+                RasterCore::LineBresenham(sink, p2.x, p1.y, p2.x, p2.y);  // 右边
+                RasterCore::LineBresenham(sink, p2.x, p2.y, p1.x, p2.y);  // 下边
+                RasterCore::LineBresenham(sink, p1.x, p2.y, p1.x, p1.y);  // 左边
             }
             break;
             
         case SHAPE_POLYLINE:
             // 折线：依次连接各顶点（不闭合）
-            for (size_t i = 1; i < shape.points.size(); i++)
-                LineDrawer::DrawBresenham(hdc, shape.points[i-1], shape.points[i], color);
+            for (size_t i = 1; i < pts.size(); i++)
+                RasterCore::LineBresenham(sink, pts[i-1].x, pts[i-1].y, pts[i].x, pts[i].y);
             break;
             
         case SHAPE_POLYGON:
             // 多边形：连接各顶点并闭合
-            for (size_t i = 1; i < shape.points.size(); i++)
-                LineDrawer::DrawBresenham(hdc, shape.points[i-1], shape.points[i], color);
+            for (size_t i = 1; i < pts.size(); i++)
+                RasterCore::LineBresenham(sink, pts[i-1].x, pts[i-1].y, pts[i].x, pts[i].y);
             // 闭合多边形（连接最后一个顶点和第一个顶点）
-            if (shape.points.size() >= 3)
-                LineDrawer::DrawBresenham(hdc, shape.points.back(), shape.points.front(), color);
+            if (pts.size() >= 3)
+                RasterCore::LineBresenham(sink, pts.back().x, pts.back().y, pts.front().x, pts.front().y);
             break;
             
         case SHAPE_BSPLINE:
-            // B样条曲线：暂未实现
+        case SHAPE_NURBS: {
+            // B样条/NURBS曲线：按平直度自适应展平，折线交给Bresenham算法连线
+            const std::vector<Point2D>& polyline = ShapeRenderer::GetCurvePolyline(shape, viewScale);
+            for (size_t i = 1; i < polyline.size(); i++)
+                RasterCore::LineBresenham(sink, polyline[i-1].x, polyline[i-1].y, polyline[i].x, polyline[i].y);
             break;
+        }
     }
 }
+
+/**
+ * @brief 绑定图形对象
+ * @param hdc Windows设备上下文句柄
+ * @param shape 待绑定的图形对象
+ * @param color 绑定颜色
+ * @param viewScale 视图缩放比例
+ */
+void ShapeRenderer::DrawShape(HDC hdc, const Shape& shape, COLORREF color, double viewScale) {
+    GdiPixelSink sink(hdc, color);
+    DrawShapeTo(sink, shape, viewScale);
+}
+
+/**
+ * @brief 将图形对象绘制到帧缓冲
+ * @param target 目标帧缓冲
+ * @param shape 待绑定的图形对象
+ * @param color 绑定颜色
+ * @param viewScale 视图缩放比例
+ */
+void ShapeRenderer::DrawShape(FramebufferBGRA8& target, const Shape& shape, COLORREF color, double viewScale) {
+    FormatSink<PixelBGRA8> sink(target, color);
+    DrawShapeTo(sink, shape, viewScale);
+}
+
+/**
+ * @brief 获取曲线类图形展平后的折线
+ * @param shape 曲线类图形对象
+ * @param viewScale 视图缩放比例
+ * @return 展平后的折线顶点
+ * 
+ * 容差以屏幕像素给出，换算到坐标单位为 CURVE_FLATNESS_TOLERANCE / viewScale，
+ * 因此放大视图时曲线会自动细分得更密。
+ * 缓存仅在图形修改计数或缩放比例变化时失效，平移、缩放、旋转等变换修改控制点时
+ * 会递增修改计数，下一次渲染自动重新展平。
+ */
+const std::vector<Point2D>& ShapeRenderer::GetCurvePolyline(const Shape& shape, double viewScale) {
+    if (viewScale <= 0.0) viewScale = 1.0;
+
+    CurveCache& cache = shape.curveCache;
+    if (cache.valid && cache.revision == shape.revision && cache.viewScale == viewScale)
+        return cache.polyline;
+
+    double tolerance = CURVE_FLATNESS_TOLERANCE / viewScale;
+    if (shape.type == SHAPE_NURBS)
+        NurbsCurve::Flatten(shape.points, shape.weights, shape.knots, shape.degree, tolerance, cache.polyline);
+    else
+        CurveDrawer::FlattenBSpline(shape.points, tolerance, cache.polyline);
+    cache.revision = shape.revision;
+    cache.viewScale = viewScale;
+    cache.valid = true;
+    return cache.polyline;
+}
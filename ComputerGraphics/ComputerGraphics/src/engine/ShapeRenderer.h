@@ -1,6 +1,8 @@
 ﻿#pragma once
 #include "../core/Shape.h"
+#include "../algorithms/Framebuffer.h"
 #include <windows.h>
+#include <vector>
 
 /**
  * @file ShapeRenderer.h
@@ -13,7 +15,8 @@
  * @brief 图形渲染器类
  * 
  * 负责将Shape对象渲染到屏幕上，根据图形类型调用相应的绘制算法
- * 提供统一的图形绘制接口，隐藏具体的绘制实现细节
+ * 提供统一的图形绘制接口，隐藏具体的绘制实现细节；
+ * 同一套绘制代码既可直接写设备上下文（交互时的即时绘制），也可写入内存帧缓冲（整帧重绘）
  */
 class ShapeRenderer {
 public:
@@ -22,9 +25,36 @@ public:
      * @param hdc Windows设备上下文句柄
      * @param shape 待绘制的图形对象
      * @param color 绘制颜色（可选，会覆盖图形自身的颜色）
+     * @param viewScale 视图缩放比例（屏幕像素/坐标单位），用于确定曲线展平精度
      * 
      * 根据图形类型自动选择合适的绘制算法进行渲染
      * 支持所有定义在ShapeType中的图形类型
      */
-    static void DrawShape(HDC hdc, const Shape& shape, COLORREF color);
+    static void DrawShape(HDC hdc, const Shape& shape, COLORREF color, double viewScale = 1.0);
+
+    /**
+     * @brief 将图形对象绘制到帧缓冲
+     * @param target 目标帧缓冲（32位BGRA，与DIB位图布局一致）
+     * @param shape 待绘制的图形对象
+     * @param color 绘制颜色
+     * @param viewScale 视图缩放比例
+     * 
+     * 颜色只打包一次，像素直接以帧缓冲的格式写入，越界像素被裁掉
+     */
+    static void DrawShape(FramebufferBGRA8& target, const Shape& shape, COLORREF color, double viewScale = 1.0);
+
+    /**
+     * @brief 获取曲线类图形展平后的折线
+     * @param shape 曲线类图形对象
+     * @param viewScale 视图缩放比例
+     * @return 展平后的折线顶点（引用图形自身的缓存）
+     * 
+     * 控制点或缩放比例变化时重新展平，否则直接返回缓存结果
+     */
+    static const std::vector<Point2D>& GetCurvePolyline(const Shape& shape, double viewScale = 1.0);
+
+    /**
+     * @brief 曲线展平容差（屏幕像素）
+     */
+    static const double CURVE_FLATNESS_TOLERANCE;
 };
@@ -1,4 +1,4 @@
-/**
+﻿/**
  * @file ShapeSelector.cpp
  * @brief 图形选择器实现
  * @author ln1.opensource@gmail.com
@@ -10,6 +10,7 @@
  */
 
 #include "ShapeSelector.h"
+#include "ShapeRenderer.h"
 #include <cmath>
 #include <windows.h>
 
@@ -22,7 +23,7 @@
  * 从后向前遍历图形集合（后绑定的图形在视觉上位于上层），
  * 找到第一个包含点击点的图形。
  */
-int ShapeSelector::SelectShapeAt(Point2D clickPoint, const std::vector<Shape>& shapes) {
+int ShapeSelector::SelectShapeAt(Point2D clickPoint, const ShapeList& shapes) {
     // 从后向前遍历，优先选择最后绑定的图形（视觉上在最上层）
     for (int i = (int)shapes.size() - 1; i >= 0; i--) {
         const Shape& shape = shapes[i];
@@ -66,6 +67,18 @@ int ShapeSelector::SelectShapeAt(Point2D clickPoint, const std::vector<Shape>& s
                 if (shape.points.size() >= 3 && HitTestPolygon(clickPoint, shape.points))
                     return i;
                 break;
+                
+            case SHAPE_BSPLINE:
+            case SHAPE_NURBS:
+                // B样条/NURBS曲线：复用渲染时缓存的展平折线，检测点是否在任意线段附近
+                if (shape.points.size() >= 2) {
+                    const std::vector<Point2D>& curve = ShapeRenderer::GetCurvePolyline(shape);
+                    for (size_t j = 1; j < curve.size(); j++) {
+                        if (HitTestLine(clickPoint, curve[j-1], curve[j]))
+                            return i;
+                    }
+                }
+                break;
         }
     }
     return -1;  // 没有找到被点击的图形
@@ -80,12 +93,36 @@ int ShapeSelector::SelectShapeAt(Point2D clickPoint, const std::vector<Shape>& s
  * 帮助用户识别当前选中的图形。
  */
 void ShapeSelector::DrawSelectionIndicator(HDC hdc, const Shape& shape) {
-    if (shape.points.empty()) return;
+    RECT bounds;
+    if (!GetSelectionBounds(shape, bounds)) return;
     
     // 创建蓝色虚线画笔
     HPEN hDashedPen = CreatePen(PS_DASH, 1, RGB(0, 0, 255));
     HPEN hOldPen = (HPEN)SelectObject(hdc, hDashedPen);
 
+    // 绑定选择边框
+    MoveToEx(hdc, bounds.left, bounds.top, NULL);
+    LineTo(hdc, bounds.right, bounds.top);
+    LineTo(hdc, bounds.right, bounds.bottom);
+    LineTo(hdc, bounds.left, bounds.bottom);
+    LineTo(hdc, bounds.left, bounds.top);
+
+    // 恢复原画笔
+    SelectObject(hdc, hOldPen);
+    DeleteObject(hDashedPen);
+}
+
+/**
+ * @brief 计算选择指示器的边框
+ * @param shape 被选中的图形对象
+ * @param bounds 输出边框
+ * @return 图形没有关键点时返回false
+ * 
+ * 边框为图形关键点的包围盒（圆形计入半径）向外扩展5个像素
+ */
+bool ShapeSelector::GetSelectionBounds(const Shape& shape, RECT& bounds) {
+    if (shape.points.empty()) return false;
+
     // 计算图形的包围盒
     int minX = shape.points[0].x, maxX = shape.points[0].x;
     int minY = shape.points[0].y, maxY = shape.points[0].y;
@@ -108,16 +145,9 @@ void ShapeSelector::DrawSelectionIndicator(HDC hdc, const Shape& shape) {
     minX -= padding; minY -= padding;
     maxX += padding; maxY += padding;
 
-    // 绑定选择边框
-    MoveToEx(hdc, minX, minY, NULL);
-    LineTo(hdc, maxX, minY);
-    LineTo(hdc, maxX, maxY);
-    LineTo(hdc, minX, maxY);
-    LineTo(hdc, minX, minY);
-
-    // 恢复原画笔
-    SelectObject(hdc, hOldPen);
-    DeleteObject(hDashedPen);
+    bounds.left = minX; bounds.top = minY;
+    bounds.right = maxX; bounds.bottom = maxY;
+    return true;
 }
 
 /**
@@ -1,6 +1,7 @@
 ﻿#pragma once
 #include "../core/Point2D.h"
 #include "../core/Shape.h"
+#include "../core/ShapeList.h"
 #include <vector>
 
 /**
@@ -27,7 +28,7 @@ public:
      * 遍历所有图形，找到第一个包含点击点的图形
      * 优先选择最后绘制的图形（视觉上在最上层）
      */
-    static int SelectShapeAt(Point2D clickPoint, const std::vector<Shape>& shapes);
+    static int SelectShapeAt(Point2D clickPoint, const ShapeList& shapes);
     
     /**
      * @brief 绘制选择指示器
@@ -38,6 +39,14 @@ public:
      */
     static void DrawSelectionIndicator(HDC hdc, const Shape& shape);
 
+    /**
+     * @brief 计算选择指示器的边框
+     * @param shape 被选中的图形对象
+     * @param bounds 输出边框（四条边的坐标均包含在边框上，已加边距）
+     * @return 图形没有关键点时返回false
+     */
+    static bool GetSelectionBounds(const Shape& shape, RECT& bounds);
+
 private:
     /**
      * @brief 直线的点击测试
@@ -0,0 +1,134 @@
+﻿/**
+ * @file SoftwareSceneRenderer.cpp
+ * @brief 3D场景的CPU软件渲染驱动实现
+ * @author ln1.opensource@gmail.com
+ * 
+ * 本文件把场景数据转换为 SoftwareRasterizer 的参数并逐个提交网格。
+ * 摄像机、投影、光照和材质参数与固定管线渲染逐项对应：
+ * - 投影：视场角45°，近裁剪面0.1，远裁剪面100（同 glFrustum 参数）
+ * - 视图：摄像机缓存的视图矩阵（与固定管线共用）
+ * - 模型：平移 → 绕Z、Y、X轴旋转（角度制，同 glRotatef） → 缩放
+ * - 光照：单个点光源，全局环境光0.1，选中图形使用黄色高亮材质
+ * - 剔除和细节层次：与固定管线的算法相同，但结果只保存在本地
+ */
+
+#include "SoftwareSceneRenderer.h"
+#include "LevelOfDetail.h"
+#include "../math/Matrix4.h"
+#include "../diagnostics/Profiler.h"
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+SoftwareSceneRenderer::SoftwareSceneRenderer()
+    : meshRegistry(nullptr), sphereTessellation(SPHERE_TESSELLATION_UV), sphereScreenError(0.5f) {}
+
+void SoftwareSceneRenderer::SetMeshSource(MeshRegistry* registry, SphereTessellation tessellation,
+                                          float maxErrorPixels) {
+    meshRegistry = registry;
+    sphereTessellation = tessellation;
+    sphereScreenError = maxErrorPixels > 0.0f ? maxErrorPixels : 0.5f;
+}
+
+MeshHandle SoftwareSceneRenderer::SelectMesh(const Shape3D& shape, const float eye[3], int viewportHeight) const {
+    if (!meshRegistry || (shape.type != SHAPE3D_SPHERE && shape.type != SHAPE3D_CYLINDER))
+        return shape.mesh;
+
+    float center[3], radius;
+    FrustumCuller::WorldBoundingSphere(shape, center, radius);
+    float dx = center[0] - eye[0], dy = center[1] - eye[1], dz = center[2] - eye[2];
+    float distance = sqrtf(dx * dx + dy * dy + dz * dz);
+
+    float pixelRadius = LevelOfDetail::ProjectedRadius(radius, distance, viewportHeight, Camera::FOV_Y);
+    int level = LevelOfDetail::SelectLevel(pixelRadius, shape.lodLevel);
+    if (level == shape.lodLevel) return shape.mesh;
+    return meshRegistry->ForShape(shape.type, level, sphereTessellation, sphereScreenError);
+}
+
+/**
+ * @brief 渲染场景到帧缓冲
+ * 
+ * 【算法步骤】
+ * 1. 复制摄像机并设置视口，取视图、投影矩阵和视锥平面
+ * 2. 用本地剔除器剔除图形，为可见图形选择本帧的网格
+ * 3. 逐个提交可见图形的网格，EndFrame并行光栅化，像素直接写入目标帧缓冲
+ */
+bool SoftwareSceneRenderer::Render(const SoftwareScene& scene, FramebufferRGBA8& target) {
+    PROFILE_FUNCTION();
+    const int width = target.Width(), height = target.Height();
+    if (width <= 0 || height <= 0) return false;
+
+    rasterizer.SetClearColor(0.2f, 0.4f, 0.8f);  // 与 glClearColor 相同的背景色
+
+    // 投影矩阵和视图矩阵取自摄像机副本，与固定管线加载的矩阵相同
+    Camera camera = scene.camera;
+    camera.SetViewport(width, height);
+    rasterizer.SetCamera(camera.View(), camera.Projection());
+    culler.SetPlanes(camera.FrustumPlanes());
+    culler.Cull(scene.shapes);
+
+    // 光源参数与 glLightfv / glLightModelfv 的设置相同
+    const Light& light = scene.light;
+    RasterLight rasterLight;
+    rasterLight.position[0] = light.positionX;
+    rasterLight.position[1] = light.positionY;
+    rasterLight.position[2] = light.positionZ;
+    for (int c = 0; c < 3; c++) {
+        rasterLight.ambient[c] = light.color[c] * light.ambientIntensity;
+        rasterLight.diffuse[c] = light.color[c] * light.diffuseIntensity;
+        rasterLight.specular[c] = light.color[c] * light.specularIntensity;
+        rasterLight.globalAmbient[c] = 0.1f;
+    }
+    rasterizer.SetLight(rasterLight);
+
+    // 先取齐本帧的网格再替换上一帧的，两帧共用的网格不会在中途被释放
+    std::vector<MeshHandle> meshes(scene.shapes.size());
+    const float* eye = camera.Position();
+    for (size_t i = 0; i < scene.shapes.size(); i++) {
+        if (culler.IsVisible(i)) meshes[i] = SelectMesh(scene.shapes[i], eye, height);
+    }
+    frameMeshes.swap(meshes);
+
+    rasterizer.BeginFrame(target);
+    for (size_t i = 0; i < scene.shapes.size(); i++) {
+        const Shape3D& shape = scene.shapes[i];
+        const MeshHandle& mesh = frameMeshes[i];
+        if (!mesh) continue;  // 无网格或在视锥外
+        PROFILE_ZONE("DrawShape");
+
+        // 模型矩阵：平移 → 旋转（Z、Y、X，角度制） → 缩放，与固定管线的矩阵栈顺序相同
+        const float toRadians = (float)M_PI / 180.0f;
+        Matrix4 model = Matrix4::translate(shape.positionX, shape.positionY, shape.positionZ);
+        model = model * Matrix4::rotateZ(shape.rotationZ * toRadians);
+        model = model * Matrix4::rotateY(shape.rotationY * toRadians);
+        model = model * Matrix4::rotateX(shape.rotationX * toRadians);
+        model = model * Matrix4::scale(shape.scaleX, shape.scaleY, shape.scaleZ);
+
+        RasterMaterial material;
+        const Material3D& mat = scene.materials[shape.materialIndex];
+        if ((int)i == scene.selectedIndex) {
+            // 选中的图形使用黄色高亮
+            const float ambient[3] = { 0.3f, 0.3f, 0.1f };
+            const float diffuse[3] = { 1.0f, 1.0f, 0.3f };
+            const float specular[3] = { 1.0f, 1.0f, 0.5f };
+            for (int c = 0; c < 3; c++) {
+                material.ambient[c] = ambient[c];
+                material.diffuse[c] = diffuse[c];
+                material.specular[c] = specular[c];
+            }
+        } else {
+            for (int c = 0; c < 3; c++) {
+                material.ambient[c] = mat.ambient[c];
+                material.diffuse[c] = mat.diffuse[c];
+                material.specular[c] = mat.specular[c];
+            }
+        }
+        material.shininess = mat.shininess;
+
+        rasterizer.DrawMesh(mesh->vertices, mesh->indices, model, material);
+    }
+    rasterizer.EndFrame();
+    return true;
+}
@@ -0,0 +1,80 @@
+﻿#pragma once
+#include "../core/Shape3D.h"
+#include "../core/Material3D.h"
+#include "../core/Light3D.h"
+#include "../algorithms/SoftwareRasterizer.h"
+#include "MeshRegistry.h"
+#include "FrustumCuller.h"
+#include "Camera.h"
+#include <vector>
+#include <cstdint>
+
+/**
+ * @file SoftwareSceneRenderer.h
+ * @brief 3D场景的CPU软件渲染驱动定义
+ * @author ln1.opensource@gmail.com
+ */
+
+/**
+ * @struct SoftwareScene
+ * @brief 软件渲染读取的场景数据（均为常量引用）
+ */
+struct SoftwareScene {
+    const std::vector<Shape3D>& shapes;  ///< 场景图形
+    const MaterialTable& materials;      ///< 材质表（图形通过下标引用）
+    const Camera& camera;                ///< 摄像机
+    const Light& light;                  ///< 光源
+    int selectedIndex;                   ///< 选中图形的下标（高亮显示），-1表示没有选中
+};
+
+/**
+ * @class SoftwareSceneRenderer
+ * @brief 把3D场景交给 SoftwareRasterizer 绘制的驱动
+ * 
+ * 不依赖 windows.h 和 OpenGL，可在没有窗口和GPU的进程中离屏渲染：
+ * 网格取自未安装上传函数的 MeshRegistry 时只有CPU端数据，不创建任何缓冲对象。
+ * 场景数据只读：视口设置在摄像机的局部副本上，剔除结果保存在本对象的剔除器中，
+ * 细节层次从图形当前的层次出发在本地重新选择，不写回图形。
+ * 光栅化器、剔除器和本地网格句柄在多次渲染之间复用。
+ */
+class SoftwareSceneRenderer {
+public:
+    SoftwareSceneRenderer();
+
+    /**
+     * @brief 设置细节层次变化时取网格的注册表
+     * @param registry 网格注册表，为空时始终使用图形当前的网格
+     * @param tessellation 球体的剖分方式
+     * @param maxErrorPixels 球体允许的最大屏幕误差（像素，经纬球不使用）
+     */
+    void SetMeshSource(MeshRegistry* registry, SphereTessellation tessellation = SPHERE_TESSELLATION_UV,
+                       float maxErrorPixels = 0.5f);
+
+    /**
+     * @brief 设置光栅化线程数（0表示使用硬件并发数）
+     */
+    void SetThreadCount(int count) { rasterizer.SetThreadCount(count); }
+
+    /**
+     * @brief 渲染场景到帧缓冲
+     * @param scene 场景数据
+     * @param target 输出帧缓冲，输出尺寸取其宽高
+     * @return 尺寸无效时返回false
+     */
+    bool Render(const SoftwareScene& scene, FramebufferRGBA8& target);
+
+private:
+    /**
+     * @brief 选择图形本帧使用的网格
+     * 
+     * 按投影半径在本地选择细节层次，与图形当前层次相同时直接用图形的网格。
+     */
+    MeshHandle SelectMesh(const Shape3D& shape, const float eye[3], int viewportHeight) const;
+
+    SoftwareRasterizer rasterizer;       ///< CPU光栅化器（复用缓冲和工作线程）
+    FrustumCuller culler;                ///< 本驱动自己的剔除结果
+    std::vector<MeshHandle> frameMeshes; ///< 上一帧使用的网格，保留到下一帧以免注册表反复生成
+    MeshRegistry* meshRegistry;          ///< 细节层次变化时取网格的注册表（可为空）
+    SphereTessellation sphereTessellation; ///< 球体的剖分方式
+    float sphereScreenError;             ///< 球体允许的最大屏幕误差（像素）
+};
@@ -15,6 +15,8 @@
 #include "engine/GraphicsEngine3D.h"
 #include "ui/MenuIDs.h"
 #include "ui/Dialogs3D.h"
+#include "diagnostics/Log.h"
+#include "diagnostics/Profiler.h"
 #include <windowsx.h>  // For GET_WHEEL_DELTA_WPARAM
 
 // === 全局变量 ===
@@ -40,10 +42,13 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
  * @param nCmdShow 窗口显示方式
  * @return 程序退出代码
  * 
- * 负责初始化窗口类、创建主窗口并启动消息循环
+ * 负责启动日志输出线程、初始化窗口类、创建主窗口并启动消息循环
  */
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR, int nCmdShow) {
     const wchar_t CLASS_NAME[] = L"GraphicsApp";
+    
+    // 日志在后台线程格式化输出，退出前输出剩余的记录
+    Log::Start();
 
     // 注册窗口类
     WNDCLASS wc = {};
@@ -68,6 +73,7 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR, int nCmdShow) {
         TranslateMessage(&msg);
         DispatchMessage(&msg);
     }
+    Log::Stop();
     return 0;
 }
 
@@ -83,6 +89,12 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
             AppendMenuW(hFileMenu, MF_STRING, ID_FILE_EXIT, L"退出(&X)");
             AppendMenuW(hMenuBar, MF_POPUP, (UINT_PTR)hFileMenu, L"文件(&F)");
             
+            // === 编辑菜单 ===
+            HMENU hEditMenu = CreatePopupMenu();
+            AppendMenuW(hEditMenu, MF_STRING, ID_EDIT_UNDO, L"撤销(&U)\tCtrl+Z");
+            AppendMenuW(hEditMenu, MF_STRING, ID_EDIT_REDO, L"重做(&R)\tCtrl+Y");
+            AppendMenuW(hMenuBar, MF_POPUP, (UINT_PTR)hEditMenu, L"编辑(&Z)");
+            
             // === 模式切换菜单 ===
             HMENU hModeMenu = CreatePopupMenu();
             AppendMenuW(hModeMenu, MF_STRING, ID_MODE_2D, L"2D模式(&2)");
@@ -105,6 +117,8 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
             AppendMenuW(hDrawMenu, MF_STRING, ID_DRAW_RECTANGLE, L"矩形(&R)");
             AppendMenuW(hDrawMenu, MF_STRING, ID_DRAW_POLYLINE, L"折线 (右键结束)(&P)");
             AppendMenuW(hDrawMenu, MF_STRING, ID_DRAW_POLYGON, L"多边形 (右键结束)(&G)");
+            AppendMenuW(hDrawMenu, MF_STRING, ID_DRAW_BSPLINE, L"B样条曲线 (右键结束)(&S)");
+            AppendMenuW(hDrawMenu, MF_STRING, ID_DRAW_NURBS, L"NURBS曲线 (右键结束)(&N)");
             AppendMenuW(hMenuBar, MF_POPUP, (UINT_PTR)hDrawMenu, L"绘图(&D)");
             
             // === 填充菜单 ===
@@ -155,8 +169,23 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
             AppendMenuW(h3DControlMenu, MF_STRING | MF_CHECKED, ID_3D_SHOW_AXES, L"显示坐标轴(&A)");
             AppendMenuW(h3DControlMenu, MF_STRING | MF_CHECKED, ID_3D_SHOW_GRID, L"显示网格(&G)");
             AppendMenuW(h3DControlMenu, MF_STRING | MF_CHECKED, ID_3D_SHOW_LIGHT, L"显示光源(&I)");
+            AppendMenuW(h3DControlMenu, MF_SEPARATOR, 0, NULL);
+            
+            // 球体剖分子菜单（单选）
+            HMENU hSphereMenu = CreatePopupMenu();
+            AppendMenuW(hSphereMenu, MF_STRING, ID_3D_SPHERE_UV, L"经纬球(&U)");
+            AppendMenuW(hSphereMenu, MF_STRING, ID_3D_SPHERE_ICOSPHERE, L"二十面体球(&I)");
+            AppendMenuW(hSphereMenu, MF_STRING, ID_3D_SPHERE_CUBE, L"立方体投影球(&C)");
+            CheckMenuRadioItem(hSphereMenu, ID_3D_SPHERE_UV, ID_3D_SPHERE_CUBE, ID_3D_SPHERE_UV, MF_BYCOMMAND);
+            AppendMenuW(h3DControlMenu, MF_POPUP, (UINT_PTR)hSphereMenu, L"球体剖分(&T)");
             AppendMenuW(hMenuBar, MF_POPUP, (UINT_PTR)h3DControlMenu, L"3D控制(&O)");
             
+            // 创建调试菜单
+            HMENU hDebugMenu = CreatePopupMenu();
+            AppendMenuW(hDebugMenu, MF_STRING, ID_DEBUG_PROFILE_START, L"开始性能采集(&P)");
+            AppendMenuW(hDebugMenu, MF_STRING | MF_GRAYED, ID_DEBUG_PROFILE_STOP, L"停止采集并导出(&E)");
+            AppendMenuW(hMenuBar, MF_POPUP, (UINT_PTR)hDebugMenu, L"调试(&G)");
+            
             SetMenu(hwnd, hMenuBar);
             
             // 初始化3D引擎
@@ -259,6 +288,15 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
             return 0;
         }
         
+        case WM_KEYDOWN: {
+            // Ctrl+Z / Ctrl+Y 快捷键转为编辑菜单命令
+            if (GetKeyState(VK_CONTROL) & 0x8000) {
+                if (wParam == 'Z') SendMessage(hwnd, WM_COMMAND, ID_EDIT_UNDO, 0);
+                else if (wParam == 'Y') SendMessage(hwnd, WM_COMMAND, ID_EDIT_REDO, 0);
+            }
+            return 0;
+        }
+        
         case WM_COMMAND: {
             // 处理菜单命令消息
             switch (LOWORD(wParam)) {
@@ -276,6 +314,19 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
                     // 退出程序
                     DestroyWindow(hwnd);
                     break;
+
+                // === 编辑菜单命令 ===
+                case ID_EDIT_UNDO:
+                case ID_EDIT_REDO: {
+                    // 撤销/重做（仅2D模式）
+                    if (is3DMode) break;
+                    HDC hdc = GetDC(hwnd);
+                    g_engine.Initialize(hwnd, hdc);
+                    if (LOWORD(wParam) == ID_EDIT_UNDO) g_engine.Undo();
+                    else g_engine.Redo();
+                    ReleaseDC(hwnd, hdc);
+                    break;
+                }
                     
                 // === 实验菜单命令 ===
                 case ID_EXPR_EXPR1:
@@ -312,6 +363,14 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
                     // 多边形绘制
                     g_engine.SetMode(MODE_POLYGON);
                     break;
+                case ID_DRAW_BSPLINE:
+                    // B样条曲线绘制
+                    g_engine.SetMode(MODE_BSPLINE);
+                    break;
+                case ID_DRAW_NURBS:
+                    // NURBS曲线绘制（三次，clamped均匀节点，曲线经过首末控制点）
+                    g_engine.SetMode(MODE_NURBS);
+                    break;
                 // === 填充算法菜单命令 ===
                 case ID_FILL_BOUNDARY:
                     // 边界填充算法
@@ -447,6 +506,48 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
                     InvalidateRect(hwnd, NULL, FALSE);
                     break;
                 }
+                case ID_3D_SPHERE_UV:
+                case ID_3D_SPHERE_ICOSPHERE:
+                case ID_3D_SPHERE_CUBE: {
+                    // 切换球体剖分方式，已有球体随之更换网格
+                    SphereTessellation mode = SPHERE_TESSELLATION_UV;
+                    if (LOWORD(wParam) == ID_3D_SPHERE_ICOSPHERE) mode = SPHERE_TESSELLATION_ICOSPHERE;
+                    if (LOWORD(wParam) == ID_3D_SPHERE_CUBE) mode = SPHERE_TESSELLATION_CUBE;
+                    g_engine3D.SetSphereTessellation(mode);
+                    
+                    // 更新单选标记
+                    HMENU hMenu = GetMenu(hwnd);
+                    CheckMenuRadioItem(hMenu, ID_3D_SPHERE_UV, ID_3D_SPHERE_CUBE, LOWORD(wParam), MF_BYCOMMAND);
+                    
+                    InvalidateRect(hwnd, NULL, FALSE);
+                    break;
+                }
+                
+                // === 调试菜单命令 ===
+                case ID_DEBUG_PROFILE_START: {
+                    // 开始采集帧内分段计时，之后的每次重绘都会被记录
+                    Profiler::StartCapture();
+                    HMENU hMenu = GetMenu(hwnd);
+                    EnableMenuItem(hMenu, ID_DEBUG_PROFILE_START, MF_GRAYED);
+                    EnableMenuItem(hMenu, ID_DEBUG_PROFILE_STOP, MF_ENABLED);
+                    break;
+                }
+                case ID_DEBUG_PROFILE_STOP: {
+                    // 停止采集，导出到工作目录下的 frame_trace.json（可在 chrome://tracing 中打开）
+                    Profiler::StopCapture();
+                    HMENU hMenu = GetMenu(hwnd);
+                    EnableMenuItem(hMenu, ID_DEBUG_PROFILE_START, MF_ENABLED);
+                    EnableMenuItem(hMenu, ID_DEBUG_PROFILE_STOP, MF_GRAYED);
+                    
+                    if (Profiler::WriteChromeTrace("frame_trace.json")) {
+                        wchar_t message[128];
+                        swprintf_s(message, L"已导出 %zu 个计时区到 frame_trace.json", Profiler::EventCount());
+                        MessageBoxW(hwnd, message, L"性能采集", MB_OK | MB_ICONINFORMATION);
+                    } else {
+                        MessageBoxW(hwnd, L"无法写入 frame_trace.json", L"错误", MB_OK | MB_ICONERROR);
+                    }
+                    break;
+                }
             }
             return 0;
         }
@@ -473,6 +574,7 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
  * - WM_PAINT: 窗口重绘时渲染图形
  * - WM_LBUTTONDOWN/WM_RBUTTONDOWN: 鼠标按键事件
  * - WM_MOUSEMOVE: 鼠标移动事件
+ * - WM_KEYDOWN: 撤销/重做快捷键
  * - WM_COMMAND: 菜单命令处理
  * - WM_DESTROY: 窗口销毁时清理资源
  */
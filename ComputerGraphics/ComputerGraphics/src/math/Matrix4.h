@@ -382,13 +382,13 @@ struct Matrix4 {
     Matrix4 multiply(const Matrix4& other) const {
         Matrix4 result;
         
-        // 遍历结果矩阵的每个元素
+        // 遍历结果矩阵的每个元素（列主序：第i行第j列存放在 m[j*4 + i]）
         for (int i = 0; i < 4; i++) {          // 行
             for (int j = 0; j < 4; j++) {      // 列
-                result.m[i*4 + j] = 0;
+                result.m[j*4 + i] = 0;
                 // 计算第i行与第j列的点积
                 for (int k = 0; k < 4; k++) {
-                    result.m[i*4 + j] += m[i*4 + k] * other.m[k*4 + j];
+                    result.m[j*4 + i] += m[k*4 + i] * other.m[j*4 + k];
                 }
             }
         }
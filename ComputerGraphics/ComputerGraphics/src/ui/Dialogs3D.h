@@ -23,6 +23,7 @@
 
 #pragma once
 #include "../core/Shape3D.h"
+#include "../core/Material3D.h"
 #include <windows.h>
 #include <string>
 
@@ -54,12 +55,14 @@ public:
      * @brief 显示变换参数对话框
      * @param parent 父窗口句柄
      * @param shape 要编辑的3D图形指针
+     * @param material 图形材质的副本，由对话框中的材质按钮编辑
      * @return 用户点击确定返回true，取消返回false
      * 
      * 显示模态对话框，允许用户编辑图形的变换参数
      * 对话框会显示当前图形的参数值，用户可以修改后确认或取消
+     * 材质保存在共享的材质表中，调用者负责把修改后的副本重新登记
      */
-    static bool Show(HWND parent, Shape3D* shape);
+    static bool Show(HWND parent, Shape3D* shape, Material3D* material);
     
 private:
     /**
@@ -92,7 +95,8 @@ private:
      */
     static void SetFloatValue(HWND hwnd, int controlID, float value);
     
-    static Shape3D* s_currentShape;  ///< 当前正在编辑的图形指针
+    static Shape3D* s_currentShape;        ///< 当前正在编辑的图形指针
+    static Material3D* s_currentMaterial;  ///< 当前图形材质的副本
 };
 
 /**
@@ -166,13 +170,13 @@ public:
     /**
      * @brief 显示材质编辑对话框
      * @param parent 父窗口句柄
-     * @param shape 要编辑的3D图形指针
+     * @param material 要编辑的材质指针
      * @return 用户点击确定返回true，取消返回false
      * 
-     * 显示模态对话框，允许用户编辑图形的材质参数
-     * 对话框会显示当前图形的材质值，用户可以修改后确认或取消
+     * 显示模态对话框，允许用户编辑材质参数
+     * 对话框会显示当前的材质值，用户可以修改后确认或取消
      */
-    static bool Show(HWND parent, Shape3D* shape);
+    static bool Show(HWND parent, Material3D* material);
     
 private:
     /**
@@ -205,7 +209,7 @@ private:
      */
     static void SetFloatValue(HWND hwnd, int controlID, float value);
     
-    static Shape3D* s_currentShape;  ///< 当前正在编辑的图形指针
+    static Material3D* s_currentMaterial;  ///< 当前正在编辑的材质指针
 };
 
 /**
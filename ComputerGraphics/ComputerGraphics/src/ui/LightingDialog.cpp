@@ -34,6 +34,7 @@
 #include "Dialogs3D.h"
 #include "MenuIDs.h"
 #include "../engine/GraphicsEngine3D.h"
+#include "../diagnostics/Log.h"
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -276,11 +277,8 @@ INT_PTR CALLBACK LightingDialog::DialogProc(HWND hwnd, UINT msg,
                     s_currentLight->color[2] = colorB;
                     
                     // 调试输出
-                    char debugMsg[512];
-                    sprintf_s(debugMsg, 
-                        "Lighting applied: Pos(%.2f, %.2f, %.2f) Intensity(A:%.2f, D:%.2f, S:%.2f) Color(%.2f, %.2f, %.2f)",
-                        posX, posY, posZ, ambient, diffuse, specular, colorR, colorG, colorB);
-                    OutputDebugStringA(debugMsg);
+                    LOG_DEBUG("Lighting applied: Pos(%.2f, %.2f, %.2f) Intensity(A:%.2f, D:%.2f, S:%.2f) Color(%.2f, %.2f, %.2f)",
+                              posX, posY, posZ, ambient, diffuse, specular, colorR, colorG, colorB);
                     
                     EndDialog(hwnd, IDOK);
                     return TRUE;
@@ -39,6 +39,7 @@
 #include "Dialogs3D.h"
 #include "MenuIDs.h"
 #include "../engine/GraphicsEngine3D.h"
+#include "../diagnostics/Log.h"
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -50,20 +51,20 @@
 /**
  * @brief 静态成员初始化
  */
-Shape3D* MaterialDialog::s_currentShape = nullptr;
+Material3D* MaterialDialog::s_currentMaterial = nullptr;
 
 /**
  * @brief 显示材质编辑对话框
  * @param parent 父窗口句柄
- * @param shape 要编辑的3D图形指针，不能为nullptr
+ * @param material 要编辑的材质指针，不能为nullptr
  * @return 用户点击确定返回true，取消返回false
  */
-bool MaterialDialog::Show(HWND parent, Shape3D* shape) {
-    if (!shape) {
+bool MaterialDialog::Show(HWND parent, Material3D* material) {
+    if (!material) {
         return false;
     }
     
-    s_currentShape = shape;
+    s_currentMaterial = material;
     
     // 获取应用程序实例句柄
     // 尝试从父窗口获取，如果失败则使用GetModuleHandle
@@ -76,7 +77,7 @@ bool MaterialDialog::Show(HWND parent, Shape3D* shape) {
     INT_PTR result = DialogBoxW(hInstance, MAKEINTRESOURCEW(IDD_MATERIAL3D), 
                                 parent, DialogProc);
     
-    s_currentShape = nullptr;
+    s_currentMaterial = nullptr;
     
     return (result == IDOK);
 }
@@ -97,28 +98,28 @@ INT_PTR CALLBACK MaterialDialog::DialogProc(HWND hwnd, UINT msg,
             // 对话框初始化
             // 将当前图形的材质参数填充到各个编辑框中
             // ================================================================
-            if (s_currentShape) {
+            if (s_currentMaterial) {
                 // 设置环境光反射系数（Ambient）
                 // 这些值决定物体在阴影区域的颜色
-                SetFloatValue(hwnd, IDC_EDIT_MAT_AMBIENT_R, s_currentShape->ambient[0]);
-                SetFloatValue(hwnd, IDC_EDIT_MAT_AMBIENT_G, s_currentShape->ambient[1]);
-                SetFloatValue(hwnd, IDC_EDIT_MAT_AMBIENT_B, s_currentShape->ambient[2]);
+                SetFloatValue(hwnd, IDC_EDIT_MAT_AMBIENT_R, s_currentMaterial->ambient[0]);
+                SetFloatValue(hwnd, IDC_EDIT_MAT_AMBIENT_G, s_currentMaterial->ambient[1]);
+                SetFloatValue(hwnd, IDC_EDIT_MAT_AMBIENT_B, s_currentMaterial->ambient[2]);
                 
                 // 设置漫反射系数（Diffuse）
                 // 这些值决定物体的主要颜色
-                SetFloatValue(hwnd, IDC_EDIT_MAT_DIFFUSE_R, s_currentShape->diffuse[0]);
-                SetFloatValue(hwnd, IDC_EDIT_MAT_DIFFUSE_G, s_currentShape->diffuse[1]);
-                SetFloatValue(hwnd, IDC_EDIT_MAT_DIFFUSE_B, s_currentShape->diffuse[2]);
+                SetFloatValue(hwnd, IDC_EDIT_MAT_DIFFUSE_R, s_currentMaterial->diffuse[0]);
+                SetFloatValue(hwnd, IDC_EDIT_MAT_DIFFUSE_G, s_currentMaterial->diffuse[1]);
+                SetFloatValue(hwnd, IDC_EDIT_MAT_DIFFUSE_B, s_currentMaterial->diffuse[2]);
                 
                 // 设置镜面反射系数（Specular）
                 // 这些值决定高光的颜色
-                SetFloatValue(hwnd, IDC_EDIT_MAT_SPECULAR_R, s_currentShape->specular[0]);
-                SetFloatValue(hwnd, IDC_EDIT_MAT_SPECULAR_G, s_currentShape->specular[1]);
-                SetFloatValue(hwnd, IDC_EDIT_MAT_SPECULAR_B, s_currentShape->specular[2]);
+                SetFloatValue(hwnd, IDC_EDIT_MAT_SPECULAR_R, s_currentMaterial->specular[0]);
+                SetFloatValue(hwnd, IDC_EDIT_MAT_SPECULAR_G, s_currentMaterial->specular[1]);
+                SetFloatValue(hwnd, IDC_EDIT_MAT_SPECULAR_B, s_currentMaterial->specular[2]);
                 
                 // 设置光泽度（Shininess）
                 // 值越大高光越小越锐利
-                SetFloatValue(hwnd, IDC_EDIT_MAT_SHININESS, s_currentShape->shininess);
+                SetFloatValue(hwnd, IDC_EDIT_MAT_SHININESS, s_currentMaterial->shininess);
             }
             
             // 将对话框居中显示
@@ -141,7 +142,7 @@ INT_PTR CALLBACK MaterialDialog::DialogProc(HWND hwnd, UINT msg,
                     // 用户点击确定按钮
                     // 验证所有输入并应用材质参数
                     // ========================================================
-                    if (!s_currentShape) {
+                    if (!s_currentMaterial) {
                         EndDialog(hwnd, IDCANCEL);
                         return TRUE;
                     }
@@ -311,29 +312,26 @@ INT_PTR CALLBACK MaterialDialog::DialogProc(HWND hwnd, UINT msg,
                     // --------------------------------------------------------
                     // 所有验证通过，应用新的材质参数
                     // --------------------------------------------------------
-                    s_currentShape->ambient[0] = ambientR;
-                    s_currentShape->ambient[1] = ambientG;
-                    s_currentShape->ambient[2] = ambientB;
+                    s_currentMaterial->ambient[0] = ambientR;
+                    s_currentMaterial->ambient[1] = ambientG;
+                    s_currentMaterial->ambient[2] = ambientB;
                     
-                    s_currentShape->diffuse[0] = diffuseR;
-                    s_currentShape->diffuse[1] = diffuseG;
-                    s_currentShape->diffuse[2] = diffuseB;
+                    s_currentMaterial->diffuse[0] = diffuseR;
+                    s_currentMaterial->diffuse[1] = diffuseG;
+                    s_currentMaterial->diffuse[2] = diffuseB;
                     
-                    s_currentShape->specular[0] = specularR;
-                    s_currentShape->specular[1] = specularG;
-                    s_currentShape->specular[2] = specularB;
+                    s_currentMaterial->specular[0] = specularR;
+                    s_currentMaterial->specular[1] = specularG;
+                    s_currentMaterial->specular[2] = specularB;
                     
-                    s_currentShape->shininess = shininess;
+                    s_currentMaterial->shininess = shininess;
                     
                     // 调试输出
-                    char debugMsg[512];
-                    sprintf_s(debugMsg, 
-                        "Material applied: Ambient(%.2f, %.2f, %.2f) Diffuse(%.2f, %.2f, %.2f) Specular(%.2f, %.2f, %.2f) Shininess(%.2f)",
-                        ambientR, ambientG, ambientB, 
-                        diffuseR, diffuseG, diffuseB, 
-                        specularR, specularG, specularB, 
-                        shininess);
-                    OutputDebugStringA(debugMsg);
+                    LOG_DEBUG("Material applied: Ambient(%.2f, %.2f, %.2f) Diffuse(%.2f, %.2f, %.2f) Specular(%.2f, %.2f, %.2f) Shininess(%.2f)",
+                              ambientR, ambientG, ambientB,
+                              diffuseR, diffuseG, diffuseB,
+                              specularR, specularG, specularB,
+                              shininess);
                     
                     EndDialog(hwnd, IDOK);
                     return TRUE;
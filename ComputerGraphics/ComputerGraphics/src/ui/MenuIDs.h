@@ -13,6 +13,10 @@
 #define ID_FILE_NEW 40001                    ///< 新建文件
 #define ID_FILE_EXIT 40002                   ///< 退出程序
 
+// === 编辑菜单ID ===
+#define ID_EDIT_UNDO 40701                   ///< 撤销
+#define ID_EDIT_REDO 40702                   ///< 重做
+
 // === 实验功能菜单ID ===
 #define ID_EXPR_EXPR1 40101                  ///< 实验功能1
 
@@ -30,6 +34,7 @@
 #define ID_DRAW_POLYLINE 40206               ///< 折线绘制
 #define ID_DRAW_POLYGON 40208                ///< 多边形绘制
 #define ID_DRAW_BSPLINE 40207                ///< B样条曲线绘制
+#define ID_DRAW_NURBS 40209                  ///< NURBS曲线绘制
 
 // === 2D填充算法菜单ID ===
 #define ID_FILL_SCANLINE 40301               ///< 扫描线填充算法
@@ -47,6 +52,10 @@
 #define ID_CLIP_SUTHERLAND_HODGMAN 40603     ///< Sutherland-Hodgman多边形裁剪
 #define ID_CLIP_WEILER_ATHERTON 40604        ///< Weiler-Atherton多边形裁剪
 
+// === 调试菜单ID ===
+#define ID_DEBUG_PROFILE_START 40801         ///< 开始采集帧内分段计时
+#define ID_DEBUG_PROFILE_STOP 40802          ///< 停止采集并导出Chrome trace
+
 // === 帮助菜单ID ===
 #define ID_HELP_ABOUT 40401                  ///< 关于对话框
 
@@ -67,6 +76,9 @@
 #define ID_3D_SHOW_AXES 61004                ///< 显示/隐藏坐标轴
 #define ID_3D_SHOW_GRID 61005                ///< 显示/隐藏网格
 #define ID_3D_SHOW_LIGHT 61006               ///< 显示/隐藏光源
+#define ID_3D_SPHERE_UV 61007                ///< 球体剖分：经纬球
+#define ID_3D_SPHERE_ICOSPHERE 61008         ///< 球体剖分：细分二十面体球
+#define ID_3D_SPHERE_CUBE 61009              ///< 球体剖分：立方体投影球
 
 // === 3D对话框ID ===
 #define IDD_TRANSFORM3D 70001                ///< 3D变换对话框
@@ -47,6 +47,7 @@
 #include "Dialogs3D.h"
 #include "MenuIDs.h"
 #include "../engine/GraphicsEngine3D.h"
+#include "../diagnostics/Log.h"
 #include "../algorithms/TextureLoader.h"
 #include <cstdio>
 #include <cstdlib>
@@ -159,9 +160,7 @@ INT_PTR CALLBACK TextureDialog::DialogProc(HWND hwnd, UINT msg,
 
         case WM_COMMAND: {
             // 调试输出
-            char cmdDebug[128];
-            sprintf_s(cmdDebug, "TextureDialog WM_COMMAND: 控件ID=%d", LOWORD(wParam));
-            OutputDebugStringA(cmdDebug);
+            LOG_TRACE("TextureDialog WM_COMMAND: 控件ID=%d", (int)LOWORD(wParam));
             
             switch (LOWORD(wParam)) {
                 case 8002: {  // 浏览按钮
@@ -169,7 +168,7 @@ INT_PTR CALLBACK TextureDialog::DialogProc(HWND hwnd, UINT msg,
                     // 用户点击浏览按钮
                     // 打开文件选择对话框让用户选择纹理文件
                     // ========================================================
-                    OutputDebugStringA("浏览按钮被点击");
+                    LOG_DEBUG("浏览按钮被点击");
                     std::string filepath;
                     if (OpenFileDialog(hwnd, filepath)) {
                         s_texturePath = filepath;
@@ -194,7 +193,7 @@ INT_PTR CALLBACK TextureDialog::DialogProc(HWND hwnd, UINT msg,
                         SetDlgItemTextA(hwnd, 8001, "(No texture)");  // 路径编辑框
                         
                         // 调试输出
-                        OutputDebugStringA("Texture removed from shape");
+                        LOG_DEBUG("Texture removed from shape");
                         
                         MessageBoxW(hwnd, L"纹理已移除", L"提示", MB_OK | MB_ICONINFORMATION);
                     }
@@ -241,10 +240,7 @@ INT_PTR CALLBACK TextureDialog::DialogProc(HWND hwnd, UINT msg,
                         s_currentShape->hasTexture = true;
                         
                         // 调试输出
-                        char debugMsg[512];
-                        sprintf_s(debugMsg, "Texture applied: %s (ID: %u)", 
-                                  s_texturePath.c_str(), newTextureID);
-                        OutputDebugStringA(debugMsg);
+                        LOG_DEBUG("Texture applied: %s (ID: %u)", s_texturePath.c_str(), newTextureID);
                     }
                     
                     EndDialog(hwnd, IDOK);
@@ -19,6 +19,7 @@
 #include "Dialogs3D.h"
 #include "MenuIDs.h"
 #include "../engine/GraphicsEngine3D.h"
+#include "../diagnostics/Log.h"
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -31,14 +32,17 @@
  * @brief 静态成员初始化
  * 
  * s_currentShape 用于在静态回调函数中访问当前正在编辑的图形
+ * s_currentMaterial 是该图形材质的副本，供材质按钮打开的材质对话框编辑
  * 由于Windows对话框回调函数必须是静态的，我们使用静态成员来传递数据
  */
 Shape3D* TransformDialog3D::s_currentShape = nullptr;
+Material3D* TransformDialog3D::s_currentMaterial = nullptr;
 
 /**
  * @brief 显示变换参数对话框
  * @param parent 父窗口句柄，对话框将相对于此窗口居中显示
  * @param shape 要编辑的3D图形指针，不能为nullptr
+ * @param material 图形材质的副本，材质对话框在其上修改，可为nullptr（此时不能编辑材质）
  * @return 用户点击确定返回true，取消或关闭返回false
  * 
  * 工作流程：
@@ -48,7 +52,7 @@ Shape3D* TransformDialog3D::s_currentShape = nullptr;
  * 4. 等待用户操作完成
  * 5. 清理静态成员并返回结果
  */
-bool TransformDialog3D::Show(HWND parent, Shape3D* shape) {
+bool TransformDialog3D::Show(HWND parent, Shape3D* shape, Material3D* material) {
     // 参数验证：确保传入的图形指针有效
     if (!shape) {
         return false;
@@ -56,6 +60,7 @@ bool TransformDialog3D::Show(HWND parent, Shape3D* shape) {
     
     // 保存当前图形指针，供对话框回调函数使用
     s_currentShape = shape;
+    s_currentMaterial = material;
     
     // 获取应用程序实例句柄，用于加载对话框资源
     HINSTANCE hInstance = (HINSTANCE)GetWindowLongPtr(parent, GWLP_HINSTANCE);
@@ -67,6 +72,7 @@ bool TransformDialog3D::Show(HWND parent, Shape3D* shape) {
     
     // 清理静态成员
     s_currentShape = nullptr;
+    s_currentMaterial = nullptr;
     
     // 返回用户是否点击了确定按钮
     return (result == IDOK);
@@ -128,10 +134,7 @@ INT_PTR CALLBACK TransformDialog3D::DialogProc(HWND hwnd, UINT msg,
         
         case WM_COMMAND: {
             // 调试输出：显示收到的控件ID
-            char cmdDebug[128];
-            sprintf_s(cmdDebug, "WM_COMMAND: 控件ID=%d, 通知码=%d", 
-                      LOWORD(wParam), HIWORD(wParam));
-            OutputDebugStringA(cmdDebug);
+            LOG_TRACE("WM_COMMAND: 控件ID=%d, 通知码=%d", (int)LOWORD(wParam), (int)HIWORD(wParam));
             
             switch (LOWORD(wParam)) {
                 case IDOK: {
@@ -241,11 +244,8 @@ INT_PTR CALLBACK TransformDialog3D::DialogProc(HWND hwnd, UINT msg,
                     s_currentShape->scaleZ = scaleZ;
                     
                     // 调试输出，便于跟踪变换参数的变化
-                    char debugMsg[512];
-                    sprintf_s(debugMsg, 
-                        "Transform applied: Pos(%.2f, %.2f, %.2f) Rot(%.2f, %.2f, %.2f) Scale(%.2f, %.2f, %.2f)",
-                        posX, posY, posZ, rotX, rotY, rotZ, scaleX, scaleY, scaleZ);
-                    OutputDebugStringA(debugMsg);
+                    LOG_DEBUG("Transform applied: Pos(%.2f, %.2f, %.2f) Rot(%.2f, %.2f, %.2f) Scale(%.2f, %.2f, %.2f)",
+                              posX, posY, posZ, rotX, rotY, rotZ, scaleX, scaleY, scaleZ);
                     
                     EndDialog(hwnd, IDOK);
                     return TRUE;
@@ -259,26 +259,26 @@ INT_PTR CALLBACK TransformDialog3D::DialogProc(HWND hwnd, UINT msg,
                 
                 case 5165: {  // 材质按钮（资源编译器分配的ID）
                     // 用户点击材质按钮，打开材质编辑对话框
-                    OutputDebugStringA("材质按钮被点击");
-                    if (s_currentShape) {
-                        OutputDebugStringA("正在打开材质对话框...");
-                        MaterialDialog::Show(hwnd, s_currentShape);
-                        OutputDebugStringA("材质对话框已关闭");
+                    LOG_DEBUG("材质按钮被点击");
+                    if (s_currentMaterial) {
+                        LOG_DEBUG("正在打开材质对话框...");
+                        MaterialDialog::Show(hwnd, s_currentMaterial);
+                        LOG_DEBUG("材质对话框已关闭");
                     } else {
-                        OutputDebugStringA("错误: s_currentShape 为空");
+                        LOG_ERROR("s_currentMaterial 为空");
                     }
                     return TRUE;
                 }
                 
                 case 5166: {  // 纹理按钮（资源编译器分配的ID）
                     // 用户点击纹理按钮，打开纹理设置对话框
-                    OutputDebugStringA("纹理按钮被点击");
+                    LOG_DEBUG("纹理按钮被点击");
                     if (s_currentShape) {
-                        OutputDebugStringA("正在打开纹理对话框...");
+                        LOG_DEBUG("正在打开纹理对话框...");
                         TextureDialog::Show(hwnd, s_currentShape);
-                        OutputDebugStringA("纹理对话框已关闭");
+                        LOG_DEBUG("纹理对话框已关闭");
                     } else {
-                        OutputDebugStringA("错误: s_currentShape 为空");
+                        LOG_ERROR("s_currentShape 为空");
                     }
                     return TRUE;
                 }